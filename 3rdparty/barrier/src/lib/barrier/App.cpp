@@ -25,6 +25,7 @@
 #include "base/log_outputters.h"
 #include "barrier/XBarrier.h"
 #include "barrier/ArgsBase.h"
+#include "barrier/MetricsReporter.h"
 #include "ipc/IpcServerProxy.h"
 #include "base/TMethodEventJob.h"
 #include "ipc/IpcMessage.h"
@@ -218,6 +219,18 @@ App::cleanupIpcClient()
     delete m_ipcClient;
 }
 
+void
+App::initMetricsReporter()
+{
+    m_metricsReporter = std::make_unique<MetricsReporter>(m_events);
+}
+
+void
+App::cleanupMetricsReporter()
+{
+    m_metricsReporter.reset();
+}
+
 void
 App::handleIpcMessage(const Event& e, void*)
 {
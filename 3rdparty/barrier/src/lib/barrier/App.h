@@ -40,6 +40,7 @@ class FileLogOutputter;
 namespace barrier { class Screen; }
 class IEventQueue;
 class SocketMultiplexer;
+class MetricsReporter;
 
 typedef IArchTaskBarReceiver* (*CreateTaskBarReceiverFunc)(const BufferedLogOutputter*, IEventQueue* events);
 
@@ -108,6 +109,8 @@ private:
 protected:
     void                initIpcClient();
     void                cleanupIpcClient();
+    void                initMetricsReporter();
+    void                cleanupMetricsReporter();
     void run_events_loop();
 
     IArchTaskBarReceiver* m_taskBarReceiver;
@@ -122,6 +125,7 @@ private:
     ARCH_APP_UTIL m_appUtil;
     IpcClient*            m_ipcClient;
     std::unique_ptr<SocketMultiplexer> m_socketMultiplexer;
+    std::unique_ptr<MetricsReporter> m_metricsReporter;
 };
 
 class MinimalApp : public App {
@@ -457,6 +457,9 @@ ClientApp::mainLoop()
         initIpcClient();
     }
 
+    // report the input sharing counters to the launching process
+    initMetricsReporter();
+
     // run event loop.  if startClient() failed we're supposed to retry
     // later.  the timer installed by startClient() will take care of
     // that.
@@ -488,6 +491,8 @@ ClientApp::mainLoop()
         cleanupIpcClient();
     }
 
+    cleanupMetricsReporter();
+
     return kExitSuccess;
 }
 
@@ -21,6 +21,7 @@
 #include "barrier/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Log.h"
+#include "base/Telemetry.h"
 #include <cstring>
 
 size_t ClipboardChunk::s_expectedSize = 0;
@@ -100,10 +101,12 @@ ClipboardChunk::assemble(barrier::IStream* stream,
         s_expectedSize = barrier::string::stringToSizeType(data);
         LOG((CLOG_DEBUG "start receiving clipboard data"));
         dataCached.clear();
+        Telemetry::clipboardStarted();
         return kStart;
     }
     else if (mark == kDataChunk) {
         dataCached.append(data);
+        Telemetry::addClipboardBytes(data.size());
         return kNotFinish;
     }
     else if (mark == kDataEnd) {
@@ -115,6 +118,7 @@ ClipboardChunk::assemble(barrier::IStream* stream,
             LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", s_expectedSize, dataCached.size()));
             return kError;
         }
+        Telemetry::clipboardFinished();
         return kFinish;
     }
 
@@ -143,6 +147,7 @@ ClipboardChunk::send(barrier::IStream* stream, void* data)
 
     case kDataChunk:
         LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", dataChunk.size()));
+        Telemetry::addClipboardBytes(dataChunk.size());
         break;
 
     case kDataEnd:
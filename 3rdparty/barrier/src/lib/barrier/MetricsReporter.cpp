@@ -0,0 +1,158 @@
+/*
+ * barrier -- mouse and keyboard sharing utility
+ * Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "barrier/MetricsReporter.h"
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/TMethodEventJob.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if SYSAPI_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+static const double s_interval = 1.0;
+
+//
+// MetricsReporter
+//
+
+MetricsReporter::MetricsReporter(IEventQueue* events) :
+    m_events(events),
+    m_timer(NULL),
+    m_fd(-1),
+    m_lastTime(0.0)
+{
+#if SYSAPI_UNIX
+    const char* path = std::getenv("BARRIER_METRICS_SOCKET");
+    if (path != NULL) {
+        m_path = path;
+    }
+#endif
+    if (!isEnabled()) {
+        return;
+    }
+
+    m_last     = Telemetry::sample();
+    m_lastTime = ARCH->time();
+    m_timer    = m_events->newTimer(s_interval, NULL);
+    m_events->adoptHandler(Event::kTimer, m_timer,
+                            new TMethodEventJob<MetricsReporter>(this,
+                                &MetricsReporter::handleTimer));
+    LOG((CLOG_DEBUG "reporting metrics to %s", m_path.c_str()));
+}
+
+MetricsReporter::~MetricsReporter()
+{
+    if (m_timer != NULL) {
+        m_events->removeHandler(Event::kTimer, m_timer);
+        m_events->deleteTimer(m_timer);
+    }
+    disconnect();
+}
+
+void
+MetricsReporter::handleTimer(const Event&, void*)
+{
+    Telemetry::Sample sample = Telemetry::sample();
+    double now = ARCH->time();
+    String line = Telemetry::format(m_last, sample, now - m_lastTime);
+    m_last     = sample;
+    m_lastTime = now;
+
+    if (connect()) {
+        send(line + "\n");
+    }
+}
+
+bool
+MetricsReporter::connect()
+{
+#if SYSAPI_UNIX
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    sockaddr_un address;
+    if (m_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, m_path.c_str(), m_path.size());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    // the reader may not be listening yet, try again on the next interval
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+MetricsReporter::disconnect()
+{
+#if SYSAPI_UNIX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+void
+MetricsReporter::send(const String& line)
+{
+#if SYSAPI_UNIX
+    ssize_t n = ::send(m_fd, line.c_str(), line.size(), MSG_NOSIGNAL);
+    if (n == static_cast<ssize_t>(line.size())) {
+        return;
+    }
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // the reader is behind, drop this interval
+        return;
+    }
+
+    // a partial line would corrupt the stream, start a new connection
+    LOG((CLOG_DEBUG1 "metrics socket closed"));
+    disconnect();
+#endif
+}
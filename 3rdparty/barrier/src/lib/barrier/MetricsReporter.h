@@ -0,0 +1,63 @@
+/*
+ * barrier -- mouse and keyboard sharing utility
+ * Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/Telemetry.h"
+#include "base/String.h"
+
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+
+//! Reports the telemetry to the launching process
+/*!
+When the environment variable \c BARRIER_METRICS_SOCKET names a local
+stream socket, the counters of Telemetry are written to it once a second,
+one line per interval in the format of Telemetry::format().  Lines are
+dropped rather than queued when the reader falls behind, so a stalled
+reader never delays the input sharing.
+
+Only available on unix, elsewhere the reporter does nothing.
+*/
+class MetricsReporter {
+public:
+    MetricsReporter(IEventQueue* events);
+    ~MetricsReporter();
+
+    //! @name accessors
+    //@{
+
+    //! Test if a metrics socket was requested
+    bool                isEnabled() const { return !m_path.empty(); }
+
+    //@}
+
+private:
+    void                handleTimer(const Event&, void*);
+    bool                connect();
+    void                disconnect();
+    void                send(const String& line);
+
+private:
+    IEventQueue*        m_events;
+    EventQueueTimer*    m_timer;
+    String              m_path;
+    int                 m_fd;
+    Telemetry::Sample   m_last;
+    double              m_lastTime;
+};
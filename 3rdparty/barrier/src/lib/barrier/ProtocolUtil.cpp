@@ -23,6 +23,7 @@
 #include "barrier/XBarrier.h"
 #include "common/stdvector.h"
 #include "base/String.h"
+#include "base/Telemetry.h"
 
 #include <cctype>
 #include <cstring>
@@ -38,6 +39,10 @@ ProtocolUtil::writef(barrier::IStream* stream, const char* fmt, ...)
     assert(fmt != NULL);
     LOG((CLOG_DEBUG2 "writef(%s)", fmt));
 
+    if (isInputMessage(fmt)) {
+        Telemetry::addEvent();
+    }
+
     va_list args;
     va_start(args, fmt);
     UInt32 size = getLength(fmt, args);
@@ -68,6 +73,14 @@ ProtocolUtil::readf(barrier::IStream* stream, const char* fmt, ...)
     return result;
 }
 
+bool
+ProtocolUtil::isInputMessage(const void* code)
+{
+    // DKxx and DMxx, see protocol_types.h
+    const char* c = static_cast<const char*>(code);
+    return c[0] == 'D' && (c[1] == 'K' || c[1] == 'M');
+}
+
 void
 ProtocolUtil::vwritef(barrier::IStream* stream,
                 const char* fmt, UInt32 size, va_list args)
@@ -72,6 +72,13 @@ public:
     static bool            readf(barrier::IStream*,
                             const char* fmt, ...);
 
+    //! Test for a key or mouse message
+    /*!
+    Returns true if the 4 byte message \c code forwards a key or mouse
+    event to the client.
+    */
+    static bool            isInputMessage(const void* code);
+
 private:
     static void            vwritef(barrier::IStream*,
                             const char* fmt, UInt32 size, va_list);
@@ -773,6 +773,9 @@ ServerApp::mainLoop()
         initIpcClient();
     }
 
+    // report the input sharing counters to the launching process
+    initMetricsReporter();
+
     // handle hangup signal by reloading the server's configuration
     ARCH->setSignalHandler(Arch::kHANGUP, &reloadSignalHandler, NULL);
     m_events->adoptHandler(m_events->forServerApp().reloadConfig(),
@@ -826,6 +829,8 @@ ServerApp::mainLoop()
         cleanupIpcClient();
     }
 
+    cleanupMetricsReporter();
+
     return kExitSuccess;
 }
 
@@ -0,0 +1,133 @@
+/*
+ * barrier -- mouse and keyboard sharing utility
+ * Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Telemetry.h"
+#include "base/String.h"
+#include "arch/Arch.h"
+
+#include <atomic>
+
+static std::atomic<std::uint64_t> s_events(0);
+static std::atomic<std::uint64_t> s_clipboardBytes(0);
+static std::atomic<std::int64_t> s_queuedBytes(0);
+static std::atomic<double> s_keepAliveSent(0.0);
+static std::atomic<double> s_rtt(-1.0);
+static std::atomic<double> s_clipboardStart(0.0);
+static std::atomic<double> s_clipboardTime(-1.0);
+
+//
+// Telemetry::Sample
+//
+
+Telemetry::Sample::Sample() :
+    m_events(0),
+    m_clipboardBytes(0),
+    m_queuedBytes(0),
+    m_rtt(-1.0),
+    m_clipboardTime(-1.0)
+{
+    // do nothing
+}
+
+//
+// Telemetry
+//
+
+void
+Telemetry::addEvent()
+{
+    s_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+Telemetry::addClipboardBytes(size_t n)
+{
+    s_clipboardBytes.fetch_add(n, std::memory_order_relaxed);
+}
+
+void
+Telemetry::addQueuedBytes(std::int64_t n)
+{
+    s_queuedBytes.fetch_add(n, std::memory_order_relaxed);
+}
+
+void
+Telemetry::keepAliveSent()
+{
+    // an unanswered keep alive is measured from the latest one
+    s_keepAliveSent.store(ARCH->time(), std::memory_order_relaxed);
+}
+
+void
+Telemetry::keepAliveReceived()
+{
+    double sent = s_keepAliveSent.exchange(0.0, std::memory_order_relaxed);
+    if (sent > 0.0) {
+        s_rtt.store(ARCH->time() - sent, std::memory_order_relaxed);
+    }
+}
+
+void
+Telemetry::clipboardStarted()
+{
+    s_clipboardStart.store(ARCH->time(), std::memory_order_relaxed);
+}
+
+void
+Telemetry::clipboardFinished()
+{
+    double start = s_clipboardStart.exchange(0.0, std::memory_order_relaxed);
+    if (start > 0.0) {
+        s_clipboardTime.store(ARCH->time() - start, std::memory_order_relaxed);
+    }
+}
+
+Telemetry::Sample
+Telemetry::sample()
+{
+    Sample sample;
+    sample.m_events         = s_events.load(std::memory_order_relaxed);
+    sample.m_clipboardBytes = s_clipboardBytes.load(std::memory_order_relaxed);
+    std::int64_t queued     = s_queuedBytes.load(std::memory_order_relaxed);
+    sample.m_queuedBytes    = queued > 0 ? static_cast<std::uint64_t>(queued) : 0;
+    sample.m_rtt            = s_rtt.load(std::memory_order_relaxed);
+    sample.m_clipboardTime  = s_clipboardTime.load(std::memory_order_relaxed);
+    return sample;
+}
+
+std::string
+Telemetry::format(const Sample& previous, const Sample& current, double interval)
+{
+    if (interval <= 0.0) {
+        interval = 1.0;
+    }
+
+    // counters may have been reset between the samples
+    std::uint64_t events = current.m_events >= previous.m_events ?
+                        current.m_events - previous.m_events : current.m_events;
+    std::uint64_t clipboard = current.m_clipboardBytes >= previous.m_clipboardBytes ?
+                        current.m_clipboardBytes - previous.m_clipboardBytes :
+                        current.m_clipboardBytes;
+
+    return barrier::string::sprintf(
+                "events=%.1f queue=%llu rtt=%.1f clipboard=%.0f clipboard_ms=%.1f",
+                events / interval,
+                static_cast<unsigned long long>(current.m_queuedBytes),
+                current.m_rtt < 0.0 ? -1.0 : current.m_rtt * 1000.0,
+                clipboard / interval,
+                current.m_clipboardTime < 0.0 ? -1.0 : current.m_clipboardTime * 1000.0);
+}
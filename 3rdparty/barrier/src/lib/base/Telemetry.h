@@ -0,0 +1,92 @@
+/*
+ * barrier -- mouse and keyboard sharing utility
+ * Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//! Input sharing counters
+/*!
+Process wide counters of the connection to the peer.  They are updated
+from the event loop and the socket multiplexer thread without locking,
+and are sampled periodically to report rates.
+*/
+class Telemetry {
+public:
+    //! Counters at one point in time
+    struct Sample {
+        Sample();
+
+        //! Key and mouse messages sent or received
+        std::uint64_t   m_events;
+        //! Clipboard payload sent or received
+        std::uint64_t   m_clipboardBytes;
+        //! Bytes waiting in the socket output buffers
+        std::uint64_t   m_queuedBytes;
+        //! Last keep alive round trip in seconds, negative if unknown
+        double          m_rtt;
+        //! Transfer time of the last received clipboard, negative if none
+        double          m_clipboardTime;
+    };
+
+    //! @name manipulators
+    //@{
+
+    //! Count a key or mouse message
+    static void         addEvent();
+
+    //! Count clipboard payload bytes
+    static void         addClipboardBytes(size_t n);
+
+    //! Track bytes entering (positive) or leaving the output buffers
+    static void         addQueuedBytes(std::int64_t n);
+
+    //! Note a keep alive was sent to the peer
+    static void         keepAliveSent();
+
+    //! Note the peer answered a keep alive
+    /*!
+    Updates the round trip if a keep alive is outstanding.
+    */
+    static void         keepAliveReceived();
+
+    //! Note the first chunk of a clipboard was received
+    static void         clipboardStarted();
+
+    //! Note the last chunk of a clipboard was received
+    static void         clipboardFinished();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Read the current counters
+    static Sample       sample();
+
+    //! Format the metrics of an interval
+    /*!
+    Returns one line of space separated \c key=value pairs with the rates
+    between \p previous and \p current, taken \p interval seconds apart.
+    Times are in milliseconds, -1 if unknown.
+    */
+    static std::string  format(const Sample& previous,
+                            const Sample& current, double interval);
+
+    //@}
+};
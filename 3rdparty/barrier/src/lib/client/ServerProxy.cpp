@@ -32,6 +32,7 @@
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
 #include "base/XBase.h"
+#include "base/Telemetry.h"
 
 #include <memory>
 
@@ -231,6 +232,10 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 ServerProxy::EResult
 ServerProxy::parseMessage(const UInt8* code)
 {
+    if (ProtocolUtil::isInputMessage(code)) {
+        Telemetry::addEvent();
+    }
+
     if (memcmp(code, kMsgDMouseMove, 4) == 0) {
         mouseMove();
     }
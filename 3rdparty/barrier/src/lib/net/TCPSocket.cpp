@@ -28,6 +28,7 @@
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/IEventJob.h"
+#include "base/Telemetry.h"
 
 #include <cstring>
 #include <cstdlib>
@@ -176,6 +177,7 @@ TCPSocket::write(const void* buffer, UInt32 n)
         // copy data to the output buffer
         wasEmpty = (m_outputBuffer.getSize() == 0);
         m_outputBuffer.write(buffer, n);
+        Telemetry::addQueuedBytes(n);
 
         // there's data to write
         m_flushed = false;
@@ -461,6 +463,7 @@ void
 TCPSocket::discardWrittenData(int bytesWrote)
 {
     m_outputBuffer.pop(bytesWrote);
+    Telemetry::addQueuedBytes(-static_cast<std::int64_t>(bytesWrote));
     if (m_outputBuffer.getSize() == 0) {
         sendEvent(m_events->forIStream().outputFlushed());
         m_flushed = true;
@@ -486,6 +489,7 @@ TCPSocket::onInputShutdown()
 void
 TCPSocket::onOutputShutdown()
 {
+    Telemetry::addQueuedBytes(-static_cast<std::int64_t>(m_outputBuffer.getSize()));
     m_outputBuffer.pop(m_outputBuffer.getSize());
     m_writable = false;
 
@@ -22,6 +22,7 @@
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
+#include "base/Telemetry.h"
 
 #include <cstring>
 #include <memory>
@@ -60,6 +61,7 @@ ClientProxy1_3::parseMessage(const UInt8* code)
     if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
         // reset alarm
         resetHeartbeatTimer();
+        Telemetry::keepAliveReceived();
         return true;
     }
     else {
@@ -127,4 +129,5 @@ void
 ClientProxy1_3::keepAlive()
 {
     ProtocolUtil::writef(getStream(), kMsgCKeepAlive);
+    Telemetry::keepAliveSent();
 }
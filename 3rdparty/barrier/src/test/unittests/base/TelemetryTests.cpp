@@ -0,0 +1,60 @@
+/*
+ * barrier -- mouse and keyboard sharing utility
+ * Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Telemetry.h"
+
+#include "test/global/gtest.h"
+
+TEST(TelemetryTests, format_twoSamples_ratesOfInterval)
+{
+    Telemetry::Sample previous;
+    previous.m_events = 100;
+    previous.m_clipboardBytes = 1000;
+
+    Telemetry::Sample current;
+    current.m_events = 300;
+    current.m_clipboardBytes = 5000;
+    current.m_queuedBytes = 42;
+    current.m_rtt = 0.0025;
+    current.m_clipboardTime = 0.5;
+
+    std::string result = Telemetry::format(previous, current, 2.0);
+
+    EXPECT_EQ("events=100.0 queue=42 rtt=2.5 clipboard=2000 clipboard_ms=500.0", result);
+}
+
+TEST(TelemetryTests, format_unknownTimes_negativeTimes)
+{
+    Telemetry::Sample sample;
+
+    std::string result = Telemetry::format(sample, sample, 1.0);
+
+    EXPECT_EQ("events=0.0 queue=0 rtt=-1.0 clipboard=0 clipboard_ms=-1.0", result);
+}
+
+TEST(TelemetryTests, format_countersReset_ratesOfCurrent)
+{
+    Telemetry::Sample previous;
+    previous.m_events = 500;
+
+    Telemetry::Sample current;
+    current.m_events = 20;
+
+    std::string result = Telemetry::format(previous, current, 1.0);
+
+    EXPECT_EQ("events=20.0 queue=0 rtt=-1.0 clipboard=0 clipboard_ms=-1.0", result);
+}
@@ -6,6 +6,7 @@
 #include "singleton/commandparser.h"
 #include "base/baseutils.h"
 #include "config.h"
+#include "common/logger.h"
 
 #include "core/cooperationcoreplugin.h"
 
@@ -14,6 +15,9 @@
 #include <QDebug>
 #include <QProcess>
 
+#include <cstring>
+#include <iostream>
+
 #include <signal.h>
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -37,6 +41,10 @@ static void appExitHandler(int sig)
 
 int main(int argc, char *argv[])
 {
+    // render a binary log (.binlog or archived .binlog.zip) as text, without starting the app
+    if (argc == 3 && std::strcmp(argv[1], "--render-log") == 0)
+        return deepin_cross::Logger::renderBinaryLog(argv[2], std::cout) ? 0 : 1;
+
     // qputenv("QT_LOGGING_RULES", "dde-cooperation.debug=true");
     // qputenv("SLOTIPC_DEBUG", "1");
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -128,13 +128,6 @@ void CommonUitls::loadTranslator()
 
 void CommonUitls::initLog()
 {
-    qInfo() << "Initializing logger in directory: " << logDir();
-    deepin_cross::Logger::GetInstance().init(logDir().toStdString(), qApp->applicationName().toStdString());
-#ifdef QT_DEBUG
-    deepin_cross::g_logLevel = deepin_cross::debug;
-    LOG << "Debug build, set LogLevel " << deepin_cross::g_logLevel;
-#endif
-
 #ifdef linux
     QString logConfPath = QString("/usr/share/%1/")
                                   .arg(qApp->applicationName());   //  /usr/share/xx
@@ -143,6 +136,15 @@ void CommonUitls::initLog()
 #endif
     QString configFile = logConfPath + "config.conf";   //日志级别配置
     QSettings settings(configFile, QSettings::IniFormat);
+
+    // 二进制日志：只记录格式串和参数，文本离线渲染
+    bool binaryLog = settings.value("g_binaryLog", false).toBool();
+    qInfo() << "Initializing logger in directory: " << logDir() << "binary:" << binaryLog;
+    deepin_cross::Logger::GetInstance().init(logDir().toStdString(), qApp->applicationName().toStdString(), binaryLog);
+#ifdef QT_DEBUG
+    deepin_cross::g_logLevel = deepin_cross::debug;
+    LOG << "Debug build, set LogLevel " << deepin_cross::g_logLevel;
+#endif
 #ifndef linux
     // On Windows, create config file if not exists (logDir is user-writable)
     QFile file(configFile);
@@ -20,6 +20,7 @@ typedef enum trans_result_t {
     TRANS_FILE_CHANGE = 54,
     TRANS_FILE_SPEED = 55,
     TRANS_FILE_DONE = 56,
+    TRANS_COUNTING = 57, // partial total, the sender is still counting
 } TransResult;
 
 // compat old protocol transfer status
@@ -20,6 +20,16 @@
 #define ELOG  if (deepin_cross::g_logLevel <= deepin_cross::error)   _LOG_STREAM(deepin_cross::error)
 #define FLOG  if (deepin_cross::g_logLevel <= deepin_cross::fatal)   _LOG_STREAM(deepin_cross::fatal)
 
+// deferred format log: only the pattern and raw arguments are captured on the caller thread
+// usage: DLOGF("progress size: {}", size);
+#define _LOG_FORMAT(lv, tag, fmtstr, ...) deepin_cross::Logger::GetInstance().logf(lv, "[" tag "] [{}:{}] " fmtstr, _LOG_FILELINE, ##__VA_ARGS__)
+
+#define DLOGF(fmtstr, ...) if (deepin_cross::g_logLevel <= deepin_cross::debug)   _LOG_FORMAT(deepin_cross::debug, "Debug  ", fmtstr, ##__VA_ARGS__)
+#define LOGF(fmtstr, ...)  if (deepin_cross::g_logLevel <= deepin_cross::info)    _LOG_FORMAT(deepin_cross::info, "Info   ", fmtstr, ##__VA_ARGS__)
+#define WLOGF(fmtstr, ...) if (deepin_cross::g_logLevel <= deepin_cross::warning) _LOG_FORMAT(deepin_cross::warning, "Warning", fmtstr, ##__VA_ARGS__)
+#define ELOGF(fmtstr, ...) if (deepin_cross::g_logLevel <= deepin_cross::error)   _LOG_FORMAT(deepin_cross::error, "Error  ", fmtstr, ##__VA_ARGS__)
+#define FLOGF(fmtstr, ...) if (deepin_cross::g_logLevel <= deepin_cross::fatal)   _LOG_FORMAT(deepin_cross::fatal, "Fatal  ", fmtstr, ##__VA_ARGS__)
+
 // conditional log
 #define DLOG_IF(cond) if (cond) DLOG
 #define  LOG_IF(cond) if (cond) LOG
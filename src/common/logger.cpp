@@ -3,11 +3,14 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logger.h"
+#include <fstream>
+#include <iterator>
 #include <mutex>
 
 using namespace deepin_cross;
 
 const char *Logger::_levels[] = {"Debug  ", "Info   ", "Warning", "Error  ", "Fatal  "};
+const char *Logger::_pattern = "{LocalYear}-{LocalMonth}-{LocalDay} {LocalHour}:{LocalMinute}:{LocalSecond}.{Millisecond} {Message} {EndLine}";
 
 Logger::Logger()
     : _initialized(false)  // atomic<bool> 的初始化
@@ -33,7 +36,7 @@ LogStream Logger::log(const char* fname, unsigned line, int level)
     return LogStream(*this, data);
 }
 
-void Logger::init(const std::string &logpath, const std::string &logname) {
+void Logger::init(const std::string &logpath, const std::string &logname, bool binary) {
     // 使用互斥锁确保 init 只被调用一次，且不会被并发调用
     std::lock_guard<std::mutex> lock(_initMutex);
 
@@ -45,26 +48,49 @@ void Logger::init(const std::string &logpath, const std::string &logname) {
     BaseKit::Path savepath = BaseKit::Path(logpath);
     // Create a custom text layout pattern {LocalDate} {LocalTime}
     // std::string fileAndLine = std::string(__FILE__) + ":" + std::to_string(__LINE__);
-    const std::string pattern = "{LocalYear}-{LocalMonth}-{LocalDay} {LocalHour}:{LocalMinute}:{LocalSecond}.{Millisecond} {Message} {EndLine}";
-
-
-    // Create default logging sink processor with a text layout
-    auto sink = std::make_shared<Logging::AsyncWaitFreeProcessor>(std::make_shared<Logging::TextLayout>(pattern));
-
-    // Add console appender
-    sink->appenders().push_back(std::make_shared<Logging::ConsoleAppender>());
-    // Add syslog appender
-    sink->appenders().push_back(std::make_shared<Logging::SyslogAppender>());
-
-    // Add file appender
-    //BaseKit::Path logfile = logpath + "/" + logname + ".log";
-    //sink->appenders().push_back(std::make_shared<Logging::FileAppender>(logfile));
-
-    // Add file appender with time-based rolling policy and archivation
-    // sink->appenders().push_back(std::make_shared<Logging::RollingFileAppender>(savepath, Logging::TimeRollingPolicy::DAY, logname + "_{LocalDate}.log", true));
-
-    // Add rolling file appender which rolls after append 100MB of logs and will keep only 5 recent archives
-    sink->appenders().push_back(std::make_shared<Logging::RollingFileAppender>(savepath, logname, "log", 104857600, 5, true));
+    const std::string pattern = _pattern;
+
+    // 前端队列在日志线程上完成布局，然后每个输出端拥有独立的队列和线程，
+    // 慢速的 syslog 或日志归档不会阻塞文件写入
+    std::shared_ptr<Logging::Processor> sink;
+    if (binary) {
+        // 二进制模式：文件只保存格式串和原始参数，不在日志线程上格式化
+        sink = std::make_shared<Logging::AsyncWaitFreeProcessor>(std::make_shared<Logging::BinaryLayout>());
+
+        auto file = std::make_shared<Logging::AsyncFanoutProcessor>(nullptr);
+        file->AddAppender(std::make_shared<Logging::RollingFileAppender>(savepath, logname, "binlog", 104857600, 5, true), Logging::OverflowPolicy::BLOCK);
+        sink->processors().push_back(file);
+
+        // 警告及以上级别仍然渲染为文本，输出到控制台和 syslog
+        auto text = std::make_shared<Logging::AsyncFanoutProcessor>(std::make_shared<Logging::TextLayout>(pattern));
+        text->filters().push_back(std::make_shared<Logging::LevelFilter>(Logging::Level::WARN));
+        text->AddAppender(std::make_shared<Logging::ConsoleAppender>(), Logging::OverflowPolicy::DROP);
+        text->AddAppender(std::make_shared<Logging::SyslogAppender>(), Logging::OverflowPolicy::SAMPLE);
+        sink->processors().push_back(text);
+    } else {
+        // Create default logging sink processor, the fan-out lays out records on its thread
+        sink = std::make_shared<Logging::AsyncWaitFreeProcessor>(nullptr);
+
+        // 输出端丢弃的记录数由 fan-out 按同样的文本格式报告
+        auto fanout = std::make_shared<Logging::AsyncFanoutProcessor>(std::make_shared<Logging::TextLayout>(pattern));
+
+        // Add console appender
+        fanout->AddAppender(std::make_shared<Logging::ConsoleAppender>(), Logging::OverflowPolicy::DROP);
+        // Add syslog appender
+        fanout->AddAppender(std::make_shared<Logging::SyslogAppender>(), Logging::OverflowPolicy::SAMPLE);
+
+        // Add file appender
+        //BaseKit::Path logfile = logpath + "/" + logname + ".log";
+        //sink->appenders().push_back(std::make_shared<Logging::FileAppender>(logfile));
+
+        // Add file appender with time-based rolling policy and archivation
+        // sink->appenders().push_back(std::make_shared<Logging::RollingFileAppender>(savepath, Logging::TimeRollingPolicy::DAY, logname + "_{LocalDate}.log", true));
+
+        // Add rolling file appender which rolls after append 100MB of logs and will keep only 5 recent archives
+        fanout->AddAppender(std::make_shared<Logging::RollingFileAppender>(savepath, logname, "log", 104857600, 5, true), Logging::OverflowPolicy::BLOCK);
+
+        sink->processors().push_back(fanout);
+    }
 
     // Configure example logger
     Logging::Config::ConfigLogger("dde-cooperation", sink);
@@ -125,3 +151,39 @@ void Logger::logout(ThreadLocalData& data, const std::string& message)
     data.buffer.clear();
     data.buffer.str("");
 }
+
+bool Logger::renderBinaryLog(const std::string &binfile, std::ostream &out)
+{
+    std::vector<uint8_t> content;
+    const std::string archive = ".zip";
+    if (binfile.size() > archive.size() && binfile.compare(binfile.size() - archive.size(), archive.size(), archive) == 0) {
+        // 滚动归档的备份文件（*.binlog.zip）
+        try {
+            content = Logging::RollingFileAppender::ReadArchive(binfile);
+        } catch (const std::exception &) {
+            return false;
+        }
+    } else {
+        std::ifstream in(binfile, std::ios::binary);
+        if (!in.is_open())
+            return false;
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    Logging::TextLayout layout(_pattern);
+    Logging::Record record;
+    size_t offset = 0;
+    while (offset < content.size()) {
+        size_t size = Logging::BinaryLayout::RestoreRecord(content.data() + offset, content.size() - offset, record);
+        if (size == 0) {
+            // 文件尾部记录不完整（例如进程被终止），忽略
+            break;
+        }
+        offset += size;
+
+        layout.LayoutRecord(record);
+        out.write((const char *)record.raw.data(), record.raw.size() - 1);
+    }
+
+    return true;
+}
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <mutex>
 #include <atomic>
+#include <cstdio>
 
 namespace deepin_cross {
 
@@ -43,11 +44,20 @@ public:
 
     ~Logger();
 
-    void init(const std::string &logpath, const std::string &logname);
+    // binary 为 true 时日志文件只写入格式串和原始参数，由 renderBinaryLog 离线渲染
+    void init(const std::string &logpath, const std::string &logname, bool binary = false);
     void stop();
 
     LogStream log(const char* fname, unsigned line, int level);
 
+    // 延迟格式化：只保存格式串和参数，文本在异步线程或离线时生成
+    template <typename... T>
+    void logf(int level, fmt::format_string<T...> message, T&&... args);
+
+    // 将二进制日志文件（或滚动归档的 .binlog.zip）渲染为文本输出，
+    // 可通过 dde-cooperation --render-log <file> 调用
+    static bool renderBinaryLog(const std::string &binfile, std::ostream &out);
+
     // 使用 thread_local 确保每个线程有自己的缓冲区和级别
     struct ThreadLocalData {
         std::ostringstream buffer;
@@ -60,6 +70,7 @@ public:
 
 private:
     static const char *_levels[];
+    static const char *_pattern;
     Logging::Logger _logger;
     std::atomic<bool> _initialized;  // 使用原子变量防止数据竞争
 
@@ -67,6 +78,38 @@ private:
     std::mutex _initMutex;
 };
 
+template <typename... T>
+inline void Logger::logf(int level, fmt::format_string<T...> message, T&&... args)
+{
+    if (!_initialized.load(std::memory_order_acquire)) {
+        // 未初始化时，使用 stderr 作为备用输出
+        std::string text = BaseKit::format(message, std::forward<T>(args)...);
+        fprintf(stderr, "%s\n", text.c_str());
+        fflush(stderr);
+        return;
+    }
+
+    switch (level) {
+    case debug:
+        _logger.Debug(message, std::forward<T>(args)...);
+        break;
+    case info:
+        _logger.Info(message, std::forward<T>(args)...);
+        break;
+    case warning:
+        _logger.Warn(message, std::forward<T>(args)...);
+        break;
+    case error:
+        _logger.Error(message, std::forward<T>(args)...);
+        break;
+    case fatal:
+        _logger.Fatal(message, std::forward<T>(args)...);
+        break;
+    default:
+        break;
+    }
+}
+
 // 代理类 LogStream
 class LogStream {
 public:
@@ -20,6 +20,10 @@
 #define KEY_APP_OPTION_KEYBOARD "option_keyboard"
 #define KEY_APP_OPTION_MOUSE "option_mouse"
 #define KEY_APP_OPTION_FILETRANS "option_filetrans"
+// 传输带宽限制，字节/秒，0不限
+#define KEY_APP_RATE_LIMIT "ratelimit"
+#define KEY_APP_JOB_RATE_LIMIT "jobratelimit"
+#define KEY_APP_ADAPTIVE_LIMIT "adaptivelimit"
 
 
 // 功能设置关键字
@@ -133,6 +137,7 @@ typedef enum flow_type_t {
 } FSFlowType;
 
 typedef enum rpc_result_t {
+    INVOKE_CORRUPTED = -4, // 数据包校验失败，连接正常，可以重发
     HAVE_NO_EXECTOR = -3,
     PARAM_ERROR = -2,
     INVOKE_FAIL = -1,
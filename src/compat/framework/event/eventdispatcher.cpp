@@ -85,6 +85,7 @@ bool EventDispatcherManager::unsubscribe(const QString &space, const QString &to
 bool EventDispatcherManager::unsubscribe(EventType type)
 {
     QWriteLocker guard(&rwLock);
+    typedTable.store(type, nullptr);
     if (dispatcherMap.contains(type))
         return dispatcherMap.remove(type) > 0;
 
@@ -114,6 +114,7 @@ PluginMetaObject::PluginMetaObject(const PluginMetaObject &meta)
     d->state = pluginState();
     d->plugin = plugin();
     d->loader = meta.d->loader;
+    d->fileName = meta.d->fileName;
 }
 /*!
  * \brief 赋值拷贝
@@ -131,6 +132,7 @@ PluginMetaObject &PluginMetaObject::operator=(const PluginMetaObject &meta)
     d->state = pluginState();
     d->plugin = plugin();
     d->loader = meta.d->loader;
+    d->fileName = meta.d->fileName;
     return *this;
 }
 
@@ -146,7 +148,7 @@ bool PluginMetaObject::isVirtual() const
  */
 QString PluginMetaObject::fileName() const
 {
-    return d->loader->fileName();
+    return d->fileName;
 }
 
 /*!
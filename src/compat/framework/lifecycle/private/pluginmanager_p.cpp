@@ -9,8 +9,50 @@
 #include <dde-cooperation-framework/lifecycle/plugin.h>
 #include <dde-cooperation-framework/lifecycle/plugincreator.h>
 
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
 DPF_BEGIN_NAMESPACE
 
+namespace {
+
+// 插件元数据缓存：以文件路径为键，记录修改时间、大小和 QPluginLoader::metaData()
+inline constexpr char kCacheFileName[] { "plugin-metadata.json" };
+inline constexpr char kCacheModified[] { "mtime" };
+inline constexpr char kCacheSize[] { "size" };
+inline constexpr char kCacheMeta[] { "meta" };
+
+QString metaCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + kCacheFileName;
+}
+
+QJsonObject readMetaCache()
+{
+    QFile file(metaCachePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void writeMetaCache(const QJsonObject &cache)
+{
+    const QString &path = metaCachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write plugin meta cache:" << path;
+        return;
+    }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+}   // namespace
+
 PluginManagerPrivate::PluginManagerPrivate(PluginManager *qq)
     : q(qq)
 {
@@ -121,6 +163,10 @@ void PluginManagerPrivate::scanfAllPlugin(QQueue<PluginMetaObjectPointer> *destQ
     if (pluginIIDs.isEmpty())
         return;
 
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList fileNames;
     for (const QString &path : pluginPaths) {
         QString libSuffix =
         #ifdef WIN32
@@ -135,20 +181,62 @@ void PluginManagerPrivate::scanfAllPlugin(QQueue<PluginMetaObjectPointer> *destQ
 
         while (dirItera.hasNext()) {
             dirItera.next();
-            PluginMetaObjectPointer metaObj(new PluginMetaObject);
-            const QString &fileName { dirItera.path() + "/" + dirItera.fileName() };
-            metaObj->d->loader->setFileName(fileName);
-            QJsonObject &&metaJson = metaObj->d->loader->metaData();
-            QJsonObject &&dataJson = metaJson.value("MetaData").toObject();
-            QString &&iid = metaJson.value("IID").toString();
-            if (!pluginIIDs.contains(iid))
-                continue;
+            fileNames.append(dirItera.path() + "/" + dirItera.fileName());
+        }
+    }
+
+    // 未变化的插件直接使用缓存的元数据，其余的并行读取
+    const QJsonObject &cache = readMetaCache();
+    QJsonObject newCache;
+    QHash<QString, QJsonObject> metaJsons;
+    QStringList missFileNames;
+    for (const QString &fileName : fileNames) {
+        QFileInfo info(fileName);
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        const QJsonObject &entry = cache.value(fileName).toObject();
+        if (!entry.isEmpty()
+            && static_cast<qint64>(entry.value(kCacheModified).toDouble()) == modified
+            && static_cast<qint64>(entry.value(kCacheSize).toDouble()) == info.size()) {
+            metaJsons.insert(fileName, entry.value(kCacheMeta).toObject());
+            newCache.insert(fileName, entry);
+        } else {
+            missFileNames.append(fileName);
+        }
+    }
 
-            bool isVirtual = dataJson.contains(kVirtualPluginMeta) && dataJson.contains(kVirtualPluginList);
-            if (isVirtual)
-                scanfVirtualPlugin(destQueue, fileName, dataJson, blackList);
-            else
-                scanfRealPlugin(destQueue, metaObj, dataJson, blackList);
+    const QList<QJsonObject> &missMetaJsons = QtConcurrent::blockingMapped<QList<QJsonObject>>(missFileNames, [](const QString &fileName) {
+        return QPluginLoader(fileName).metaData();
+    });
+    for (int i = 0; i < missFileNames.size(); ++i) {
+        const QString &fileName = missFileNames.at(i);
+        QFileInfo info(fileName);
+        metaJsons.insert(fileName, missMetaJsons.at(i));
+        newCache.insert(fileName, QJsonObject { { kCacheModified, static_cast<double>(info.lastModified().toMSecsSinceEpoch()) },
+                                                { kCacheSize, static_cast<double>(info.size()) },
+                                                { kCacheMeta, missMetaJsons.at(i) } });
+    }
+    if (!missFileNames.isEmpty() || newCache.size() != cache.size())
+        writeMetaCache(newCache);
+
+    qInfo() << "Scanned" << fileNames.size() << "plugin files," << missFileNames.size()
+            << "not cached, in" << timer.elapsed() << "ms";
+
+    for (const QString &fileName : fileNames) {
+        const QJsonObject &metaJson = metaJsons.value(fileName);
+        QJsonObject &&dataJson = metaJson.value("MetaData").toObject();
+        QString &&iid = metaJson.value("IID").toString();
+        if (!pluginIIDs.contains(iid))
+            continue;
+
+        bool isVirtual = dataJson.contains(kVirtualPluginMeta) && dataJson.contains(kVirtualPluginList);
+        if (isVirtual) {
+            scanfVirtualPlugin(destQueue, fileName, metaJson, blackList);
+        } else {
+            // QPluginLoader::setFileName reads the library, defer it until the plugin is loaded
+            PluginMetaObjectPointer metaObj(new PluginMetaObject);
+            metaObj->d->fileName = fileName;
+            metaObj->d->metaData = metaJson;
+            scanfRealPlugin(destQueue, metaObj, dataJson, blackList);
         }
     }
 }
@@ -172,10 +260,11 @@ void PluginManagerPrivate::scanfRealPlugin(QQueue<PluginMetaObjectPointer> *dest
 }
 
 void PluginManagerPrivate::scanfVirtualPlugin(QQueue<PluginMetaObjectPointer> *destQueue, const QString &fileName,
-                                              const QJsonObject &dataJson, const QStringList &blackList)
+                                              const QJsonObject &metaJson, const QStringList &blackList)
 {
     Q_ASSERT(destQueue);
 
+    QJsonObject &&dataJson { metaJson.value("MetaData").toObject() };
     QJsonObject &&metaDataJson { dataJson.value(kVirtualPluginMeta).toObject() };
     QString &&realName { metaDataJson.value(kPluginName).toString() };
     if (blackList.contains(realName)) {
@@ -193,7 +282,8 @@ void PluginManagerPrivate::scanfVirtualPlugin(QQueue<PluginMetaObjectPointer> *d
         }
 
         PluginMetaObjectPointer metaObj(new PluginMetaObject);
-        metaObj->d->loader->setFileName(fileName);
+        metaObj->d->fileName = fileName;
+        metaObj->d->metaData = metaJson;
         metaObj->d->isVirtual = true;
         metaObj->d->realName = realName;
         metaObj->d->name = name;
@@ -210,7 +300,10 @@ void PluginManagerPrivate::readJsonToMeta(PluginMetaObjectPointer metaObject)
 {
     metaObject->d->state = PluginMetaObject::kReading;
 
-    QJsonObject &&jsonObj = metaObject->d->loader->metaData();
+    // 扫描时已读取（或来自缓存），避免再次打开插件文件
+    QJsonObject jsonObj = metaObject->d->metaData;
+    if (jsonObj.isEmpty())
+        jsonObj = QPluginLoader(metaObject->d->fileName).metaData();
     if (jsonObj.isEmpty())
         return;
 
@@ -263,6 +356,8 @@ void PluginManagerPrivate::jsonToMeta(PluginMetaObjectPointer metaObject, const
 bool PluginManagerPrivate::loadPlugins()
 {
     qInfo() << "Start loading all plugins: ";
+    QElapsedTimer timer;
+    timer.start();
     dependsSort(&loadQueue, &notLazyLoadQuene);
 
     bool ret = true;
@@ -270,7 +365,7 @@ bool PluginManagerPrivate::loadPlugins()
         if (!PluginManagerPrivate::doLoadPlugin(pointer))
             ret = false;
     });
-    qInfo() << "End loading all plugins.";
+    qInfo() << "End loading all plugins in" << timer.elapsed() << "ms.";
 
     return ret;
 }
@@ -385,6 +480,8 @@ bool PluginManagerPrivate::doLoadPlugin(PluginMetaObjectPointer pointer)
     }
 
     pointer->d->state = PluginMetaObject::State::kLoading;
+    if (pointer->d->loader->fileName().isEmpty())
+        pointer->d->loader->setFileName(pointer->d->fileName);
 
     if (pointer->isVirtual() && loadedVirtualPlugins.contains(pointer->d->realName)) {
         auto creator = qobject_cast<PluginCreator *>(pointer->d->loader->instance());
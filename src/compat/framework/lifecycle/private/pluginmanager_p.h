@@ -64,7 +64,7 @@ public:
     static void scanfRealPlugin(QQueue<PluginMetaObjectPointer> *destQueue, PluginMetaObjectPointer metaObj,
                                 const QJsonObject &dataJson, const QStringList &blackList);
     static void scanfVirtualPlugin(QQueue<PluginMetaObjectPointer> *destQueue, const QString &fileName,
-                                   const QJsonObject &dataJson, const QStringList &blackList);
+                                   const QJsonObject &metaJson, const QStringList &blackList);
     static void readJsonToMeta(PluginMetaObjectPointer metaObject);
     static void jsonToMeta(PluginMetaObjectPointer metaObject, const QJsonObject &metaData);
     static void dependsSort(QQueue<PluginMetaObjectPointer> *dstQueue,
@@ -12,6 +12,7 @@
 #include <QString>
 #include <QStringList>
 #include <QSharedPointer>
+#include <QJsonObject>
 
 DPF_BEGIN_NAMESPACE
 
@@ -54,7 +55,9 @@ public:
     PluginMetaObject::State state { PluginMetaObject::kInvalid };
     QList<PluginDepend> depends;
     QSharedPointer<Plugin> plugin;
-    QSharedPointer<QPluginLoader> loader;
+    QSharedPointer<QPluginLoader> loader;   // its file name is set only when the plugin is loaded
+    QString fileName;
+    QJsonObject metaData;   // QPluginLoader::metaData() read by the scan, possibly from the cache
 
     explicit PluginMetaObjectPrivate(PluginMetaObject *q)
         : q(q), loader(new QPluginLoader(nullptr))
@@ -8,6 +8,7 @@
 #include <dde-cooperation-framework/dde_cooperation_framework_global.h>
 #include <dde-cooperation-framework/event/eventhelper.h>
 #include <dde-cooperation-framework/event/invokehelper.h>
+#include <dde-cooperation-framework/event/typeddispatcher.h>
 
 #include <QVariant>
 #include <QFuture>
@@ -153,6 +154,7 @@ public:
             dispatcher->append(obj, method);
             dispatcherMap.insert(type, dispatcher);
         }
+        typedTable.append(type, obj, method);
         return true;
     }
 
@@ -170,8 +172,10 @@ public:
             return false;
 
         QWriteLocker lk(&rwLock);
-        if (dispatcherMap.contains(type))
+        if (dispatcherMap.contains(type)) {
+            typedTable.remove(type, obj, method);
             return dispatcherMap[type]->remove(obj, std::move(method));
+        }
 
         return false;
     }
@@ -193,6 +197,11 @@ public:
             makeVariantList(&ret, param, std::forward<Args>(args)...);
             if (globalFiltered(type, ret))
                 return false;
+        } else {
+            // listeners taking exactly these types are called without QVariant and lock
+            auto result = typedTable.dispatch(type, param, args...);
+            if (result != TypedDispatcherTable::kUntyped)
+                return result == TypedDispatcherTable::kDispatched;
         }
 
         QReadLocker lk(&rwLock);
@@ -215,8 +224,14 @@ public:
     inline bool publish(EventType type)
     {
         threadEventAlert(type);
-        if (!globalFilterMap.isEmpty() && globalFiltered(type, QVariantList()))
-            return false;
+        if (!globalFilterMap.isEmpty()) {
+            if (globalFiltered(type, QVariantList()))
+                return false;
+        } else {
+            auto result = typedTable.dispatch(type);
+            if (result != TypedDispatcherTable::kUntyped)
+                return result == TypedDispatcherTable::kDispatched;
+        }
 
         QReadLocker lk(&rwLock);
         if (Q_LIKELY(dispatcherMap.contains(type))) {
@@ -307,6 +322,8 @@ public:
             dispatcher->appendFilter(obj, method);
             dispatcherMap.insert(type, dispatcher);
         }
+        // filters are called with the QVariant arguments
+        typedTable.setUntyped(type);
         return true;
     }
 
@@ -343,6 +360,8 @@ private:
     EventDispatcherMap dispatcherMap;
     GlobalEventFilterMap globalFilterMap;
     QReadWriteLock rwLock;
+    // lock-free mirror of dispatcherMap for the typed publish, written under rwLock
+    TypedDispatcherTable typedTable;
 };
 
 DPF_END_NAMESPACE
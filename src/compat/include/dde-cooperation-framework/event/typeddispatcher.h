@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TYPEDDISPATCHER_H
+#define TYPEDDISPATCHER_H
+
+#include <dde-cooperation-framework/dde_cooperation_framework_global.h>
+#include <dde-cooperation-framework/event/eventhelper.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+DPF_BEGIN_NAMESPACE
+
+class TypedDispatcherBase;
+using TypedDispatcherPtr = std::shared_ptr<const TypedDispatcherBase>;
+
+/*
+ * Listeners of one event, called with the published arguments as they are.
+ * A dispatcher is never changed after it is published in the table, a
+ * subscription replaces it with a modified copy (read-copy-update).
+ */
+class TypedDispatcherBase
+{
+public:
+    // signature nullptr: the event is dispatched by the QVariant path only
+    explicit TypedDispatcherBase(const std::type_info *signature = nullptr)
+        : signature(signature) {}
+    virtual ~TypedDispatcherBase() = default;
+
+    // copy without the listener of obj and func
+    virtual TypedDispatcherPtr without(QObject *obj, void *func) const
+    {
+        Q_UNUSED(obj)
+        Q_UNUSED(func)
+        return nullptr;
+    }
+
+    const std::type_info *const signature;
+};
+
+template<class... Args>
+class TypedDispatcher : public TypedDispatcherBase
+{
+public:
+    using Listener = std::function<void(const Args &...)>;
+    using HandlerList = std::vector<EventHandler<Listener>>;
+
+    TypedDispatcher()
+        : TypedDispatcherBase(&typeid(TypedDispatcher)) {}
+
+    // typeid compares equal across shared libraries, unlike the address of a static
+    static bool matches(const TypedDispatcherBase &dispatcher)
+    {
+        return dispatcher.signature && *dispatcher.signature == typeid(TypedDispatcher);
+    }
+
+    void dispatch(const Args &... args) const
+    {
+        for (const auto &h : handlerList)
+            h.handler(args...);
+    }
+
+    TypedDispatcherPtr without(QObject *obj, void *func) const override
+    {
+        auto next = std::make_shared<TypedDispatcher>(*this);
+        next->handlerList.erase(std::remove_if(next->handlerList.begin(), next->handlerList.end(),
+                                               [obj, func](const EventHandler<Listener> &h) {
+                                                   return h.objectIndex == obj && h.funcIndex == func;
+                                               }),
+                                next->handlerList.end());
+        return next;
+    }
+
+    HandlerList handlerList;
+};
+
+/*
+ * Member functions which can take the published arguments by const reference
+ */
+template<class Func>
+struct TypedMethod
+{
+    static constexpr bool kTyped = false;
+};
+
+template<class R, class T, class... Args>
+struct TypedMethod<R (T::*)(Args...)>
+{
+    template<class Arg>
+    using ByConstRef = std::integral_constant<bool, !std::is_reference<Arg>::value
+                                                            || (std::is_lvalue_reference<Arg>::value
+                                                                && std::is_const<typename std::remove_reference<Arg>::type>::value)>;
+
+    static constexpr bool kTyped = std::conjunction<ByConstRef<Args>...>::value;
+    using Dispatcher = TypedDispatcher<typename std::decay<Args>::type...>;
+
+    static typename Dispatcher::Listener bind(T *obj, R (T::*method)(Args...))
+    {
+        return [obj, method](const typename std::decay<Args>::type &... args) {
+            (obj->*method)(args...);
+        };
+    }
+};
+
+/*
+ * Typed dispatchers indexed by EventType
+ *
+ * Pages of the flat table are allocated on the first subscription in their
+ * range and live as long as the table, so publish() only does two atomic
+ * loads and takes a reference to the dispatcher, without any lock.
+ * Writers must be serialized by the caller.
+ */
+class TypedDispatcherTable
+{
+public:
+    enum DispatchResult {
+        kNoListener,   // nothing subscribed the event
+        kDispatched,   // the typed listeners were called
+        kUntyped   // use the QVariant path
+    };
+
+    TypedDispatcherTable() = default;
+    TypedDispatcherTable(const TypedDispatcherTable &) = delete;
+    TypedDispatcherTable &operator=(const TypedDispatcherTable &) = delete;
+
+    ~TypedDispatcherTable()
+    {
+        for (auto &page : pages)
+            delete page.load();
+    }
+
+    TypedDispatcherPtr load(EventType type) const
+    {
+        if (!isValidEventType(type))
+            return nullptr;
+        const Page *page = pages[type >> kPageBits].load(std::memory_order_acquire);
+        if (!page)
+            return nullptr;
+        return std::atomic_load_explicit(&page->slots[type & kPageMask], std::memory_order_acquire);
+    }
+
+    void store(EventType type, TypedDispatcherPtr dispatcher)
+    {
+        if (!isValidEventType(type))
+            return;
+        auto &slot = pages[type >> kPageBits];
+        Page *page = slot.load(std::memory_order_acquire);
+        if (!page) {
+            page = new Page;
+            slot.store(page, std::memory_order_release);
+        }
+        std::atomic_store_explicit(&page->slots[type & kPageMask], std::move(dispatcher), std::memory_order_release);
+    }
+
+    template<class T, class Func>
+    void append(EventType type, T *obj, Func method)
+    {
+        TypedDispatcherPtr current = load(type);
+        if (current && !current->signature)
+            return;
+
+        // listeners with other parameter types need the QVariant conversions
+        using Method = TypedMethod<Func>;
+        if constexpr (!Method::kTyped) {
+            setUntyped(type);
+        } else {
+            using Dispatcher = typename Method::Dispatcher;
+            if (current && !Dispatcher::matches(*current)) {
+                setUntyped(type);
+                return;
+            }
+            auto next = current ? std::make_shared<Dispatcher>(static_cast<const Dispatcher &>(*current))
+                                : std::make_shared<Dispatcher>();
+            next->handlerList.push_back(EventHandler<typename Dispatcher::Listener> { obj, memberFunctionVoidCast(method), Method::bind(obj, method) });
+            store(type, std::move(next));
+        }
+    }
+
+    template<class T, class Func>
+    void remove(EventType type, T *obj, Func method)
+    {
+        TypedDispatcherPtr current = load(type);
+        if (current && current->signature)
+            store(type, current->without(obj, memberFunctionVoidCast(method)));
+    }
+
+    // the event has filters or listeners of several signatures
+    void setUntyped(EventType type)
+    {
+        store(type, std::make_shared<TypedDispatcherBase>());
+    }
+
+    template<class... Args>
+    [[gnu::hot]] DispatchResult dispatch(EventType type, const Args &... args) const
+    {
+        TypedDispatcherPtr current = load(type);
+        if (!current)
+            return kNoListener;
+
+        using Dispatcher = TypedDispatcher<typename std::decay<Args>::type...>;
+        if (!Dispatcher::matches(*current))
+            return kUntyped;
+        static_cast<const Dispatcher &>(*current).dispatch(args...);
+        return kDispatched;
+    }
+
+private:
+    static constexpr int kPageBits = 8;
+    static constexpr int kPageMask = (1 << kPageBits) - 1;
+    static constexpr int kPageCount = (EventTypeScope::kCustomTop >> kPageBits) + 1;
+
+    struct Page
+    {
+        TypedDispatcherPtr slots[1 << kPageBits];
+    };
+
+    std::atomic<Page *> pages[kPageCount] {};
+};
+
+DPF_END_NAMESPACE
+
+#endif   // TYPEDDISPATCHER_H
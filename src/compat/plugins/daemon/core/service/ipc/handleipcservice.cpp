@@ -17,6 +17,8 @@
 #include "service/jobmanager.h"
 #include "protocol/version.h"
 
+#include "trace/metrics.h"
+
 #include <QPointer>
 #include <QCoreApplication>
 
@@ -309,6 +311,11 @@ void HandleIpcService::doAsyncSearch(const QString &targetip, const bool remove)
     DiscoveryJob::instance()->searchDeviceByIp(targetip, remove);
 }
 
+QString HandleIpcService::getMetrics()
+{
+    return QString::fromStdString(BaseKit::Metrics::GetInstance().ToJSON());
+}
+
 void HandleIpcService::appExit()
 {
     DLOG << "client ask Exit!";
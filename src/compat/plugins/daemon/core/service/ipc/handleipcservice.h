@@ -50,6 +50,9 @@ public:
 
     Q_INVOKABLE void doAsyncSearch(const QString &targetip, const bool remove);
 
+    // 传输链路耗时统计快照(JSON)
+    Q_INVOKABLE QString getMetrics();
+
     Q_INVOKABLE void appExit();
 
 signals:
@@ -17,6 +17,8 @@
 
 #include "ipc/bridge.h"
 
+#include "trace/metrics.h"
+
 #include <QPointer>
 #include <QElapsedTimer>
 #include <QStorageInfo>
@@ -162,6 +164,15 @@ void TransferJob::start()
         QStorageInfo info(_save_fulldir.c_str());
         _device_free_size = info.bytesFree();
     } else {
+        // 带宽限制由前端设置保存，发送作业开始时生效
+        auto limit = [this](const char *key) -> uint64_t {
+            return strtoull(DaemonConfig::instance()->getAppConfig(_app_name, key).c_str(), nullptr, 10);
+        };
+        auto &shaper = BaseKit::TrafficShaper::GetInstance();
+        shaper.SetLimits(limit(KEY_APP_RATE_LIMIT), limit(KEY_APP_JOB_RATE_LIMIT));
+        shaper.SetAdaptive(DaemonConfig::instance()->getAppConfig(_app_name, KEY_APP_ADAPTIVE_LIMIT) == "true");
+        _shaper.SetPeer(_tar_ip.c_str());
+
         // 读取所有文件的信息
         DLOG << "doTransfileJob path to save:" << _savedir;
         //并行读取文件数据
@@ -265,6 +276,9 @@ void TransferJob::pushQueque(const QSharedPointer<FSDataBlock> block)
     }
 
     _block_queue.enqueue(block);
+
+    static const size_t queued = BASEKIT_METRIC("job.block.queue", BaseKit::MetricKind::GAUGE);
+    BaseKit::Metrics::GetInstance().Set(queued, _block_queue.size());
 }
 
 qint64 TransferJob::freeBytes() const
@@ -660,11 +674,16 @@ bool TransferJob::writeAndCreateFile(const QSharedPointer<FSDataBlock> block, co
     //      << "  flags !!! " << block->flags;
     int count = 3;
     bool good = false;
+    BaseKit::TraceSpan span(BASEKIT_METRIC("disk.write", BaseKit::MetricKind::HISTOGRAM));
     do {
         good = FSAdapter::writeBlock(fullpath.c_str(), offset, buffer.c_str(), len, block->flags, &fx);
         count--;
     } while(!good && count > 0);
 
+    // 写盘耗时超过50ms记为一次卡顿
+    if (span.Finish() >= 50000)
+        BaseKit::Metrics::GetInstance().Add(BASEKIT_METRIC("disk.write.stalls", BaseKit::MetricKind::COUNTER));
+
 
     if (!good) {
         ELOG << "file : " << fullpath << " write BLOCK error";
@@ -695,12 +714,26 @@ bool TransferJob::sendToRemote(const QSharedPointer<FSDataBlock> block)
     QByteArray data(buffer.c_str(), static_cast<int>(block->data.empty() ? 0 : block->data_size));
     // DLOG << "( ==== " << _jobid << ") send block " << block->filename << " size: " << block->data_size
     //     << " ----- = " << queueCount() << "  flags  == " << block->flags;
+    // 限速时在此等待
+    _shaper.Consume(static_cast<uint64_t>(data.size()));
+
     SendResult res;
     // 必须等待对方回复了才执行后面的流程
     {
         res.errorType = 0;
         QMutexLocker g(&_send_mutex);
-        res = _remote->doSendProtoMsg(FS_DATA, file_block.as_json().str().c_str(), data);
+        // 单块往返耗时，含对端写盘
+        BASEKIT_TRACE_SPAN("rpc.send.block");
+        // 数据块校验失败时连接仍可用，直接重发该块
+        int count = 3;
+        do {
+            res = _remote->doSendProtoMsg(FS_DATA, file_block.as_json().str().c_str(), data);
+            if (res.errorType != INVOKE_CORRUPTED)
+                break;
+            WLOG << "block corrupted, resend: " << block->filename << " blk: " << block->blk_id;
+            BaseKit::Metrics::GetInstance().Add(BASEKIT_METRIC("rpc.block.resend", BaseKit::MetricKind::COUNTER));
+            count--;
+        } while (count > 0);
     }
     co::Json resJson;
     if (res.protocolType == FS_DATA && resJson.parse_from(res.data)) {
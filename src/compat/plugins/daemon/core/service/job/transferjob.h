@@ -17,6 +17,8 @@
 #include <QMutex>
 #include <QReadWriteLock>
 
+#include "algorithms/traffic_shaper.h"
+
 class RemoteServiceSender;
 class TransferJob : public QObject
 {
@@ -114,6 +116,7 @@ private:
     QReadWriteLock _file_name_maps_lock;
     QMap<fastring, fastring> _file_name_maps;
     QMutex _send_mutex;
+    BaseKit::TrafficShaper::Job _shaper; // 发送带宽限制
     fs::file *fx{ nullptr };
 };
 
@@ -122,6 +122,15 @@ SendResult RemoteServiceSender::doSendProtoMsg(const uint32 type, const QString
     wg.wait();
 #endif
 
+    if (rpc_controller->Corrupted()) {
+        // 数据包在传输中损坏，连接仍可用，由调用方重发
+        res.errorType = INVOKE_CORRUPTED;
+        ELOG << "Package corrupted, error info: " << rpc_controller->ErrorText();
+        rpc_controller->SetError(0, "");
+        res.data = _target_ip.toStdString();
+        return res;
+    }
+
     if (rpc_controller->ErrorCode() != 0) {
         res.errorType = INVOKE_FAIL;
         ELOG << "Failed to call server, error code: " << rpc_controller->ErrorCode()
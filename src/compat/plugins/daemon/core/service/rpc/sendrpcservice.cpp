@@ -15,6 +15,9 @@
 #include "common/commonstruct.h"
 #include "service/discoveryjob.h"
 
+#include "algorithms/traffic_shaper.h"
+#include "time/timestamp.h"
+
 #include <QCoreApplication>
 
 SendRpcWork::~SendRpcWork()
@@ -113,6 +116,7 @@ void SendRpcWork::handlePing(const QStringList apps)
         ping.tarAppname = sender->targetAppname().toStdString();
         ping.ip = Util::getFirstIp();
 
+        uint64_t start = BaseKit::Timestamp::nano();
         SendResult rs = sender->doSendProtoMsg(RPC_PING, ping.as_json().str().c_str(), QByteArray());
         if (rs.data.empty() || rs.errorType < INVOKE_OK) {
             DLOG << "remote server no reply ping !!!!! " << appName.toStdString();
@@ -127,6 +131,10 @@ void SendRpcWork::handlePing(const QStringList apps)
                 _ping_failed_count.insert(appName, ++count);
             }
         } else {
+            // ping往返时间用于传输带宽自适应
+            BaseKit::TrafficShaper::GetInstance().ReportRtt(sender->remoteIP().toStdString(),
+                                                            (BaseKit::Timestamp::nano() - start) / 1000);
+
             // 取消离线预处理消息
             SendIpcService::instance()->cancelOfflineStatus(appName);
             _ping_failed_count.remove(appName);
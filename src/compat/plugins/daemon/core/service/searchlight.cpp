@@ -14,6 +14,14 @@
 #include "ipc/proto/comstruct.h"
 #include "jobmanager.h"
 
+#include <algorithm>
+
+#ifdef _WIN32
+#    include <winsock2.h>
+#else
+#    include <poll.h>
+#endif
+
 //DEF_int32(max_idle, 3000, "max_idle");
 DEF_string(udp_ip, "0.0.0.0", "udp_ip");
 DEF_int32(udp_port, 30001, "udp_port");
@@ -22,6 +30,81 @@ DEF_string(mcast_ip, "239.255.0.1", "mcast_ip");
 static QMutex _search_ip_lock;
 static QStringList filter;
 static std::atomic_bool _send_tcp { false };
+// known nodes that cannot read a heartbeat, full announcements only while none is left
+static std::atomic_int _legacy_peers { 0 };
+
+namespace {
+
+// Between two full announcements a node only sends a heartbeat:
+// magic, format version and the generation of its info (big endian).
+// 0xff never starts a json text, older peers just ignore it.
+const char kHeartbeatMagic[] = "\xffSLH";
+const size_t kHeartbeatMagicSize = 4;
+const char kHeartbeatVersion = 1;
+const size_t kHeartbeatSize = kHeartbeatMagicSize + 1 + 8;
+
+// Announce the full info at least every 2s, a node that just came up
+// only learns who sends a heartbeat from it. Older peers drop a node
+// after 3s without a full announcement, so it is sent every second
+// while any of them is around.
+const int kFullAnnounceTicks = 2;
+
+// The generation follows name and port in a full announcement
+const char kGenerationKey[] = ",\"gen\":";
+const size_t kGenerationWindow = 64;
+
+// Milliseconds the local address is cached by the discoverer
+const int64_t kSelfIpRefresh = 1000;
+
+// Milliseconds without announcement before a node is offline
+const int64_t kMaxIdle = 3000;
+// Longest wait of the receive loop, one announce interval
+const int kMaxWait = 1000;
+
+// Wait until fd is readable, hooked by co inside a coroutine
+bool waitReadable(sock_t fd, int ms)
+{
+    pollfd pfd = { fd, POLLIN, 0 };
+#ifdef _WIN32
+    return WSAPoll(&pfd, 1, ms) > 0;
+#else
+    return ::poll(&pfd, 1, ms) > 0;
+#endif
+}
+
+bool isHeartbeat(const fastring &message)
+{
+    return message.size() == kHeartbeatSize
+            && message.starts_with(kHeartbeatMagic, kHeartbeatMagicSize)
+            && message[kHeartbeatMagicSize] == kHeartbeatVersion;
+}
+
+uint64_t heartbeatGeneration(const fastring &message)
+{
+    uint64_t generation = 0;
+    for (size_t i = kHeartbeatMagicSize + 1; i < kHeartbeatSize; ++i)
+        generation = (generation << 8) | static_cast<uchar>(message[i]);
+    return generation;
+}
+
+// Generation of a full announcement without parsing it, 0 if it has none
+uint64_t peekGeneration(const fastring &message)
+{
+    size_t pos = message.find(kGenerationKey);
+    if (pos == fastring::npos || pos > kGenerationWindow)
+        return 0;
+
+    uint64_t generation = 0;
+    for (pos += sizeof(kGenerationKey) - 1; pos < message.size(); ++pos) {
+        char c = message[pos];
+        if (c < '0' || c > '9')
+            break;
+        generation = generation * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return generation;
+}
+
+} // namespace
 
 namespace searchlight {
 
@@ -43,6 +126,9 @@ Discoverer::~Discoverer()
     {
         QWriteLocker lk(&_discovered_lock);
         _discovered_services.clear();
+        _expiry_order.clear();
+        _expiry_pos.clear();
+        _legacy_peers = 0;
     }
 }
 
@@ -85,43 +171,35 @@ recheck:
     }
 
     struct sockaddr_in cli;
-    int len = sizeof(cli);
     char buffer[1024];
 
     _stop = false;
 
     _timer.restart();
-    // 定时更新发现设备
-    QUNIGO([this](){
-        while (!_stop) {
-            sleep::ms(1000); //co::sleep(1000);
-            remove_idle_services();
-            // callback discovery changed
-            QList<service> _changed;
-            {
-                QReadLocker lk(&_discovered_lock);
-                _changed = _change_sevices;
-                _change_sevices.clear();
-            }
-            if (_changed.isEmpty())
-                continue;
-            _on_services_changed(_changed);
-        }
-    });
+    {
+        QMutexLocker lk(&_self_ip_lock);
+        _self_ip_time = -1;
+    }
 
     LOG << "discoverer server start";
-    // 接收组播数据包
+    // 接收组播数据包，没有数据时等到下一个节点过期
     while (!_stop) {
-        memset(buffer, 0, sizeof(buffer));
-        int recv_len = co::recvfrom(sockfd, buffer, sizeof(buffer), &cli, &len);
-        if (recv_len < 0) {
-            // LOG << "discoverer server recvfrom error: " << co::strerror();
-            co::sleep(100);
-            continue;
+        if (waitReadable(sockfd, next_expiry())) {
+            int len = sizeof(cli);
+            int recv_len = co::recvfrom(sockfd, buffer, sizeof(buffer), &cli, &len);
+            if (recv_len < 0) {
+                // LOG << "discoverer server recvfrom error: " << co::strerror();
+                co::sleep(100);
+                continue;
+            }
+
+            fastring msg(buffer, static_cast<size_t>(recv_len));
+            handle_message(msg, co::addr2str(&cli));
         }
 
-        fastring msg(buffer, static_cast<size_t>(recv_len));
-        handle_message(msg, co::addr2str(&cli));
+        remove_idle_services();
+        // callback discovery changed
+        flushChanges();
     }
 
     // 关闭套接字
@@ -154,6 +232,18 @@ void Discoverer::handle_message(const fastring& message, const fastring& sender_
 {
     // 处理接收到的数据
     // LOG << "server recv ==== " << message << " from " << sender_endpoint;
+    QString endpoint(sender_endpoint.c_str());
+    endpoint = endpoint.left(endpoint.indexOf(":"));
+
+    // 信息未改变的节点只需刷新时间，不再解析
+    if (isHeartbeat(message)) {
+        touchService(endpoint, heartbeatGeneration(message), isFilter);
+        return;
+    }
+    uint64_t generation = peekGeneration(message);
+    if (generation != 0 && touchService(endpoint, generation, isFilter))
+        return;
+
     co::Json node;
     if (!node.parse_from(message)) {
         DLOG << "Invalid service, ignore!!!!!";
@@ -164,13 +254,10 @@ void Discoverer::handle_message(const fastring& message, const fastring& sender_
     fastring info = node.get("info").as_string();
     QString  ip = node.get("info","os","ipv4").as_string().c_str();
 
-
-    QString endpoint(sender_endpoint.c_str());
-    endpoint = endpoint.left(endpoint.indexOf(":"));
     // 判断同网段
     auto preHost = ip.lastIndexOf(".") > ip.size()
             ? ip : ip.mid(0, ip.lastIndexOf("."));
-    fastring self_ip = Util::getFirstIp();
+    fastring self_ip = selfIp();
     bool filterContain { false };
     QStringList filters;
     {
@@ -182,7 +269,7 @@ void Discoverer::handle_message(const fastring& message, const fastring& sender_
     if (message.starts_with(_listen_for_service) && ip != QString(self_ip.c_str())
             && (filterContain || !isFilter || QString(self_ip.c_str()).startsWith(preHost))) {
         // 找到最近的时间修改，只发送改变了的
-        handleChanges(endpoint, info, _timer.ms());
+        handleChanges(endpoint, info, _timer.ms(), generation);
     } else {
         auto discovered_service = service
             {
@@ -198,28 +285,125 @@ void Discoverer::handle_message(const fastring& message, const fastring& sender_
 
 bool Discoverer::remove_idle_services()
 {
-    auto dead_line = _timer.ms() - 3000;//FLG_max_idle;
+    auto dead_line = _timer.ms() - kMaxIdle;
     bool removed = false;
 
     QWriteLocker lk(&_discovered_lock);
-    for (auto i = _discovered_services.begin(); i != _discovered_services.end();)
-    {
-        if (i.value()->last_seen < dead_line) {
-            service t(*(i.value()));
-            i = _discovered_services.erase(i);
+    // 只检查已到期的节点
+    while (!_expiry_order.empty()) {
+        QString endpoint = _expiry_order.front();
+        auto _ser = _discovered_services.value(endpoint);
+        if (!_ser.isNull()) {
+            if (_ser->last_seen >= dead_line)
+                break;
+            service t(*_ser);
             t.flags = 1;
-            _change_sevices.removeOne(t);
-            _change_sevices.append(t);
+            addChange(endpoint, t);
+            if (_ser->legacy)
+                --_legacy_peers;
+            _discovered_services.remove(endpoint);
             removed = true;
-        } else {
-            ++i;
         }
+        _expiry_pos.remove(endpoint);
+        _expiry_order.pop_front();
     }
 
     return removed;
 }
 
-void Discoverer::handleChanges(const QString &endpoint, const fastring &info, const qint64 time)
+int Discoverer::next_expiry()
+{
+    QReadLocker lk(&_discovered_lock);
+    if (!_change_sevices.isEmpty())
+        return 0;
+    if (_expiry_order.empty())
+        return kMaxWait;
+
+    auto _ser = _discovered_services.value(_expiry_order.front());
+    if (_ser.isNull())
+        return 0;
+    auto wait = _ser->last_seen + kMaxIdle - _timer.ms() + 1;
+    return static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait, kMaxWait)));
+}
+
+void Discoverer::touch(const QString &endpoint)
+{
+    // last_seen only grows, so the order stays sorted
+    auto it = _expiry_pos.find(endpoint);
+    if (it != _expiry_pos.end()) {
+        _expiry_order.splice(_expiry_order.end(), _expiry_order, it.value());
+        return;
+    }
+    _expiry_pos.insert(endpoint, _expiry_order.insert(_expiry_order.end(), endpoint));
+}
+
+void Discoverer::addChange(const QString &endpoint, const service &changed)
+{
+    auto it = _change_sevices.find(endpoint);
+    if (it != _change_sevices.end() && it->flags == 0) {
+        // 上线还未通知
+        if (changed.flags == 1)
+            _change_sevices.erase(it);
+        else
+            it->info = changed.info;
+        return;
+    }
+    _change_sevices.insert(endpoint, changed);
+}
+
+void Discoverer::flushChanges()
+{
+    QList<service> changed;
+    {
+        QWriteLocker lk(&_discovered_lock);
+        if (_change_sevices.isEmpty())
+            return;
+        changed = _change_sevices.values();
+        _change_sevices.clear();
+    }
+    _on_services_changed(changed);
+}
+
+bool Discoverer::touchService(const QString &endpoint, const uint64_t generation, const bool isFilter)
+{
+    {
+        QWriteLocker lk(&_discovered_lock);
+        auto _ser = _discovered_services.value(endpoint);
+        if (_ser.isNull() || _ser->generation == 0 || _ser->generation != generation)
+            return false;
+        _ser->last_seen = _timer.ms();
+        touch(endpoint);
+    }
+
+    if (isFilter) {
+        QMutexLocker lk(&_search_ip_lock);
+        if (filter.contains(endpoint))
+            _send_tcp = false;
+    }
+    return true;
+}
+
+fastring Discoverer::selfIp()
+{
+    QMutexLocker lk(&_self_ip_lock);
+    int64_t now = _timer.ms();
+    if (_self_ip_time >= 0 && now - _self_ip_time < kSelfIpRefresh)
+        return _self_ip;
+
+    fastring ip = Util::getFirstIp();
+    _self_ip_time = now;
+    if (ip.compare(_self_ip) != 0) {
+        _self_ip = ip;
+        // 本机地址改变后，已知节点需要重新过滤
+        QWriteLocker dlk(&_discovered_lock);
+        for (auto &ser : _discovered_services)
+            ser->generation = 0;
+    }
+    return _self_ip;
+}
+
+void Discoverer::handleChanges(const QString &endpoint, const fastring &info, const qint64 time,
+                               const uint64_t generation)
 {
     if (endpoint.isEmpty()) {
         ELOG << " ip is null !!!!! endpoint = " << endpoint.toStdString() << " info = " << info;
@@ -236,18 +420,28 @@ void Discoverer::handleChanges(const QString &endpoint, const fastring &info, co
                 info,
                 0,
                 _timer.ms(),
+                generation,
             };
+        discovered_service.legacy = generation == 0;
+        if (discovered_service.legacy)
+            ++_legacy_peers;
         _discovered_services.insert(endpoint, QSharedPointer<service>(new service(discovered_service)));
-        _change_sevices.append(discovered_service);
+        touch(endpoint);
+        addChange(endpoint, discovered_service);
         return;
     }
     _ser->last_seen = time;
+    _ser->generation = generation;
+    if (_ser->legacy != (generation == 0)) {
+        _ser->legacy = generation == 0;
+        _legacy_peers += _ser->legacy ? 1 : -1;
+    }
+    touch(endpoint);
     if (_ser->info.compare(info) != 0) {
         _ser->info = info;
         service t(*_ser);
         t.flags = 2;
-        _change_sevices.removeOne(t);
-        _change_sevices.append(t);
+        addChange(endpoint, t);
     }
 }
 
@@ -270,35 +464,46 @@ Announcer::~Announcer()
 
 void Announcer::updateBase(const fastring &info)
 {
+    QMutexLocker lk(&_package_lock);
+    if (_base_info.compare(info) == 0)
+        return;
     _base_info = info;
+    _package_dirty = true;
 }
 
 fastring Announcer::baseInfo() const
 {
+    QMutexLocker lk(&_package_lock);
     return _base_info;
 }
 
 void Announcer::appendApp(const fastring &info)
 {
+    QMutexLocker lk(&_package_lock);
     int idx = sameApp(info);
     if (idx >= 0) {
         //remove old one
         _app_infos.remove(idx);
     }
     _app_infos.push_back(info);
+    _package_dirty = true;
 }
 
 void Announcer::removeApp(const fastring &info)
 {
+    QMutexLocker lk(&_package_lock);
     int idx = sameApp(info);
     if (idx >= 0) {
         //remove find one
         _app_infos.remove(idx);
+        _package_dirty = true;
     }
 }
 
 void Announcer::removeAppbyName(const fastring &name)
 {
+    QMutexLocker lk(&_package_lock);
+    _package_dirty = true;
     for (size_t i = 0; i < _app_infos.size(); ++i) {
         co::Json oajson;
         if (!oajson.parse_from(_app_infos[i])) {
@@ -345,11 +550,27 @@ void Announcer::start(handleTcpDiscover handle)
     LOG << "announcer server start";
     // 发送数据包 int sendto(sock_t fd, const void* buf, int n, const void* dst_addr, int addrlen, int ms=-1);
     while (!_stop) {
-        fastring message = udpSendPackage();
+        fastring ip = Util::getFirstIp();
+        fastring message;
+        {
+            QMutexLocker lk(&_package_lock);
+            setSelfIp(ip);
+            if (_package_dirty)
+                buildPackage();
+
+            // 信息改变或到期时发送完整广播，其余时间只发送心跳
+            bool full = _sent_generation != _generation || _legacy_peers > 0
+                    || ++_ticks >= kFullAnnounceTicks;
+            if (full) {
+                _sent_generation = _generation;
+                _ticks = 0;
+            }
+            message = full ? _package : _heartbeat;
+        }
 
         // DLOG << "UDP send: === " << message;
         int send_len = co::sendto(sockfd, message.c_str(), static_cast<int>(message.size()), &dest_addr, len);
-        if (send_len < 0 || Util::getFirstIp() == "")
+        if (send_len < 0 || ip.empty())
             ELOG << "Failed to send data";
 
         co::sleep(1000); // announcer every second
@@ -378,33 +599,36 @@ void Announcer::exit()
 
 fastring Announcer::udpSendPackage()
 {
-    co::Json node;
-    node.add_member("name", _service_name);
-    node.add_member("port", _service_port);
-    co::Json baseJson;
-    baseJson.parse_from(_base_info);
-    //NodeInfo
-    co::Json nodeinfo;
-    NodePeerInfo nodepeer;
-    nodepeer.from_json(baseJson);
-    nodepeer.ipv4 = Util::getFirstIp();
-    nodeinfo.add_member("os", nodepeer.as_json());
-    co::Json appinfos;
-    for (size_t i = 0; i < _app_infos.size(); ++i) {
-        co::Json appjson;
-        if (appjson.parse_from(_app_infos[i])) {
-            appinfos.push_back(appjson);
-        }
-    }
-    nodeinfo.add_member("apps", appinfos);
-
-    // update the last info
-    node.remove("info");
-    node.add_member("info", nodeinfo);
-    return node.str();
+    // the announce loop keeps the address up to date while it runs
+    fastring ip = _stop ? Util::getFirstIp() : fastring();
+    QMutexLocker lk(&_package_lock);
+    if (_stop)
+        setSelfIp(ip);
+    if (_package_dirty)
+        buildPackage();
+    return _package;
 }
 
 fastring Announcer::nodeInfoStr()
+{
+    fastring ip = _stop ? Util::getFirstIp() : fastring();
+    QMutexLocker lk(&_package_lock);
+    if (_stop)
+        setSelfIp(ip);
+    if (_package_dirty)
+        buildPackage();
+    return _node_info;
+}
+
+void Announcer::setSelfIp(const fastring &ip)
+{
+    if (ip.compare(_self_ip) == 0)
+        return;
+    _self_ip = ip;
+    _package_dirty = true;
+}
+
+void Announcer::buildPackage()
 {
     co::Json baseJson;
     baseJson.parse_from(_base_info);
@@ -412,7 +636,7 @@ fastring Announcer::nodeInfoStr()
     co::Json nodeinfo;
     NodePeerInfo nodepeer;
     nodepeer.from_json(baseJson);
-    nodepeer.ipv4 = Util::getFirstIp();
+    nodepeer.ipv4 = _self_ip;
     nodeinfo.add_member("os", nodepeer.as_json());
     co::Json appinfos;
     for (size_t i = 0; i < _app_infos.size(); ++i) {
@@ -422,8 +646,25 @@ fastring Announcer::nodeInfoStr()
         }
     }
     nodeinfo.add_member("apps", appinfos);
+    _node_info = nodeinfo.str();
+
+    // 以启动时间为起点，重启后的版本号也不会与旧的重复
+    _generation = std::max<uint64_t>(_generation + 1, static_cast<uint64_t>(epoch::ms()));
+
+    co::Json node;
+    node.add_member("name", _service_name);
+    node.add_member("port", _service_port);
+    node.add_member("gen", static_cast<int64>(_generation));
+    node.add_member("info", nodeinfo);
+    _package = node.str();
+
+    _heartbeat.clear();
+    _heartbeat.append(kHeartbeatMagic, kHeartbeatMagicSize);
+    _heartbeat.append(kHeartbeatVersion);
+    for (int shift = 56; shift >= 0; shift -= 8)
+        _heartbeat.append(static_cast<char>((_generation >> shift) & 0xff));
 
-    return nodeinfo.str();
+    _package_dirty = false;
 }
 
 int Announcer::sameApp(const fastring &info)
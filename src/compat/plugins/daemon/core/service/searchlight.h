@@ -5,6 +5,7 @@
 #pragma once
 
 #include <QReadWriteLock>
+#include <QHash>
 #include <QMap>
 #include <QSharedPointer>
 #include <QMutex>
@@ -13,6 +14,7 @@
 #include <co/stl.h>
 #include <memory>
 #include <functional>
+#include <list>
 
 namespace searchlight {
 
@@ -35,6 +37,8 @@ public:
         fastring info; //json 格式的服务节点信息
         qint8 flags; // 0是服务器上线，1服务器下线，2信息改变
         int64_t last_seen; //last see time
+        uint64_t generation = 0; // 信息版本，0 表示未知
+        bool legacy = false; // 旧版本节点，广播中没有信息版本
 
         bool operator<(const service& o) const
         {
@@ -84,7 +88,16 @@ public:
 
 private:
     bool remove_idle_services();
-    void handleChanges(const QString &endpoint, const fastring &info, const qint64 time);
+    // milliseconds until the first node expires
+    int next_expiry();
+    void touch(const QString &endpoint);
+    void addChange(const QString &endpoint, const service &changed);
+    void flushChanges();
+    void handleChanges(const QString &endpoint, const fastring &info, const qint64 time,
+                       const uint64_t generation);
+    // mark a known node with an unchanged generation as seen
+    bool touchService(const QString &endpoint, const uint64_t generation, const bool isFilter);
+    fastring selfIp();
 
     bool _stop = true;
 
@@ -94,7 +107,16 @@ private:
 
     QReadWriteLock _discovered_lock;
     services _discovered_services;
-    QList<service> _change_sevices;
+    // endpoints ordered by last_seen, nodes expire from the front
+    std::list<QString> _expiry_order;
+    QHash<QString, std::list<QString>::iterator> _expiry_pos;
+    // latest change of each endpoint since the last callback
+    QHash<QString, service> _change_sevices;
+
+    // cached local address, enumerating the interfaces is too slow for every packet
+    QMutex _self_ip_lock;
+    fastring _self_ip;
+    int64_t _self_ip_time = -1;
 
     DISALLOW_COPY_AND_ASSIGN(Discoverer);
 };
@@ -139,6 +161,8 @@ public:
 
 private:
     int sameApp(const fastring &info);
+    void setSelfIp(const fastring &ip);
+    void buildPackage();
 
 private:
     bool _stop = true;
@@ -147,8 +171,20 @@ private:
     const fastring _service_name;
     const uint16_t _service_port;
 
+    // info and the announcements built from it, guarded by _package_lock
+    mutable QMutex _package_lock;
     fastring _base_info;
     co::vector<fastring> _app_infos;
+    fastring _self_ip;
+
+    // rebuilt only when the info or the local address changes
+    bool _package_dirty = true;
+    uint64_t _generation = 0;
+    uint64_t _sent_generation = 0;
+    int _ticks = 0;
+    fastring _package;
+    fastring _node_info;
+    fastring _heartbeat;
 
     DISALLOW_COPY_AND_ASSIGN(Announcer);
 };
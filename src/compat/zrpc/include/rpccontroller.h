@@ -44,6 +44,9 @@ public:
 
     int ErrorCode() const;
 
+    // the package was damaged on the way (checksum mismatch), it can be sent again
+    bool Corrupted() const;
+
     void SetErrorCode(const int error_code);
 
     const std::string &MsgSeq() const;
@@ -0,0 +1,32 @@
+﻿// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ZRPC_CRC32C_H
+#define ZRPC_CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace zrpc_ns {
+
+// CRC32C (Castagnoli) of the package. It uses the SSE4.2 crc32 instruction on
+// x86-64 or the ARMv8 CRC extension when the cpu has it, otherwise a
+// slicing-by-8 table.
+class Crc32C {
+public:
+    // checksum of the whole buffer
+    static uint32_t checksum(const void *data, size_t len) {
+        return ~extend(~0u, data, len);
+    }
+
+    // continue the raw (not finalized) crc with more data
+    static uint32_t extend(uint32_t crc, const void *data, size_t len);
+
+    // true if the hardware instruction is used
+    static bool hardware();
+};
+
+} // namespace zrpc_ns
+
+#endif
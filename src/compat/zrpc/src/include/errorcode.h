@@ -34,6 +34,8 @@ const int ERROR_NOT_SET_ASYNC_PRE_CALL = SYS_ERROR_PREFIX(
     0011); // you didn't set some nessary param before call async rpc
 const int ERROR_CONNECT_SYS_ERR = SYS_ERROR_PREFIX(0012); // connect sys error
 
+const int ERROR_FAILED_CHECKSUM = SYS_ERROR_PREFIX(0013); // package checksum mismatch, resend it
+
 } // namespace zrpc_ns
 
 #endif
@@ -25,6 +25,11 @@ public:
     void decode(TcpBuffer *buf, AbstractData *data);
 
     const char *encodePbData(SpecDataStruct *data, uint32_t &len);
+
+private:
+    bool verifyChecksum(const char *pkg, uint32_t pk_len, int32_t check_num);
+
+    bool decodeFields(const char *pkg, uint32_t pk_len, SpecDataStruct *pb_struct);
 };
 
 } // namespace zrpc_ns
@@ -4,13 +4,14 @@
 
 //#include <unistd.h>
 #include <string.h>
+#include <algorithm>
 #include "tcpbuffer.h"
 #include "co/log.h"
 
 namespace zrpc_ns {
 
 TcpBuffer::TcpBuffer(int size) {
-    m_buffer.resize(size);
+    m_buffer.resize(static_cast<size_t>(std::max(size, 1)));
 }
 
 TcpBuffer::~TcpBuffer() {
@@ -18,12 +19,12 @@ TcpBuffer::~TcpBuffer() {
 
 int TcpBuffer::readAble() {
 
-    return m_write_index - m_read_index;
+    return m_size;
 }
 
 int TcpBuffer::writeAble() {
 
-    return m_buffer.size() - m_write_index;
+    return getSize() - m_size;
 }
 
 int TcpBuffer::readIndex() const {
@@ -34,24 +35,61 @@ int TcpBuffer::writeIndex() const {
     return m_write_index;
 }
 
+const char *TcpBuffer::readSpan(int *len) {
+    // data is [read, write) or [read, end) + [0, write) when wrapped
+    *len = std::min(m_size, getSize() - m_read_index);
+    return &m_buffer[static_cast<size_t>(m_read_index)];
+}
+
+char *TcpBuffer::writeSpan(int *len) {
+    *len = std::min(writeAble(), getSize() - m_write_index);
+    return &m_buffer[static_cast<size_t>(m_write_index)];
+}
+
+const char *TcpBuffer::peek(int size) {
+    if (size > m_size) {
+        return nullptr;
+    }
+    if (m_read_index + size > getSize()) {
+        // the package crosses the end of storage, rotate it in place
+        std::rotate(m_buffer.begin(), m_buffer.begin() + m_read_index, m_buffer.end());
+        m_read_index = 0;
+        m_write_index = m_size % getSize();
+    }
+    return &m_buffer[static_cast<size_t>(m_read_index)];
+}
+
+void TcpBuffer::copyOut(char *dst, int size) const {
+    int first = std::min(size, static_cast<int>(m_buffer.size()) - m_read_index);
+    memcpy(dst, &m_buffer[static_cast<size_t>(m_read_index)], static_cast<size_t>(first));
+    if (size > first) {
+        memcpy(dst + first, &m_buffer[0], static_cast<size_t>(size - first));
+    }
+}
+
 void TcpBuffer::resizeBuffer(int size) {
-    std::vector<char> tmp(size);
-    int c = std::min(size, readAble());
-    if(m_buffer.size() > m_read_index)
-        memcpy(&tmp[0], &m_buffer[m_read_index], c);
+    if (size <= getSize()) {
+        return;
+    }
+    std::vector<char> tmp(static_cast<size_t>(size));
+    if (m_size > 0)
+        copyOut(&tmp[0], m_size);
 
     m_buffer.swap(tmp);
     m_read_index = 0;
-    m_write_index = m_read_index + c;
+    m_write_index = m_size % getSize();
 }
 
 void TcpBuffer::writeToBuffer(const char *buf, int size) {
     if (size > writeAble()) {
-        int new_size = (int)(1.5 * (m_write_index + size));
-        resizeBuffer(new_size);
+        resizeBuffer(std::max(2 * getSize(), m_size + size));
     }
-    memcpy(&m_buffer[m_write_index], buf, size);
-    m_write_index += size;
+    int first = std::min(size, getSize() - m_write_index);
+    memcpy(&m_buffer[static_cast<size_t>(m_write_index)], buf, static_cast<size_t>(first));
+    if (size > first) {
+        memcpy(&m_buffer[0], buf + first, static_cast<size_t>(size - first));
+    }
+    recycleWrite(size);
 }
 
 void TcpBuffer::readFromBuffer(std::vector<char> &re, int size) {
@@ -60,69 +98,51 @@ void TcpBuffer::readFromBuffer(std::vector<char> &re, int size) {
         return;
     }
     int read_size = readAble() > size ? size : readAble();
-    std::vector<char> tmp(read_size);
-
-    // std::copy(m_read_index, m_read_index + read_size, tmp);
-    memcpy(&tmp[0], &m_buffer[m_read_index], read_size);
-    re.swap(tmp);
-    m_read_index += read_size;
-    adjustBuffer();
-}
-
-void TcpBuffer::adjustBuffer() {
-    if (m_read_index > static_cast<int>(m_buffer.size() / 3)) {
-
-        std::vector<char> new_buffer(m_buffer.size());
-
-        int count = readAble();
-        // std::copy(&m_buffer[m_read_index], readAble(), &new_buffer);
-        memcpy(&new_buffer[0], &m_buffer[m_read_index], count);
-
-        m_buffer.swap(new_buffer);
-        m_write_index = count;
-        m_read_index = 0;
-        new_buffer.clear();
-    }
+    re.resize(static_cast<size_t>(read_size));
+    copyOut(&re[0], read_size);
+    recycleRead(read_size);
 }
 
 int TcpBuffer::getSize() {
-    return m_buffer.size();
+    return static_cast<int>(m_buffer.size());
 }
 
 void TcpBuffer::clearBuffer() {
-    m_buffer.clear();
+    // keep the storage, the connection reuses it for the next packages
     m_read_index = 0;
     m_write_index = 0;
+    m_size = 0;
 }
 
 void TcpBuffer::recycleRead(int index) {
-    int j = m_read_index + index;
-    if (j > (int)m_buffer.size()) {
+    if (index < 0 || index > m_size) {
         ELOG << "recycleRead error";
         return;
     }
-    m_read_index = j;
-    adjustBuffer();
+    m_size -= index;
+    if (m_size == 0) {
+        // rewind while empty, so the next package rarely wraps around
+        m_read_index = 0;
+        m_write_index = 0;
+        return;
+    }
+    m_read_index = (m_read_index + index) % getSize();
 }
 
 void TcpBuffer::recycleWrite(int index) {
-    int j = m_write_index + index;
-    if (j > (int)m_buffer.size()) {
-        ELOG << "recycleWrite error, j=" << j;
+    if (index < 0 || index > writeAble()) {
+        ELOG << "recycleWrite error, j=" << m_write_index + index;
         return;
     }
-    m_write_index = j;
-    adjustBuffer();
+    m_size += index;
+    m_write_index = (m_write_index + index) % getSize();
 }
 
 std::string TcpBuffer::getBufferString() {
     std::string re(static_cast<size_t>(readAble()), '0');
-    memcpy(&re[0], &m_buffer[static_cast<size_t>(m_read_index)], static_cast<size_t>(readAble()));
+    if (!re.empty())
+        copyOut(&re[0], readAble());
     return re;
 }
 
-std::vector<char> TcpBuffer::getBufferVector() {
-    return m_buffer;
-}
-
 } // namespace zrpc_ns
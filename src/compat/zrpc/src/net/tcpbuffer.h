@@ -12,6 +12,10 @@
 
 namespace zrpc_ns {
 
+// Ring buffer of the connection. The readable data may wrap around the end of
+// the storage, so it is exposed as (at most) two contiguous spans. The storage
+// only grows when a single package is larger than it, the steady state
+// read/write path never allocates or moves memory.
 class TcpBuffer {
 
 public:
@@ -29,36 +33,39 @@ public:
 
     int writeIndex() const;
 
-    // int readFormSocket(char* buf, int size);
+    // contiguous readable span starting at read index, len is the span length
+    const char *readSpan(int *len);
+
+    // contiguous writable span starting at write index, len is the span length
+    char *writeSpan(int *len);
+
+    // make the first size readable bytes contiguous, nullptr if not enough data
+    const char *peek(int size);
 
     void writeToBuffer(const char *buf, int size);
 
     void readFromBuffer(std::vector<char> &re, int size);
 
+    // grow the storage to hold at least size bytes, never shrink
     void resizeBuffer(int size);
 
     void clearBuffer();
 
     int getSize();
 
-    // const char* getBuffer();
-
-    std::vector<char> getBufferVector();
-
     std::string getBufferString();
 
     void recycleRead(int index);
 
     void recycleWrite(int index);
 
-    void adjustBuffer();
-
 private:
+    void copyOut(char *dst, int size) const;
+
     int m_read_index{0};
     int m_write_index{0};
-    int m_size{0};
+    int m_size{0};   // readable bytes
 
-public:
     std::vector<char> m_buffer;
 };
 
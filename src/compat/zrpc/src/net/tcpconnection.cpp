@@ -8,10 +8,17 @@
 #include "tcpclient.h"
 #include "specodec.h"
 #include "specdata.h"
+#include "errorcode.h"
 #include "co/co.h"
 
 #include "co/time.h"
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
 namespace zrpc_ns {
 
 TcpConnection::TcpConnection(TcpServer *tcp_svr,
@@ -120,6 +127,27 @@ int64 TcpConnection::read_hook(char *buf, int len)
     return r;
 }
 
+bool TcpConnection::readPending()
+{
+    int fd = -1;
+    if (m_connection_type == ServerConnection && m_serv_conn) {
+        fd = m_serv_conn->socket();
+    } else if (m_connection_type == ClientConnection && m_cli_conn) {
+        fd = m_cli_conn->socket();
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+    // zero timeout, never waits
+    pollfd pfd = { static_cast<sock_t>(fd), POLLIN, 0 };
+#ifdef _WIN32
+    return WSAPoll(&pfd, 1, 0) > 0;
+#else
+    return ::poll(&pfd, 1, 0) > 0;
+#endif
+}
+
 int64 TcpConnection::write_hook(const void *buf, int count)
 {
     int64 r = 0;
@@ -178,22 +206,23 @@ bool TcpConnection::input()
             m_read_buffer->resizeBuffer(m_read_buffer->getSize() + PERPKG_MAX_LEN);
         }
 
-        int read_count = m_read_buffer->writeAble();
-        int write_index = m_read_buffer->writeIndex();
+        // receive straight into the free span of the ring, it wraps on the next loop
+        int read_count = 0;
+        char *span = m_read_buffer->writeSpan(&read_count);
         if (read_count > PERPKG_MAX_LEN) {
             read_count = PERPKG_MAX_LEN;
         }
 
-        // DLOG << "m_read_buffer size=" << m_read_buffer->getBufferVector().size()
+        // DLOG << "m_read_buffer size=" << m_read_buffer->getSize()
         //      << " rd=" << m_read_buffer->readIndex() << " wd=" << m_read_buffer->writeIndex();
         atomic_store(&_rev_start_time, co::now::ms());
-        int64 rt = read_hook(&(m_read_buffer->m_buffer[static_cast<size_t>(write_index)]), read_count);
+        int64 rt = read_hook(span, read_count);
         atomic_store(&_rev_start_time, 0);
         if (rt > 0) {
             m_read_buffer->recycleWrite(static_cast<int>(rt));
         }
 
-        // DLOG << "m_read_buffer size=" << m_read_buffer->getBufferVector().size()
+        // DLOG << "m_read_buffer size=" << m_read_buffer->getSize()
         //      << " rd=" << m_read_buffer->readIndex() << " wd=" << m_read_buffer->writeIndex();
 
         if (rt <= 0) {
@@ -208,14 +237,15 @@ bool TcpConnection::input()
             break;
         } else {
             count += rt;
-            if (rt == read_count) {
-                // is is possible read more data, should continue read
+            // the span is full, the rest may be in the socket or the read just
+            // ended at the span end. Only read on if it does not block, a blocking
+            // read would wait for the timeout and close a healthy connection.
+            // Data kept back by ssl is read by the next input() of the loop.
+            if (rt == read_count && readPending()) {
                 continue;
-            } else if (rt < read_count) {
-                // read all data in socket buffer, skip out loop
-                read_all = true;
-                break;
             }
+            read_all = true;
+            break;
         }
     }
     if (close_flag) {
@@ -241,11 +271,21 @@ void TcpConnection::execute()
         std::shared_ptr<AbstractData> data;
         data = std::make_shared<SpecDataStruct>();
 
+        int before = m_read_buffer->readAble();
         m_codec->decode(m_read_buffer.get(), data.get());
         // DLOG << "parse service_name=" << pb_struct.service_full_name;
         if (!data->decode_succ) {
+            if (m_read_buffer->readAble() == before) {
+                // package not complete, wait for more data
+                break;
+            }
             ELOG << "it parse request error";
-            break;
+            SpecDataStruct *broken = dynamic_cast<SpecDataStruct *>(data.get());
+            if (broken && broken->err_code == static_cast<uint32_t>(ERROR_FAILED_CHECKSUM)
+                && !broken->msg_req.empty()) {
+                replyCorrupted(broken);
+            }
+            continue;
         }
 
         if (m_connection_type == ServerConnection) {
@@ -257,8 +297,24 @@ void TcpConnection::execute()
             }
         }
     }
-    // clear read buffer after execute has take it
-    m_read_buffer->clearBuffer();
+    // keep the incomplete package in read buffer, it will be completed by next input
+}
+
+void TcpConnection::replyCorrupted(SpecDataStruct *data)
+{
+    if (m_connection_type == ServerConnection) {
+        // answer the corrupted request with an error, the caller sends it again
+        SpecDataStruct reply_pk;
+        reply_pk.service_full_name = data->service_full_name;
+        reply_pk.msg_req = data->msg_req;
+        reply_pk.err_code = data->err_code;
+        reply_pk.err_info = data->err_info;
+        m_codec->encode(m_write_buffer.get(), &reply_pk);
+    } else if (m_connection_type == ClientConnection) {
+        // fail the waiting call at once instead of waiting for its timeout
+        std::shared_ptr<SpecDataStruct> reply = std::make_shared<SpecDataStruct>(*data);
+        m_reply_datas.insert(std::make_pair(reply->msg_req, reply));
+    }
 }
 
 void TcpConnection::output()
@@ -274,9 +330,10 @@ void TcpConnection::output()
             break;
         }
 
-        int total_size = m_write_buffer->readAble();
-        int read_index = m_write_buffer->readIndex();
-        int64 rt = write_hook(&(m_write_buffer->m_buffer[static_cast<size_t>(read_index)]), total_size);
+        // send the ring span by span, at most two sends when the data wraps
+        int total_size = 0;
+        const char *span = m_write_buffer->readSpan(&total_size);
+        int64 rt = write_hook(span, total_size);
         if (rt <= 0) {
             ELOG << "write empty, error=" << strerror(errno);
             break;
@@ -293,7 +350,7 @@ void TcpConnection::output()
             break;
         }
     }
-    // clear write buffer after has send it
+    // clear write buffer after has send it, the ring storage is kept
     m_write_buffer->clearBuffer();
 }
 
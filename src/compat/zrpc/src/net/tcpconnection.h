@@ -93,8 +93,11 @@ public:
 
 private:
     int64 read_hook(char *buf, int len);
+    // true if the socket has data which can be read without waiting
+    bool readPending();
     int64 write_hook(const void *buf, int count);
     void clearClient();
+    void replyCorrupted(SpecDataStruct *data);
 
 private:
     TcpServer *m_tcp_svr { nullptr };
@@ -0,0 +1,130 @@
+﻿// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <string.h>
+#include "crc32c.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ZRPC_CRC32C_SSE42
+#include <nmmintrin.h>
+#define ZRPC_CRC32C_TARGET __attribute__((target("sse4.2")))
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define ZRPC_CRC32C_SSE42
+#include <intrin.h>
+#include <nmmintrin.h>
+#define ZRPC_CRC32C_TARGET
+#elif defined(__aarch64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#define ZRPC_CRC32C_ARMV8
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define ZRPC_CRC32C_TARGET __attribute__((target("+crc")))
+#endif
+
+namespace zrpc_ns {
+
+namespace {
+
+const uint32_t CRC32C_POLY = 0x82F63B78; // reflected Castagnoli polynomial
+
+struct Crc32CTable {
+    uint32_t t[8][256];
+
+    Crc32CTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k)
+                crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+            t[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int k = 1; k < 8; ++k)
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+    }
+};
+
+uint32_t extendTable(uint32_t crc, const unsigned char *p, size_t len) {
+    static const Crc32CTable table;
+    const uint32_t (*t)[256] = table.t;
+
+    // bytes are combined explicitly, so the table path is endian neutral
+    while (len >= 8) {
+        crc ^= static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8
+               | static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+        crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff]
+              ^ t[4][crc >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(ZRPC_CRC32C_SSE42)
+ZRPC_CRC32C_TARGET uint32_t extendHardware(uint32_t crc, const unsigned char *p, size_t len) {
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+        p += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (len--)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+bool detectHardware() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#elif defined(ZRPC_CRC32C_ARMV8)
+ZRPC_CRC32C_TARGET uint32_t extendHardware(uint32_t crc, const unsigned char *p, size_t len) {
+    while (len >= 8) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        crc = __crc32cd(crc, value);
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc = __crc32cb(crc, *p++);
+    return crc;
+}
+
+bool detectHardware() {
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+#else
+uint32_t extendHardware(uint32_t crc, const unsigned char *p, size_t len) {
+    return extendTable(crc, p, len);
+}
+
+bool detectHardware() {
+    return false;
+}
+#endif
+
+} // namespace
+
+uint32_t Crc32C::extend(uint32_t crc, const void *data, size_t len) {
+    static const bool hw = detectHardware();
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    return hw ? extendHardware(crc, p, len) : extendTable(crc, p, len);
+}
+
+bool Crc32C::hardware() {
+    static const bool hw = detectHardware();
+    return hw;
+}
+
+} // namespace zrpc_ns
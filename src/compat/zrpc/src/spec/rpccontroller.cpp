@@ -5,6 +5,7 @@
 #include <google/protobuf/service.h>
 #include <google/protobuf/stubs/callback.h>
 #include "rpccontroller.h"
+#include "errorcode.h"
 
 namespace zrpc_ns {
 
@@ -42,6 +43,10 @@ int ZRpcController::ErrorCode() const {
     return m_error_code;
 }
 
+bool ZRpcController::Corrupted() const {
+    return m_error_code == ERROR_FAILED_CHECKSUM;
+}
+
 const std::string &ZRpcController::MsgSeq() const {
     return m_msg_req;
 }
@@ -8,6 +8,8 @@
 #include <memory>
 #include <string.h>
 #include "specodec.h"
+#include "crc32c.h"
+#include "errorcode.h"
 #include "utils.h"
 #include "co/log.h"
 #include "abstractdata.h"
@@ -18,6 +20,13 @@ namespace zrpc_ns {
 static const char PB_START = 0x02; // start char
 static const char PB_END = 0x03;   // end char
 static const int MSG_REQ_LEN = 20; // default length of msg_req
+static const uint32_t PB_MIN_LEN = 2 * sizeof(char) + 6 * sizeof(uint32_t); // empty package
+// the largest real package is a 1MB file block with its json header, anything
+// far beyond is a broken or hostile length and is resynced instead of buffered
+static const uint32_t PB_MAX_LEN = 8 * 1024 * 1024;
+// old peers always send this constant, such package is accepted without verify.
+// the new peers send CRC32C, which old peers ignore, so both sides keep working
+static const int32_t CHECKSUM_LEGACY = 1;
 
 ZRpcCodeC::ZRpcCodeC() {
 }
@@ -123,7 +132,8 @@ const char *ZRpcCodeC::encodePbData(SpecDataStruct *data, uint32_t &len) {
     tmp += data->pb_data.length();
     // DLOG << "pb_data_len= " << data->pb_data.length();
 
-    int32_t checksum = 1;
+    // CRC32C of everything before the checksum field
+    int32_t checksum = static_cast<int32_t>(Crc32C::checksum(buf, static_cast<size_t>(tmp - buf)));
     int32_t checksum_net = hton32(checksum);
     memcpy(tmp, &checksum_net, sizeof(int32_t));
     tmp += sizeof(int32_t);
@@ -135,7 +145,6 @@ const char *ZRpcCodeC::encodePbData(SpecDataStruct *data, uint32_t &len) {
     data->service_name_len = service_full_name_len;
     data->err_info_len = err_info_len;
 
-    // checksum has not been implemented yet, directly skip chcksum
     data->check_num = checksum;
     data->encode_succ = true;
 
@@ -151,150 +160,123 @@ void ZRpcCodeC::decode(TcpBuffer *buf, AbstractData *data) {
         return;
     }
 
-    std::vector<char> tmp = buf->getBufferVector();
-    // int total_size = buf->readAble();
-    int start_index = buf->readIndex();
-    int end_index = -1;
-    uint32_t pk_len = 0;
-
-    bool parse_full_pack = false;
-
-    for (int i = start_index; i < buf->writeIndex(); ++i) {
-        // first find start
-        if (tmp[i] == PB_START) {
-            if (i + 1 < buf->writeIndex()) {
-                pk_len = Util::netByteToInt32(&tmp[i + 1]);
-                // DLOG << "prase pk_len =" << pk_len;
-                int j = i + pk_len - 1;
-                // DLOG << "j =" << j << ", i=" << i;
-
-                if (j >= buf->writeIndex()) {
-                    // DLOG << "recv package not complete, or pk_start find error, continue next
-                    // parse";
-                    continue;
-                }
-                if (tmp[j] == PB_END) {
-                    start_index = i;
-                    end_index = j;
-                    // DLOG << "parse succ, now break";
-                    parse_full_pack = true;
-                    break;
-                }
-            }
-        }
-    }
-
-    if (!parse_full_pack) {
-        ELOG << "not parse full package, return";
-        return;
-    }
-
-    buf->recycleRead(end_index + 1 - start_index);
-
-    // DLOG << "m_read_buffer size=" << buf->getBufferVector().size() << "rd=" << buf->readIndex()
-    //      << "wd=" << buf->writeIndex();
-
     SpecDataStruct *pb_struct = dynamic_cast<SpecDataStruct *>(data);
-    pb_struct->pk_len = pk_len;
     pb_struct->decode_succ = false;
 
-    int msg_req_len_index = start_index + sizeof(char) + sizeof(int32_t);
-    if (msg_req_len_index >= end_index) {
-        ELOG << "parse error, msg_req_len_index[" << msg_req_len_index << "] >= end_index["
-             << end_index << "]";
-        // drop this error package
-        return;
-    }
-
-    pb_struct->msg_req_len = Util::netByteToInt32(&tmp[msg_req_len_index]);
-    if (pb_struct->msg_req_len == 0) {
-        ELOG << "prase error, msg_req emptr";
-        return;
-    }
-
-    // DLOG << "msg_req_len= " << pb_struct->msg_req_len;
-    int msg_req_index = msg_req_len_index + sizeof(int32_t);
-    // DLOG << "msg_req_len_index= " << msg_req_index;
+    // 先解析帧头长度，帧未收全时直接返回等待后续数据，不再扫描和拷贝整个缓冲区
+    while (buf->readAble() > 0) {
+        int span = 0;
+        const char *begin = buf->readSpan(&span);
+        size_t avail = static_cast<size_t>(span);
+
+        // resync to the next start char, drop the garbage before it
+        const char *start = static_cast<const char *>(memchr(begin, PB_START, avail));
+        if (start == nullptr) {
+            ELOG << "drop " << avail << " bytes without package start";
+            buf->recycleRead(static_cast<int>(avail));
+            continue;
+        }
+        if (start != begin) {
+            ELOG << "drop " << (start - begin) << " bytes before package start";
+            buf->recycleRead(static_cast<int>(start - begin));
+            continue;
+        }
 
-    char msg_req[50] = {0};
+        // the header may wrap around the ring end, make it contiguous
+        const char *header = buf->peek(sizeof(char) + sizeof(uint32_t));
+        if (header == nullptr) {
+            // wait for the package length
+            return;
+        }
 
-    memcpy(&msg_req[0], &tmp[msg_req_index], pb_struct->msg_req_len);
-    pb_struct->msg_req = std::string(msg_req);
-    // DLOG << "msg_req= " << pb_struct->msg_req;
+        uint32_t pk_len = Util::netByteToInt32(header + 1);
+        if (pk_len < PB_MIN_LEN || pk_len > PB_MAX_LEN) {
+            ELOG << "parse error, invalid pk_len[" << pk_len << "], resync";
+            buf->recycleRead(1);
+            continue;
+        }
 
-    int service_name_len_index = msg_req_index + pb_struct->msg_req_len;
-    if (service_name_len_index >= end_index) {
-        ELOG << "parse error, service_name_len_index[" << service_name_len_index
-             << "] >= end_index[" << end_index << "]";
-        // drop this error package
-        return;
-    }
+        if (static_cast<uint32_t>(buf->readAble()) < pk_len) {
+            // wait for the whole package, the connection grows the ring as bytes arrive
+            return;
+        }
 
-    // DLOG << "service_name_len_index = " << service_name_len_index;
-    int service_name_index = service_name_len_index + sizeof(int32_t);
+        begin = buf->peek(static_cast<int>(pk_len));
+        if (begin[pk_len - 1] != PB_END) {
+            ELOG << "parse error, package not end with PB_END, resync";
+            buf->recycleRead(1);
+            continue;
+        }
 
-    if (service_name_index >= end_index) {
-        ELOG << "parse error, service_name_index[" << service_name_index << "] >= end_index["
-             << end_index << "]";
+        pb_struct->pk_len = pk_len;
+        bool succ = decodeFields(begin, pk_len, pb_struct);
+        if (succ && !verifyChecksum(begin, pk_len, pb_struct->check_num)) {
+            // keep msg_req, so the peer can be told to send it again
+            ELOG << "package checksum mismatch, msg_req[" << pb_struct->msg_req << "] pk_len[" << pk_len << "]";
+            pb_struct->err_code = ERROR_FAILED_CHECKSUM;
+            pb_struct->err_info = "package checksum mismatch";
+            pb_struct->pb_data.clear();
+            succ = false;
+        }
+        // the whole package is consumed even if its fields are broken
+        buf->recycleRead(static_cast<int>(pk_len));
+        pb_struct->decode_succ = succ;
         return;
     }
+}
 
-    pb_struct->service_name_len = Util::netByteToInt32(&tmp[service_name_len_index]);
+bool ZRpcCodeC::verifyChecksum(const char *pkg, uint32_t pk_len, int32_t check_num) {
+    if (check_num == CHECKSUM_LEGACY)
+        return true;
+    size_t len = pk_len - sizeof(int32_t) - sizeof(char);
+    return static_cast<int32_t>(Crc32C::checksum(pkg, len)) == check_num;
+}
 
-    if (pb_struct->service_name_len > pk_len) {
-        ELOG << "parse error, service_name_len[" << pb_struct->service_name_len << "] >= pk_len ["
-             << pk_len << "]";
-        return;
+bool ZRpcCodeC::decodeFields(const char *pkg, uint32_t pk_len, SpecDataStruct *pb_struct) {
+    // fields lay between the 5 bytes header and the 5 bytes tail (checksum + end char)
+    const char *cur = pkg + sizeof(char) + sizeof(uint32_t);
+    const char *end = pkg + pk_len - sizeof(int32_t) - sizeof(char);
+
+    auto readLen = [&](uint32_t &value) -> bool {
+        if (end - cur < static_cast<ptrdiff_t>(sizeof(uint32_t)))
+            return false;
+        value = Util::netByteToInt32(cur);
+        cur += sizeof(uint32_t);
+        return true;
+    };
+    auto readStr = [&](std::string &value, uint32_t len) -> bool {
+        if (static_cast<size_t>(end - cur) < len)
+            return false;
+        value.assign(cur, len);
+        cur += len;
+        return true;
+    };
+
+    if (!readLen(pb_struct->msg_req_len) || pb_struct->msg_req_len == 0
+        || !readStr(pb_struct->msg_req, pb_struct->msg_req_len)) {
+        ELOG << "parse error, msg_req_len[" << pb_struct->msg_req_len << "] pk_len[" << pk_len << "]";
+        return false;
     }
-    // DLOG << "service_name_len = " << pb_struct->service_name_len;
-
-    char service_name[512] = {0};
-
-    memcpy(&service_name[0], &tmp[service_name_index], pb_struct->service_name_len);
-    pb_struct->service_full_name = std::string(service_name);
-    // DLOG << "service_name = " << pb_struct->service_full_name;
 
-    int err_code_index = service_name_index + pb_struct->service_name_len;
-    pb_struct->err_code = Util::netByteToInt32(&tmp[err_code_index]);
-
-    int err_info_len_index = err_code_index + sizeof(int32_t);
-
-    if (err_info_len_index >= end_index) {
-        ELOG << "parse error, err_info_len_index[" << err_info_len_index << "] >= end_index["
-             << end_index << "]";
-        // drop this error package
-        return;
+    if (!readLen(pb_struct->service_name_len)
+        || !readStr(pb_struct->service_full_name, pb_struct->service_name_len)) {
+        ELOG << "parse error, service_name_len[" << pb_struct->service_name_len << "] pk_len[" << pk_len << "]";
+        return false;
     }
-    pb_struct->err_info_len = Util::netByteToInt32(&tmp[err_info_len_index]);
-    // DLOG << "err_info_len = " << pb_struct->err_info_len;
-    int err_info_index = err_info_len_index + sizeof(int32_t);
-
-    char err_info[512] = {0};
-
-    memcpy(&err_info[0], &tmp[err_info_index], pb_struct->err_info_len);
-    pb_struct->err_info = std::string(err_info);
 
-    int pb_data_len = pb_struct->pk_len - pb_struct->service_name_len - pb_struct->msg_req_len -
-                      pb_struct->err_info_len - 2 * sizeof(char) - 6 * sizeof(int32_t);
-
-    int pb_data_index = err_info_index + pb_struct->err_info_len;
-    // DLOG << "pb_data_len= " << pb_data_len << ", pb_index = " << pb_data_index;
-
-    if (pb_data_index >= end_index) {
-        ELOG << "parse error, pb_data_index[" << pb_data_index << "] >= end_index[" << end_index
-             << "]";
-        return;
+    if (!readLen(pb_struct->err_code) || !readLen(pb_struct->err_info_len)
+        || !readStr(pb_struct->err_info, pb_struct->err_info_len)) {
+        ELOG << "parse error, err_info_len[" << pb_struct->err_info_len << "] pk_len[" << pk_len << "]";
+        return false;
     }
-    // DLOG << "pb_data_index = " << pb_data_index << ", pb_data.length = " << pb_data_len;
 
-    std::string pb_data_str(&tmp[pb_data_index], pb_data_len);
-    pb_struct->pb_data = pb_data_str;
+    // the rest of package is the business data, copied once from the read buffer
+    pb_struct->pb_data.assign(cur, static_cast<size_t>(end - cur));
+    pb_struct->check_num = static_cast<int32_t>(Util::netByteToInt32(end));
 
     // DLOG << "decode succ,  pk_len = " << pk_len << ", service_name = " <<
     // pb_struct->service_full_name;
-
-    pb_struct->decode_succ = true;
-    data = pb_struct;
+    return true;
 }
 
 } // namespace zrpc_ns
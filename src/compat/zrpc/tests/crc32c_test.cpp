@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "crc32c.h"
+#include <string>
+#include <vector>
+
+using namespace zrpc_ns;
+
+// 逐位计算的参考实现
+static uint32_t referenceCrc32C(const unsigned char *data, size_t len)
+{
+    uint32_t crc = ~0u;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+// 测试已知的校验值（RFC 3720 B.4）
+TEST(Crc32CTest, KnownVectors) {
+    EXPECT_EQ(Crc32C::checksum("123456789", 9), 0xE3069283u);
+    EXPECT_EQ(Crc32C::checksum("", 0), 0x00000000u);
+
+    std::vector<unsigned char> data(32, 0x00);
+    EXPECT_EQ(Crc32C::checksum(data.data(), data.size()), 0x8A9136AAu);
+
+    std::fill(data.begin(), data.end(), 0xFF);
+    EXPECT_EQ(Crc32C::checksum(data.data(), data.size()), 0x62A8AB43u);
+
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<unsigned char>(i);
+    EXPECT_EQ(Crc32C::checksum(data.data(), data.size()), 0x46DD794Eu);
+
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<unsigned char>(31 - i);
+    EXPECT_EQ(Crc32C::checksum(data.data(), data.size()), 0x113FDB5Cu);
+}
+
+// 测试各种长度和未对齐地址，硬件和查表实现都要与参考实现一致
+TEST(Crc32CTest, UnalignedLengths) {
+    std::vector<unsigned char> data(1024 + 16);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<unsigned char>(i * 131 + 7);
+
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t len = 0; len <= 1024; len += (len < 64 ? 1 : 61)) {
+            EXPECT_EQ(Crc32C::checksum(&data[offset], len), referenceCrc32C(&data[offset], len))
+                    << "offset " << offset << " len " << len;
+        }
+    }
+}
+
+// 测试分段计算与整体计算结果一致
+TEST(Crc32CTest, Extend) {
+    std::string text = "The quick brown fox jumps over the lazy dog";
+    uint32_t whole = Crc32C::checksum(text.data(), text.size());
+
+    for (size_t split = 0; split <= text.size(); ++split) {
+        uint32_t crc = Crc32C::extend(~0u, text.data(), split);
+        crc = Crc32C::extend(crc, text.data() + split, text.size() - split);
+        EXPECT_EQ(~crc, whole) << "split " << split;
+    }
+}
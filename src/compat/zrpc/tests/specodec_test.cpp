@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "net/tcpbuffer.h"
+#include "specodec.h"
+#include "specdata.h"
+#include "errorcode.h"
+#include "rpccontroller.h"
+#include <string>
+#include <vector>
+
+using namespace zrpc_ns;
+
+// 编码一个测试包，返回完整的帧
+static std::string encodePackage(const std::string &payload, const std::string &msg_req = "00000000000000000001")
+{
+    ZRpcCodeC codec;
+    SpecDataStruct data;
+    data.msg_req = msg_req;
+    data.service_full_name = "TestService.test";
+    data.pb_data = payload;
+
+    TcpBuffer buffer(16);
+    codec.encode(&buffer, &data);
+    EXPECT_TRUE(data.encode_succ);
+    return buffer.getBufferString();
+}
+
+// 测试编码后完整解码
+TEST(ZRpcCodeCTest, RoundTrip) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("payload data");
+
+    TcpBuffer buffer(64);
+    buffer.writeToBuffer(frame.data(), static_cast<int>(frame.size()));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.msg_req, "00000000000000000001");
+    EXPECT_EQ(data.service_full_name, "TestService.test");
+    EXPECT_EQ(data.pb_data, "payload data");
+    EXPECT_EQ(data.pk_len, frame.size());
+    EXPECT_EQ(buffer.readAble(), 0);
+}
+
+// 测试逐字节到达的帧，帧头未收全时不消耗数据
+TEST(ZRpcCodeCTest, SplitHeader) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("split");
+
+    TcpBuffer buffer(8);
+    for (size_t i = 0; i + 1 < frame.size(); ++i) {
+        buffer.writeToBuffer(&frame[i], 1);
+        SpecDataStruct data;
+        codec.decode(&buffer, &data);
+        EXPECT_FALSE(data.decode_succ);
+        EXPECT_EQ(static_cast<size_t>(buffer.readAble()), i + 1);
+    }
+
+    buffer.writeToBuffer(&frame.back(), 1);
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.pb_data, "split");
+}
+
+// 测试跨越环形缓冲区末尾的帧
+TEST(ZRpcCodeCTest, WrappedFrame) {
+    ZRpcCodeC codec;
+    std::string first = encodePackage("first");
+    std::string second = encodePackage("second", "00000000000000000002");
+
+    // 缓冲区恰好容纳两个帧，第二个帧在读出第一个帧后跨越末尾
+    TcpBuffer buffer(static_cast<int>(first.size() + second.size() - 4));
+    buffer.writeToBuffer(first.data(), static_cast<int>(first.size()));
+    buffer.writeToBuffer(second.data(), static_cast<int>(second.size() - 8));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.pb_data, "first");
+
+    buffer.writeToBuffer(second.data() + second.size() - 8, 8);
+    EXPECT_LT(buffer.writeIndex(), buffer.readIndex());
+
+    SpecDataStruct wrapped;
+    codec.decode(&buffer, &wrapped);
+    ASSERT_TRUE(wrapped.decode_succ);
+    EXPECT_EQ(wrapped.msg_req, "00000000000000000002");
+    EXPECT_EQ(wrapped.pb_data, "second");
+    EXPECT_EQ(buffer.readAble(), 0);
+}
+
+// 测试超长的帧长度被丢弃并重新同步到下一个帧
+TEST(ZRpcCodeCTest, OversizedFrame) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("after garbage");
+
+    // 帧头声明 0x7fffffff 字节，不会等待也不会预分配
+    std::string garbage("\x02\x7f\xff\xff\xff" "abc", 8);
+
+    TcpBuffer buffer(16);
+    buffer.writeToBuffer(garbage.data(), static_cast<int>(garbage.size()));
+    buffer.writeToBuffer(frame.data(), static_cast<int>(frame.size()));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.pb_data, "after garbage");
+    EXPECT_EQ(buffer.readAble(), 0);
+    EXPECT_LT(buffer.getSize(), 1024);
+}
+
+// 测试帧前的无效数据被跳过
+TEST(ZRpcCodeCTest, GarbageBeforeStart) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("clean");
+
+    TcpBuffer buffer(16);
+    buffer.writeToBuffer("noise", 5);
+    buffer.writeToBuffer(frame.data(), static_cast<int>(frame.size()));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.pb_data, "clean");
+}
+
+// 测试校验失败的包保留请求号，以便对端重发
+TEST(ZRpcCodeCTest, ChecksumMismatchKeepsRequest) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("corrupted payload");
+    // 修改负载中的一个字节
+    frame[frame.size() - 10] ^= 0x01;
+
+    TcpBuffer buffer(16);
+    buffer.writeToBuffer(frame.data(), static_cast<int>(frame.size()));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    EXPECT_FALSE(data.decode_succ);
+    EXPECT_EQ(data.err_code, static_cast<uint32_t>(ERROR_FAILED_CHECKSUM));
+    EXPECT_EQ(data.msg_req, "00000000000000000001");
+    EXPECT_TRUE(data.pb_data.empty());
+    // 整个包被消耗，后续的包仍可解析
+    EXPECT_EQ(buffer.readAble(), 0);
+
+    // 服务端以同一请求号回复错误，调用方据此重发
+    SpecDataStruct reply;
+    reply.service_full_name = data.service_full_name;
+    reply.msg_req = data.msg_req;
+    reply.err_code = data.err_code;
+    reply.err_info = data.err_info;
+    codec.encode(&buffer, &reply);
+
+    SpecDataStruct received;
+    codec.decode(&buffer, &received);
+    ASSERT_TRUE(received.decode_succ);
+    EXPECT_EQ(received.msg_req, "00000000000000000001");
+
+    ZRpcController controller;
+    controller.SetErrorCode(static_cast<int>(received.err_code));
+    EXPECT_TRUE(controller.Corrupted());
+}
+
+// 测试旧版本对端发送的固定校验值仍被接受
+TEST(ZRpcCodeCTest, LegacyChecksum) {
+    ZRpcCodeC codec;
+    std::string frame = encodePackage("legacy");
+    const char legacy[4] = { 0, 0, 0, 1 };
+    frame.replace(frame.size() - 5, 4, legacy, 4);
+
+    TcpBuffer buffer(16);
+    buffer.writeToBuffer(frame.data(), static_cast<int>(frame.size()));
+
+    SpecDataStruct data;
+    codec.decode(&buffer, &data);
+    ASSERT_TRUE(data.decode_succ);
+    EXPECT_EQ(data.pb_data, "legacy");
+}
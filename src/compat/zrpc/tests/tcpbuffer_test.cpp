@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "net/tcpbuffer.h"
+#include <string>
+#include <vector>
+
+using namespace zrpc_ns;
+
+// 写入后读出，使读写位置移动到缓冲区中部
+static void advance(TcpBuffer &buffer, int count)
+{
+    std::string fill(static_cast<size_t>(count), 'x');
+    buffer.writeToBuffer(fill.data(), count);
+    std::vector<char> out;
+    buffer.readFromBuffer(out, count - 1);
+}
+
+// 测试顺序写入和读取
+TEST(TcpBufferTest, WriteAndRead) {
+    TcpBuffer buffer(16);
+    buffer.writeToBuffer("hello", 5);
+    EXPECT_EQ(buffer.readAble(), 5);
+    EXPECT_EQ(buffer.writeAble(), 11);
+
+    std::vector<char> out;
+    buffer.readFromBuffer(out, 16);
+    EXPECT_EQ(std::string(out.begin(), out.end()), "hello");
+    EXPECT_EQ(buffer.readAble(), 0);
+
+    // 读空后回到起点
+    EXPECT_EQ(buffer.readIndex(), 0);
+    EXPECT_EQ(buffer.writeIndex(), 0);
+}
+
+// 测试数据跨越缓冲区末尾时的读写
+TEST(TcpBufferTest, WrapAround) {
+    TcpBuffer buffer(16);
+    advance(buffer, 13);
+    EXPECT_EQ(buffer.readIndex(), 12);
+    EXPECT_EQ(buffer.writeIndex(), 13);
+
+    buffer.writeToBuffer("abcdefgh", 8);
+    EXPECT_EQ(buffer.getSize(), 16);
+    EXPECT_EQ(buffer.writeIndex(), 5);
+    EXPECT_EQ(buffer.readAble(), 9);
+
+    // 可读数据分为两段
+    int len = 0;
+    const char *span = buffer.readSpan(&len);
+    EXPECT_EQ(len, 4);
+    EXPECT_EQ(std::string(span, static_cast<size_t>(len)), "xabc");
+
+    EXPECT_EQ(buffer.getBufferString(), "xabcdefgh");
+
+    std::vector<char> out;
+    buffer.readFromBuffer(out, 9);
+    EXPECT_EQ(std::string(out.begin(), out.end()), "xabcdefgh");
+}
+
+// 测试可写区域的分段
+TEST(TcpBufferTest, WriteSpans) {
+    TcpBuffer buffer(16);
+    advance(buffer, 11);
+
+    // 第一段到缓冲区末尾，第二段从起点到读位置
+    int len = 0;
+    char *span = buffer.writeSpan(&len);
+    EXPECT_EQ(len, 5);
+    memcpy(span, "12345", 5);
+    buffer.recycleWrite(len);
+    EXPECT_EQ(buffer.writeIndex(), 0);
+
+    span = buffer.writeSpan(&len);
+    EXPECT_EQ(len, 10);
+    memcpy(span, "6789", 4);
+    buffer.recycleWrite(4);
+
+    EXPECT_EQ(buffer.getBufferString(), "x123456789");
+
+    // 写满后没有可写区域，多写的长度被拒绝
+    buffer.writeToBuffer("ABCDEF", 6);
+    EXPECT_EQ(buffer.writeAble(), 0);
+    buffer.recycleWrite(1);
+    EXPECT_EQ(buffer.readAble(), 16);
+    EXPECT_EQ(buffer.getBufferString(), "x123456789ABCDEF");
+}
+
+// 测试跨越末尾的数据通过peek变为连续
+TEST(TcpBufferTest, PeekWrapped) {
+    TcpBuffer buffer(16);
+    advance(buffer, 15);
+    buffer.writeToBuffer("abcdef", 6);
+
+    EXPECT_EQ(buffer.peek(8), nullptr);
+
+    const char *data = buffer.peek(7);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(std::string(data, 7), "xabcdef");
+    EXPECT_EQ(buffer.readIndex(), 0);
+    EXPECT_EQ(buffer.writeIndex(), 7);
+
+    // 旋转后继续写入，顺序不变
+    buffer.writeToBuffer("gh", 2);
+    EXPECT_EQ(buffer.getBufferString(), "xabcdefgh");
+}
+
+// 测试扩容保留跨越末尾的数据顺序
+TEST(TcpBufferTest, ResizeWrapped) {
+    TcpBuffer buffer(8);
+    advance(buffer, 7);
+    buffer.writeToBuffer("abcde", 5);
+    EXPECT_EQ(buffer.writeIndex(), 4);
+
+    buffer.resizeBuffer(32);
+    EXPECT_EQ(buffer.getSize(), 32);
+    EXPECT_EQ(buffer.readIndex(), 0);
+    EXPECT_EQ(buffer.writeIndex(), 6);
+    EXPECT_EQ(buffer.getBufferString(), "xabcde");
+
+    // 缩小请求被忽略
+    buffer.resizeBuffer(4);
+    EXPECT_EQ(buffer.getSize(), 32);
+
+    // 写入超过剩余空间时自动扩容
+    std::string big(40, 'y');
+    buffer.writeToBuffer(big.data(), static_cast<int>(big.size()));
+    EXPECT_GE(buffer.getSize(), 46);
+    EXPECT_EQ(buffer.getBufferString(), "xabcde" + big);
+}
+
+// 测试非法的回收长度
+TEST(TcpBufferTest, RecycleOutOfRange) {
+    TcpBuffer buffer(8);
+    buffer.writeToBuffer("abc", 3);
+
+    buffer.recycleRead(4);
+    EXPECT_EQ(buffer.readAble(), 3);
+
+    buffer.recycleWrite(6);
+    EXPECT_EQ(buffer.readAble(), 3);
+
+    buffer.clearBuffer();
+    EXPECT_EQ(buffer.readAble(), 0);
+    EXPECT_EQ(buffer.getSize(), 8);
+}
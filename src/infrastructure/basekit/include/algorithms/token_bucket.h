@@ -43,6 +43,26 @@ public:
     */
     bool Consume(uint64_t tokens = 1);
 
+    //! Reserve the given count of tokens
+    /*!
+        Tokens are always consumed, the bucket goes into debt when it is lack
+        of them. The caller is expected to wait the returned delay before it
+        uses the tokens, which shapes the traffic instead of dropping it.
+
+        \param tokens - Tokens to reserve (default is 1)
+        \return Delay in nanoseconds until the reserved tokens are accumulated, 0 if they are available now
+    */
+    uint64_t Reserve(uint64_t tokens = 1);
+
+    //! Change the rate and the burst of the token bucket
+    /*!
+        Could be called while other threads consume tokens.
+
+        \param rate - Rate of tokens per second to accumulate in the token bucket
+        \param burst - Maximum of burst tokens in the token bucket
+    */
+    void Reset(uint64_t rate, uint64_t burst);
+
 private:
     std::atomic<uint64_t> _time;
     std::atomic<uint64_t> _time_per_token;
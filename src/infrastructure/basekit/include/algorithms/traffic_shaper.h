@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BASEKIT_ALGORITHMS_TRAFFIC_SHAPER_H
+#define BASEKIT_ALGORITHMS_TRAFFIC_SHAPER_H
+
+#include "algorithms/token_bucket.h"
+#include "utility/singleton.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace BaseKit {
+
+//! Bandwidth shaper of the file transfers
+/*!
+    Traffic shaper limits the bandwidth of all transfers together (global
+    limit) and of each transfer job (job limit) with token buckets. Senders
+    wait before they send a chunk instead of dropping it.
+
+    In adaptive mode the rate to a peer backs off when the round trip time
+    of the interactive session with it rises above its idle value, and
+    recovers when it falls back. So the transfers give way to the
+    interactive traffic on a congested link without any configured limit.
+    Each peer has its own adaptive state, a slow link to one peer does not
+    slow down the transfers to the others.
+
+    Thread-safe.
+*/
+class TrafficShaper : public BaseKit::Singleton<TrafficShaper>
+{
+   friend Singleton<TrafficShaper>;
+
+public:
+    //! Bandwidth limit of one transfer job
+    /*!
+        Job follows the limits of the shaper, also when they are changed
+        while it runs.
+
+        Not thread-safe, use one job per sending thread.
+    */
+    class Job
+    {
+        friend class TrafficShaper;
+
+    public:
+        explicit Job(TrafficShaper& shaper = TrafficShaper::GetInstance());
+        Job(const Job&) = delete;
+        Job(Job&&) = delete;
+        ~Job() = default;
+
+        Job& operator=(const Job&) = delete;
+        Job& operator=(Job&&) = delete;
+
+        //! Set the peer the job sends to
+        /*!
+            The job follows the adaptive rate of the peer. A job without a peer
+            follows the configured limits only.
+
+            \param peer - Peer address, as reported to ReportRtt()
+        */
+        void SetPeer(const std::string& peer);
+
+        //! Reserve the given count of bytes
+        /*!
+            Does not wait, so it could be used by asynchronous senders which
+            resume on a timer.
+
+            \param bytes - Bytes to send
+            \return Delay in nanoseconds before the bytes are allowed to be sent, 0 if they are allowed now
+        */
+        uint64_t Reserve(uint64_t bytes);
+
+        //! Wait until the given count of bytes is allowed to be sent
+        /*!
+            \param bytes - Bytes to send
+        */
+        void Consume(uint64_t bytes);
+
+    private:
+        struct Peer;
+
+        TrafficShaper& _shaper;
+        std::shared_ptr<Peer> _peer;
+        TokenBucket _bucket;
+        uint64_t _generation;
+        uint64_t _rate;
+    };
+
+    TrafficShaper();
+    TrafficShaper(const TrafficShaper&) = delete;
+    TrafficShaper(TrafficShaper&&) = delete;
+    ~TrafficShaper() = default;
+
+    TrafficShaper& operator=(const TrafficShaper&) = delete;
+    TrafficShaper& operator=(TrafficShaper&&) = delete;
+
+    //! Get the current global rate in bytes per second (0 is unlimited)
+    uint64_t rate() const noexcept { return _rate.load(std::memory_order_relaxed); }
+    //! Get the current adaptive rate to the given peer in bytes per second (0 is unlimited)
+    uint64_t peer_rate(const std::string& peer);
+    //! Get the job rate in bytes per second (0 is unlimited)
+    uint64_t job_rate() const noexcept { return _job_rate.load(std::memory_order_relaxed); }
+    //! Is the adaptive mode enabled?
+    bool adaptive() const noexcept { return _adaptive.load(std::memory_order_relaxed); }
+
+    //! Set the bandwidth limits
+    /*!
+        \param global - Limit of all transfers in bytes per second (0 is unlimited)
+        \param job - Limit of each transfer job in bytes per second (0 is unlimited)
+    */
+    void SetLimits(uint64_t global, uint64_t job);
+    //! Enable or disable the adaptive mode
+    void SetAdaptive(bool adaptive);
+
+    //! Report the measured round trip time of the interactive session with a peer
+    /*!
+        Expected to be called periodically, e.g. on each heartbeat. Drives
+        the rate to the peer in adaptive mode.
+
+        \param peer - Peer address
+        \param rtt - Round trip time in microseconds
+    */
+    void ReportRtt(const std::string& peer, uint64_t rtt);
+
+private:
+    //! Reserve the bytes in the global bucket and return the delay in nanoseconds
+    uint64_t Reserve(uint64_t bytes);
+    //! Get or create the state of the peer, the mutex must be locked
+    std::shared_ptr<Job::Peer> GetPeer(const std::string& peer);
+    //! Apply the adaptive rate to the bucket of the peer
+    static void Apply(Job::Peer& peer, uint64_t rate);
+
+    std::mutex _mutex;
+    std::atomic<uint64_t> _rate;
+    std::atomic<uint64_t> _job_rate;
+    std::atomic<uint64_t> _generation;
+    std::atomic<bool> _adaptive;
+    TokenBucket _bucket;
+
+    // Protected by the mutex
+    std::map<std::string, std::shared_ptr<Job::Peer>> _peers;
+};
+
+} // namespace BaseKit
+
+#endif // BASEKIT_ALGORITHMS_TRAFFIC_SHAPER_H
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BASEKIT_ALGORITHMS_XXHASH_H
+#define BASEKIT_ALGORITHMS_XXHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BaseKit {
+
+//! XXH64 streaming hash algorithm
+/*!
+    XXH64 is a fast non-cryptographic hash algorithm, which runs at memory
+    bandwidth speed. It is suitable to detect changed or corrupted content,
+    but not to protect it against intentional modifications.
+
+    Data could be hashed by chunks with Update() and the result is the same
+    as hashing all the data at once.
+
+    Not thread-safe.
+
+    https://github.com/Cyan4973/xxHash
+*/
+class XXHash64
+{
+public:
+    //! Initialize the hash state
+    /*!
+        \param seed - Hash seed (default is 0)
+    */
+    explicit XXHash64(uint64_t seed = 0) noexcept { Reset(seed); }
+    XXHash64(const XXHash64&) = default;
+    XXHash64(XXHash64&&) = default;
+    ~XXHash64() = default;
+
+    XXHash64& operator=(const XXHash64&) = default;
+    XXHash64& operator=(XXHash64&&) = default;
+
+    //! Get the total count of hashed bytes
+    uint64_t size() const noexcept { return _total; }
+
+    //! Reset the hash state
+    /*!
+        \param seed - Hash seed (default is 0)
+    */
+    void Reset(uint64_t seed = 0) noexcept;
+
+    //! Hash the next chunk of data
+    /*!
+        \param data - Data buffer
+        \param size - Data size
+    */
+    void Update(const void* data, size_t size) noexcept;
+
+    //! Get the hash of all data updated so far
+    /*!
+        Hash state is not changed, so more data could be updated later.
+
+        \return 64-bit hash value
+    */
+    uint64_t Digest() const noexcept;
+
+    //! Hash the given data at once
+    /*!
+        \param data - Data buffer
+        \param size - Data size
+        \param seed - Hash seed (default is 0)
+        \return 64-bit hash value
+    */
+    static uint64_t Hash(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
+    //! Convert the hash value into the 16 chars hex string
+    static std::string ToString(uint64_t hash);
+
+private:
+    uint64_t _acc[4];
+    uint64_t _seed;
+    uint64_t _total;
+    uint8_t _buffer[32];
+    size_t _buffered;
+};
+
+} // namespace BaseKit
+
+#include "xxhash.inl"
+
+#endif // BASEKIT_ALGORITHMS_XXHASH_H
@@ -0,0 +1,14 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+namespace BaseKit {
+
+inline uint64_t XXHash64::Hash(const void* data, size_t size, uint64_t seed) noexcept
+{
+    XXHash64 hash(seed);
+    hash.Update(data, size);
+    return hash.Digest();
+}
+
+} // namespace BaseKit
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BASEKIT_FILESYSTEM_DIRECTORY_WALKER_H
+#define BASEKIT_FILESYSTEM_DIRECTORY_WALKER_H
+
+#include "filesystem/path.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace BaseKit {
+
+//! Directory entry with cached metadata
+/*!
+    Metadata is read once while walking, so the consumers do not need to
+    stat the path again. Size, modified time, device, inode and links are
+    valid only if the entry was stated (see DirectoryWalker::Options::stat).
+*/
+struct DirectoryEntry
+{
+    Path path;                          //!< Full path of the entry
+    FileType type{FileType::NONE};      //!< Entry type (target type for followed symlinks)
+    bool symlink{false};                //!< Is the entry a symbolic link?
+    bool stated{false};                 //!< Is the metadata below valid?
+    uint64_t size{0};                   //!< File size in bytes
+    uint64_t modified{0};               //!< Modified time in nanoseconds since the epoch
+    uint64_t device{0};                 //!< Device of the entry
+    uint64_t inode{0};                  //!< Inode of the entry
+    uint64_t links{0};                  //!< Hard links count of the entry
+
+    //! Get the entry filename
+    Path filename() const { return path.filename(); }
+
+    //! Is the entry a regular file?
+    bool IsRegularFile() const noexcept { return type == FileType::REGULAR; }
+    //! Is the entry a directory?
+    bool IsDirectory() const noexcept { return type == FileType::DIRECTORY; }
+};
+
+//! Fast directory walker
+/*!
+    Directory walker reads directories with the fewest possible syscalls.
+    On Linux it reads the entries in large batches with getdents64(), takes
+    the entry type from d_type and stats only the entries which need it with
+    statx() relative to the opened directory. Other platforms fall back to
+    the directory iterator.
+
+    Recursive walks run in parallel: each directory is a task, every worker
+    thread walks its own subtrees depth first and steals pending directories
+    from the others when it runs out of work, so big subtrees are spread
+    over all threads.
+
+    Unreadable sub-directories are skipped and counted in errors().
+
+    Thread-safe.
+*/
+class DirectoryWalker
+{
+public:
+    //! Walk options
+    struct Options
+    {
+        bool recursive{true};           //!< Walk sub-directories
+        bool stat{true};                //!< Read size, modified time, device and inode of non-directories
+        bool follow_symlinks{false};    //!< Resolve symlinks and walk symlinked directories (each directory once)
+        size_t threads{0};              //!< Worker threads (0 - hardware concurrency, at most 8)
+    };
+
+    //! Entry visitor
+    /*!
+        Called for each entry, concurrently from the worker threads in a
+        recursive walk. Return false to skip the walk into a directory entry.
+    */
+    typedef std::function<bool(const DirectoryEntry& entry)> Visitor;
+
+    DirectoryWalker() : DirectoryWalker(Options()) {}
+    explicit DirectoryWalker(const Options& options);
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker(DirectoryWalker&&) = delete;
+    ~DirectoryWalker() = default;
+
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(DirectoryWalker&&) = delete;
+
+    //! Get the walk options
+    const Options& options() const noexcept { return _options; }
+    //! Get the count of the skipped unreadable directories
+    uint64_t errors() const noexcept { return _errors.load(std::memory_order_relaxed); }
+    //! Is the walk stopped?
+    bool stopped() const noexcept { return _stop.load(std::memory_order_relaxed); }
+
+    //! Walk the given directory
+    /*!
+        Blocks until all entries are visited or the walk is stopped.
+        Exception thrown by the visitor stops the walk and is rethrown.
+
+        \param root - Directory to walk
+        \param visitor - Entry visitor
+        \return 'true' if the walk is completed, 'false' if it was stopped
+    */
+    bool Walk(const Path& root, const Visitor& visitor);
+    //! Walk the given directories together
+    /*!
+        Unreadable roots are skipped and counted in errors().
+
+        \param roots - Directories to walk
+        \param visitor - Entry visitor
+        \return 'true' if the walk is completed, 'false' if it was stopped
+    */
+    bool Walk(const std::vector<Path>& roots, const Visitor& visitor);
+
+    //! Stop the running walk as soon as possible
+    /*!
+        Stopped walker stays stopped, so it may be stopped before its walk
+        starts. Use a new walker for the next walk.
+    */
+    void Stop() noexcept { _stop.store(true, std::memory_order_relaxed); }
+
+    //! List the entries of the given directory
+    /*!
+        \param path - Directory path
+        \param stat - Read the metadata of non-directories (default is true)
+        \return Directory entries without any sort order
+    */
+    static std::vector<DirectoryEntry> List(const Path& path, bool stat = true);
+
+    //! Stat the given path
+    /*!
+        \param path - Path to stat
+        \param follow_symlinks - Resolve the symlink (default is true)
+        \return Entry with the metadata, its type is FileType::NONE if the path does not exist
+    */
+    static DirectoryEntry Stat(const Path& path, bool follow_symlinks = true);
+
+private:
+    //! Walk the roots with the worker threads, strict walk throws the errors of its single root
+    bool Run(std::vector<Path> roots, bool strict, const Visitor& visitor);
+
+    Options _options;
+    std::atomic<bool> _stop;
+    std::atomic<uint64_t> _errors;
+};
+
+} // namespace BaseKit
+
+#endif // BASEKIT_FILESYSTEM_DIRECTORY_WALKER_H
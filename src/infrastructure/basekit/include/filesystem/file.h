@@ -11,6 +11,7 @@
 #include "filesystem/path.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace BaseKit {
@@ -129,6 +130,21 @@ public:
     */
     size_t Write(const void* buffer, size_t size) override;
 
+    //! Write several byte buffers into the opened file
+    /*!
+        Buffers that fit into the file write buffer are simply copied there.
+        Otherwise the pending write buffer and all given buffers are written
+        with a single gather operation (writev) where it is supported.
+
+        If the file is not opened for writing the method will raise
+        a filesystem exception!
+
+        \param buffers - Array of buffer pointer and size pairs
+        \param count - Count of buffers in the array
+        \return Count of written bytes
+    */
+    size_t WriteVector(const std::pair<const void*, size_t>* buffers, size_t count);
+
     using Writer::Write;
 
     //! Seek into the opened file
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BASEKIT_TRACE_METRICS_H
+#define BASEKIT_TRACE_METRICS_H
+
+#include "time/timestamp.h"
+#include "utility/singleton.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace BaseKit {
+
+//! Metric kind
+enum class MetricKind
+{
+    COUNTER,    //!< Monotonic counter (bytes, files, stalls)
+    GAUGE,      //!< Last value with the observed maximum (queue depths)
+    HISTOGRAM   //!< Log2 distribution of durations in microseconds
+};
+
+//! Process wide metrics registry
+/*!
+    Metrics registry keeps counters, gauges and histograms for hot paths.
+    Every metric is registered once by name and then updated by its index.
+
+    Counters and histograms are accumulated in per-thread slots: only the
+    owning thread writes its slot, so updates are plain relaxed stores
+    without any lock or read-modify-write contention. Snapshot readers sum
+    all live thread slots together with the values of already finished
+    threads. Gauges are shared relaxed atomics.
+
+    Thread-safe.
+*/
+class Metrics : public BaseKit::Singleton<Metrics>
+{
+   friend Singleton<Metrics>;
+
+public:
+    //! Maximal count of registered metrics
+    static const size_t MAX_METRICS = 64;
+    //! Count of histogram buckets, bucket N counts values in [2^(N-1), 2^N) microseconds
+    static const size_t HISTOGRAM_BUCKETS = 32;
+
+    //! Histogram snapshot
+    struct Histogram
+    {
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t max{0};
+        std::array<uint64_t, HISTOGRAM_BUCKETS> buckets{};
+
+        //! Get the approximated percentile value
+        /*!
+            \param percentile - Percentile in range [0, 1]
+            \return Upper bound of the bucket which contains the given percentile
+        */
+        uint64_t Percentile(double percentile) const noexcept;
+    };
+
+    Metrics(const Metrics&) = delete;
+    Metrics(Metrics&&) = delete;
+    ~Metrics() = default;
+
+    Metrics& operator=(const Metrics&) = delete;
+    Metrics& operator=(Metrics&&) = delete;
+
+    //! Register the metric with the given name
+    /*!
+        Registering the same name twice returns the same index.
+
+        \param name - Metric name
+        \param kind - Metric kind
+        \return Metric index or MAX_METRICS if the registry is full
+    */
+    size_t Register(const std::string& name, MetricKind kind);
+
+    //! Increase the counter
+    /*!
+        \param id - Counter index
+        \param value - Value to add (default is 1)
+    */
+    void Add(size_t id, uint64_t value = 1) noexcept;
+    //! Record the duration into the histogram
+    /*!
+        \param id - Histogram index
+        \param microseconds - Duration in microseconds
+    */
+    void Record(size_t id, uint64_t microseconds) noexcept;
+    //! Set the gauge value
+    /*!
+        \param id - Gauge index
+        \param value - Current value
+    */
+    void Set(size_t id, int64_t value) noexcept;
+
+    //! Get the counter value
+    uint64_t counter(size_t id) const;
+    //! Get the gauge value
+    int64_t gauge(size_t id) const noexcept;
+    //! Get the gauge maximum
+    int64_t gauge_max(size_t id) const noexcept;
+    //! Get the histogram snapshot
+    Histogram histogram(size_t id) const;
+
+    //! Get all metrics as JSON snapshot
+    /*!
+        Counters are exported as numbers, gauges as {"value", "max"} and
+        histograms as {"count", "sum_us", "max_us", "p50_us", "p90_us", "p99_us"}.
+
+        \return JSON string
+    */
+    std::string ToJSON() const;
+
+    //! Reset all metrics values
+    /*!
+        Registered names are kept. Values updated concurrently with reset
+        may survive it.
+    */
+    void Reset();
+
+private:
+    // Counter uses the first cell, histogram uses count, sum, max and buckets
+    static const size_t CELLS = HISTOGRAM_BUCKETS + 3;
+
+    struct Slots
+    {
+        std::atomic<uint64_t> cells[MAX_METRICS][CELLS];
+
+        Slots();
+    };
+
+    struct ThreadSlots;
+
+    mutable std::mutex _lock;
+    std::atomic<size_t> _size;
+    std::array<std::string, MAX_METRICS> _names;
+    std::array<MetricKind, MAX_METRICS> _kinds;
+    std::array<std::atomic<int64_t>, MAX_METRICS> _gauges;
+    std::array<std::atomic<int64_t>, MAX_METRICS> _gauges_max;
+    std::vector<Slots*> _threads;
+    Slots _retired;
+
+    Metrics();
+
+    Slots& local();
+    void Attach(Slots* slots);
+    void Detach(Slots* slots);
+    uint64_t Sum(size_t id, size_t cell) const;
+};
+
+//! Trace span
+/*!
+    Trace span measures the duration of the scope it lives in and records
+    it into the given histogram when finished or destroyed.
+
+    Not thread-safe.
+
+    Example:
+    \code{.cpp}
+    void Transfer()
+    {
+        static const size_t id = BaseKit::Metrics::GetInstance().Register("transfer", BaseKit::MetricKind::HISTOGRAM);
+        BaseKit::TraceSpan span(id);
+        ...
+    }
+    \endcode
+*/
+class TraceSpan
+{
+public:
+    //! Start the trace span
+    /*!
+        \param id - Histogram index
+    */
+    explicit TraceSpan(size_t id) noexcept;
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan(TraceSpan&&) = delete;
+    ~TraceSpan() { Finish(); }
+
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    TraceSpan& operator=(TraceSpan&&) = delete;
+
+    //! Is the trace span finished?
+    bool finished() const noexcept { return _finished; }
+    //! Get the elapsed time in microseconds
+    uint64_t elapsed() const noexcept;
+
+    //! Finish the trace span and record its duration
+    /*!
+        Finishing the span twice records nothing.
+
+        \return Elapsed time in microseconds
+    */
+    uint64_t Finish() noexcept;
+    //! Cancel the trace span without recording
+    void Cancel() noexcept { _finished = true; }
+
+private:
+    size_t _id;
+    uint64_t _start;
+    bool _finished;
+};
+
+} // namespace BaseKit
+
+//! Get the metric index registered once for the call site
+#define BASEKIT_METRIC(name, kind) [] { static const size_t id = BaseKit::Metrics::GetInstance().Register(name, kind); return id; }()
+
+#define BASEKIT_TRACE_CONCAT_IMPL(x, y) x##y
+#define BASEKIT_TRACE_CONCAT(x, y) BASEKIT_TRACE_CONCAT_IMPL(x, y)
+
+//! Measure the current scope into the named histogram
+#define BASEKIT_TRACE_SPAN(name) BaseKit::TraceSpan BASEKIT_TRACE_CONCAT(__trace_span_, __LINE__)(BASEKIT_METRIC(name, BaseKit::MetricKind::HISTOGRAM))
+
+#include "metrics.inl"
+
+#endif // BASEKIT_TRACE_METRICS_H
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+namespace BaseKit {
+
+inline void Metrics::Add(size_t id, uint64_t value) noexcept
+{
+    if (id >= MAX_METRICS)
+        return;
+
+    // Only the owning thread writes its slot, so load + store is enough
+    std::atomic<uint64_t>& cell = local().cells[id][0];
+    cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void Metrics::Record(size_t id, uint64_t microseconds) noexcept
+{
+    if (id >= MAX_METRICS)
+        return;
+
+    std::atomic<uint64_t>* cells = local().cells[id];
+
+    // Bucket N keeps values in [2^(N-1), 2^N)
+    size_t bucket = 0;
+    for (uint64_t value = microseconds; (value != 0) && (bucket < (HISTOGRAM_BUCKETS - 1)); value >>= 1)
+        ++bucket;
+
+    cells[0].store(cells[0].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    cells[1].store(cells[1].load(std::memory_order_relaxed) + microseconds, std::memory_order_relaxed);
+    if (microseconds > cells[2].load(std::memory_order_relaxed))
+        cells[2].store(microseconds, std::memory_order_relaxed);
+    cells[3 + bucket].store(cells[3 + bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline void Metrics::Set(size_t id, int64_t value) noexcept
+{
+    if (id >= MAX_METRICS)
+        return;
+
+    _gauges[id].store(value, std::memory_order_relaxed);
+
+    int64_t max = _gauges_max[id].load(std::memory_order_relaxed);
+    while ((value > max) && !_gauges_max[id].compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+inline int64_t Metrics::gauge(size_t id) const noexcept
+{
+    return (id < MAX_METRICS) ? _gauges[id].load(std::memory_order_relaxed) : 0;
+}
+
+inline int64_t Metrics::gauge_max(size_t id) const noexcept
+{
+    return (id < MAX_METRICS) ? _gauges_max[id].load(std::memory_order_relaxed) : 0;
+}
+
+inline TraceSpan::TraceSpan(size_t id) noexcept
+    : _id(id),
+      _start(Timestamp::nano()),
+      _finished(false)
+{
+}
+
+inline uint64_t TraceSpan::elapsed() const noexcept
+{
+    return (Timestamp::nano() - _start) / 1000;
+}
+
+inline uint64_t TraceSpan::Finish() noexcept
+{
+    uint64_t microseconds = elapsed();
+    if (!_finished)
+    {
+        _finished = true;
+        Metrics::GetInstance().Record(_id, microseconds);
+    }
+    return microseconds;
+}
+
+} // namespace BaseKit
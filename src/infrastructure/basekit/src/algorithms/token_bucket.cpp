@@ -39,4 +39,28 @@ bool TokenBucket::Consume(uint64_t tokens)
     }
 }
 
+uint64_t TokenBucket::Reserve(uint64_t tokens)
+{
+    uint64_t now = Timestamp::nano();
+    uint64_t delay = tokens * _time_per_token.load(std::memory_order_relaxed);
+    uint64_t minTime = now - _time_per_burst.load(std::memory_order_relaxed);
+    uint64_t oldTime = _time.load(std::memory_order_relaxed);
+
+    // Lock-free token reserve loop, the time may go ahead of now
+    for (;;)
+    {
+        uint64_t newTime = ((minTime > oldTime) ? minTime : oldTime) + delay;
+
+        if (_time.compare_exchange_weak(oldTime, newTime, std::memory_order_relaxed, std::memory_order_relaxed))
+            return (newTime > now) ? (newTime - now) : 0;
+    }
+}
+
+void TokenBucket::Reset(uint64_t rate, uint64_t burst)
+{
+    uint64_t time_per_token = 1000000000 / rate;
+    _time_per_token.store(time_per_token, std::memory_order_relaxed);
+    _time_per_burst.store(burst * time_per_token, std::memory_order_relaxed);
+}
+
 } // namespace BaseKit
@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "algorithms/traffic_shaper.h"
+
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <algorithm>
+
+namespace BaseKit {
+
+//! @cond INTERNALS
+
+namespace {
+
+// One token stands for this count of bytes, so the nanoseconds per token stay
+// precise for high rates
+const uint64_t TOKEN_BYTES = 64;
+// Burst of the buckets in milliseconds of the rate, and its minimum in bytes
+const uint64_t BURST_MS = 100;
+const uint64_t MIN_BURST = 64 * 1024;
+
+// Round trip time above 2 * idle + slack means the link is queuing
+const uint64_t RTT_SLACK_US = 20000;
+// Multiplicative decrease and additive increase of the adaptive rate
+const uint64_t BACKOFF_PERCENT = 70;
+const uint64_t MIN_ADAPTIVE_RATE = 256 * 1024;
+
+uint64_t Tokens(uint64_t bytes)
+{
+    return (bytes + TOKEN_BYTES - 1) / TOKEN_BYTES;
+}
+
+void SetupBucket(TokenBucket& bucket, uint64_t rate)
+{
+    uint64_t burst = std::max(rate * BURST_MS / 1000, MIN_BURST);
+    bucket.Reset(std::max(rate / TOKEN_BYTES, (uint64_t)1), Tokens(burst));
+}
+
+} // namespace
+
+// Adaptive state of the transfers to one peer
+struct TrafficShaper::Job::Peer
+{
+    TokenBucket bucket{1, 1};
+    std::atomic<uint64_t> rate{0};
+    std::atomic<uint64_t> consumed{0};
+
+    // Protected by the mutex of the shaper
+    uint64_t adaptive_rate{0};
+    uint64_t base_rtt{0};
+    uint64_t last_report{0};
+    uint64_t last_consumed{0};
+};
+
+//! @endcond
+
+TrafficShaper::Job::Job(TrafficShaper& shaper)
+    : _shaper(shaper),
+      _bucket(1, 1),
+      _generation(0),
+      _rate(0)
+{
+}
+
+void TrafficShaper::Job::SetPeer(const std::string& peer)
+{
+    std::lock_guard<std::mutex> locker(_shaper._mutex);
+    _peer = _shaper.GetPeer(peer);
+}
+
+uint64_t TrafficShaper::Job::Reserve(uint64_t bytes)
+{
+    // Limits changed, follow them
+    uint64_t generation = _shaper._generation.load(std::memory_order_acquire);
+    if (generation != _generation)
+    {
+        _generation = generation;
+        _rate = _shaper.job_rate();
+        if (_rate > 0)
+            SetupBucket(_bucket, _rate);
+    }
+
+    uint64_t delay = _shaper.Reserve(bytes);
+    if (_rate > 0)
+        delay = std::max(delay, _bucket.Reserve(Tokens(bytes)));
+
+    if (_peer)
+    {
+        _peer->consumed.fetch_add(bytes, std::memory_order_relaxed);
+        if (_peer->rate.load(std::memory_order_relaxed) > 0)
+            delay = std::max(delay, _peer->bucket.Reserve(Tokens(bytes)));
+    }
+
+    return delay;
+}
+
+void TrafficShaper::Job::Consume(uint64_t bytes)
+{
+    uint64_t delay = Reserve(bytes);
+    if (delay > 0)
+        Thread::SleepFor(Timespan::nanoseconds((int64_t)delay));
+}
+
+TrafficShaper::TrafficShaper()
+    : _rate(0),
+      _job_rate(0),
+      _generation(1),
+      _adaptive(false),
+      _bucket(1, 1)
+{
+}
+
+uint64_t TrafficShaper::peer_rate(const std::string& peer)
+{
+    std::lock_guard<std::mutex> locker(_mutex);
+    auto it = _peers.find(peer);
+    return (it != _peers.end()) ? it->second->rate.load(std::memory_order_relaxed) : 0;
+}
+
+void TrafficShaper::SetLimits(uint64_t global, uint64_t job)
+{
+    std::lock_guard<std::mutex> locker(_mutex);
+    _job_rate.store(job, std::memory_order_relaxed);
+    _generation.fetch_add(1, std::memory_order_release);
+
+    if (global != _rate.load(std::memory_order_relaxed))
+    {
+        if (global > 0)
+            SetupBucket(_bucket, global);
+        _rate.store(global, std::memory_order_relaxed);
+    }
+}
+
+void TrafficShaper::SetAdaptive(bool adaptive)
+{
+    std::lock_guard<std::mutex> locker(_mutex);
+    if (adaptive == _adaptive.load(std::memory_order_relaxed))
+        return;
+    _adaptive.store(adaptive, std::memory_order_relaxed);
+
+    // Start over from the idle link, running jobs keep their peer state
+    for (auto& it : _peers)
+    {
+        it.second->adaptive_rate = 0;
+        it.second->base_rtt = 0;
+        Apply(*it.second, 0);
+    }
+}
+
+void TrafficShaper::ReportRtt(const std::string& peer, uint64_t rtt)
+{
+    std::lock_guard<std::mutex> locker(_mutex);
+    Job::Peer& state = *GetPeer(peer);
+
+    // Throughput of the transfers to the peer since the last report
+    uint64_t now = Timestamp::nano();
+    uint64_t consumed = state.consumed.load(std::memory_order_relaxed);
+    uint64_t elapsed = now - state.last_report;
+    uint64_t throughput = ((state.last_report > 0) && (elapsed > 0)) ? (consumed - state.last_consumed) * 1000000000 / elapsed : 0;
+    state.last_report = now;
+    state.last_consumed = consumed;
+
+    if (!_adaptive.load(std::memory_order_relaxed))
+        return;
+
+    // The lowest round trip time is the idle link, drift up slowly to follow route changes
+    if ((state.base_rtt == 0) || (rtt < state.base_rtt))
+        state.base_rtt = rtt;
+    else
+        state.base_rtt += (rtt - state.base_rtt) / 64;
+
+    uint64_t limit = _rate.load(std::memory_order_relaxed);
+    bool congested = (rtt > 2 * state.base_rtt + RTT_SLACK_US);
+    if (congested && (throughput > 0))
+    {
+        // Back off from what the transfers really send now
+        uint64_t current = (state.adaptive_rate > 0) ? std::min(state.adaptive_rate, throughput) : throughput;
+        state.adaptive_rate = std::max(current * BACKOFF_PERCENT / 100, MIN_ADAPTIVE_RATE);
+    }
+    else if (state.adaptive_rate > 0)
+    {
+        state.adaptive_rate += std::max(state.adaptive_rate / 8, MIN_ADAPTIVE_RATE);
+        // Released when the transfers do not even use half of it
+        if ((state.adaptive_rate > 2 * throughput) || ((limit > 0) && (state.adaptive_rate >= limit)))
+            state.adaptive_rate = 0;
+    }
+
+    Apply(state, state.adaptive_rate);
+}
+
+uint64_t TrafficShaper::Reserve(uint64_t bytes)
+{
+    if (_rate.load(std::memory_order_relaxed) == 0)
+        return 0;
+    return _bucket.Reserve(Tokens(bytes));
+}
+
+std::shared_ptr<TrafficShaper::Job::Peer> TrafficShaper::GetPeer(const std::string& peer)
+{
+    auto& state = _peers[peer];
+    if (!state)
+        state = std::make_shared<Job::Peer>();
+    return state;
+}
+
+void TrafficShaper::Apply(Job::Peer& peer, uint64_t rate)
+{
+    if (rate != peer.rate.load(std::memory_order_relaxed))
+    {
+        if (rate > 0)
+            SetupBucket(peer.bucket, rate);
+        peer.rate.store(rate, std::memory_order_relaxed);
+    }
+}
+
+} // namespace BaseKit
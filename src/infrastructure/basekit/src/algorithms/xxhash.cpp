@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "algorithms/xxhash.h"
+
+#include "utility/endian.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace BaseKit {
+
+//! @cond INTERNALS
+
+namespace {
+
+const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t Rotate(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const uint8_t* buffer)
+{
+    uint64_t value;
+    Endian::ReadLittleEndian(buffer, value);
+    return value;
+}
+
+inline uint64_t Read32(const uint8_t* buffer)
+{
+    uint32_t value;
+    Endian::ReadLittleEndian(buffer, value);
+    return value;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME2;
+    acc = Rotate(acc, 31);
+    return acc * PRIME1;
+}
+
+inline uint64_t Merge(uint64_t acc, uint64_t value)
+{
+    acc ^= Round(0, value);
+    return acc * PRIME1 + PRIME4;
+}
+
+} // namespace
+
+//! @endcond
+
+void XXHash64::Reset(uint64_t seed) noexcept
+{
+    _acc[0] = seed + PRIME1 + PRIME2;
+    _acc[1] = seed + PRIME2;
+    _acc[2] = seed;
+    _acc[3] = seed - PRIME1;
+    _seed = seed;
+    _total = 0;
+    _buffered = 0;
+}
+
+void XXHash64::Update(const void* data, size_t size) noexcept
+{
+    const uint8_t* input = (const uint8_t*)data;
+    _total += size;
+
+    // Complete the buffered stripe first
+    if (_buffered > 0)
+    {
+        size_t count = std::min(size, sizeof(_buffer) - _buffered);
+        std::memcpy(_buffer + _buffered, input, count);
+        _buffered += count;
+        input += count;
+        size -= count;
+
+        if (_buffered < sizeof(_buffer))
+            return;
+
+        for (size_t i = 0; i < 4; ++i)
+            _acc[i] = Round(_acc[i], Read64(_buffer + i * 8));
+        _buffered = 0;
+    }
+
+    // Process full 32 bytes stripes straight from the input
+    uint64_t acc0 = _acc[0], acc1 = _acc[1], acc2 = _acc[2], acc3 = _acc[3];
+    while (size >= sizeof(_buffer))
+    {
+        acc0 = Round(acc0, Read64(input));
+        acc1 = Round(acc1, Read64(input + 8));
+        acc2 = Round(acc2, Read64(input + 16));
+        acc3 = Round(acc3, Read64(input + 24));
+        input += sizeof(_buffer);
+        size -= sizeof(_buffer);
+    }
+    _acc[0] = acc0; _acc[1] = acc1; _acc[2] = acc2; _acc[3] = acc3;
+
+    // Keep the tail for the next update
+    if (size > 0)
+    {
+        std::memcpy(_buffer, input, size);
+        _buffered = size;
+    }
+}
+
+uint64_t XXHash64::Digest() const noexcept
+{
+    uint64_t hash;
+
+    if (_total >= sizeof(_buffer))
+    {
+        hash = Rotate(_acc[0], 1) + Rotate(_acc[1], 7) + Rotate(_acc[2], 12) + Rotate(_acc[3], 18);
+        for (size_t i = 0; i < 4; ++i)
+            hash = Merge(hash, _acc[i]);
+    }
+    else
+        hash = _seed + PRIME5;
+
+    hash += _total;
+
+    const uint8_t* tail = _buffer;
+    size_t size = _buffered;
+    while (size >= 8)
+    {
+        hash ^= Round(0, Read64(tail));
+        hash = Rotate(hash, 27) * PRIME1 + PRIME4;
+        tail += 8;
+        size -= 8;
+    }
+    if (size >= 4)
+    {
+        hash ^= Read32(tail) * PRIME1;
+        hash = Rotate(hash, 23) * PRIME2 + PRIME3;
+        tail += 4;
+        size -= 4;
+    }
+    while (size > 0)
+    {
+        hash ^= (*tail) * PRIME5;
+        hash = Rotate(hash, 11) * PRIME1;
+        ++tail;
+        --size;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string XXHash64::ToString(uint64_t hash)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    std::string result(16, '0');
+    for (size_t i = 0; i < 16; ++i)
+        result[15 - i] = digits[(hash >> (i * 4)) & 0x0F];
+    return result;
+}
+
+} // namespace BaseKit
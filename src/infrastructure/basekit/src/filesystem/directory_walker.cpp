@@ -0,0 +1,470 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filesystem/directory_walker.h"
+
+#include "filesystem/directory.h"
+#include "filesystem/exceptions.h"
+#include "filesystem/file.h"
+#include "filesystem/symlink.h"
+#include "utility/resource.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace BaseKit {
+
+//! @cond INTERNALS
+
+namespace {
+
+// Default count of the worker threads, more of them only contend on the disk
+const unsigned MAX_THREADS = 8;
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+
+// Kernel record returned by getdents64(), glibc does not export it
+struct LinuxDirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+// Batch size of the directory entries read at once
+const size_t DIRENTS_BUFFER = 32 * 1024;
+
+FileType TypeFromMode(mode_t mode)
+{
+    if (S_ISREG(mode))
+        return FileType::REGULAR;
+    else if (S_ISDIR(mode))
+        return FileType::DIRECTORY;
+    else if (S_ISLNK(mode))
+        return FileType::SYMLINK;
+    else if (S_ISBLK(mode))
+        return FileType::BLOCK;
+    else if (S_ISCHR(mode))
+        return FileType::CHARACTER;
+    else if (S_ISFIFO(mode))
+        return FileType::FIFO;
+    else if (S_ISSOCK(mode))
+        return FileType::SOCKETFD;
+    else
+        return FileType::UNKNOWN;
+}
+
+// FileType::NONE means the filesystem does not fill d_type
+FileType TypeFromDirent(unsigned char type)
+{
+    switch (type)
+    {
+        case DT_REG:
+            return FileType::REGULAR;
+        case DT_DIR:
+            return FileType::DIRECTORY;
+        case DT_LNK:
+            return FileType::SYMLINK;
+        case DT_BLK:
+            return FileType::BLOCK;
+        case DT_CHR:
+            return FileType::CHARACTER;
+        case DT_FIFO:
+            return FileType::FIFO;
+        case DT_SOCK:
+            return FileType::SOCKETFD;
+        default:
+            return FileType::NONE;
+    }
+}
+
+// Stat the name relative to the directory descriptor
+bool StatAt(int dirfd, const char* name, bool follow, DirectoryEntry& entry)
+{
+#if defined(STATX_BASIC_STATS)
+    struct statx status;
+    int flags = AT_STATX_DONT_SYNC | (follow ? 0 : AT_SYMLINK_NOFOLLOW);
+    if (statx(dirfd, name, flags, STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_INO | STATX_NLINK, &status) != 0)
+        return false;
+
+    entry.type = TypeFromMode(status.stx_mode);
+    entry.size = status.stx_size;
+    entry.modified = (status.stx_mtime.tv_sec * 1000000000ull) + status.stx_mtime.tv_nsec;
+    entry.device = makedev(status.stx_dev_major, status.stx_dev_minor);
+    entry.inode = status.stx_ino;
+    entry.links = status.stx_nlink;
+#else
+    struct stat status;
+    if (fstatat(dirfd, name, &status, follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+        return false;
+
+    entry.type = TypeFromMode(status.st_mode);
+    entry.size = status.st_size;
+    entry.modified = (status.st_mtim.tv_sec * 1000000000ull) + status.st_mtim.tv_nsec;
+    entry.device = status.st_dev;
+    entry.inode = status.st_ino;
+    entry.links = status.st_nlink;
+#endif
+    entry.stated = true;
+    return true;
+}
+
+// Fill the entry type and metadata, false if the entry vanished meanwhile
+bool StatEntry(int dirfd, const char* name, bool stat, bool follow, DirectoryEntry& entry)
+{
+    // Filesystems without d_type need the status for the type itself
+    if (entry.type == FileType::NONE)
+    {
+        if (!StatAt(dirfd, name, false, entry))
+            return false;
+        entry.symlink = (entry.type == FileType::SYMLINK);
+        if (!entry.symlink && (!stat || (entry.type != FileType::DIRECTORY)))
+            return true;
+    }
+
+    if (entry.symlink)
+    {
+        if (follow)
+        {
+            // Dangling symlink has no target type
+            if (!StatAt(dirfd, name, true, entry))
+            {
+                entry.type = FileType::NONE;
+                entry.stated = false;
+            }
+            return true;
+        }
+        return !stat || StatAt(dirfd, name, false, entry);
+    }
+
+    if (stat && (entry.type != FileType::DIRECTORY))
+        return StatAt(dirfd, name, false, entry);
+
+    return true;
+}
+
+int OpenDirectory(const Path& path)
+{
+    return openat(AT_FDCWD, path.string().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOCTTY);
+}
+
+// Read the opened directory and call the handler for each entry
+template <typename THandler>
+void ReadDirectory(int fd, const Path& parent, bool stat, bool follow, const std::atomic<bool>* stop, THandler&& handler)
+{
+    alignas(LinuxDirent64) char buffer[DIRENTS_BUFFER];
+    for (;;)
+    {
+        long size = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (size < 0)
+            throwex FileSystemException("Cannot read directory entries!").Attach(parent);
+        if (size == 0)
+            return;
+
+        for (long offset = 0; offset < size;)
+        {
+            const LinuxDirent64* dirent = (const LinuxDirent64*)(buffer + offset);
+            offset += dirent->d_reclen;
+
+            const char* name = dirent->d_name;
+            if ((name[0] == '.') && ((name[1] == '\0') || ((name[1] == '.') && (name[2] == '\0'))))
+                continue;
+
+            DirectoryEntry entry;
+            entry.type = TypeFromDirent(dirent->d_type);
+            entry.symlink = (entry.type == FileType::SYMLINK);
+            entry.inode = dirent->d_ino;
+            if (!StatEntry(fd, name, stat, follow, entry))
+                continue;
+
+            entry.path = parent / name;
+            handler(entry);
+        }
+
+        if ((stop != nullptr) && stop->load(std::memory_order_relaxed))
+            return;
+    }
+}
+
+#else
+
+DirectoryEntry StatPath(const Path& path, bool follow)
+{
+    DirectoryEntry entry;
+    entry.path = path;
+    entry.type = path.type();
+    entry.symlink = (entry.type == FileType::SYMLINK);
+    if (entry.symlink && follow)
+    {
+        try
+        {
+            entry.type = Symlink(path).target().type();
+        }
+        catch (const FileSystemException&)
+        {
+            entry.type = FileType::NONE;
+        }
+    }
+
+    if (entry.type == FileType::REGULAR)
+    {
+        entry.size = File(path).size();
+        entry.modified = path.modified().total();
+        entry.stated = true;
+    }
+    return entry;
+}
+
+#endif
+
+} // namespace
+
+//! @endcond
+
+DirectoryWalker::DirectoryWalker(const Options& options)
+    : _options(options),
+      _stop(false),
+      _errors(0)
+{
+}
+
+bool DirectoryWalker::Walk(const Path& root, const Visitor& visitor)
+{
+    return Run(std::vector<Path>{ root }, true, visitor);
+}
+
+bool DirectoryWalker::Walk(const std::vector<Path>& roots, const Visitor& visitor)
+{
+    return Run(roots, false, visitor);
+}
+
+bool DirectoryWalker::Run(std::vector<Path> roots, bool strict, const Visitor& visitor)
+{
+    _errors.store(0, std::memory_order_relaxed);
+
+    // Directories reached through symlinks may repeat or loop
+    std::mutex visited_mutex;
+    std::set<std::pair<uint64_t, uint64_t>> visited;
+
+    // Visit one directory and return its sub-directories to walk
+    auto process = [this, &visitor, &visited_mutex, &visited](const Path& directory) -> std::vector<Path>
+    {
+        std::vector<Path> subdirs;
+#if defined(linux) || defined(__linux) || defined(__linux__)
+        int fd = OpenDirectory(directory);
+        if (fd < 0)
+            throwex FileSystemException("Cannot open a directory!").Attach(directory);
+        auto cleaner = resource([fd](void*) { close(fd); });
+
+        if (_options.follow_symlinks)
+        {
+            struct stat status;
+            if (fstat(fd, &status) == 0)
+            {
+                std::lock_guard<std::mutex> locker(visited_mutex);
+                if (!visited.emplace(status.st_dev, status.st_ino).second)
+                    return subdirs;
+            }
+        }
+
+        ReadDirectory(fd, directory, _options.stat, _options.follow_symlinks, &_stop, [this, &visitor, &subdirs](const DirectoryEntry& entry)
+        {
+            if (stopped())
+                return;
+            if (visitor(entry) && _options.recursive && entry.IsDirectory())
+                subdirs.push_back(entry.path);
+        });
+#else
+        if (_options.follow_symlinks)
+        {
+            std::lock_guard<std::mutex> locker(visited_mutex);
+            if (!visited.emplace(0, std::hash<std::string>()(directory.absolute().string())).second)
+                return subdirs;
+        }
+
+        for (const auto& item : Directory(directory))
+        {
+            if (stopped())
+                break;
+            DirectoryEntry entry = StatPath(item, _options.follow_symlinks);
+            if (visitor(entry) && _options.recursive && entry.IsDirectory())
+                subdirs.push_back(entry.path);
+        }
+#endif
+        return subdirs;
+    };
+
+    // The single root is processed in the calling thread, so its errors are thrown
+    if (strict && !roots.empty() && !stopped())
+        roots = process(roots.front());
+    if (roots.empty() || stopped())
+        return !stopped();
+
+    size_t threads = (_options.threads > 0) ? _options.threads : std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_THREADS);
+
+    // Each worker owns a queue of directories: it pushes and pops its own
+    // sub-directories at the back (depth first) and steals from the front
+    // of the others, where the oldest and usually the biggest subtrees are
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Path> tasks;
+    };
+    std::vector<Queue> queues(threads);
+    for (size_t i = 0; i < roots.size(); ++i)
+        queues[i % threads].tasks.push_back(std::move(roots[i]));
+
+    // Queued and running directories, the walk is done when none is left
+    std::atomic<size_t> outstanding(roots.size());
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+    std::exception_ptr error;
+
+    auto take = [&queues, threads](size_t index, Path& directory) -> bool
+    {
+        for (size_t i = 0; i < threads; ++i)
+        {
+            Queue& queue = queues[(index + i) % threads];
+            std::lock_guard<std::mutex> locker(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0)
+            {
+                directory = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                directory = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto worker = [this, &process, &take, &queues, &outstanding, &idle_mutex, &idle, &error](size_t index)
+    {
+        Path directory;
+        while (!stopped())
+        {
+            if (!take(index, directory))
+            {
+                if (outstanding.load(std::memory_order_acquire) == 0)
+                    break;
+                // Others are still reading, wait for their sub-directories
+                std::unique_lock<std::mutex> locker(idle_mutex);
+                idle.wait_for(locker, std::chrono::milliseconds(1));
+                continue;
+            }
+
+            std::vector<Path> subdirs;
+            try
+            {
+                subdirs = process(directory);
+            }
+            catch (const FileSystemException&)
+            {
+                _errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            catch (...)
+            {
+                Stop();
+                std::lock_guard<std::mutex> locker(idle_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+
+            if (!subdirs.empty())
+            {
+                outstanding.fetch_add(subdirs.size(), std::memory_order_relaxed);
+                Queue& queue = queues[index];
+                std::lock_guard<std::mutex> locker(queue.mutex);
+                for (auto& subdir : subdirs)
+                    queue.tasks.push_back(std::move(subdir));
+            }
+            if ((outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) || (subdirs.size() > 1))
+                idle.notify_all();
+        }
+        idle.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(worker, i);
+    worker(0);
+    for (auto& thread : workers)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return !stopped();
+}
+
+std::vector<DirectoryEntry> DirectoryWalker::List(const Path& path, bool stat)
+{
+    std::vector<DirectoryEntry> entries;
+#if defined(linux) || defined(__linux) || defined(__linux__)
+    int fd = OpenDirectory(path);
+    if (fd < 0)
+        throwex FileSystemException("Cannot open a directory!").Attach(path);
+    auto cleaner = resource([fd](void*) { close(fd); });
+
+    ReadDirectory(fd, path, stat, false, nullptr, [&entries](const DirectoryEntry& entry) { entries.push_back(entry); });
+#else
+    for (const auto& item : Directory(path))
+    {
+        DirectoryEntry entry = StatPath(item, false);
+        if (!stat)
+            entry.stated = false;
+        entries.push_back(std::move(entry));
+    }
+#endif
+    return entries;
+}
+
+DirectoryEntry DirectoryWalker::Stat(const Path& path, bool follow_symlinks)
+{
+#if defined(linux) || defined(__linux) || defined(__linux__)
+    DirectoryEntry entry;
+    entry.path = path;
+    if (!StatAt(AT_FDCWD, path.string().c_str(), false, entry))
+    {
+        entry.type = FileType::NONE;
+        return entry;
+    }
+
+    entry.symlink = (entry.type == FileType::SYMLINK);
+    if (entry.symlink && follow_symlinks && !StatAt(AT_FDCWD, path.string().c_str(), true, entry))
+    {
+        entry.type = FileType::NONE;
+        entry.stated = false;
+    }
+    return entry;
+#else
+    return StatPath(path, follow_symlinks);
+#endif
+}
+
+} // namespace BaseKit
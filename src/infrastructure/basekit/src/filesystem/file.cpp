@@ -7,11 +7,15 @@
 #include "errors/fatal.h"
 #include "utility/validate_aligned_storage.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
 #if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
 #include <fcntl.h>
 #include <unistd.h>
 #elif defined(_WIN32) || defined(_WIN64)
@@ -482,6 +486,73 @@ public:
         return counter;
     }
 
+    size_t WriteVector(const std::pair<const void*, size_t>* buffers, size_t count)
+    {
+        if ((buffers == nullptr) || (count == 0))
+            return 0;
+
+        assert(IsFileWriteOpened() && "File is not opened for writing!");
+        if (!IsFileWriteOpened())
+            throwex FileSystemException("File is not opened for writing!").Attach(path());
+
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i)
+            total += buffers[i].second;
+
+        // Small batches are simply collected in the local write buffer
+        if (!_write_buffer.empty() && (total <= (_write_buffer.size() - _write_size)))
+        {
+            for (size_t i = 0; i < count; ++i)
+                Write(buffers[i].first, buffers[i].second);
+            return total;
+        }
+
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+        std::vector<iovec> iov;
+        iov.reserve(count + 1);
+
+        // Pending buffered data must be written first to keep the order
+        if (_write_size > _write_index)
+            iov.push_back({ _write_buffer.data() + _write_index, _write_size - _write_index });
+        for (size_t i = 0; i < count; ++i)
+            if (buffers[i].second > 0)
+                iov.push_back({ const_cast<void*>(buffers[i].first), buffers[i].second });
+
+        size_t index = 0;
+        while (index < iov.size())
+        {
+            int chunk = (int)std::min(iov.size() - index, (size_t)IOV_MAX);
+            ssize_t result = writev(_file, iov.data() + index, chunk);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throwex FileSystemException("Cannot write into the file!").Attach(path());
+            }
+
+            // Skip completely written buffers and adjust the partial one
+            size_t written = (size_t)result;
+            while ((index < iov.size()) && (written >= iov[index].iov_len))
+                written -= iov[index++].iov_len;
+            if (written > 0)
+            {
+                iov[index].iov_base = (uint8_t*)iov[index].iov_base + written;
+                iov[index].iov_len -= written;
+            }
+        }
+
+        // Reset the write buffer cursor
+        _write_index = 0;
+        _write_size = 0;
+
+        return total;
+#elif defined(_WIN32) || defined(_WIN64)
+        for (size_t i = 0; i < count; ++i)
+            Write(buffers[i].first, buffers[i].second);
+        return total;
+#endif
+    }
+
     void Seek(uint64_t offset)
     {
         assert(IsFileOpened() && "File is not opened!");
@@ -754,6 +825,7 @@ void File::OpenOrCreate(bool read, bool write, bool truncate, const Flags<FileAt
 
 size_t File::Read(void* buffer, size_t size) { return impl().Read(buffer, size); }
 size_t File::Write(const void* buffer, size_t size) { return impl().Write(buffer, size); }
+size_t File::WriteVector(const std::pair<const void*, size_t>* buffers, size_t count) { return impl().WriteVector(buffers, count); }
 
 void File::Seek(uint64_t offset) { return impl().Seek(offset); }
 void File::Resize(uint64_t size) { return impl().Resize(size); }
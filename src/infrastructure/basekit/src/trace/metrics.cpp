@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trace/metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace BaseKit {
+
+//! @cond INTERNALS
+
+// Thread slots holder attaches its slots to the registry on the first
+// update and folds them into the retired values when the thread exits.
+struct Metrics::ThreadSlots
+{
+    Slots slots;
+
+    ThreadSlots() { Metrics::GetInstance().Attach(&slots); }
+    ~ThreadSlots() { Metrics::GetInstance().Detach(&slots); }
+};
+
+namespace {
+
+void WriteJSONString(std::ostream& stream, const std::string& value)
+{
+    stream << '"';
+    for (char ch : value)
+    {
+        if ((ch == '"') || (ch == '\\'))
+            stream << '\\';
+        stream << ch;
+    }
+    stream << '"';
+}
+
+} // namespace
+
+//! @endcond
+
+Metrics::Slots::Slots()
+{
+    for (auto& metric : cells)
+        for (auto& cell : metric)
+            cell.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::Histogram::Percentile(double percentile) const noexcept
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(percentile * count);
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        accumulated += buckets[i];
+        if (accumulated >= rank)
+            return std::min<uint64_t>((i == 0) ? 0 : ((uint64_t)1 << i) - 1, max);
+    }
+    return max;
+}
+
+Metrics::Metrics() : _size(0)
+{
+    for (size_t i = 0; i < MAX_METRICS; ++i)
+    {
+        _kinds[i] = MetricKind::COUNTER;
+        _gauges[i].store(0, std::memory_order_relaxed);
+        _gauges_max[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t Metrics::Register(const std::string& name, MetricKind kind)
+{
+    std::lock_guard<std::mutex> locker(_lock);
+
+    size_t size = _size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size; ++i)
+        if (_names[i] == name)
+            return i;
+
+    // Registry is full, updates of unknown index are ignored
+    if (size == MAX_METRICS)
+        return MAX_METRICS;
+
+    _names[size] = name;
+    _kinds[size] = kind;
+    _size.store(size + 1, std::memory_order_release);
+    return size;
+}
+
+Metrics::Slots& Metrics::local()
+{
+    thread_local ThreadSlots slots;
+    return slots.slots;
+}
+
+void Metrics::Attach(Slots* slots)
+{
+    std::lock_guard<std::mutex> locker(_lock);
+    _threads.push_back(slots);
+}
+
+void Metrics::Detach(Slots* slots)
+{
+    std::lock_guard<std::mutex> locker(_lock);
+
+    for (size_t id = 0; id < MAX_METRICS; ++id)
+    {
+        for (size_t cell = 0; cell < CELLS; ++cell)
+        {
+            uint64_t value = slots->cells[id][cell].load(std::memory_order_relaxed);
+            if (cell == 2)
+            {
+                // Maximum is merged, not accumulated
+                if (value > _retired.cells[id][cell].load(std::memory_order_relaxed))
+                    _retired.cells[id][cell].store(value, std::memory_order_relaxed);
+            }
+            else
+                _retired.cells[id][cell].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    _threads.erase(std::remove(_threads.begin(), _threads.end(), slots), _threads.end());
+}
+
+uint64_t Metrics::Sum(size_t id, size_t cell) const
+{
+    uint64_t result = _retired.cells[id][cell].load(std::memory_order_relaxed);
+    for (auto slots : _threads)
+    {
+        uint64_t value = slots->cells[id][cell].load(std::memory_order_relaxed);
+        result = (cell == 2) ? std::max(result, value) : (result + value);
+    }
+    return result;
+}
+
+uint64_t Metrics::counter(size_t id) const
+{
+    if (id >= MAX_METRICS)
+        return 0;
+
+    std::lock_guard<std::mutex> locker(_lock);
+    return Sum(id, 0);
+}
+
+Metrics::Histogram Metrics::histogram(size_t id) const
+{
+    Histogram result;
+    if (id >= MAX_METRICS)
+        return result;
+
+    std::lock_guard<std::mutex> locker(_lock);
+    result.count = Sum(id, 0);
+    result.sum = Sum(id, 1);
+    result.max = Sum(id, 2);
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        result.buckets[i] = Sum(id, 3 + i);
+    return result;
+}
+
+std::string Metrics::ToJSON() const
+{
+    std::vector<std::pair<std::string, MetricKind>> metrics;
+    {
+        std::lock_guard<std::mutex> locker(_lock);
+        size_t size = _size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; ++i)
+            metrics.emplace_back(_names[i], _kinds[i]);
+    }
+
+    std::ostringstream counters;
+    std::ostringstream gauges;
+    std::ostringstream histograms;
+
+    for (size_t id = 0; id < metrics.size(); ++id)
+    {
+        const std::string& name = metrics[id].first;
+        switch (metrics[id].second)
+        {
+            case MetricKind::COUNTER:
+                if (counters.tellp() > 0)
+                    counters << ',';
+                WriteJSONString(counters, name);
+                counters << ':' << counter(id);
+                break;
+            case MetricKind::GAUGE:
+                if (gauges.tellp() > 0)
+                    gauges << ',';
+                WriteJSONString(gauges, name);
+                gauges << ":{\"value\":" << gauge(id) << ",\"max\":" << gauge_max(id) << '}';
+                break;
+            case MetricKind::HISTOGRAM:
+            {
+                Histogram snapshot = histogram(id);
+                if (histograms.tellp() > 0)
+                    histograms << ',';
+                WriteJSONString(histograms, name);
+                histograms << ":{\"count\":" << snapshot.count
+                           << ",\"sum_us\":" << snapshot.sum
+                           << ",\"max_us\":" << snapshot.max
+                           << ",\"p50_us\":" << snapshot.Percentile(0.50)
+                           << ",\"p90_us\":" << snapshot.Percentile(0.90)
+                           << ",\"p99_us\":" << snapshot.Percentile(0.99) << '}';
+                break;
+            }
+        }
+    }
+
+    std::ostringstream result;
+    result << "{\"timestamp\":" << Timestamp::utc()
+           << ",\"counters\":{" << counters.str()
+           << "},\"gauges\":{" << gauges.str()
+           << "},\"histograms\":{" << histograms.str() << "}}";
+    return result.str();
+}
+
+void Metrics::Reset()
+{
+    std::lock_guard<std::mutex> locker(_lock);
+
+    for (size_t id = 0; id < MAX_METRICS; ++id)
+    {
+        _gauges[id].store(0, std::memory_order_relaxed);
+        _gauges_max[id].store(0, std::memory_order_relaxed);
+        for (size_t cell = 0; cell < CELLS; ++cell)
+        {
+            _retired.cells[id][cell].store(0, std::memory_order_relaxed);
+            for (auto slots : _threads)
+                slots->cells[id][cell].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace BaseKit
@@ -114,4 +114,34 @@ TEST(TokenBucketTest, EdgeCases) {
     // 测试0令牌消费
     TokenBucket normal(10, 10);
     EXPECT_TRUE(normal.Consume(0)); // 消费0个令牌应该总是成功
-} 
\ No newline at end of file
+} 
+
+// 测试TokenBucket预留令牌
+TEST(TokenBucketTest, Reserve) {
+    // 每秒1000个令牌，最大容量为100个令牌
+    TokenBucket bucket(1000, 100);
+
+    // 桶是满的，预留不需要等待
+    EXPECT_EQ(bucket.Reserve(100), 0u);
+
+    // 令牌不足时仍然预留，返回需要等待的时间（约100毫秒）
+    uint64_t delay = bucket.Reserve(100);
+    EXPECT_GT(delay, 90000000u);
+    EXPECT_LE(delay, 100000000u);
+
+    // 欠账累加，再预留需要等待更久
+    EXPECT_GT(bucket.Reserve(100), delay);
+    EXPECT_FALSE(bucket.Consume(1));
+}
+
+// 测试TokenBucket修改速率
+TEST(TokenBucketTest, Reset) {
+    TokenBucket bucket(10, 10);
+    EXPECT_TRUE(bucket.Consume(10));
+    EXPECT_FALSE(bucket.Consume(1));
+
+    // 提高速率后，令牌积累更快
+    bucket.Reset(1000, 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 应该积累约100个令牌
+    EXPECT_TRUE(bucket.Consume(50));
+}
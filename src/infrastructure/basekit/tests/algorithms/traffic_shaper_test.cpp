@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "algorithms/traffic_shaper.h"
+#include "time/timestamp.h"
+
+using namespace BaseKit;
+
+namespace {
+
+// 分块发送，返回耗时（毫秒）
+uint64_t SendChunks(TrafficShaper::Job& job, uint64_t total, uint64_t chunk)
+{
+    uint64_t start = Timestamp::nano();
+    for (uint64_t sent = 0; sent < total; sent += chunk)
+        job.Consume(chunk);
+    return (Timestamp::nano() - start) / 1000000;
+}
+
+} // namespace
+
+// 测试不限速时不等待
+TEST(TrafficShaperTest, Unlimited) {
+    TrafficShaper shaper;
+    TrafficShaper::Job job(shaper);
+
+    EXPECT_EQ(shaper.rate(), 0u);
+    EXPECT_LT(SendChunks(job, 100 * 1024 * 1024, 4096), 100u);
+}
+
+// 测试全局限速
+TEST(TrafficShaperTest, GlobalLimit) {
+    TrafficShaper shaper;
+    shaper.SetLimits(1024 * 1024, 0);
+    EXPECT_EQ(shaper.rate(), 1024u * 1024u);
+
+    // 1MB/s，突发约100KB，发送400KB约需300毫秒
+    TrafficShaper::Job job(shaper);
+    uint64_t elapsed = SendChunks(job, 400 * 1024, 4096);
+    EXPECT_GE(elapsed, 250u);
+    EXPECT_LE(elapsed, 450u);
+}
+
+// 测试单任务限速，以及运行中修改限速
+TEST(TrafficShaperTest, JobLimit) {
+    TrafficShaper shaper;
+    shaper.SetLimits(0, 1024 * 1024);
+    EXPECT_EQ(shaper.rate(), 0u);
+    EXPECT_EQ(shaper.job_rate(), 1024u * 1024u);
+
+    TrafficShaper::Job job(shaper);
+    uint64_t elapsed = SendChunks(job, 400 * 1024, 4096);
+    EXPECT_GE(elapsed, 250u);
+
+    // 取消限速后立即生效
+    shaper.SetLimits(0, 0);
+    EXPECT_LT(SendChunks(job, 10 * 1024 * 1024, 4096), 100u);
+}
+
+// 测试Reserve只返回等待时间，不阻塞
+TEST(TrafficShaperTest, Reserve) {
+    TrafficShaper shaper;
+    shaper.SetLimits(1024 * 1024, 0);
+
+    // 突发约100KB，之后每4KB约需4毫秒
+    TrafficShaper::Job job(shaper);
+    uint64_t start = Timestamp::nano();
+    uint64_t delay = 0;
+    for (int i = 0; i < 50; ++i)
+        delay = job.Reserve(4096);
+    EXPECT_LT((Timestamp::nano() - start) / 1000000, 10u);
+    EXPECT_GT(delay, 50u * 1000000);
+    EXPECT_LT(delay, 150u * 1000000);
+}
+
+// 测试自适应模式：往返时间升高时降速，恢复后解除
+TEST(TrafficShaperTest, Adaptive) {
+    TrafficShaper shaper;
+    EXPECT_FALSE(shaper.adaptive());
+    shaper.SetAdaptive(true);
+    EXPECT_TRUE(shaper.adaptive());
+
+    TrafficShaper::Job job(shaper);
+    job.SetPeer("10.0.0.1");
+    shaper.ReportRtt("10.0.0.1", 1000);
+    SendChunks(job, 8 * 1024 * 1024, 4096);
+    shaper.ReportRtt("10.0.0.1", 1000);
+    EXPECT_EQ(shaper.peer_rate("10.0.0.1"), 0u);
+
+    // 往返时间明显升高，开始限速
+    SendChunks(job, 8 * 1024 * 1024, 4096);
+    shaper.ReportRtt("10.0.0.1", 200000);
+    uint64_t backoff = shaper.peer_rate("10.0.0.1");
+    EXPECT_GT(backoff, 0u);
+    // 全局速率不受影响
+    EXPECT_EQ(shaper.rate(), 0u);
+
+    // 继续拥塞，继续降速
+    SendChunks(job, 64 * 1024, 4096);
+    shaper.ReportRtt("10.0.0.1", 200000);
+    EXPECT_LT(shaper.peer_rate("10.0.0.1"), backoff);
+
+    // 往返时间恢复，且传输用不满速率时解除限速
+    for (int i = 0; i < 16 && shaper.peer_rate("10.0.0.1") > 0; ++i)
+        shaper.ReportRtt("10.0.0.1", 1000);
+    EXPECT_EQ(shaper.peer_rate("10.0.0.1"), 0u);
+
+    // 关闭自适应模式不再限速
+    shaper.SetAdaptive(false);
+    shaper.ReportRtt("10.0.0.1", 200000);
+    EXPECT_EQ(shaper.peer_rate("10.0.0.1"), 0u);
+}
+
+// 测试一个对端拥塞不影响发往其他对端的任务
+TEST(TrafficShaperTest, AdaptivePerPeer) {
+    TrafficShaper shaper;
+    shaper.SetAdaptive(true);
+
+    TrafficShaper::Job slow(shaper);
+    slow.SetPeer("10.0.0.1");
+    TrafficShaper::Job fast(shaper);
+    fast.SetPeer("10.0.0.2");
+
+    shaper.ReportRtt("10.0.0.1", 1000);
+    shaper.ReportRtt("10.0.0.2", 1000);
+    SendChunks(slow, 8 * 1024 * 1024, 4096);
+    SendChunks(fast, 8 * 1024 * 1024, 4096);
+    shaper.ReportRtt("10.0.0.1", 200000);
+    shaper.ReportRtt("10.0.0.2", 1000);
+
+    EXPECT_GT(shaper.peer_rate("10.0.0.1"), 0u);
+    EXPECT_EQ(shaper.peer_rate("10.0.0.2"), 0u);
+    EXPECT_LT(SendChunks(fast, 10 * 1024 * 1024, 4096), 100u);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "algorithms/xxhash.h"
+#include <string>
+#include <vector>
+
+using namespace BaseKit;
+
+// 测试XXH64标准向量
+TEST(XXHash64Test, KnownValues) {
+    EXPECT_EQ(XXHash64::Hash("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(XXHash64::Hash("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    std::string text = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(XXHash64::Hash(text.data(), text.size()), 0xFBCEA83C8A378BF1ULL);
+    EXPECT_EQ(XXHash64::ToString(0xFBCEA83C8A378BF1ULL), "fbcea83c8a378bf1");
+}
+
+// 测试分块计算与一次计算结果一致
+TEST(XXHash64Test, Streaming) {
+    std::vector<char> data(100000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (char)(i * 31 + 7);
+
+    uint64_t expected = XXHash64::Hash(data.data(), data.size(), 42);
+
+    for (size_t chunk : { 1, 3, 31, 32, 33, 4096 }) {
+        XXHash64 hash(42);
+        for (size_t offset = 0; offset < data.size(); offset += chunk)
+            hash.Update(data.data() + offset, std::min(chunk, data.size() - offset));
+        EXPECT_EQ(hash.size(), data.size());
+        EXPECT_EQ(hash.Digest(), expected);
+    }
+
+    // 修改一个字节后结果不同
+    data[5000] ^= 1;
+    EXPECT_NE(XXHash64::Hash(data.data(), data.size(), 42), expected);
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "filesystem/directory.h"
+#include "filesystem/directory_walker.h"
+#include "filesystem/file.h"
+#include "filesystem/symlink.h"
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <mutex>
+
+using namespace BaseKit;
+
+namespace {
+
+// 临时目录树：root/a/1.txt(1) root/a/b/2.txt(22) root/c/3.txt(333) root/4.txt(4444)
+class DirectoryWalkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = Path::temp() / Path::unique();
+        Directory::CreateTree(root / "a" / "b");
+        Directory::CreateTree(root / "c");
+        File::WriteAllText(root / "a" / "1.txt", "1");
+        File::WriteAllText(root / "a" / "b" / "2.txt", "22");
+        File::WriteAllText(root / "c" / "3.txt", "333");
+        File::WriteAllText(root / "4.txt", "4444");
+    }
+
+    void TearDown() override {
+        Path::RemoveAll(root);
+    }
+
+    // 遍历并返回相对路径到大小（目录为-1）的映射
+    std::map<std::string, int64_t> Walk(DirectoryWalker& walker) {
+        std::mutex mutex;
+        std::map<std::string, int64_t> result;
+        walker.Walk(root, [this, &mutex, &result](const DirectoryEntry& entry) {
+            std::string name = entry.path.string().substr(root.string().size() + 1);
+            std::lock_guard<std::mutex> locker(mutex);
+            result[name] = entry.IsDirectory() ? -1 : (int64_t)entry.size;
+            return true;
+        });
+        return result;
+    }
+
+    Path root;
+};
+
+} // namespace
+
+// 测试单层列出目录及元数据
+TEST_F(DirectoryWalkerTest, List) {
+    auto entries = DirectoryWalker::List(root);
+    ASSERT_EQ(entries.size(), 3u);
+
+    for (const auto& entry : entries) {
+        if (entry.filename() == "4.txt") {
+            EXPECT_TRUE(entry.IsRegularFile());
+            EXPECT_TRUE(entry.stated);
+            EXPECT_EQ(entry.size, 4u);
+            EXPECT_EQ(entry.modified, (uint64_t)entry.path.modified().total());
+            EXPECT_GT(entry.inode, 0u);
+        } else {
+            EXPECT_TRUE(entry.IsDirectory());
+        }
+    }
+}
+
+// 测试多线程递归遍历
+TEST_F(DirectoryWalkerTest, Recursive) {
+    DirectoryWalker::Options options;
+    options.threads = 4;
+    DirectoryWalker walker(options);
+
+    auto result = Walk(walker);
+    std::map<std::string, int64_t> expected = {
+        { "a", -1 }, { "a/1.txt", 1 }, { "a/b", -1 }, { "a/b/2.txt", 2 },
+        { "c", -1 }, { "c/3.txt", 3 }, { "4.txt", 4 }
+    };
+    EXPECT_EQ(result, expected);
+    EXPECT_EQ(walker.errors(), 0u);
+}
+
+// 测试符号链接：默认不跟随，跟随时不会因循环链接死循环
+TEST_F(DirectoryWalkerTest, Symlinks) {
+    Symlink::CreateSymlink(root / "c", root / "a" / "link");
+    Symlink::CreateSymlink(root, root / "c" / "loop");
+
+    DirectoryWalker plain;
+    auto result = Walk(plain);
+    EXPECT_EQ(result.count("a/link/3.txt"), 0u);
+    EXPECT_EQ(DirectoryWalker::Stat(root / "a" / "link", false).type, FileType::SYMLINK);
+    EXPECT_EQ(DirectoryWalker::Stat(root / "a" / "link").type, FileType::DIRECTORY);
+
+    DirectoryWalker::Options options;
+    options.follow_symlinks = true;
+    DirectoryWalker follow(options);
+    result = Walk(follow);
+
+    // 每个目录只遍历一次，c 可能经由 a/link 或直接到达
+    size_t found = result.count("c/3.txt") + result.count("a/link/3.txt");
+    EXPECT_EQ(found, 1u);
+    EXPECT_EQ(result.count("4.txt"), 1u);
+
+    // Path::RemoveAll 会跟随链接，先删除链接
+    Path::Remove(root / "a" / "link");
+    Path::Remove(root / "c" / "loop");
+}
+
+// 测试跟随符号链接时文件和指向它的链接有相同的 (dev, inode)，按它去重只统计一次
+TEST_F(DirectoryWalkerTest, SymlinkedFiles) {
+    Symlink::CreateSymlink(root / "4.txt", root / "c" / "link.txt");
+
+    DirectoryWalker::Options options;
+    options.follow_symlinks = true;
+    DirectoryWalker walker(options);
+
+    std::mutex mutex;
+    std::set<std::pair<uint64_t, uint64_t>> seen;
+    uint64_t files = 0, bytes = 0;
+    EXPECT_TRUE(walker.Walk(root, [&](const DirectoryEntry& entry) {
+        if (!entry.IsRegularFile())
+            return true;
+        EXPECT_TRUE(entry.stated);
+        std::lock_guard<std::mutex> locker(mutex);
+        if (seen.emplace(entry.device, entry.inode).second) {
+            ++files;
+            bytes += entry.size;
+        }
+        return true;
+    }));
+    EXPECT_EQ(files, 4u);
+    EXPECT_EQ(bytes, 1u + 2 + 3 + 4);
+
+    auto link = DirectoryWalker::Stat(root / "c" / "link.txt");
+    auto origin = DirectoryWalker::Stat(root / "4.txt");
+    EXPECT_EQ(link.inode, origin.inode);
+    EXPECT_EQ(link.device, origin.device);
+}
+
+// 测试停止遍历
+TEST_F(DirectoryWalkerTest, Stop) {
+    DirectoryWalker walker;
+    std::atomic<int> visited(0);
+    bool completed = walker.Walk(root, [&walker, &visited](const DirectoryEntry&) {
+        ++visited;
+        walker.Stop();
+        return true;
+    });
+    EXPECT_FALSE(completed);
+    EXPECT_TRUE(walker.stopped());
+    EXPECT_LT(visited.load(), 7);
+
+    // 停止后保持停止状态
+    visited = 0;
+    EXPECT_FALSE(walker.Walk(root, [&visited](const DirectoryEntry&) { ++visited; return true; }));
+    EXPECT_EQ(visited.load(), 0);
+}
+
+// 测试同时遍历多个目录，不可读的目录计入错误
+TEST_F(DirectoryWalkerTest, MultipleRoots) {
+    // 足够多的子目录让各线程互相窃取任务
+    for (int i = 0; i < 64; ++i) {
+        Directory::CreateTree(root / "a" / "b" / std::to_string(i) / "d");
+        File::WriteAllText(root / "a" / "b" / std::to_string(i) / "d" / "f", "12345");
+    }
+
+    DirectoryWalker::Options options;
+    options.threads = 4;
+    DirectoryWalker walker(options);
+
+    std::atomic<uint64_t> files(0), bytes(0);
+    std::vector<Path> roots = { root / "a", root / "c", root / "none" };
+    EXPECT_TRUE(walker.Walk(roots, [&files, &bytes](const DirectoryEntry& entry) {
+        if (entry.IsRegularFile()) {
+            ++files;
+            bytes += entry.size;
+        }
+        return true;
+    }));
+    EXPECT_EQ(files.load(), 67u);
+    EXPECT_EQ(bytes.load(), 64u * 5 + 1 + 2 + 3);
+    EXPECT_EQ(walker.errors(), 1u);
+}
+
+// 测试硬链接计数
+TEST_F(DirectoryWalkerTest, Hardlinks) {
+    Symlink::CreateHardlink(root / "4.txt", root / "c" / "hard.txt");
+
+    auto entry = DirectoryWalker::Stat(root / "c" / "hard.txt");
+    auto origin = DirectoryWalker::Stat(root / "4.txt");
+    EXPECT_EQ(entry.links, 2u);
+    EXPECT_EQ(entry.inode, origin.inode);
+    EXPECT_EQ(entry.device, origin.device);
+}
+
+// 测试不存在的路径
+TEST_F(DirectoryWalkerTest, Missing) {
+    EXPECT_EQ(DirectoryWalker::Stat(root / "none").type, FileType::NONE);
+
+    DirectoryWalker walker;
+    EXPECT_THROW(walker.Walk(root / "none", [](const DirectoryEntry&) { return true; }), FileSystemException);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "trace/metrics.h"
+#include <thread>
+#include <vector>
+
+using namespace BaseKit;
+
+// 测试计数器在多个线程之间累加，线程退出后数值仍保留
+TEST(MetricsTest, CounterAcrossThreads) {
+    size_t id = Metrics::GetInstance().Register("test.counter", MetricKind::COUNTER);
+    EXPECT_EQ(Metrics::GetInstance().Register("test.counter", MetricKind::COUNTER), id);
+
+    uint64_t before = Metrics::GetInstance().counter(id);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([id]() {
+            for (int j = 0; j < 1000; ++j)
+                Metrics::GetInstance().Add(id);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    Metrics::GetInstance().Add(id, 10);
+    EXPECT_EQ(Metrics::GetInstance().counter(id) - before, 4010);
+}
+
+// 测试直方图统计与分位数
+TEST(MetricsTest, Histogram) {
+    size_t id = Metrics::GetInstance().Register("test.histogram", MetricKind::HISTOGRAM);
+
+    for (int i = 0; i < 90; ++i)
+        Metrics::GetInstance().Record(id, 10);
+    for (int i = 0; i < 10; ++i)
+        Metrics::GetInstance().Record(id, 5000);
+
+    auto snapshot = Metrics::GetInstance().histogram(id);
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_EQ(snapshot.sum, 90 * 10 + 10 * 5000);
+    EXPECT_EQ(snapshot.max, 5000);
+    EXPECT_GE(snapshot.Percentile(0.5), 10);
+    EXPECT_LT(snapshot.Percentile(0.5), 16);
+    EXPECT_EQ(snapshot.Percentile(0.99), 5000);
+}
+
+// 测试仪表值保留最大值，以及作用域跟踪与JSON导出
+TEST(MetricsTest, GaugeSpanAndJSON) {
+    size_t gauge = Metrics::GetInstance().Register("test.queue", MetricKind::GAUGE);
+    Metrics::GetInstance().Set(gauge, 8);
+    Metrics::GetInstance().Set(gauge, 3);
+    EXPECT_EQ(Metrics::GetInstance().gauge(gauge), 3);
+    EXPECT_EQ(Metrics::GetInstance().gauge_max(gauge), 8);
+
+    {
+        BASEKIT_TRACE_SPAN("test.span");
+    }
+    size_t span = Metrics::GetInstance().Register("test.span", MetricKind::HISTOGRAM);
+    EXPECT_EQ(Metrics::GetInstance().histogram(span).count, 1);
+
+    std::string json = Metrics::GetInstance().ToJSON();
+    EXPECT_NE(json.find("\"test.queue\":{\"value\":3,\"max\":8}"), std::string::npos);
+    EXPECT_NE(json.find("\"test.span\":{\"count\":1"), std::string::npos);
+
+    Metrics::GetInstance().Reset();
+    EXPECT_EQ(Metrics::GetInstance().histogram(span).count, 0);
+    EXPECT_EQ(Metrics::GetInstance().gauge_max(gauge), 0);
+}
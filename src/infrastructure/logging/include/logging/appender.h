@@ -34,6 +34,21 @@ public:
     */
     virtual void AppendRecord(Record& record) = 0;
 
+    //! Append the given batch of logging records
+    /*!
+         Default behavior of the method will append records one by one.
+         Appenders which can write several records with a single system
+         call should override it.
+
+         \param records - Logging records array
+         \param count - Count of logging records
+    */
+    virtual void AppendRecords(Record* records, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            AppendRecord(records[i]);
+    }
+
     //! Flush the logging appender
     virtual void Flush() {}
 };
@@ -45,6 +45,7 @@ public:
     bool Start() override;
     bool Stop() override;
     void AppendRecord(Record& record) override;
+    void AppendRecords(Record* records, size_t count) override;
     void Flush() override;
 
 private:
@@ -10,6 +10,7 @@
 #include "filesystem/filesystem.h"
 
 #include <memory>
+#include <vector>
 
 namespace Logging {
 
@@ -116,8 +117,19 @@ public:
     bool Start() override;
     bool Stop() override;
     void AppendRecord(Record& record) override;
+    void AppendRecords(Record* records, size_t count) override;
     void Flush() override;
 
+    //! Read the first file stored in the logging backup archive
+    /*!
+         Reads back the content of a backup archived by this appender
+         (e.g. "example.1.log.zip").
+
+         \param path - Archive path
+         \return Content of the archived logging file
+    */
+    static std::vector<uint8_t> ReadArchive(const BaseKit::Path& path);
+
 protected:
     //! Initialize archivation thread handler
     /*!
@@ -14,6 +14,10 @@ namespace Logging {
     Binary layout performs simple memory copy operation to convert
     the given logging record into the plane raw buffer.
 
+    Stored format messages are kept as pattern and serialized arguments,
+    so the text can be rendered later with RestoreRecord() and any text
+    layout (e.g. when reading a binary log file offline).
+
     Thread-safe.
 */
 class BinaryLayout : public Layout
@@ -29,6 +33,15 @@ public:
 
     // Implementation of Layout
     void LayoutRecord(Record& record) override;
+
+    //! Restore the logging record from the binary layout raw buffer
+    /*!
+         \param buffer - Raw buffer started with the record size prefix
+         \param size - Raw buffer size
+         \param record - Logging record to restore
+         \return Count of consumed bytes or 0 if the buffer does not contain a complete record
+    */
+    static size_t RestoreRecord(const uint8_t* buffer, size_t size, Record& record);
 };
 
 } // namespace Logging
@@ -10,25 +10,25 @@ inline TOutputStream& operator<<(TOutputStream& stream, Level level)
     switch (level)
     {
         case Level::NONE:
-            stream << "None";
+            stream << "NONE";
             break;
         case Level::FATAL:
-            stream << "Fatal";
+            stream << "FATAL";
             break;
         case Level::ERROR:
-            stream << "Error";
+            stream << "ERROR";
             break;
         case Level::WARN:
-            stream << "Warn";
+            stream << "WARN";
             break;
         case Level::INFO:
-            stream << "Info";
+            stream << "INFO";
             break;
         case Level::DEBUG:
-            stream << "Debug";
+            stream << "DEBUG";
             break;
         case Level::ALL:
-            stream << "All";
+            stream << "ALL";
             break;
         default:
             stream << "<unknown>";
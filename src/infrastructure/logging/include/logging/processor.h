@@ -91,6 +91,19 @@ public:
     virtual void Flush();
 
 protected:
+    //! Process the given batch of logging records
+    /*!
+         Filters and layouts all records first, then passes the whole batch
+         to every appender (so they can write it at once) and finally
+         processes each record with sub processors.
+
+         Records which were filtered out are moved to the end of the array.
+
+         \param records - Logging records array
+         \param count - Count of logging records
+    */
+    void ProcessBatch(Record* records, size_t count);
+
     std::atomic<bool> _started{true};
     std::shared_ptr<Layout> _layout;
     std::vector<std::shared_ptr<Filter>> _filters;
@@ -10,5 +10,6 @@
 #include "logging/processors/sync_processor.h"
 #include "logging/processors/async_wait_processor.h"
 #include "logging/processors/async_wait_free_processor.h"
+#include "logging/processors/async_fanout_processor.h"
 
 #endif // LOGGING_PROCESSORS_H
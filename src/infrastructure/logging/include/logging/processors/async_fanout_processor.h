@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGING_PROCESSORS_ASYNC_FANOUT_PROCESSOR_H
+#define LOGGING_PROCESSORS_ASYNC_FANOUT_PROCESSOR_H
+
+#include "logging/processors/async_wait_free_processor.h"
+
+namespace Logging {
+
+//! Appender buffer overflow policy
+enum class OverflowPolicy : uint8_t
+{
+    BLOCK,  //!< Block the caller until the appender buffer has a free space
+    DROP,   //!< Drop logging records while the appender buffer is full
+    SAMPLE  //!< Keep only every N-th logging record while the appender buffer is more than half full
+};
+
+//! Asynchronous fan-out logging processor
+/*!
+    Asynchronous fan-out logging processor gives each appender its own
+    bounded buffer and processing thread. A slow appender (e.g. syslog
+    socket or rolling archive) fills only its own buffer and does not
+    stall the others. Each appender has an independent overflow policy
+    and writes records in batches.
+
+    The given logging record is copied into every appender buffer and
+    left untouched, so it can be used by following processors.
+
+    Records lost by OverflowPolicy::DROP or OverflowPolicy::SAMPLE are
+    counted, and once the appender buffer drains below half the appender
+    receives a warning record with the count of lost records. The warning
+    is laid out with the processor layout, so it is only written by
+    appenders which need no layout when the processor has none.
+
+    Appenders must be added with AddAppender() before the processor
+    is started. Appenders added directly into appenders() collection
+    are ignored.
+
+    Thread-safe.
+*/
+class AsyncFanoutProcessor : public Processor
+{
+public:
+    //! Initialize asynchronous fan-out processor with a given layout interface
+    /*!
+         Layout is applied once in the caller thread before the record is copied
+         to appenders. Use empty layout if the record is already laid out by the
+         parent processor.
+
+         \param layout - Logging layout interface
+    */
+    explicit AsyncFanoutProcessor(const std::shared_ptr<Layout>& layout) : Processor(layout) {}
+    AsyncFanoutProcessor(const AsyncFanoutProcessor&) = delete;
+    AsyncFanoutProcessor(AsyncFanoutProcessor&&) = delete;
+    virtual ~AsyncFanoutProcessor();
+
+    AsyncFanoutProcessor& operator=(const AsyncFanoutProcessor&) = delete;
+    AsyncFanoutProcessor& operator=(AsyncFanoutProcessor&&) = delete;
+
+    //! Add the appender with its own buffer and overflow policy
+    /*!
+         \param appender - Logging appender
+         \param policy - Buffer overflow policy (default is OverflowPolicy::DROP)
+         \param capacity - Buffer capacity in logging records, must be a power of two (default is 8192)
+         \param sample - Keep every N-th record with OverflowPolicy::SAMPLE (default is 16)
+    */
+    void AddAppender(const std::shared_ptr<Appender>& appender, OverflowPolicy policy = OverflowPolicy::DROP, size_t capacity = 8192, size_t sample = 16);
+
+    //! Get count of appender channels
+    size_t channels() const noexcept { return _channels.size(); }
+    //! Get statistics of the appender channel with a given index
+    /*!
+         Records thinned out by OverflowPolicy::SAMPLE are counted as dropped.
+
+         \param index - Appender channel index
+         \return Appender channel statistics
+    */
+    AsyncWaitFreeProcessor::Statistics statistics(size_t index) const noexcept;
+
+    // Implementation of Processor
+    bool Start() override;
+    bool Stop() override;
+    bool ProcessRecord(Record& record) override;
+    void Flush() override;
+
+private:
+    struct Channel
+    {
+        std::shared_ptr<AsyncWaitFreeProcessor> processor;
+        OverflowPolicy policy;
+        size_t sample;
+        std::atomic<size_t> counter;
+        std::atomic<uint64_t> sampled;
+        std::atomic<uint64_t> reported;
+    };
+
+    std::vector<std::unique_ptr<Channel>> _channels;
+
+    //! Send the count of records lost since the last report to the appender channel
+    void ReportDropped(Channel& channel, const Record& record);
+};
+
+} // namespace Logging
+
+#endif // LOGGING_PROCESSORS_ASYNC_FANOUT_PROCESSOR_H
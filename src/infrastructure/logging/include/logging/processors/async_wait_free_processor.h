@@ -8,6 +8,7 @@
 #include "logging/processor.h"
 
 #include "logging/processors/async_wait_free_queue.h"
+#include "threads/event_auto_reset.h"
 
 #include <functional>
 
@@ -20,6 +21,10 @@ namespace Logging {
 
     This processor use fixed size async buffer which can overflow.
 
+    The processing thread spins for a short while when the buffer becomes
+    empty and then parks until a producer signals new records. Records are
+    dequeued in batches, so appenders can write a burst at once.
+
     Please note that asynchronous logging processor moves the given
     logging record (ProcessRecord() method always returns false)
     into the buffer!
@@ -29,6 +34,23 @@ namespace Logging {
 class AsyncWaitFreeProcessor : public Processor
 {
 public:
+    //! Asynchronous processor statistics
+    struct Statistics
+    {
+        //! Count of processed logging records
+        uint64_t processed;
+        //! Count of logging records discarded on buffer overflow
+        uint64_t dropped;
+        //! Count of processed batches
+        uint64_t batches;
+        //! Total latency from the record creation till its processing (nanoseconds)
+        uint64_t latency_total;
+        //! Maximal latency from the record creation till its processing (nanoseconds)
+        uint64_t latency_max;
+        //! Count of logging records waiting in the buffer
+        size_t queued;
+    };
+
     //! Initialize asynchronous processor with a given layout interface, overflow policy and buffer capacity
     /*!
          \param layout - Logging layout interface
@@ -52,15 +74,50 @@ public:
     bool ProcessRecord(Record& record) override;
     void Flush() override;
 
+    //! Get the buffer capacity in logging records
+    size_t capacity() const noexcept { return _queue.capacity(); }
+    //! Get the count of logging records waiting in the buffer
+    size_t size() const noexcept { return _queue.size(); }
+
+    //! Get the processor statistics
+    Statistics statistics() const noexcept;
+
 private:
+    //! Count of yields before the processing thread or a blocked producer parks
+    static const size_t SPIN_COUNT = 64;
+    //! Maximal count of logging records processed in one batch
+    static const size_t BATCH_SIZE = 64;
+
     bool _discard;
     AsyncWaitFreeQueue<Record> _queue;
     std::thread _thread;
     std::function<void ()> _on_thread_initialize;
     std::function<void ()> _on_thread_clenup;
 
+    // Processing thread is parked and waits for new records
+    std::atomic<bool> _sleeping{false};
+    BaseKit::EventAutoReset _wakeup;
+    // Count of producers blocked on the full queue
+    std::atomic<size_t> _blocked{0};
+    BaseKit::EventAutoReset _space;
+
+    // Statistics counters, only dropped counter is updated by producers
+    std::atomic<uint64_t> _processed{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _batches{0};
+    std::atomic<uint64_t> _latency_total{0};
+    std::atomic<uint64_t> _latency_max{0};
+
     bool EnqueueRecord(bool discard, Record& record);
     void ProcessThread(const std::function<void ()>& on_thread_initialize, const std::function<void ()>& on_thread_clenup);
+
+    //! Wake up the parked processing thread
+    void WakeupConsumer();
+    //! Park the processing thread until new records arrive or the timeout expires
+    /*!
+         \param timeout - Maximal time to wait (negative value means wait without timeout)
+    */
+    void ParkConsumer(const BaseKit::Timespan& timeout);
 };
 
 } // namespace Logging
@@ -66,6 +66,39 @@ void FileAppender::AppendRecord(Record& record)
     }
 }
 
+void FileAppender::AppendRecords(Record* records, size_t count)
+{
+    // Thread local gather buffers of the logging records batch
+    thread_local std::vector<std::pair<const void*, size_t>> buffers;
+
+    // Skip logging records without layout
+    buffers.clear();
+    for (size_t i = 0; i < count; ++i)
+        if (!records[i].raw.empty())
+            buffers.emplace_back(records[i].raw.data(), records[i].raw.size() - 1);
+
+    if (buffers.empty())
+        return;
+
+    if (PrepareFile())
+    {
+        // Try to write all logging records content into the opened file at once
+        try
+        {
+            _file.WriteVector(buffers.data(), buffers.size());
+
+            // Perform auto-flush if enabled
+            if (_auto_flush)
+                _file.Flush();
+        }
+        catch (const BaseKit::FileSystemException&)
+        {
+            // Try to close the opened file in case of any IO error
+            CloseFile();
+        }
+    }
+}
+
 void FileAppender::Flush()
 {
     if (PrepareFile())
@@ -13,6 +13,7 @@
 #include "utility/resource.h"
 #include "utility/validate_aligned_storage.h"
 
+#include "minizip/unzip.h"
 #include "minizip/zip.h"
 #if defined(_WIN32) || defined(_WIN64)
 #include "minizip/iowin32.h"
@@ -74,6 +75,11 @@ public:
     }
 
     virtual void AppendRecord(Record& record) = 0;
+    virtual void AppendRecords(Record* records, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            AppendRecord(records[i]);
+    }
     virtual void Flush() = 0;
 
 protected:
@@ -1011,6 +1017,56 @@ public:
         }
     }
 
+    void AppendRecords(Record* records, size_t count) override
+    {
+        // Thread local gather buffers of the logging records batch
+        thread_local std::vector<std::pair<const void*, size_t>> buffers;
+
+        size_t index = 0;
+        while (index < count)
+        {
+            // Collect records which fit into the current file size limit
+            size_t total = 0;
+            buffers.clear();
+            for (; index < count; ++index)
+            {
+                // Skip logging records without layout
+                if (records[index].raw.empty())
+                    continue;
+
+                size_t size = records[index].raw.size() - 1;
+                if (!buffers.empty() && ((_written + total + size) > _size))
+                    break;
+
+                buffers.emplace_back(records[index].raw.data(), size);
+                total += size;
+            }
+
+            if (buffers.empty() || !PrepareFile(total))
+                continue;
+
+            // Try to write collected logging records content into the opened file at once
+            try
+            {
+                _file.WriteVector(buffers.data(), buffers.size());
+                _written += total;
+
+                // Perform auto-flush if enabled
+                if (_auto_flush)
+                    _file.Flush();
+            }
+            catch (const BaseKit::FileSystemException&)
+            {
+                // Try to close the opened file in case of any IO error
+                try
+                {
+                    _file.Close();
+                }
+                catch (const BaseKit::FileSystemException&) {}
+            }
+        }
+    }
+
     void Flush() override
     {
         if (FlushFile(0))
@@ -1203,6 +1259,47 @@ bool RollingFileAppender::IsStarted() const noexcept { return impl().IsStarted()
 bool RollingFileAppender::Start() { return impl().Start(); }
 bool RollingFileAppender::Stop() { return impl().Stop(); }
 void RollingFileAppender::AppendRecord(Record& record) { impl().AppendRecord(record); }
+void RollingFileAppender::AppendRecords(Record* records, size_t count) { impl().AppendRecords(records, count); }
 void RollingFileAppender::Flush() { impl().Flush(); }
 
+std::vector<uint8_t> RollingFileAppender::ReadArchive(const BaseKit::Path& path)
+{
+    // Open the zip archive
+    unzFile uf;
+#if defined(_WIN32) || defined(_WIN64)
+    zlib_filefunc64_def ffunc;
+    fill_win32_filefunc64W(&ffunc);
+    uf = unzOpen2_64(path.wstring().c_str(), &ffunc);
+#else
+    uf = unzOpen64(path.string().c_str());
+#endif
+    if (uf == nullptr)
+        throwex BaseKit::FileSystemException("Cannot open a zip archive!").Attach(path);
+
+    // Smart resource cleaner pattern
+    auto unzip = BaseKit::resource(uf, [](unzFile handle) { unzClose(handle); });
+
+    // Open the archived logging file
+    if ((unzGoToFirstFile(uf) != UNZ_OK) || (unzOpenCurrentFile(uf) != UNZ_OK))
+        throwex BaseKit::FileSystemException("Cannot open a file in zip archive!").Attach(path);
+
+    // Smart resource cleaner pattern
+    auto unzip_file = BaseKit::resource(uf, [](unzFile handle) { unzCloseCurrentFile(handle); });
+
+    std::vector<uint8_t> content;
+    uint8_t buffer[16384];
+    int size;
+
+    // Read data from the zip file
+    do
+    {
+        size = unzReadCurrentFile(uf, buffer, (unsigned)BaseKit::countof(buffer));
+        if (size < 0)
+            throwex BaseKit::FileSystemException("Cannot read from the zip file!").Attach(path);
+        content.insert(content.end(), buffer, buffer + size);
+    } while (size > 0);
+
+    return content;
+}
+
 } // namespace Logging
@@ -12,7 +12,7 @@ namespace Logging {
 void BinaryLayout::LayoutRecord(Record& record)
 {
     // Calculate logging record size
-    uint32_t size = (uint32_t)(sizeof(uint64_t) + sizeof(uint64_t) + sizeof(Level) + sizeof(uint8_t) + record.logger.size() + sizeof(uint16_t) + record.message.size() + sizeof(uint32_t) + record.buffer.size());
+    uint32_t size = (uint32_t)(sizeof(uint64_t) + sizeof(uint64_t) + sizeof(Level) + sizeof(uint8_t) + record.logger.size() + sizeof(uint32_t) + record.message.size() + sizeof(uint32_t) + record.buffer.size());
 
     // Resize the raw buffer to the required size
     record.raw.resize(sizeof(uint32_t) + size + 1);
@@ -38,9 +38,9 @@ void BinaryLayout::LayoutRecord(Record& record)
     buffer += record.logger.size();
 
     // Serialize the logging message
-    uint16_t message_size = (uint16_t)record.message.size();
-    std::memcpy(buffer, &message_size, sizeof(uint16_t));
-    buffer += sizeof(uint16_t);
+    uint32_t message_size = (uint32_t)record.message.size();
+    std::memcpy(buffer, &message_size, sizeof(uint32_t));
+    buffer += sizeof(uint32_t);
     std::memcpy(buffer, record.message.data(), record.message.size());
     buffer += record.message.size();
 
@@ -55,4 +55,59 @@ void BinaryLayout::LayoutRecord(Record& record)
     *buffer = 0;
 }
 
+size_t BinaryLayout::RestoreRecord(const uint8_t* buffer, size_t size, Record& record)
+{
+    // Read the logging record size
+    uint32_t record_size;
+    if (size < sizeof(uint32_t))
+        return 0;
+    std::memcpy(&record_size, buffer, sizeof(uint32_t));
+    if ((size - sizeof(uint32_t)) < record_size)
+        return 0;
+
+    const uint8_t* begin = buffer + sizeof(uint32_t);
+    const uint8_t* end = begin + record_size;
+    const uint8_t* current = begin;
+
+    // Deserialize the logging record
+    if ((size_t)(end - current) < (sizeof(uint64_t) + sizeof(uint64_t) + sizeof(Level) + sizeof(uint8_t)))
+        return 0;
+    std::memcpy(&record.timestamp, current, sizeof(uint64_t));
+    current += sizeof(uint64_t);
+    std::memcpy(&record.thread, current, sizeof(uint64_t));
+    current += sizeof(uint64_t);
+    std::memcpy(&record.level, current, sizeof(Level));
+    current += sizeof(Level);
+
+    // Deserialize the logger name
+    uint8_t logger_size;
+    std::memcpy(&logger_size, current, sizeof(uint8_t));
+    current += sizeof(uint8_t);
+    if ((size_t)(end - current) < (logger_size + sizeof(uint32_t)))
+        return 0;
+    record.logger.assign((const char*)current, logger_size);
+    current += logger_size;
+
+    // Deserialize the logging message
+    uint32_t message_size;
+    std::memcpy(&message_size, current, sizeof(uint32_t));
+    current += sizeof(uint32_t);
+    if ((size_t)(end - current) < ((size_t)message_size + sizeof(uint32_t)))
+        return 0;
+    record.message.assign((const char*)current, message_size);
+    current += message_size;
+
+    // Deserialize the logging buffer
+    uint32_t buffer_size;
+    std::memcpy(&buffer_size, current, sizeof(uint32_t));
+    current += sizeof(uint32_t);
+    if ((size_t)(end - current) < buffer_size)
+        return 0;
+    record.buffer.assign(current, current + buffer_size);
+
+    record.raw.clear();
+
+    return sizeof(uint32_t) + record_size;
+}
+
 } // namespace Logging
@@ -120,6 +120,42 @@ bool Processor::ProcessRecord(Record& record)
     return true;
 }
 
+void Processor::ProcessBatch(Record* records, size_t count)
+{
+    // Check if the logging processor started
+    if (!IsStarted())
+        return;
+
+    // Filter and layout the given logging records
+    size_t accepted = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!FilterRecord(records[i]))
+            continue;
+
+        if (_layout && _layout->IsStarted())
+            _layout->LayoutRecord(records[i]);
+
+        if (i != accepted)
+            swap(records[accepted], records[i]);
+        ++accepted;
+    }
+
+    if (accepted == 0)
+        return;
+
+    // Append the given logging records
+    for (auto& appender : _appenders)
+        if (appender && appender->IsStarted())
+            appender->AppendRecords(records, accepted);
+
+    // Process the given logging records with sub processors
+    for (size_t i = 0; i < accepted; ++i)
+        for (auto& processor : _processors)
+            if (processor && processor->IsStarted() && !processor->ProcessRecord(records[i]))
+                break;
+}
+
 void Processor::Flush()
 {
     // Check if the logging processor started
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logging/processors/async_fanout_processor.h"
+
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+namespace Logging {
+
+AsyncFanoutProcessor::~AsyncFanoutProcessor()
+{
+    // Stop the logging processor
+    if (IsStarted())
+        Stop();
+}
+
+void AsyncFanoutProcessor::AddAppender(const std::shared_ptr<Appender>& appender, OverflowPolicy policy, size_t capacity, size_t sample)
+{
+    // Create the appender channel with its own buffer and processing thread
+    auto channel = std::make_unique<Channel>();
+    channel->processor = std::make_shared<AsyncWaitFreeProcessor>(nullptr, false, capacity, (policy != OverflowPolicy::BLOCK));
+    channel->processor->appenders().push_back(appender);
+    channel->policy = policy;
+    channel->sample = (sample > 0) ? sample : 1;
+    channel->counter = 0;
+    channel->sampled = 0;
+    channel->reported = 0;
+    _channels.emplace_back(std::move(channel));
+}
+
+AsyncWaitFreeProcessor::Statistics AsyncFanoutProcessor::statistics(size_t index) const noexcept
+{
+    const Channel& channel = *_channels[index];
+    AsyncWaitFreeProcessor::Statistics result = channel.processor->statistics();
+    result.dropped += channel.sampled.load(std::memory_order_relaxed);
+    return result;
+}
+
+bool AsyncFanoutProcessor::Start()
+{
+    if (!Processor::Start())
+        return false;
+
+    // Start appender channels
+    for (auto& channel : _channels)
+        if (!channel->processor->IsStarted())
+            if (!channel->processor->Start())
+                return false;
+
+    return true;
+}
+
+bool AsyncFanoutProcessor::Stop()
+{
+    // Stop appender channels, all buffered records will be processed
+    for (auto& channel : _channels)
+        if (channel->processor->IsStarted())
+            if (!channel->processor->Stop())
+                return false;
+
+    return Processor::Stop();
+}
+
+bool AsyncFanoutProcessor::ProcessRecord(Record& record)
+{
+    // Check if the logging processor started
+    if (!IsStarted())
+        return true;
+
+    // Filter the given logging record
+    if (!FilterRecord(record))
+        return true;
+
+    // Layout the given logging record
+    if (_layout && _layout->IsStarted())
+        _layout->LayoutRecord(record);
+
+    // Thread local copy of the logging record. Buffers swap their records
+    // with it, so its capacity is reused and no allocation happens later.
+    thread_local Record copy;
+
+    // Copy the given logging record into all appender channels
+    for (auto& channel : _channels)
+    {
+        if (channel->policy == OverflowPolicy::SAMPLE)
+        {
+            // Keep only every N-th record while the buffer is more than half full
+            if ((channel->processor->size() * 2) >= channel->processor->capacity())
+            {
+                if ((channel->counter.fetch_add(1, std::memory_order_relaxed) % channel->sample) != 0)
+                {
+                    channel->sampled.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+            else
+                channel->counter.store(0, std::memory_order_relaxed);
+        }
+
+        copy = record;
+        if (channel->processor->ProcessRecord(copy) && (channel->policy != OverflowPolicy::BLOCK))
+            ReportDropped(*channel, record);
+    }
+
+    // Process the given logging record with sub processors
+    for (auto& processor : _processors)
+        if (processor && processor->IsStarted() && !processor->ProcessRecord(record))
+            return false;
+
+    return true;
+}
+
+void AsyncFanoutProcessor::ReportDropped(Channel& channel, const Record& record)
+{
+    uint64_t lost = channel.processor->statistics().dropped + channel.sampled.load(std::memory_order_relaxed);
+    uint64_t reported = channel.reported.load(std::memory_order_relaxed);
+    if (lost <= reported)
+        return;
+
+    // Report once the buffer has drained, not while the appender is still behind
+    if ((channel.processor->size() * 2) >= channel.processor->capacity())
+        return;
+
+    // Only one producer reports the same records
+    if (!channel.reported.compare_exchange_strong(reported, lost, std::memory_order_relaxed))
+        return;
+
+    Record notice;
+    notice.timestamp = BaseKit::Timestamp::utc();
+    notice.thread = BaseKit::Thread::CurrentThreadId();
+    notice.level = Level::WARN;
+    notice.logger = record.logger;
+    notice.message = "Logging buffer overflow, " + std::to_string(lost - reported) + " records were dropped";
+
+    // Layout the notice like the records of the channel
+    if (_layout && _layout->IsStarted())
+        _layout->LayoutRecord(notice);
+
+    // A lost notice is counted as dropped and reported next time
+    channel.processor->ProcessRecord(notice);
+}
+
+void AsyncFanoutProcessor::Flush()
+{
+    // Check if the logging processor started
+    if (!IsStarted())
+        return;
+
+    // Flush all appender channels
+    for (auto& channel : _channels)
+        channel->processor->Flush();
+
+    Processor::Flush();
+}
+
+} // namespace Logging
@@ -83,16 +83,64 @@ bool AsyncWaitFreeProcessor::EnqueueRecord(bool discard, Record& record)
     {
         // If the overflow policy is discard logging record, return immediately
         if (discard)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
             return false;
+        }
 
-        // If the overflow policy is blocking then yield if the queue is full
-        while (!_queue.Enqueue(record))
-            BaseKit::Thread::Yield();
+        // If the overflow policy is blocking then spin for a while and wait for the free space
+        for (size_t spin = 0; !_queue.Enqueue(record); ++spin)
+        {
+            if (spin < SPIN_COUNT)
+            {
+                BaseKit::Thread::Yield();
+                continue;
+            }
+
+            _blocked.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_queue.size() >= _queue.capacity())
+                _space.TryWaitFor(BaseKit::Timespan::milliseconds(10));
+            _blocked.fetch_sub(1);
+        }
     }
 
+    // Wake up the processing thread if it is parked
+    WakeupConsumer();
+
     return true;
 }
 
+void AsyncWaitFreeProcessor::WakeupConsumer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false))
+        _wakeup.Signal();
+}
+
+void AsyncWaitFreeProcessor::ParkConsumer(const BaseKit::Timespan& timeout)
+{
+    // Spin for a while, records of a burst usually follow each other closely
+    for (size_t spin = 0; spin < SPIN_COUNT; ++spin)
+    {
+        if (!_queue.empty())
+            return;
+        BaseKit::Thread::Yield();
+    }
+
+    // Announce parking and check the queue once again to not miss a record
+    _sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_queue.empty())
+    {
+        if (timeout.total() < 0)
+            _wakeup.Wait();
+        else
+            _wakeup.TryWaitFor(timeout);
+    }
+    _sleeping.store(false);
+}
+
 void AsyncWaitFreeProcessor::ProcessThread(const std::function<void ()>& on_thread_initialize, const std::function<void ()>& on_thread_clenup)
 {
     // Call the thread initialize handler
@@ -102,37 +150,70 @@ void AsyncWaitFreeProcessor::ProcessThread(const std::function<void ()>& on_thre
 
     try
     {
-        // Thread local logger record to process
-        thread_local Record record;
+        // Thread local logger records batch to process
+        thread_local std::vector<Record> batch(BATCH_SIZE);
         thread_local uint64_t previous = BaseKit::Timestamp::utc();
 
+        // Records were appended after the last flush
+        bool dirty = false;
+
         while (_started)
         {
-            // Try to dequeue the next logging record
-            bool empty = !_queue.Dequeue(record);
-
-            // Current timestamp
-            uint64_t current;
+            bool stop = false;
+            bool flush = false;
 
-            if (!empty)
+            // Try to dequeue the next batch of logging records
+            size_t count = 0;
+            while ((count < batch.size()) && _queue.Dequeue(batch[count]))
             {
                 // Handle stop operation record
-                if (record.timestamp == 0)
-                    return;
+                if (batch[count].timestamp == 0)
+                {
+                    stop = true;
+                    break;
+                }
 
                 // Handle flush operation record
-                if (record.timestamp == 1)
+                if (batch[count].timestamp == 1)
                 {
-                    // Flush the logging processor
-                    Processor::Flush();
-                    continue;
+                    flush = true;
+                    break;
                 }
 
-                // Process logging record
-                Processor::ProcessRecord(record);
+                ++count;
+            }
+
+            // Notify producers blocked on the full queue
+            if ((count > 0) && (_blocked.load() > 0))
+                _space.Signal();
 
+            // Current timestamp
+            uint64_t current;
+
+            if (count > 0)
+            {
                 // Update the current timestamp
-                current = record.timestamp;
+                current = batch[count - 1].timestamp;
+
+                // Remember creation timestamps, processing may move records away
+                uint64_t oldest = batch[0].timestamp;
+                uint64_t created = 0;
+                for (size_t i = 0; i < count; ++i)
+                    created += batch[i].timestamp;
+
+                // Process logging records batch
+                Processor::ProcessBatch(batch.data(), count);
+                dirty = true;
+
+                // Update statistics, the first record of the batch waited the longest
+                uint64_t now = BaseKit::Timestamp::utc();
+                uint64_t latency = (now > oldest) ? (now - oldest) : 0;
+                uint64_t latency_total = (now * count > created) ? (now * count - created) : 0;
+                _processed.store(_processed.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+                _batches.store(_batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                _latency_total.store(_latency_total.load(std::memory_order_relaxed) + latency_total, std::memory_order_relaxed);
+                if (latency > _latency_max.load(std::memory_order_relaxed))
+                    _latency_max.store(latency, std::memory_order_relaxed);
             }
             else
             {
@@ -140,19 +221,24 @@ void AsyncWaitFreeProcessor::ProcessThread(const std::function<void ()>& on_thre
                 current = BaseKit::Timestamp::utc();
             }
 
+            if (stop)
+                return;
+
             // Handle auto-flush period
-            if (BaseKit::Timespan((int64_t)(current - previous)).seconds() > 1)
+            if (flush || (dirty && (BaseKit::Timespan((int64_t)(current - previous)).seconds() > 1)))
             {
                 // Flush the logging processor
                 Processor::Flush();
+                dirty = false;
 
                 // Update the previous timestamp
                 previous = current;
             }
 
-            // Sleep for a while if the queue was empty
-            if (empty)
-                BaseKit::Thread::Sleep(100);
+            // Park the processing thread if the queue was empty. Wait without
+            // timeout when there is nothing to flush, so idle thread never wakes up
+            if ((count == 0) && !flush)
+                ParkConsumer(dirty ? BaseKit::Timespan::seconds(2) : BaseKit::Timespan(-1));
         }
     }
     catch (const std::exception& ex)
@@ -170,6 +256,18 @@ void AsyncWaitFreeProcessor::ProcessThread(const std::function<void ()>& on_thre
         on_thread_clenup();
 }
 
+AsyncWaitFreeProcessor::Statistics AsyncWaitFreeProcessor::statistics() const noexcept
+{
+    Statistics result;
+    result.processed = _processed.load(std::memory_order_relaxed);
+    result.dropped = _dropped.load(std::memory_order_relaxed);
+    result.batches = _batches.load(std::memory_order_relaxed);
+    result.latency_total = _latency_total.load(std::memory_order_relaxed);
+    result.latency_max = _latency_max.load(std::memory_order_relaxed);
+    result.queued = _queue.size();
+    return result;
+}
+
 void AsyncWaitFreeProcessor::Flush()
 {
     // Check if the logging processor started
@@ -128,4 +128,47 @@ TEST_CASE("CustomLayout functionality", "[layout]") {
         std::string expected = "FUNCTOR: [ERROR] Error message";
         REQUIRE(result == expected);
     }
-} 
\ No newline at end of file
+} 
+TEST_CASE("Binary Layout round trip", "[layout]") {
+    SECTION("Restore stored format record from binary layout") {
+        auto layout = std::make_shared<BinaryLayout>();
+
+        // 仅保存格式串和原始参数
+        auto record = createTestLayoutRecord(Level::DEBUG, "");
+        record.StoreFormat("progress {} of {}", 42, "file.txt");
+        layout->LayoutRecord(record);
+
+        // 从二进制数据恢复记录
+        Record restored;
+        size_t size = BinaryLayout::RestoreRecord(record.raw.data(), record.raw.size() - 1, restored);
+        REQUIRE(size == record.raw.size() - 1);
+        REQUIRE(restored.timestamp == record.timestamp);
+        REQUIRE(restored.thread == record.thread);
+        REQUIRE(restored.level == Level::DEBUG);
+        REQUIRE(restored.logger == "TestLogger");
+        REQUIRE(restored.RestoreFormat() == "progress 42 of file.txt");
+    }
+
+    SECTION("Incomplete binary record is not restored") {
+        auto layout = std::make_shared<BinaryLayout>();
+
+        auto record = createTestLayoutRecord(Level::INFO, "Truncated message");
+        layout->LayoutRecord(record);
+
+        Record restored;
+        REQUIRE(BinaryLayout::RestoreRecord(record.raw.data(), record.raw.size() / 2, restored) == 0);
+    }
+
+    SECTION("Message longer than 64KB is restored") {
+        auto layout = std::make_shared<BinaryLayout>();
+
+        std::string message(70000, 'x');
+        auto record = createTestLayoutRecord(Level::INFO, message);
+        layout->LayoutRecord(record);
+
+        Record restored;
+        size_t size = BinaryLayout::RestoreRecord(record.raw.data(), record.raw.size() - 1, restored);
+        REQUIRE(size == record.raw.size() - 1);
+        REQUIRE(restored.message == message);
+    }
+}
@@ -5,9 +5,16 @@
 #include <logging/appenders.h>
 #include <logging/filters.h>
 #include <logging/layouts.h>
+#include <filesystem/file.h>
+#include <system/environment.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace Logging;
 
@@ -22,13 +29,6 @@ Record createTestProcessorRecord(Level level, const std::string& message) {
     return record;
 }
 
-// 辅助函数：将Level转换为字符串
-std::string levelToString(const Level& level) {
-    std::ostringstream oss;
-    oss << level;
-    return oss.str();
-}
-
 // 测试用的自定义Appender类
 class TestAppender : public Appender {
 public:
@@ -54,8 +54,8 @@ public:
     virtual ~TestFilter() = default;
     
     bool FilterRecord(Record& record) override {
-        // 只接受INFO及以上级别的记录
-        return record.level >= filterLevel;
+        // 只接受INFO及以上级别的记录（级别越严重数值越小）
+        return record.level <= filterLevel;
     }
     
     Level filterLevel = Level::INFO;
@@ -188,4 +188,172 @@ TEST_CASE("Async Processor", "[processor]") {
         REQUIRE(appender->appendCount == recordCount);
     }
 }
-*/ 
\ No newline at end of file
+*/ 
+TEST_CASE("Async fan-out Processor", "[processor]") {
+    SECTION("Every appender receives its own copy of the record") {
+        auto processor = std::make_shared<AsyncFanoutProcessor>(std::make_shared<TextLayout>());
+
+        auto first = std::make_shared<TestAppender>();
+        auto second = std::make_shared<TestAppender>();
+        processor->AddAppender(first, OverflowPolicy::BLOCK, 64);
+        processor->AddAppender(second, OverflowPolicy::BLOCK, 64);
+        processor->Start();
+
+        const int recordCount = 1000;
+        for (int i = 0; i < recordCount; ++i) {
+            auto testRecord = createTestProcessorRecord(Level::INFO, "Fan-out message " + std::to_string(i));
+            processor->ProcessRecord(testRecord);
+            // 原始记录保持不变，后续处理器仍可使用
+            REQUIRE(testRecord.message == "Fan-out message " + std::to_string(i));
+        }
+
+        // 停止处理器会处理完所有缓冲的记录
+        processor->Stop();
+
+        REQUIRE(first->appendCount == recordCount);
+        REQUIRE(second->appendCount == recordCount);
+        REQUIRE(first->lastRecord.message == "Fan-out message 999");
+        REQUIRE(processor->channels() == 2);
+        REQUIRE(processor->statistics(0).processed == recordCount);
+        REQUIRE(processor->statistics(0).dropped == 0);
+    }
+}
+
+// 记录到达顺序的Appender，由处理线程调用
+class OrderAppender : public Appender {
+public:
+    bool Start() override { return true; }
+    bool Stop() override { return true; }
+    void AppendRecord(Record& record) override {
+        // 第一个记录到达后等待放行，使后续记录在队列中堆积
+        while (hold.load())
+            std::this_thread::yield();
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.push_back(record.message);
+        count.fetch_add(1);
+    }
+
+    bool waitFor(int expected, int ms) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+        while (count.load() < expected) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::atomic<bool> hold{false};
+    std::atomic<int> count{0};
+    std::mutex mutex;
+    std::vector<std::string> messages;
+};
+
+TEST_CASE("Async wait-free Processor", "[processor]") {
+    SECTION("Parked thread wakes up for a new record") {
+        auto processor = std::make_shared<AsyncWaitFreeProcessor>(std::make_shared<TextLayout>(), false);
+        auto appender = std::make_shared<OrderAppender>();
+        processor->appenders().push_back(appender);
+        processor->Start();
+
+        // 空闲的处理线程在没有待刷新数据时无超时挂起，只有生产者能唤醒它
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto testRecord = createTestProcessorRecord(Level::INFO, "Wakeup message");
+        processor->ProcessRecord(testRecord);
+        REQUIRE(appender->waitFor(1, 1000));
+
+        // 再次挂起后同样可以被唤醒
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        testRecord = createTestProcessorRecord(Level::INFO, "Second wakeup message");
+        processor->ProcessRecord(testRecord);
+        REQUIRE(appender->waitFor(2, 1000));
+
+        processor->Stop();
+        REQUIRE(appender->messages == std::vector<std::string>({ "Wakeup message", "Second wakeup message" }));
+    }
+
+    SECTION("Queued records are processed in batches and in order") {
+        auto processor = std::make_shared<AsyncWaitFreeProcessor>(std::make_shared<TextLayout>(), false, 256);
+        auto appender = std::make_shared<OrderAppender>();
+        processor->appenders().push_back(appender);
+        processor->Start();
+
+        appender->hold = true;
+        auto first = createTestProcessorRecord(Level::INFO, "Batch message 0");
+        processor->ProcessRecord(first);
+
+        // 处理线程被第一个记录阻塞时，后续记录在队列中堆积，生产者在队列满时阻塞
+        const int recordCount = 1000;
+        std::thread producer([&processor]() {
+            for (int i = 1; i < recordCount; ++i) {
+                auto testRecord = createTestProcessorRecord(Level::INFO, "Batch message " + std::to_string(i));
+                processor->ProcessRecord(testRecord);
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        appender->hold = false;
+        producer.join();
+
+        processor->Stop();
+
+        REQUIRE(appender->messages.size() == recordCount);
+        for (int i = 0; i < recordCount; ++i)
+            REQUIRE(appender->messages[i] == "Batch message " + std::to_string(i));
+
+        auto statistics = processor->statistics();
+        REQUIRE(statistics.processed == recordCount);
+        REQUIRE(statistics.dropped == 0);
+        REQUIRE(statistics.batches < statistics.processed);
+    }
+
+    SECTION("File appender writes a batch at once in order") {
+        BaseKit::Path path = BaseKit::Path::temp() / BaseKit::Path::unique();
+        {
+            auto processor = std::make_shared<AsyncWaitFreeProcessor>(std::make_shared<TextLayout>("{Message}{EndLine}"), false);
+            processor->appenders().push_back(std::make_shared<FileAppender>(path, true));
+            processor->Start();
+
+            for (int i = 0; i < 500; ++i) {
+                auto testRecord = createTestProcessorRecord(Level::INFO, "File message " + std::to_string(i));
+                processor->ProcessRecord(testRecord);
+            }
+            processor->Stop();
+        }
+
+        std::string expected;
+        for (int i = 0; i < 500; ++i)
+            expected += "File message " + std::to_string(i) + BaseKit::Environment::EndLine();
+        REQUIRE(BaseKit::File::ReadAllText(path) == expected);
+        BaseKit::Path::Remove(path);
+    }
+}
+
+TEST_CASE("Async fan-out Processor overflow", "[processor]") {
+    SECTION("Dropped records are reported once the buffer drains") {
+        auto processor = std::make_shared<AsyncFanoutProcessor>(std::make_shared<TextLayout>());
+        auto appender = std::make_shared<OrderAppender>();
+        processor->AddAppender(appender, OverflowPolicy::DROP, 16);
+        processor->Start();
+
+        // 输出端阻塞时缓冲区很快写满，多余的记录被丢弃
+        appender->hold = true;
+        for (int i = 0; i < 200; ++i) {
+            auto testRecord = createTestProcessorRecord(Level::INFO, "Overflow message " + std::to_string(i));
+            processor->ProcessRecord(testRecord);
+        }
+        appender->hold = false;
+        while (processor->statistics(0).queued > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // 缓冲区清空后的下一条记录之后报告丢弃数量
+        auto testRecord = createTestProcessorRecord(Level::INFO, "After overflow");
+        processor->ProcessRecord(testRecord);
+        processor->Stop();
+
+        uint64_t dropped = processor->statistics(0).dropped;
+        REQUIRE(dropped > 0);
+        REQUIRE(appender->messages.size() == 201 - dropped + 1);
+        REQUIRE(appender->messages[appender->messages.size() - 2] == "After overflow");
+        REQUIRE(appender->messages.back() == "Logging buffer overflow, " + std::to_string(dropped) + " records were dropped");
+    }
+}
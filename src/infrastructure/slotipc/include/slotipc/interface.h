@@ -8,6 +8,9 @@
 #include "argdefine.h"
 
 #include <QObject>
+#include <QVariant>
+
+#include <functional>
 
 #if __cplusplus >= 201402L
 #  define DECL_DEPRECATED(x) [[deprecated(x)]]
@@ -28,6 +31,9 @@ class Q_DECL_EXPORT SlotIPCInterface : public QObject
   Q_OBJECT
 
   public:
+    // Result of an asynchronous call: the returned value, or the error message if ok is false
+    typedef std::function<void(bool ok, const QVariant& result)> CallFinished;
+
     SlotIPCInterface(QObject* parent = 0);
     ~SlotIPCInterface();
 
@@ -85,6 +91,18 @@ class Q_DECL_EXPORT SlotIPCInterface : public QObject
               METHOD_ARG val9 = METHOD_ARG());
 
 
+    quint64 callAsync(const QString& method, const QString& returnType, CallFinished finished,
+              METHOD_ARG val0 = METHOD_ARG(),
+              METHOD_ARG val1 = METHOD_ARG(),
+              METHOD_ARG val2 = METHOD_ARG(),
+              METHOD_ARG val3 = METHOD_ARG(),
+              METHOD_ARG val4 = METHOD_ARG(),
+              METHOD_ARG val5 = METHOD_ARG(),
+              METHOD_ARG val6 = METHOD_ARG(),
+              METHOD_ARG val7 = METHOD_ARG(),
+              METHOD_ARG val8 = METHOD_ARG(),
+              METHOD_ARG val9 = METHOD_ARG());
+
     QString lastError() const;
 
   signals:
@@ -108,6 +126,8 @@ class Q_DECL_EXPORT SlotIPCInterface : public QObject
     Q_PRIVATE_SLOT(d_func(), void _q_setLastError(QString))
     Q_PRIVATE_SLOT(d_func(), void _q_invokeRemoteSignal(QString, SlotIPCMessage::Arguments))
     Q_PRIVATE_SLOT(d_func(), void _q_removeRemoteConnectionsOfObject(QObject*))
+    Q_PRIVATE_SLOT(d_func(), void _q_asyncCallFinished(quint64, bool, QVariant))
+    Q_PRIVATE_SLOT(d_func(), void _q_failPendingCalls())
 };
 
 #endif // INTERFACE_H
@@ -43,7 +43,8 @@
 
 SlotIPCInterfacePrivate::SlotIPCInterfacePrivate()
   : m_workerThread(new QThread),
-    m_worker(new SlotIPCInterfaceWorker)
+    m_worker(new SlotIPCInterfaceWorker),
+    m_nextRequestId(1)
 {
   m_worker->moveToThread(m_workerThread);
   m_workerThread->start();
@@ -82,7 +83,7 @@ bool SlotIPCInterfacePrivate::checkRemoteSlotExistance(const QString& slot)
 {
   DEBUG << "Check remote slot existence" << slot;
   SlotIPCMessage message(SlotIPCMessage::SlotConnectionRequest, slot);
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, m_worker->compactFrames());
   return sendSynchronousRequest(request);
 }
 
@@ -94,7 +95,7 @@ bool SlotIPCInterfacePrivate::sendRemoteConnectRequest(const QString& signalSign
   DEBUG << "Requesting connection to signal" << signalSignature << "Worker connection ID: " << connectionId;
 
   SlotIPCMessage message(SlotIPCMessage::SignalConnectionRequest, signalSignature, Q_ARG(QString, connectionId));
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, m_worker->compactFrames());
 
   return sendSynchronousRequest(request);
 }
@@ -115,7 +116,7 @@ bool SlotIPCInterfacePrivate::sendRemoteDisconnectRequest(const QString& signalS
   SlotIPCMessage::Arguments args;
   args.push_back(genArg);
   SlotIPCMessage message(SlotIPCMessage::SignalConnectionRequest, signalSignature, args, "disconnect");
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, m_worker->compactFrames());
 
   return sendSynchronousRequest(request);
 }
@@ -190,6 +191,31 @@ void SlotIPCInterfacePrivate::_q_setLastError(QString lastError)
 }
 
 
+void SlotIPCInterfacePrivate::_q_asyncCallFinished(quint64 requestId, bool ok, const QVariant& result)
+{
+  SlotIPCInterface::CallFinished finished = m_pendingCalls.take(requestId);
+  if (!ok)
+    m_lastError = result.toString();
+
+  if (finished)
+    finished(ok, result);
+}
+
+
+void SlotIPCInterfacePrivate::_q_failPendingCalls()
+{
+  // The callbacks may start new calls
+  QHash<quint64, SlotIPCInterface::CallFinished> pendingCalls;
+  pendingCalls.swap(m_pendingCalls);
+
+  foreach (const SlotIPCInterface::CallFinished& finished, pendingCalls)
+  {
+    if (finished)
+      finished(false, QString("SlotIPC: The connection was closed before the response"));
+  }
+}
+
+
 void SlotIPCInterfacePrivate::_q_invokeRemoteSignal(const QString& signalSignature, const SlotIPCMessage::Arguments& arguments)
 {
   QList<MethodData> recieversData = m_connections.values(signalSignature);
@@ -307,8 +333,9 @@ bool SlotIPCInterfacePrivate::call(const QString& method,
                           arguments,
                           retType);
     
-    // 序列化并发送请求
-    QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+    // 序列化并发送请求。同步调用每次使用新的连接，未经过共享内存的能力协商，参数内联发送；
+    // 紧凑格式由同一服务端在长连接上确认，服务端收到紧凑帧后同样以紧凑格式应答
+    QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, m_worker->compactFrames());
     DEBUG << "Remote call" << method;
     return sendSynchronousRequest(request, ret);
 }
@@ -327,14 +354,18 @@ SlotIPCInterface::SlotIPCInterface(QObject* parent)
   d->q_ptr = this;
 
   connect(d->m_worker, SIGNAL(disconnected()), SIGNAL(disconnected()));
+  connect(d->m_worker, SIGNAL(disconnected()), SLOT(_q_failPendingCalls()));
   connect(d->m_worker, SIGNAL(setLastError(QString)), SLOT(_q_setLastError(QString)));
   connect(d->m_worker, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)),
           SLOT(_q_invokeRemoteSignal(QString, SlotIPCMessage::Arguments)));
+  connect(d->m_worker, SIGNAL(asyncCallFinished(quint64, bool, QVariant)),
+          SLOT(_q_asyncCallFinished(quint64, bool, QVariant)));
 
   qRegisterMetaType<QGenericReturnArgument>("QGenericReturnArgument");
   qRegisterMetaType<QAbstractSocket::SocketState>("QAbstractSocket::SocketState");
   qRegisterMetaType<SlotIPCMessage::Arguments>("SlotIPCMessage::Arguments");
   qRegisterMetaType<QHostAddress>("QHostAddress");
+  qRegisterMetaType<quint64>("quint64");
 }
 
 
@@ -345,14 +376,18 @@ SlotIPCInterface::SlotIPCInterface(SlotIPCInterfacePrivate& dd, QObject* parent)
   Q_D(SlotIPCInterface);
   d->q_ptr = this;
 
+  connect(d->m_worker, SIGNAL(disconnected()), SLOT(_q_failPendingCalls()));
   connect(d->m_worker, SIGNAL(setLastError(QString)), SLOT(_q_setLastError(QString)));
   connect(d->m_worker, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)),
           SLOT(_q_invokeRemoteSignal(QString, SlotIPCMessage::Arguments)));
+  connect(d->m_worker, SIGNAL(asyncCallFinished(quint64, bool, QVariant)),
+          SLOT(_q_asyncCallFinished(quint64, bool, QVariant)));
 
   qRegisterMetaType<QGenericReturnArgument>("QGenericReturnArgument");
   qRegisterMetaType<QAbstractSocket::SocketState>("QAbstractSocket::SocketState");
   qRegisterMetaType<SlotIPCMessage::Arguments>("SlotIPCMessage::Arguments");
   qRegisterMetaType<QHostAddress>("QHostAddress");
+  qRegisterMetaType<quint64>("quint64");
 }
 
 
@@ -886,12 +921,89 @@ void SlotIPCInterface::callNoReply(const QString& method,
                           val5, val6, val7, val8, val9);
 #endif
 
-    QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+    QByteArray request = SlotIPCMarshaller::marshallMessage(message, d->m_worker->sharesMemory() ? 1 : 0,
+                                                         d->m_worker->compactFrames());
     DEBUG << "Remote call (asynchronous)" << method;
     d->_q_sendAsynchronousRequest(request);
 }
 
 
+/*!
+    Invokes the remote \a method (of the server) without waiting for the result.
+    Returns the id of the request, or 0 if the request could not be sent.
+
+    Unlike call(), the caller is not blocked in an event loop and several calls can
+    be in flight over the connection at once. When the response arrives, \a finished
+    is called in the thread of the interface with the returned value of type
+    \a returnType, which is empty for a method without return value.
+    If the remote call fails or the connection is closed meanwhile, \a finished is called
+    with ok set to false and the error message as the result.
+
+    \note To set arguments, you must enclose them using Q_ARG macro.
+    \note This method doesn't establish the connection to the server, you must use connectToServer() first.
+    \sa call(), callNoReply()
+ */
+quint64 SlotIPCInterface::callAsync(const QString& method, const QString& returnType, CallFinished finished,
+                                    METHOD_ARG val0,
+                                    METHOD_ARG val1,
+                                    METHOD_ARG val2,
+                                    METHOD_ARG val3,
+                                    METHOD_ARG val4,
+                                    METHOD_ARG val5,
+                                    METHOD_ARG val6,
+                                    METHOD_ARG val7,
+                                    METHOD_ARG val8,
+                                    METHOD_ARG val9)
+{
+    Q_D(SlotIPCInterface);
+
+    if (!isConnected())
+    {
+        d->_q_setLastError("SlotIPC: Not connected to the server when the asynchronous method was called");
+        return 0;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    // Qt6: 需要转换参数类型
+    SlotIPCMessage::Arguments arguments;
+    arguments.reserve(10);
+
+    const METHOD_ARG args[] = {
+        val0, val1, val2, val3, val4, val5, val6, val7, val8, val9
+    };
+
+    for(int i = 0; i < 10; ++i) {
+        if(args[i].name) {
+            arguments.append(QGenericArgument(args[i].name, args[i].data));
+        }
+    }
+
+    SlotIPCMessage message(SlotIPCMessage::MessageAsyncCall, method, arguments, returnType);
+#else
+    // Qt5: 直接使用参数
+    SlotIPCMessage message(SlotIPCMessage::MessageAsyncCall, method,
+                          val0, val1, val2, val3, val4,
+                          val5, val6, val7, val8, val9, returnType);
+#endif
+
+    const quint64 requestId = d->m_nextRequestId++;
+    message.setRequestId(requestId);
+
+    QByteArray request = SlotIPCMarshaller::marshallMessage(message, d->m_worker->sharesMemory() ? 1 : 0,
+                                                         d->m_worker->compactFrames());
+    if (request.isEmpty())
+    {
+        d->_q_setLastError("SlotIPC: Failed to serialize the arguments of " + method);
+        return 0;
+    }
+
+    d->m_pendingCalls.insert(requestId, finished);
+    DEBUG << "Remote call (asynchronous with response)" << method << requestId;
+    d->_q_sendAsynchronousRequest(request);
+    return requestId;
+}
+
+
 /*!
     Returns the last occured error.
  */
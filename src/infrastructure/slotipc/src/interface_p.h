@@ -45,6 +45,8 @@ class SlotIPCInterfacePrivate
     void _q_setLastError(QString); //TODO: !!!!!!
     void _q_invokeRemoteSignal(const QString& signalSignature, const SlotIPCMessage::Arguments& arguments);
     void _q_removeRemoteConnectionsOfObject(QObject* destroyedObject);
+    void _q_asyncCallFinished(quint64 requestId, bool ok, const QVariant& result);
+    void _q_failPendingCalls();
 
     bool call(const QString& method, 
               const QGenericReturnArgument& ret,
@@ -61,6 +63,10 @@ class SlotIPCInterfacePrivate
     QPair<QHostAddress, quint16> m_tcpAddress;
 
     QMultiHash<QString, MethodData> m_connections;
+
+    // Asynchronous calls waiting for their response, by request id
+    QHash<quint64, SlotIPCInterface::CallFinished> m_pendingCalls;
+    quint64 m_nextRequestId;
 };
 
 #endif //INTERFACE_P_H
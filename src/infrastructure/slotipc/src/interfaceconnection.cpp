@@ -13,6 +13,10 @@
 #include <QMetaType>
 
 
+// Blocks are fetched in one buffer, large arguments of local peers come in shared memory
+static const quint32 kMaxBlockReserve = 16 * 1024 * 1024;
+
+
 SlotIPCInterfaceConnection::SlotIPCInterfaceConnection(QLocalSocket* socket, QObject* parent)
   : QObject(parent),
     m_socket(socket),
@@ -86,6 +90,7 @@ bool SlotIPCInterfaceConnection::readMessageFromSocket()
       return true;
 
     in >> m_nextBlockSize;
+    m_block.reserve(qMin(m_nextBlockSize, kMaxBlockReserve));
   }
 
   if (in.atEnd())
@@ -133,6 +138,31 @@ bool SlotIPCInterfaceConnection::readMessageFromSocket()
 
         break;
       }
+      case SlotIPCMessage::MessageAsyncResponse:
+      {
+        SlotIPCMessage message = SlotIPCMarshaller::demarshallMessage(m_block);
+        QVariant result;
+        if (!message.arguments().isEmpty())
+        {
+          const QGenericArgument& arg = message.arguments().first();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+          result = QVariant(QMetaType::fromName(arg.name()), arg.data());
+#else
+          result = QVariant(QMetaType::type(arg.name()), arg.data());
+#endif
+        }
+        emit asyncCallFinished(message.requestId(), true, result);
+        SlotIPCMarshaller::freeArguments(message.arguments());
+        break;
+      }
+      case SlotIPCMessage::MessageAsyncError:
+      {
+        SlotIPCMessage message = SlotIPCMarshaller::demarshallMessage(m_block);
+        qWarning() << "SlotIPC:" << "Error:" << message.method();
+        emit asyncCallFinished(message.requestId(), false, message.method());
+        SlotIPCMarshaller::freeArguments(message.arguments());
+        break;
+      }
       case SlotIPCMessage::MessageSignal:
       {
         SlotIPCMessage message = SlotIPCMarshaller::demarshallMessage(m_block);
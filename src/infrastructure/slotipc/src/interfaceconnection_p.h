@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QLocalSocket>
 #include <QTcpSocket>
+#include <QVariant>
 
 
 #include "slotipc/interface.h"
@@ -32,6 +33,7 @@ class SlotIPCInterfaceConnection : public QObject
     void callFinished();
     void socketDisconnected();
     void invokeRemoteSignal(const QString& signalSignature, const SlotIPCMessage::Arguments& arguments);
+    void asyncCallFinished(quint64 requestId, bool ok, const QVariant& result);
     void errorOccured(const QString&);
 
   public slots:
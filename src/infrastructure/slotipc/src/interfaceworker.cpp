@@ -30,6 +30,9 @@ void SlotIPCInterfaceWorker::connectToServer(const QString& name, void* successf
 {
   // TODO: Add checking for existing connection
 
+  m_sharesMemory.storeRelease(0);
+  m_compactFrames.storeRelease(0);
+
   QLocalSocket* socket = new QLocalSocket;
   socket->connectToServer(name);
 
@@ -45,6 +48,8 @@ void SlotIPCInterfaceWorker::connectToServer(const QString& name, void* successf
     m_connection = new SlotIPCInterfaceConnection(socket, this);
     connect(m_connection, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)),
             this, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)));
+    connect(m_connection, SIGNAL(asyncCallFinished(quint64, bool, QVariant)),
+            this, SIGNAL(asyncCallFinished(quint64, bool, QVariant)));
     connect(m_connection, SIGNAL(errorOccured(QString)), this, SIGNAL(setLastError(QString)));
 
     connect(m_connection, SIGNAL(socketDisconnected()), SIGNAL(disconnected()));
@@ -53,22 +58,22 @@ void SlotIPCInterfaceWorker::connectToServer(const QString& name, void* successf
 
     DEBUG << "SlotIPC:" << "Connected:" << name << connected;
 
-    // Register connection ID on the serverside
-    QString id = connectionId();
-    SlotIPCMessage message(SlotIPCMessage::ConnectionInitialize, "", Q_ARG(QString, id));
-    QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+    // Register connection ID on the serverside, offering the capabilities of a local peer
+    SlotIPCHandshake offer;
+    if (SlotIPCSharedMemory::publishProbe(offer.probe))
+      offer.capabilities |= SlotIPCHandshake::SharedMemory;
 
-    DEBUG << "Send connection ID to the server:" << id;
+    SlotIPCHandshake reply;
+    bool ok = initializeConnection(offer, reply);
+    m_sharesMemory.storeRelease(ok && reply.probeRead ? 1 : 0);
 
-    QEventLoop loop;
-    QObject::connect(m_connection, SIGNAL(callFinished()), &loop, SLOT(quit()));
-    QObject::connect(m_connection, SIGNAL(socketDisconnected()), &loop, SLOT(quit()));
-    m_connection->sendCallRequest(request);
-    loop.exec();
+    *reinterpret_cast<bool*>(successful) = connected;
+    emit connectToServerFinished();
 
-    bool ok = m_connection->lastCallSuccessful();
-    if (!ok)
-      qWarning() << "SlotIPC:" << "Error: send connection ID failed. Remote signal connections will be unsuccessful";
+    // The caller does not wait for the probe of the server
+    if (ok && (reply.capabilities & SlotIPCHandshake::SharedMemory))
+      confirmCapabilities(reply);
+    return;
   }
 
   *reinterpret_cast<bool*>(successful) = connected;
@@ -76,8 +81,64 @@ void SlotIPCInterfaceWorker::connectToServer(const QString& name, void* successf
 }
 
 
+bool SlotIPCInterfaceWorker::initializeConnection(SlotIPCHandshake offer, SlotIPCHandshake& reply)
+{
+  offer.capabilities |= SlotIPCHandshake::CompactTypes;
+
+  // Always a legacy frame, the server may not read compact ones
+  QString id = connectionId();
+  QByteArray offerData = offer.toByteArray();
+  SlotIPCMessage message(SlotIPCMessage::ConnectionInitialize, "", Q_ARG(QString, id), Q_ARG(QByteArray, offerData));
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+
+  DEBUG << "Send connection ID to the server:" << id;
+
+  // A server without the handshake answers without a value
+  QByteArray replyData;
+  m_connection->setReturnedObject(QGenericReturnArgument("QByteArray", &replyData));
+
+  QEventLoop loop;
+  QObject::connect(m_connection, SIGNAL(callFinished()), &loop, SLOT(quit()));
+  QObject::connect(m_connection, SIGNAL(socketDisconnected()), &loop, SLOT(quit()));
+  m_connection->sendCallRequest(request);
+  loop.exec();
+
+  bool ok = m_connection && m_connection->lastCallSuccessful();
+  if (m_connection)
+    m_connection->setReturnedObject(QGenericReturnArgument());
+  if (!ok)
+  {
+    qWarning() << "SlotIPC:" << "Error: send connection ID failed. Remote signal connections will be unsuccessful";
+    return false;
+  }
+
+  reply = SlotIPCHandshake::fromByteArray(replyData);
+  m_compactFrames.storeRelease((reply.capabilities & SlotIPCHandshake::CompactTypes) ? 1 : 0);
+  return true;
+}
+
+
+void SlotIPCInterfaceWorker::confirmCapabilities(const SlotIPCHandshake& reply)
+{
+  if (!m_connection)
+    return;
+
+  // The server shares payloads with this connection once it knows they can be read
+  SlotIPCHandshake confirmation;
+  confirmation.probeRead = SlotIPCSharedMemory::readProbe(reply.probe);
+  DEBUG << "Shared memory of the server can be read:" << confirmation.probeRead;
+
+  QByteArray confirmationData = confirmation.toByteArray();
+  SlotIPCMessage message(SlotIPCMessage::ConnectionCapabilities, "", Q_ARG(QByteArray, confirmationData));
+  m_connection->sendCallRequest(SlotIPCMarshaller::marshallMessage(message));
+}
+
+
 void SlotIPCInterfaceWorker::connectToTcpServer(const QHostAddress& host, const quint16 port, void *successful)
 {
+  m_sharesMemory.storeRelease(0);
+  m_compactFrames.storeRelease(0);
+
   QTcpSocket* socket = new QTcpSocket;
   socket->connectToHost(host, port);
   bool connected = socket->waitForConnected(5000);
@@ -92,6 +153,8 @@ void SlotIPCInterfaceWorker::connectToTcpServer(const QHostAddress& host, const
     m_connection = new SlotIPCInterfaceConnection(socket, this);
     connect(m_connection, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)),
             this, SIGNAL(invokeRemoteSignal(QString, SlotIPCMessage::Arguments)));
+    connect(m_connection, SIGNAL(asyncCallFinished(quint64, bool, QVariant)),
+            this, SIGNAL(asyncCallFinished(quint64, bool, QVariant)));
     connect(m_connection, SIGNAL(errorOccured(QString)), this, SIGNAL(setLastError(QString)));
 
     connect(m_connection, SIGNAL(socketDisconnected()), SIGNAL(disconnected()));
@@ -100,22 +163,9 @@ void SlotIPCInterfaceWorker::connectToTcpServer(const QHostAddress& host, const
 
     DEBUG << "SlotIPC:" << "Connected over network:" << host << port << connected;
 
-    // Register connection ID on the serverside
-    QString id = connectionId();
-    SlotIPCMessage message(SlotIPCMessage::ConnectionInitialize, "", Q_ARG(QString, id));
-    QByteArray request = SlotIPCMarshaller::marshallMessage(message);
-
-    DEBUG << "Send connection ID to the server:" << id;
-
-    QEventLoop loop;
-    QObject::connect(m_connection, SIGNAL(callFinished()), &loop, SLOT(quit()));
-    QObject::connect(m_connection, SIGNAL(socketDisconnected()), &loop, SLOT(quit()));
-    m_connection->sendCallRequest(request);
-    loop.exec();
-
-    bool ok = m_connection->lastCallSuccessful();
-    if (!ok)
-      qWarning() << "SlotIPC:" << "Error: send connection ID failed. Remote signal connections will be unsuccessful";
+    // Register connection ID on the serverside, the memory is not shared over network
+    SlotIPCHandshake reply;
+    initializeConnection(SlotIPCHandshake(), reply);
   }
 
   *reinterpret_cast<bool*>(successful) = connected;
@@ -125,6 +175,8 @@ void SlotIPCInterfaceWorker::connectToTcpServer(const QHostAddress& host, const
 
 void SlotIPCInterfaceWorker::disconnectFromServer()
 {
+  m_sharesMemory.storeRelease(0);
+  m_compactFrames.storeRelease(0);
   if (!m_socket)
     return;
 
@@ -139,7 +191,19 @@ void SlotIPCInterfaceWorker::disconnectFromServer()
 
 
 bool SlotIPCInterfaceWorker::isConnected() {
-  return m_connection->isConnected();
+  return m_connection && m_connection->isConnected();
+}
+
+
+bool SlotIPCInterfaceWorker::sharesMemory() const
+{
+  return m_sharesMemory.loadAcquire() != 0;
+}
+
+
+bool SlotIPCInterfaceWorker::compactFrames() const
+{
+  return m_compactFrames.loadAcquire() != 0;
 }
 
 void SlotIPCInterfaceWorker::sendCallRequest(const QByteArray& request)
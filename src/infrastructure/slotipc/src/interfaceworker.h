@@ -5,8 +5,10 @@
 #ifndef INTERFACEWORKER_H
 #define INTERFACEWORKER_H
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QPointer>
+#include <QVariant>
 class QIODevice;
 class QHostAddress;
 
@@ -26,6 +28,11 @@ class SlotIPCInterfaceWorker : public QObject
     ~SlotIPCInterfaceWorker();
 
     bool isConnected();
+    // Whether the server confirmed it reads the shared memory of this process
+    bool sharesMemory() const;
+    // Whether the server announced it reads compact frames
+    bool compactFrames() const;
+
   signals:
     void setLastError(const QString& error);
     void disconnected();
@@ -35,6 +42,7 @@ class SlotIPCInterfaceWorker : public QObject
     void sendConnectionIdFinished();
     void disconnectFromServerFinished();
     void invokeRemoteSignal(const QString& signalSignature, const SlotIPCMessage::Arguments& arguments);
+    void asyncCallFinished(quint64 requestId, bool ok, const QVariant& result);
 
   public slots:
     void connectToServer(const QString& name, void* successful);
@@ -48,9 +56,14 @@ class SlotIPCInterfaceWorker : public QObject
   private:
     void sendRemoteConnectionRequest(const QString& signal);
     void sendSignalDisconnectRequest(const QString& signal);
+    // Sends the connection ID with the offer, false if the server did not answer
+    bool initializeConnection(SlotIPCHandshake offer, SlotIPCHandshake& reply);
+    void confirmCapabilities(const SlotIPCHandshake& reply);
 
     QPointer<SlotIPCInterfaceConnection> m_connection;
     QPointer<QIODevice> m_socket;
+    QAtomicInt m_sharesMemory;
+    QAtomicInt m_compactFrames;
 };
 
 #endif // INTERFACEWORKER_H
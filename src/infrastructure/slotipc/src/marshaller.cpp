@@ -4,6 +4,7 @@
 
 #include "marshaller_p.h"
 #include "message_p.h"
+#include "sharedmemory_p.h"
 
 
 #include <QDataStream>
@@ -15,23 +16,207 @@
 #include <QList>
 #include <QLinkedList>
 #include <QStack>
+#include <QStringList>
 #include <QVector>
 
+#include <limits>
 
-QByteArray SlotIPCMarshaller::marshallMessage(const SlotIPCMessage& message)
+
+// Frames come in two formats, told apart by a flag in the message type.
+//
+// A legacy frame names every argument type with a QString, which all versions of
+// the protocol read. A compact frame only goes to a peer which announced it reads
+// them (SlotIPCHandshake::CompactTypes) or which sent one itself: the method and
+// the return type are UTF-8 bytes, and each argument starts with a 32-bit tag of
+// the type table below, or a tag followed by the type name.
+static const int kCompactFrame = 0x10000;
+
+static const quint32 kTagMask = 0xff000000;
+static const quint32 kTableType = 0xc0000000;
+static const quint32 kNamedType = 0xc1000000;
+// Argument which value is in shared memory, followed by its type and the handle
+static const quint32 kSharedArgument = 0xc2000000;
+// The same in legacy frames, followed by the real type name and the handle
+static const char kSharedArgumentName[] = "SlotIPC::SharedArgument";
+// Byte count of a QImage which pixels are in shared memory, followed by the handle
+static const int kSharedImageData = -1;
+
+// Type tags of compact frames. They are part of the protocol and independent of
+// the QMetaType ids, which differ between Qt 5 and Qt 6: a tag is never changed
+// or reused, a new type gets a new tag. Other types are written by name.
+static const struct
+{
+  quint32 tag;
+  int type;
+} kTypeTable[] = {
+  { 1, QMetaType::Bool },
+  { 2, QMetaType::Int },
+  { 3, QMetaType::UInt },
+  { 4, QMetaType::LongLong },
+  { 5, QMetaType::ULongLong },
+  { 6, QMetaType::Double },
+  { 7, QMetaType::QString },
+  { 8, QMetaType::QByteArray },
+  { 9, QMetaType::QStringList },
+  { 10, QMetaType::QVariant },
+  { 11, QMetaType::QVariantMap },
+  { 12, QMetaType::QVariantList },
+  { 13, QMetaType::QImage }
+};
+
+
+// Size of the values which can be large enough to be shared, 0 for the other types
+static qint64 payloadSize(int type, const void* data)
+{
+  switch (type)
+  {
+    case QMetaType::QByteArray:
+      return static_cast<const QByteArray*>(data)->size();
+    case QMetaType::QString:
+      return static_cast<const QString*>(data)->size() * qint64(sizeof(QChar));
+    case QMetaType::QStringList:
+    {
+      qint64 size = 0;
+      foreach (const QString& item, *static_cast<const QStringList*>(data))
+        size += item.size() * qint64(sizeof(QChar));
+      return size;
+    }
+    default:
+      return 0;
+  }
+}
+
+
+static void writeArgumentType(QDataStream& stream, int type, const char* name, bool compact)
+{
+  if (!compact)
+  {
+    stream << QString::fromLatin1(name);
+    return;
+  }
+
+  for (const auto& entry : kTypeTable)
+  {
+    if (entry.type == type)
+    {
+      stream << (kTableType | entry.tag);
+      return;
+    }
+  }
+  stream << kNamedType << QByteArray::fromRawData(name, int(qstrlen(name)));
+}
+
+
+// Type id of the next argument, 0 if it is unknown
+static int readArgumentType(QDataStream& stream, bool compact, bool* shared = 0)
+{
+  if (!compact)
+  {
+    QString name;
+    stream >> name;
+
+    if (shared)
+    {
+      *shared = (name == QLatin1String(kSharedArgumentName));
+      if (*shared)
+        stream >> name;
+    }
+
+    int type = QMetaType::type(name.toLatin1());
+    if (type == 0)
+      qWarning() << "SlotIPC:" << "Unsupported type of argument" << ":" << name;
+    return type;
+  }
+
+  quint32 tag = 0;
+  stream >> tag;
+
+  if (shared)
+  {
+    *shared = (tag == kSharedArgument);
+    if (*shared)
+      stream >> tag;
+  }
+
+  switch (tag & kTagMask)
+  {
+    case kTableType:
+    {
+      const quint32 index = tag & ~kTagMask;
+      for (const auto& entry : kTypeTable)
+      {
+        if (entry.tag == index)
+          return entry.type;
+      }
+
+      qWarning() << "SlotIPC:" << "Unsupported type tag of argument" << ":" << index;
+      return 0;
+    }
+    case kNamedType:
+    {
+      QByteArray name;
+      stream >> name;
+      int type = QMetaType::type(name.constData());
+      if (type == 0)
+        qWarning() << "SlotIPC:" << "Unsupported type of argument" << ":" << name;
+      return type;
+    }
+    default:
+      qWarning() << "SlotIPC:" << "Invalid argument type tag" << tag;
+      return 0;
+  }
+}
+
+
+// Method and return type, UTF-8 bytes in compact frames
+static void writeText(QDataStream& stream, const QString& text, bool compact)
+{
+  if (compact)
+    stream << text.toUtf8();
+  else
+    stream << text;
+}
+
+
+static QString readText(QDataStream& stream, bool compact)
+{
+  if (!compact)
+  {
+    QString text;
+    stream >> text;
+    return text;
+  }
+
+  QByteArray text;
+  stream >> text;
+  return QString::fromUtf8(text);
+}
+
+
+static void unmapImage(void* info)
+{
+  QPair<uchar*, qint64>* mapping = static_cast<QPair<uchar*, qint64>*>(info);
+  SlotIPCSharedMemory::unmap(mapping->first, mapping->second);
+  delete mapping;
+}
+
+
+QByteArray SlotIPCMarshaller::marshallMessage(const SlotIPCMessage& message, int sharedReaders, bool compact)
 {
   QByteArray result;
   QDataStream stream(&result, QIODevice::WriteOnly);
 
-  stream << message.messageType();
-  stream << message.method();
-  stream << message.returnType();
+  stream << (compact ? int(message.messageType()) | kCompactFrame : int(message.messageType()));
+  if (SlotIPCMessage::hasRequestId(message.messageType()))
+    stream << message.requestId();
+  writeText(stream, message.method(), compact);
+  writeText(stream, message.returnType(), compact);
   stream << (quint32)message.arguments().size();
 
   bool successfullyMarshalled;
   foreach (const auto& arg, message.arguments())
   {
-    successfullyMarshalled = marshallArgumentToStream(arg, stream);
+    successfullyMarshalled = marshallArgumentToStream(arg, stream, sharedReaders, compact);
 
     if (!successfullyMarshalled)
         return QByteArray();
@@ -49,14 +234,16 @@ SlotIPCMessage SlotIPCMarshaller::demarshallMessage(QByteArray& call)
   SlotIPCMessage::MessageType type;
   int buffer;
   stream >> buffer;
-  type = SlotIPCMessage::MessageType(buffer);
+  const bool compact = buffer & kCompactFrame;
+  type = SlotIPCMessage::MessageType(buffer & ~kCompactFrame);
 
-  // Method
-  QString method;
-  stream >> method;
+  quint64 requestId = 0;
+  if (SlotIPCMessage::hasRequestId(type))
+    stream >> requestId;
 
-  QString returnType;
-  stream >> returnType;
+  // Method
+  QString method = readText(stream, compact);
+  QString returnType = readText(stream, compact);
 
   // Arguments
   quint32 argc = 0;
@@ -67,7 +254,7 @@ SlotIPCMessage SlotIPCMarshaller::demarshallMessage(QByteArray& call)
   for (int i = 0; i < argc; ++i)
   {
     bool ok;
-    QGenericArgument argument = demarshallArgumentFromStream(ok, stream);
+    QGenericArgument argument = demarshallArgumentFromStream(ok, stream, compact);
     if (!ok)
     {
       qWarning() << "SlotIPC:" << "Failed to deserialize argument" << i;
@@ -76,7 +263,9 @@ SlotIPCMessage SlotIPCMarshaller::demarshallMessage(QByteArray& call)
     args.append(argument);
   }
 
-  return SlotIPCMessage(type, method, args, returnType);
+  SlotIPCMessage message(type, method, args, returnType);
+  message.setRequestId(requestId);
+  return message;
 }
 
 
@@ -86,7 +275,16 @@ SlotIPCMessage::MessageType SlotIPCMarshaller::demarshallMessageType(QByteArray&
   // Call type
   int buffer;
   stream >> buffer;
-  return SlotIPCMessage::MessageType(buffer);
+  return SlotIPCMessage::MessageType(buffer & ~kCompactFrame);
+}
+
+
+bool SlotIPCMarshaller::isCompactFrame(const QByteArray& message)
+{
+  QDataStream stream(message);
+  int buffer = 0;
+  stream >> buffer;
+  return buffer & kCompactFrame;
 }
 
 
@@ -97,13 +295,11 @@ SlotIPCMessage SlotIPCMarshaller::demarshallResponse(QByteArray& call, QGenericR
   SlotIPCMessage::MessageType type;
   int buffer;
   stream >> buffer;
-  type = SlotIPCMessage::MessageType(buffer);
-
-  QString method;
-  stream >> method;
+  const bool compact = buffer & kCompactFrame;
+  type = SlotIPCMessage::MessageType(buffer & ~kCompactFrame);
 
-  QString returnType;
-  stream >> returnType;
+  QString method = readText(stream, compact);
+  QString returnType = readText(stream, compact);
 
   SlotIPCMessage::Arguments args; //construct message with empty arguments
 
@@ -111,36 +307,19 @@ SlotIPCMessage SlotIPCMarshaller::demarshallResponse(QByteArray& call, QGenericR
   stream >> argc;
   if (argc != 0) // load returned value to the arg (not to the message)
   {
-    QString typeName;
-    stream >> typeName;
+    bool shared = false;
+    int type = readArgumentType(stream, compact, &shared);
 
-    // Check type
-    int type = QMetaType::type(typeName.toLatin1());
-    if (type == 0)
-      qWarning() << "SlotIPC:" << "Unsupported type of argument " << ":" << typeName;
-
-    if (arg.name() && arg.data())
+    if (type != 0 && arg.name() && arg.data())
     {
       if (type != QMetaType::type(arg.name()))
-        qWarning() << "SlotIPC:" << "Type doesn't match:" << typeName << "Expected:" << arg.name();
-
-      bool dataLoaded = false;
-
-      if (type == QMetaType::QImage)
-        dataLoaded = loadQImage(stream, arg.data());
-      else if (type == QMetaType::type("QLinkedList<QImage>"))
-        dataLoaded = loadContainerOfQImages<QLinkedList>(stream, arg.data());
-      else if (type == QMetaType::type("QList<QImage>"))
-        dataLoaded = loadContainerOfQImages<QList>(stream, arg.data());
-      else if (type == QMetaType::type("QStack<QImage>"))
-        dataLoaded = loadContainerOfQImages<QStack>(stream, arg.data());
-      else if (type == QMetaType::type("QVector<QImage>"))
-        dataLoaded = loadContainerOfQImages<QVector>(stream, arg.data());
-      else
-        dataLoaded = QMetaType::load(stream, type, arg.data());
+        qWarning() << "SlotIPC:" << "Type doesn't match:" << QMetaType::typeName(type) << "Expected:" << arg.name();
+
+      bool dataLoaded = shared ? loadSharedArgument(stream, type, arg.data(), compact)
+                               : loadArgument(stream, type, arg.data(), compact);
 
       if (!dataLoaded)
-        qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << typeName;
+        qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << QMetaType::typeName(type);
     }
   }
 
@@ -148,7 +327,7 @@ SlotIPCMessage SlotIPCMarshaller::demarshallResponse(QByteArray& call, QGenericR
 }
 
 
-bool SlotIPCMarshaller::marshallArgumentToStream(QGenericArgument value, QDataStream& stream)
+bool SlotIPCMarshaller::marshallArgumentToStream(QGenericArgument value, QDataStream& stream, int readers, bool compact)
 {
   // Detect and check type
   int type = QMetaType::type(value.name());
@@ -158,17 +337,26 @@ bool SlotIPCMarshaller::marshallArgumentToStream(QGenericArgument value, QDataSt
     return false;
   }
   if (type == QMetaType::QImage)
-    return marshallQImageToStream(value, stream);
-  else if (type == QMetaType::type("QLinkedList<QImage>"))
-    return marshallContainerOfQImagesToStream<QLinkedList>(value, stream);
-  else if (type == QMetaType::type("QList<QImage>"))
-    return marshallContainerOfQImagesToStream<QList>(value, stream);
-  else if (type == QMetaType::type("QStack<QImage>"))
-    return marshallContainerOfQImagesToStream<QStack>(value, stream);
-  else if (type == QMetaType::type("QVector<QImage>"))
-    return marshallContainerOfQImagesToStream<QVector>(value, stream);
-
-  stream << QString::fromLatin1(value.name());
+    return marshallQImageToStream(value, stream, readers, compact);
+
+  // The containers are registered at runtime, builtin types skip the lookups by name
+  if (type >= QMetaType::User)
+  {
+    if (type == QMetaType::type("QLinkedList<QImage>"))
+      return marshallContainerOfQImagesToStream<QLinkedList>(value, stream, readers, compact);
+    else if (type == QMetaType::type("QList<QImage>"))
+      return marshallContainerOfQImagesToStream<QList>(value, stream, readers, compact);
+    else if (type == QMetaType::type("QStack<QImage>"))
+      return marshallContainerOfQImagesToStream<QStack>(value, stream, readers, compact);
+    else if (type == QMetaType::type("QVector<QImage>"))
+      return marshallContainerOfQImagesToStream<QVector>(value, stream, readers, compact);
+  }
+
+  // Falls back to the inline value when the argument is small or sharing fails
+  if (readers > 0 && marshallSharedArgumentToStream(value, type, stream, readers, compact))
+    return true;
+
+  writeArgumentType(stream, type, value.name(), compact);
   bool ok = QMetaType::save(stream, type, value.data());
   if (!ok)
   {
@@ -182,17 +370,13 @@ bool SlotIPCMarshaller::marshallArgumentToStream(QGenericArgument value, QDataSt
 }
 
 
-QGenericArgument SlotIPCMarshaller::demarshallArgumentFromStream(bool& ok, QDataStream& stream)
+QGenericArgument SlotIPCMarshaller::demarshallArgumentFromStream(bool& ok, QDataStream& stream, bool compact)
 {
   // Load type
-  QString typeName;
-  stream >> typeName;
-
-  // Check type
-  int type = QMetaType::type(typeName.toLatin1());
+  bool shared = false;
+  int type = readArgumentType(stream, compact, &shared);
   if (type == 0)
   {
-    qWarning() << "SlotIPC:" << "Unsupported type of argument " << ":" << typeName;
     ok = false;
     return QGenericArgument();
   }
@@ -204,35 +388,94 @@ QGenericArgument SlotIPCMarshaller::demarshallArgumentFromStream(bool& ok, QData
   void* data = QMetaType::construct(type);
 #endif
 
-  bool dataLoaded = false;
-
-  if (type == QMetaType::QImage)
-    dataLoaded = loadQImage(stream, data);
-  else if (type == QMetaType::type("QLinkedList<QImage>"))
-    dataLoaded = loadContainerOfQImages<QLinkedList>(stream, data);
-  else if (type == QMetaType::type("QList<QImage>"))
-    dataLoaded = loadContainerOfQImages<QList>(stream, data);
-  else if (type == QMetaType::type("QStack<QImage>"))
-    dataLoaded = loadContainerOfQImages<QStack>(stream, data);
-  else if (type == QMetaType::type("QVector<QImage>"))
-    dataLoaded = loadContainerOfQImages<QVector>(stream, data);
-  else
-    dataLoaded = QMetaType::load(stream, type, data);
+  bool dataLoaded = shared ? loadSharedArgument(stream, type, data, compact)
+                           : loadArgument(stream, type, data, compact);
 
   if (!dataLoaded)
   {
-    qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << typeName;
+    qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << QMetaType::typeName(type);
     QMetaType::destroy(type, data);
     ok = false;
     return QGenericArgument();
   }
 
+  // The name is owned by the type registry, nothing to copy or free
   ok = true;
-  return QGenericArgument(qstrdup(typeName.toLatin1()), data);
+  return QGenericArgument(QMetaType::typeName(type), data);
+}
+
+
+bool SlotIPCMarshaller::marshallSharedArgumentToStream(QGenericArgument value, int type, QDataStream& stream, int readers,
+                                                       bool compact)
+{
+  if (!SlotIPCSharedMemory::shouldShare(payloadSize(type, value.data())))
+    return false;
+
+  const int version = stream.version();
+  SlotIPCSharedMemory::Handle handle;
+  bool published = SlotIPCSharedMemory::publish([&](QIODevice& device) {
+    QDataStream out(&device);
+    out.setVersion(version);
+    return QMetaType::save(out, type, value.data()) && out.status() == QDataStream::Ok;
+  }, readers, handle);
+
+  if (!published)
+    return false;
+
+  if (compact)
+    stream << kSharedArgument;
+  else
+    stream << QString::fromLatin1(kSharedArgumentName);
+  writeArgumentType(stream, type, value.name(), compact);
+  stream << handle;
+  return true;
+}
+
+
+bool SlotIPCMarshaller::loadArgument(QDataStream& stream, int type, void* data, bool compact)
+{
+  if (type == QMetaType::QImage)
+    return loadQImage(stream, data);
+
+  if (type >= QMetaType::User)
+  {
+    if (type == QMetaType::type("QLinkedList<QImage>"))
+      return loadContainerOfQImages<QLinkedList>(stream, data, compact);
+    else if (type == QMetaType::type("QList<QImage>"))
+      return loadContainerOfQImages<QList>(stream, data, compact);
+    else if (type == QMetaType::type("QStack<QImage>"))
+      return loadContainerOfQImages<QStack>(stream, data, compact);
+    else if (type == QMetaType::type("QVector<QImage>"))
+      return loadContainerOfQImages<QVector>(stream, data, compact);
+  }
+
+  return QMetaType::load(stream, type, data);
+}
+
+
+bool SlotIPCMarshaller::loadSharedArgument(QDataStream& stream, int type, void* data, bool compact)
+{
+  SlotIPCSharedMemory::Handle handle;
+  stream >> handle;
+  if (stream.status() != QDataStream::Ok || handle.size > std::numeric_limits<int>::max())
+    return false;
+
+  uchar* mapped = SlotIPCSharedMemory::map(handle);
+  if (!mapped)
+    return false;
+
+  // The loaded value is a copy, the mapping is released right away
+  QByteArray payload = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), int(handle.size));
+  QDataStream in(payload);
+  in.setVersion(stream.version());
+  bool ok = loadArgument(in, type, data, compact) && in.status() == QDataStream::Ok;
+
+  SlotIPCSharedMemory::unmap(mapped, handle.size);
+  return ok;
 }
 
 
-bool SlotIPCMarshaller::marshallQImageToStream(QGenericArgument value, QDataStream& stream)
+bool SlotIPCMarshaller::marshallQImageToStream(QGenericArgument value, QDataStream& stream, int readers, bool compact)
 {
   QImage* image = static_cast<QImage*>(value.data());
   const uchar* imageData = image->constBits();
@@ -243,7 +486,7 @@ bool SlotIPCMarshaller::marshallQImageToStream(QGenericArgument value, QDataStre
   const int size = image->sizeInBytes();
 #endif
 
-  stream << QString::fromLatin1(value.name());
+  writeArgumentType(stream, QMetaType::QImage, value.name(), compact);
 
   stream << image->width();
   stream << image->height();
@@ -255,6 +498,17 @@ bool SlotIPCMarshaller::marshallQImageToStream(QGenericArgument value, QDataStre
 
   stream << image->colorTable();
 
+  SlotIPCSharedMemory::Handle handle;
+  if (readers > 0 && SlotIPCSharedMemory::shouldShare(size)
+      && SlotIPCSharedMemory::publish([=](QIODevice& device) {
+           return device.write(reinterpret_cast<const char*>(imageData), size) == size;
+         }, readers, handle))
+  {
+    stream << kSharedImageData;
+    stream << handle;
+    return true;
+  }
+
   stream << size;
   stream.writeRawData(reinterpret_cast<const char*>(imageData), size);
 
@@ -263,7 +517,8 @@ bool SlotIPCMarshaller::marshallQImageToStream(QGenericArgument value, QDataStre
 
 
 template <template<class QImage> class Container>
-bool SlotIPCMarshaller::marshallContainerOfQImagesToStream(QGenericArgument value, QDataStream& stream)
+bool SlotIPCMarshaller::marshallContainerOfQImagesToStream(QGenericArgument value, QDataStream& stream, int readers,
+                                                           bool compact)
 {
   const Container<QImage>* imgContainer = static_cast<Container<QImage>*>(value.data());
 
@@ -279,12 +534,12 @@ bool SlotIPCMarshaller::marshallContainerOfQImagesToStream(QGenericArgument valu
     QGenericArgument genArg("QImage", arg.data);
 #endif
 
-    if (!marshallQImageToStream(genArg, dtStream))
+    if (!marshallQImageToStream(genArg, dtStream, readers, compact))
       return false;
     dataContainer << dt;
   }
 
-  stream << QString::fromLatin1(value.name());
+  writeArgumentType(stream, QMetaType::type(value.name()), value.name(), compact);
   stream << dataContainer.size();
   for (typename Container<QByteArray>::iterator it = dataContainer.begin(); it != dataContainer.end(); ++it)
     stream << *it;
@@ -318,6 +573,38 @@ bool SlotIPCMarshaller::loadQImage(QDataStream& stream, void* data)
   int byteCount;
   stream >> byteCount;
 
+  if (byteCount == kSharedImageData)
+  {
+    // The image uses the private mapping of the shared memory, the pixels are not copied
+    SlotIPCSharedMemory::Handle handle;
+    stream >> handle;
+    if (width <= 0 || height <= 0 || bytesPerLine <= 0 || qint64(bytesPerLine) * height > handle.size)
+    {
+      qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << "QImage";
+      return false;
+    }
+
+    uchar* mapped = SlotIPCSharedMemory::map(handle);
+    if (!mapped)
+      return false;
+
+    QPair<uchar*, qint64>* mapping = new QPair<uchar*, qint64>(mapped, handle.size);
+    QImage image(mapped, width, height, bytesPerLine, QImage::Format(format), unmapImage, mapping);
+    if (image.isNull())
+    {
+      unmapImage(mapping);
+      qWarning() << "SlotIPC:" << "Failed to deserialize argument value" << "of type" << "QImage";
+      return false;
+    }
+
+    image.setDotsPerMeterX(dpmX);
+    image.setDotsPerMeterY(dpmY);
+    image.setColorTable(colorTable);
+
+    *static_cast<QImage*>(data) = image;
+    return true;
+  }
+
   uchar* bits = new uchar[byteCount];
   if (stream.readRawData(reinterpret_cast<char*>(bits), byteCount) != byteCount)
   {
@@ -337,7 +624,7 @@ bool SlotIPCMarshaller::loadQImage(QDataStream& stream, void* data)
 
 
 template <template<class QImage> class Container>
-bool SlotIPCMarshaller::loadContainerOfQImages(QDataStream& stream, void* data)
+bool SlotIPCMarshaller::loadContainerOfQImages(QDataStream& stream, void* data, bool compact)
 {
   Container<QByteArray> dataContainer;
   int dataContainerSize = 0;
@@ -357,10 +644,7 @@ bool SlotIPCMarshaller::loadContainerOfQImages(QDataStream& stream, void* data)
     QImage img;
     QDataStream imgStream(&(*it), QIODevice::ReadOnly);
 
-    QString typeName;
-    imgStream >> typeName;
-
-    if (QMetaType::type(typeName.toLatin1()) != QMetaType::QImage)
+    if (readArgumentType(imgStream, compact) != QMetaType::QImage)
       return false;
 
     if (!loadQImage(imgStream, static_cast<void*>(&img)))
@@ -384,8 +668,7 @@ void SlotIPCMarshaller::freeArguments(const SlotIPCMessage::Arguments& args)
 
 void SlotIPCMarshaller::freeArgument(QGenericArgument arg)
 {
+  // Only the value is owned, see SlotIPCMessage::Arguments
   if (arg.data())
     QMetaType::destroy(QMetaType::type(arg.name()), arg.data());
-
-  delete[] arg.name();
 }
@@ -17,28 +17,39 @@
 class SlotIPCMarshaller
 {
   public:
-    static QByteArray marshallMessage(const SlotIPCMessage& message);
+    // sharedReaders: count of local peers receiving the message, large arguments go to
+    // shared memory fetched once by each of them. 0 writes all arguments inline.
+    // compact: every receiver reads compact frames, otherwise the frame names each type
+    static QByteArray marshallMessage(const SlotIPCMessage& message, int sharedReaders = 0, bool compact = false);
     static SlotIPCMessage demarshallMessage(QByteArray& call);
     static SlotIPCMessage demarshallResponse(QByteArray& call, QGenericReturnArgument arg);
 
     static SlotIPCMessage::MessageType demarshallMessageType(QByteArray& message);
+    // Whether the frame is compact, its sender reads compact frames as well
+    static bool isCompactFrame(const QByteArray& message);
 
     static void freeArguments(const SlotIPCMessage::Arguments&);
     static void freeArgument(QGenericArgument);
 
   private:
-    static bool marshallArgumentToStream(QGenericArgument value, QDataStream& stream);
-    static QGenericArgument demarshallArgumentFromStream(bool& ok, QDataStream& stream);
+    static bool marshallArgumentToStream(QGenericArgument value, QDataStream& stream, int readers, bool compact);
+    static QGenericArgument demarshallArgumentFromStream(bool& ok, QDataStream& stream, bool compact);
 
-    static bool marshallQImageToStream(QGenericArgument value, QDataStream& stream);
+    static bool marshallSharedArgumentToStream(QGenericArgument value, int type, QDataStream& stream, int readers,
+                                               bool compact);
+    static bool loadArgument(QDataStream& stream, int type, void* data, bool compact);
+    static bool loadSharedArgument(QDataStream& stream, int type, void* data, bool compact);
+
+    static bool marshallQImageToStream(QGenericArgument value, QDataStream& stream, int readers, bool compact);
 
     template <template<class QImage> class Container>
-    static bool marshallContainerOfQImagesToStream(QGenericArgument value, QDataStream& stream);
+    static bool marshallContainerOfQImagesToStream(QGenericArgument value, QDataStream& stream, int readers,
+                                                   bool compact);
 
     static bool loadQImage(QDataStream& stream, void* data);
 
     template <template<class QImage> class Container>
-    static bool loadContainerOfQImages(QDataStream& stream, void* data);
+    static bool loadContainerOfQImages(QDataStream& stream, void* data, bool compact);
 };
 
 #endif // MARSHALLER_P_H
@@ -5,6 +5,7 @@
 #include "message_p.h"
 
 
+#include <QDataStream>
 #include <QDebug>
 
 SlotIPCMessage::SlotIPCMessage(MessageType type, const QString& method,
@@ -32,9 +33,7 @@ SlotIPCMessage::SlotIPCMessage(MessageType type, const QString& method,
   
   for(int i = 0; i < 10; ++i) {
     if(args[i].name) {
-      // m_arguments.append(args[i]);
-      QGenericArgument arg(qstrdup(args[i].name), args[i].data);
-      m_arguments.append(arg);
+      m_arguments.append(QGenericArgument(args[i].name, args[i].data));
     }
   }
 #else
@@ -87,6 +86,24 @@ const QString& SlotIPCMessage::returnType() const
 }
 
 
+quint64 SlotIPCMessage::requestId() const
+{
+  return m_requestId;
+}
+
+
+void SlotIPCMessage::setRequestId(quint64 requestId)
+{
+  m_requestId = requestId;
+}
+
+
+bool SlotIPCMessage::hasRequestId(MessageType type)
+{
+  return type == MessageAsyncCall || type == MessageAsyncResponse || type == MessageAsyncError;
+}
+
+
 QDebug operator<<(QDebug dbg, const SlotIPCMessage& message)
 {
   QString type;
@@ -119,11 +136,26 @@ QDebug operator<<(QDebug dbg, const SlotIPCMessage& message)
     case SlotIPCMessage::ConnectionInitialize:
       type = "ConnectionInitialize";
       break;
+    case SlotIPCMessage::MessageAsyncCall:
+      type = "AsyncCall";
+      break;
+    case SlotIPCMessage::MessageAsyncResponse:
+      type = "AsyncResponse";
+      break;
+    case SlotIPCMessage::MessageAsyncError:
+      type = "AsyncError";
+      break;
+    case SlotIPCMessage::ConnectionCapabilities:
+      type = "ConnectionCapabilities";
+      break;
     default: break;
   }
 
   dbg.nospace() << "MESSAGE of type: " << type << "  " << "Method: " << message.method();
 
+  if (SlotIPCMessage::hasRequestId(message.messageType()))
+    dbg.nospace() << "  " << "Request: " << message.requestId();
+
   if (message.arguments().length())
   {
     dbg.nospace() << "  " << "Arguments of type: ";
@@ -138,3 +170,40 @@ QDebug operator<<(QDebug dbg, const SlotIPCMessage& message)
 
   return dbg.space();
 }
+
+
+QByteArray SlotIPCHandshake::toByteArray() const
+{
+  QByteArray result;
+  QDataStream stream(&result, QIODevice::WriteOnly);
+  stream << capabilities << probeRead;
+  if (capabilities & SharedMemory)
+    stream << probe;
+  return result;
+}
+
+
+SlotIPCHandshake SlotIPCHandshake::fromByteArray(const QByteArray& data)
+{
+  SlotIPCHandshake handshake;
+  QDataStream stream(data);
+  stream >> handshake.capabilities >> handshake.probeRead;
+  if (handshake.capabilities & SharedMemory)
+    stream >> handshake.probe;
+
+  if (stream.status() != QDataStream::Ok)
+    return SlotIPCHandshake();
+  return handshake;
+}
+
+
+SlotIPCHandshake SlotIPCHandshake::fromArgument(const SlotIPCMessage& message, int index)
+{
+  if (index >= message.arguments().size())
+    return SlotIPCHandshake();
+
+  const QGenericArgument& arg = message.arguments().at(index);
+  if (!arg.data() || qstrcmp(arg.name(), "QByteArray") != 0)
+    return SlotIPCHandshake();
+  return fromByteArray(*static_cast<const QByteArray*>(arg.data()));
+}
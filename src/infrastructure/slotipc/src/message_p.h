@@ -12,12 +12,15 @@
 
 // 添加宏定义
 #include "slotipc/argdefine.h"
+#include "sharedmemory_p.h"
 
 #define DEBUG if (qgetenv("SLOTIPC_DEBUG") == "1") qDebug() << "SlotIPC:"
 
 class SlotIPCMessage
 {
   public:
+    // The arguments own neither their type names nor, until demarshalled, their values:
+    // names are literals, registered type names or buffers which outlive the message
     typedef QList<QGenericArgument> Arguments;
 
     enum MessageType
@@ -30,9 +33,16 @@ class SlotIPCMessage
       SlotConnectionRequest,
       MessageSignal,
       AboutToCloseSocket,
-      ConnectionInitialize
+      ConnectionInitialize,
+      MessageAsyncCall,
+      MessageAsyncResponse,
+      MessageAsyncError,
+      ConnectionCapabilities
     };
 
+    // The asynchronous messages carry the id of their request
+    static bool hasRequestId(MessageType type);
+
     SlotIPCMessage(MessageType type,
                    const QString& method = QString(),
                    METHOD_ARG val0 = METHOD_ARG(),
@@ -56,14 +66,46 @@ class SlotIPCMessage
     const QString& returnType() const;
     const Arguments& arguments() const;
 
+    quint64 requestId() const;
+    void setRequestId(quint64 requestId);
+
   private:
     QString m_method;
     Arguments m_arguments;
     MessageType m_messageType;
     QString m_returnType;
+    quint64 m_requestId = 0;
 };
 
 QDebug operator<<(QDebug dbg, const SlotIPCMessage& message);
 
 
+// Capabilities exchanged when a connection is initialized.
+//
+// The client offers them with ConnectionInitialize, the server answers in the
+// response and the client confirms with ConnectionCapabilities. Peers without
+// the handshake send none of these, so a feature is used in a direction only
+// after the reader of that direction confirmed it.
+struct SlotIPCHandshake
+{
+  enum Capability
+  {
+    // Large arguments in shared memory, the probe is a payload to read
+    SharedMemory = 0x1,
+    // Compact frames, see marshaller.cpp
+    CompactTypes = 0x2
+  };
+
+  quint32 capabilities = 0;
+  // The probe offered by the other side was read
+  bool probeRead = false;
+  SlotIPCSharedMemory::Handle probe;
+
+  QByteArray toByteArray() const;
+  static SlotIPCHandshake fromByteArray(const QByteArray& data);
+  // The handshake carried as QByteArray argument index of message, empty if there is none
+  static SlotIPCHandshake fromArgument(const SlotIPCMessage& message, int index);
+};
+
+
 #endif // MESSAGE_P_H
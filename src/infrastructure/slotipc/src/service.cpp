@@ -179,7 +179,13 @@ void SlotIPCServicePrivate::_q_initializeConnection(QString connectionId, QObjec
 {
   SlotIPCServiceConnection* senderConnection = qobject_cast<SlotIPCServiceConnection*>(sender);
   m_longLivedConnections.insert(connectionId, sender);
-  senderConnection->sendResponseMessage("connectionInitialize_" + connectionId);
+
+  // A client without the handshake expects a response without value
+  QByteArray reply = senderConnection->handshakeReply();
+  if (reply.isEmpty())
+    senderConnection->sendResponseMessage("connectionInitialize_" + connectionId);
+  else
+    senderConnection->sendResponseMessage("connectionInitialize_" + connectionId, QGenericArgument("QByteArray", &reply));
 }
 
 
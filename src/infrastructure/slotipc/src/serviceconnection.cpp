@@ -11,14 +11,80 @@
 #include <QDataStream>
 #include <QTime>
 #include <QMetaType>
+#include <QMutex>
+#include <QPair>
+#include <QRunnable>
+#include <QThreadPool>
+
+
+// Blocks are fetched in one buffer, large arguments of local peers come in shared memory
+static const quint32 kMaxBlockReserve = 16 * 1024 * 1024;
+
+
+// State shared with the demarshalling tasks, which may outlive the connection
+struct SlotIPCDemarshalling
+{
+  QMutex mutex;
+  // 0 once the connection is destroyed
+  SlotIPCServiceConnection* connection = 0;
+  // Demarshalled messages, with whether the probe offered in them was read
+  QList<QPair<SlotIPCMessage, bool> > messages;
+};
+
+
+namespace
+{
+  class DemarshallTask : public QRunnable
+  {
+    public:
+      DemarshallTask(const QSharedPointer<SlotIPCDemarshalling>& state, const QByteArray& block)
+        : m_state(state),
+          m_block(block)
+      {}
+
+      void run() override
+      {
+        SlotIPCMessage message = SlotIPCMarshaller::demarshallMessage(m_block);
+
+        // A client which offers shared memory can use it if this process reads its probe
+        bool probeRead = false;
+        if (message.messageType() == SlotIPCMessage::ConnectionInitialize)
+        {
+          SlotIPCHandshake offer = SlotIPCHandshake::fromArgument(message, 1);
+          probeRead = (offer.capabilities & SlotIPCHandshake::SharedMemory)
+                      && SlotIPCSharedMemory::readProbe(offer.probe);
+        }
+
+        QMutexLocker locker(&m_state->mutex);
+        if (!m_state->connection)
+        {
+          SlotIPCMarshaller::freeArguments(message.arguments());
+          return;
+        }
+
+        m_state->messages.append(qMakePair(message, probeRead));
+        QMetaObject::invokeMethod(m_state->connection, "processDemarshalled", Qt::QueuedConnection);
+      }
+
+    private:
+      QSharedPointer<SlotIPCDemarshalling> m_state;
+      QByteArray m_block;
+  };
+}
 
 
 SlotIPCServiceConnection::SlotIPCServiceConnection(QLocalSocket* socket, SlotIPCService* parent)
   : QObject(parent),
     m_socket(socket),
     m_nextBlockSize(0),
-    m_subject(0)
+    m_subject(0),
+    m_requestId(0),
+    m_demarshalling(new SlotIPCDemarshalling),
+    m_demarshallingBlock(false),
+    m_readsShared(false)
 {
+  m_demarshalling->connection = this;
+
   // Delete connection after the socket have been disconnected
   connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
   connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
@@ -52,8 +118,14 @@ SlotIPCServiceConnection::SlotIPCServiceConnection(QTcpSocket* socket, SlotIPCSe
   : QObject(parent),
     m_socket(socket),
     m_nextBlockSize(0),
-    m_subject(0)
+    m_subject(0),
+    m_requestId(0),
+    m_demarshalling(new SlotIPCDemarshalling),
+    m_demarshallingBlock(false),
+    m_readsShared(false)
 {
+  m_demarshalling->connection = this;
+
   // Delete connection after the socket have been disconnected
   connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
   connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
@@ -81,7 +153,13 @@ SlotIPCServiceConnection::SlotIPCServiceConnection(QTcpSocket* socket, SlotIPCSe
 
 
 SlotIPCServiceConnection::~SlotIPCServiceConnection()
-{}
+{
+  QMutexLocker locker(&m_demarshalling->mutex);
+  m_demarshalling->connection = 0;
+  for (int i = 0; i < m_demarshalling->messages.size(); ++i)
+    SlotIPCMarshaller::freeArguments(m_demarshalling->messages.at(i).first.arguments());
+  m_demarshalling->messages.clear();
+}
 
 
 void SlotIPCServiceConnection::setSubject(QObject* subject)
@@ -90,6 +168,30 @@ void SlotIPCServiceConnection::setSubject(QObject* subject)
 }
 
 
+bool SlotIPCServiceConnection::isLocal() const
+{
+  return qobject_cast<QLocalSocket*>(m_socket) != 0;
+}
+
+
+bool SlotIPCServiceConnection::sharesMemory() const
+{
+  return m_sharesMemory.loadAcquire() != 0;
+}
+
+
+bool SlotIPCServiceConnection::compactFrames() const
+{
+  return m_compactFrames.loadAcquire() != 0;
+}
+
+
+QByteArray SlotIPCServiceConnection::handshakeReply() const
+{
+  return m_handshakeReply;
+}
+
+
 void SlotIPCServiceConnection::readyRead()
 {
   bool messageStreamFinished;
@@ -112,6 +214,7 @@ bool SlotIPCServiceConnection::readMessageFromSocket()
       return true;
 
     in >> m_nextBlockSize;
+    m_block.reserve(qMin(m_nextBlockSize, kMaxBlockReserve));
   }
 
   if (in.atEnd())
@@ -122,7 +225,7 @@ bool SlotIPCServiceConnection::readMessageFromSocket()
 
   if (m_block.size() == (int)m_nextBlockSize)
   {
-    processMessage();
+    processBlock(m_block);
 
     // Cleanup
     m_nextBlockSize = 0;
@@ -135,20 +238,78 @@ bool SlotIPCServiceConnection::readMessageFromSocket()
 }
 
 
-void SlotIPCServiceConnection::processMessage()
+void SlotIPCServiceConnection::processBlock(const QByteArray& block)
+{
+  QByteArray data = block;
+
+  // A synchronous call comes on a connection of its own, its frame tells how to answer
+  if (SlotIPCMarshaller::isCompactFrame(data))
+    m_compactFrames.storeRelease(1);
+
+  // Only a client which read the probe sends shared memory, the offered probe is read in the pool too
+  bool fetchesShared = m_readsShared
+      || (isLocal() && SlotIPCMarshaller::demarshallMessageType(data) == SlotIPCMessage::ConnectionInitialize);
+
+  if (fetchesShared || m_demarshallingBlock || !m_pendingBlocks.isEmpty())
+  {
+    m_pendingBlocks.enqueue(data);
+    demarshallNext();
+    return;
+  }
+
+  processMessage(SlotIPCMarshaller::demarshallMessage(data), false);
+}
+
+
+void SlotIPCServiceConnection::demarshallNext()
+{
+  if (m_demarshallingBlock || m_pendingBlocks.isEmpty())
+    return;
+
+  m_demarshallingBlock = true;
+  QThreadPool::globalInstance()->start(new DemarshallTask(m_demarshalling, m_pendingBlocks.dequeue()));
+}
+
+
+void SlotIPCServiceConnection::processDemarshalled()
+{
+  QList<QPair<SlotIPCMessage, bool> > messages;
+  {
+    QMutexLocker locker(&m_demarshalling->mutex);
+    messages.swap(m_demarshalling->messages);
+  }
+  if (messages.isEmpty())
+    return;
+
+  // The invoked method may spin an event loop, the next block is demarshalled meanwhile
+  m_demarshallingBlock = false;
+  demarshallNext();
+
+  for (int i = 0; i < messages.size(); ++i)
+    processMessage(messages.at(i).first, messages.at(i).second);
+}
+
+
+void SlotIPCServiceConnection::processMessage(const SlotIPCMessage& call, bool probeRead)
 {
-  SlotIPCMessage call = SlotIPCMarshaller::demarshallMessage(m_block);
   SlotIPCMessage::MessageType messageType = call.messageType();
   DEBUG << call;
 
   QObject* subject = m_subject ? m_subject : parent();
 
+  // An asynchronous call is answered like a call with return, tagged with its request
+  const bool withReturn = messageType == SlotIPCMessage::MessageCallWithReturn
+                          || messageType == SlotIPCMessage::MessageAsyncCall;
+  // The invoked method may spin an event loop and process another message meanwhile
+  const quint64 outerRequestId = m_requestId;
+  m_requestId = messageType == SlotIPCMessage::MessageAsyncCall ? call.requestId() : 0;
+
   // Fill empty args
   SlotIPCMessage::Arguments args = call.arguments();
   while (args.size() < 10)
     args.append(QGenericArgument());
 
-  if (messageType == SlotIPCMessage::MessageCallWithReturn && !call.returnType().isEmpty())
+  if (withReturn && !call.returnType().isEmpty())
   {
     int retType = QMetaType::type(call.returnType().toLatin1());
     if (retType > 0)
@@ -184,7 +345,7 @@ void SlotIPCServiceConnection::processMessage()
       sendErrorMessage(error);
     }
   }
-  else if ((messageType == SlotIPCMessage::MessageCallWithReturn && call.returnType().isEmpty())
+  else if ((withReturn && call.returnType().isEmpty())
            || messageType == SlotIPCMessage::MessageCallWithoutReturn)
   {
     bool successfulInvoke = QMetaObject::invokeMethod(subject, call.method().toLatin1(),
@@ -196,7 +357,7 @@ void SlotIPCServiceConnection::processMessage()
     }
     else
     {
-      if (messageType == SlotIPCMessage::MessageCallWithReturn)
+      if (withReturn)
         sendResponseMessage(call.method());
     }
   }
@@ -240,21 +401,47 @@ void SlotIPCServiceConnection::processMessage()
     void* connectionId = QMetaType::construct(QMetaType::QString, args.at(0).data());
 #endif
 
+    // A client with the handshake offers its capabilities, the reply goes with the response
+    m_readsShared = probeRead;
+    if (call.arguments().size() > 1)
+    {
+      SlotIPCHandshake offer = SlotIPCHandshake::fromArgument(call, 1);
+      if (offer.capabilities & SlotIPCHandshake::CompactTypes)
+        m_compactFrames.storeRelease(1);
+
+      SlotIPCHandshake reply;
+      reply.capabilities |= SlotIPCHandshake::CompactTypes;
+      reply.probeRead = probeRead;
+      if (isLocal() && SlotIPCSharedMemory::publishProbe(reply.probe))
+        reply.capabilities |= SlotIPCHandshake::SharedMemory;
+      m_handshakeReply = reply.toByteArray();
+    }
+    DEBUG << "Shared memory of the client can be read:" << probeRead;
+
     emit connectionInitializeRequest(*((QString*)(connectionId)), this);
 
     QMetaType::destroy(QMetaType::QString, connectionId);
   }
+  else if (messageType == SlotIPCMessage::ConnectionCapabilities)
+  {
+    // The client read the probe of the reply, large arguments may go to it in shared memory
+    SlotIPCHandshake confirmation = SlotIPCHandshake::fromArgument(call, 0);
+    m_sharesMemory.storeRelease(confirmation.probeRead ? 1 : 0);
+    DEBUG << "Shared memory can be read by the client:" << confirmation.probeRead;
+  }
 
 
   // Cleanup
+  m_requestId = outerRequestId;
   SlotIPCMarshaller::freeArguments(call.arguments());
 }
 
 
 void SlotIPCServiceConnection::sendErrorMessage(const QString& error)
 {
-  SlotIPCMessage message(SlotIPCMessage::MessageError, error);
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  SlotIPCMessage message(m_requestId ? SlotIPCMessage::MessageAsyncError : SlotIPCMessage::MessageError, error);
+  message.setRequestId(m_requestId);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, compactFrames());
   sendResponse(request);
   qWarning() << "SlotIPC:" << "Error message was sent:" << error;
 }
@@ -264,8 +451,9 @@ void SlotIPCServiceConnection::sendResponseMessage(const QString& method, QGener
 {
   SlotIPCMessage::Arguments args;
   if (arg.name()) args.push_back(arg);
-  SlotIPCMessage message(SlotIPCMessage::MessageResponse, method, args);
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  SlotIPCMessage message(m_requestId ? SlotIPCMessage::MessageAsyncResponse : SlotIPCMessage::MessageResponse, method, args);
+  message.setRequestId(m_requestId);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, sharesMemory() ? 1 : 0, compactFrames());
 
   sendResponse(request);
   //  qDebug() << "Returned value was sent";
@@ -275,7 +463,7 @@ void SlotIPCServiceConnection::sendResponseMessage(const QString& method, QGener
 void SlotIPCServiceConnection::sendAboutToQuit()
 {
   SlotIPCMessage message(SlotIPCMessage::AboutToCloseSocket);
-  QByteArray request = SlotIPCMarshaller::marshallMessage(message);
+  QByteArray request = SlotIPCMarshaller::marshallMessage(message, 0, compactFrames());
 
   DEBUG << "Send aboutToClose notification";
 
@@ -6,12 +6,17 @@
 #define SERVICECONNECTION_P_H
 
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QLocalSocket>
+#include <QQueue>
+#include <QSharedPointer>
 class QTcpSocket;
 
 
 #include "slotipc/service.h"
+#include "message_p.h"
+struct SlotIPCDemarshalling;
 
 
 class SlotIPCServiceConnection : public QObject
@@ -24,6 +29,13 @@ class SlotIPCServiceConnection : public QObject
 
     ~SlotIPCServiceConnection();
     void setSubject(QObject* subject);
+    bool isLocal() const;
+    // Whether the client confirmed it reads the shared memory of this process
+    bool sharesMemory() const;
+    // Whether the client reads compact frames, it announced it or sent one
+    bool compactFrames() const;
+    // Answer to the capabilities offered by the client, empty if it offered none
+    QByteArray handshakeReply() const;
 
   signals:
     void signalRequest(QString signalSignature, const QString& connectionId, QObject* sender);
@@ -42,14 +54,33 @@ class SlotIPCServiceConnection : public QObject
     void sendResponseMessage(const QString& method, QGenericArgument arg = QGenericArgument());
     void sendAboutToQuit();
 
+  private slots:
+    void processDemarshalled();
+
   private:
     QIODevice* m_socket;
 
     quint32 m_nextBlockSize;
     QByteArray m_block;
     QObject* m_subject;
-
-    void processMessage();
+    // Request of the asynchronous call being processed, 0 for the other messages
+    quint64 m_requestId;
+
+    // Messages which may carry shared memory are demarshalled in the thread pool,
+    // fetching the payloads does not block the thread of the connection. Blocks
+    // wait in m_pendingBlocks meanwhile, messages are processed in order
+    QSharedPointer<SlotIPCDemarshalling> m_demarshalling;
+    QQueue<QByteArray> m_pendingBlocks;
+    bool m_demarshallingBlock;
+    // The probe of the client was read, it may send arguments in shared memory
+    bool m_readsShared;
+    QAtomicInt m_sharesMemory;
+    QAtomicInt m_compactFrames;
+    QByteArray m_handshakeReply;
+
+    void processBlock(const QByteArray& block);
+    void demarshallNext();
+    void processMessage(const SlotIPCMessage& call, bool probeRead);
     bool readMessageFromSocket();
 
     void sendResponse(const QByteArray& response);
@@ -0,0 +1,472 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sharedmemory_p.h"
+#include "message_p.h"
+
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <QHash>
+#include <QMutex>
+#include <QRandomGenerator>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef Q_OS_LINUX
+
+namespace
+{
+  // Smaller payloads are cheaper to copy through the socket
+  const qint64 kThreshold = 64 * 1024;
+  // Seconds a published payload waits for its readers. The readers confirmed they
+  // can fetch it, the limit only matters for a reader which is gone or stuck
+  const int kLifetime = 30;
+  // Bytes of the payloads waiting for their readers
+  const qint64 kMaxRetained = 128 * 1024 * 1024;
+  // Seconds a descriptor request may take
+  const int kRequestTimeout = 2;
+
+  const int kSeals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+  const char kProbe[] = "slotipc";
+
+  typedef std::chrono::steady_clock Clock;
+
+
+  socklen_t serverAddress(qint64 pid, sockaddr_un& address)
+  {
+    // Abstract name, nothing is left in the file system on exit
+    QByteArray name = "slotipc-shm-" + QByteArray::number(pid);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path + 1, name.constData(), size_t(name.size()));
+    return socklen_t(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+  }
+
+
+  // Only processes of the same user may exchange payloads
+  bool isTrustedPeer(int fd, qint64 pid)
+  {
+    ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0)
+      return false;
+
+    return credentials.uid == geteuid() && (pid == 0 || credentials.pid == pid);
+  }
+
+
+  void setTimeout(int fd)
+  {
+    timeval timeout = { kRequestTimeout, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  }
+
+
+  // Hands out the published descriptors of this process by token.
+  // Created on the first shared payload, it lives until the process exits.
+  class DescriptorServer
+  {
+    public:
+      static DescriptorServer* instance()
+      {
+        static DescriptorServer* server = new DescriptorServer;
+        return server;
+      }
+
+      bool isListening() const
+      {
+        return m_fd >= 0;
+      }
+
+      bool hasRoom(qint64 size)
+      {
+        QMutexLocker locker(&m_mutex);
+        return m_retained + size <= kMaxRetained;
+      }
+
+      // False if the retained payloads would exceed the cap, fd is not taken then
+      bool publish(quint64 token, int fd, qint64 size, int readers)
+      {
+        QMutexLocker locker(&m_mutex);
+        if (m_retained + size > kMaxRetained)
+          return false;
+
+        m_retained += size;
+        m_entries.insert(token, Entry { fd, size, readers, Clock::now() + std::chrono::seconds(kLifetime) });
+        return true;
+      }
+
+    private:
+      struct Entry
+      {
+        int fd;
+        qint64 size;
+        int readers;
+        Clock::time_point deadline;
+      };
+
+      DescriptorServer()
+      {
+        m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_fd < 0)
+          return;
+
+        sockaddr_un address;
+        socklen_t length = serverAddress(getpid(), address);
+        if (bind(m_fd, reinterpret_cast<sockaddr*>(&address), length) != 0 || ::listen(m_fd, 16) != 0)
+        {
+          qWarning() << "SlotIPC:" << "Failed to start the shared memory server:" << strerror(errno);
+          close(m_fd);
+          m_fd = -1;
+          return;
+        }
+
+        std::thread(&DescriptorServer::run, this).detach();
+      }
+
+      void run()
+      {
+        pollfd listening = { m_fd, POLLIN, 0 };
+        for (;;)
+        {
+          int ready = poll(&listening, 1, 1000);
+          expire();
+          if (ready <= 0)
+            continue;
+
+          int client = accept4(m_fd, 0, 0, SOCK_CLOEXEC);
+          if (client < 0)
+            continue;
+
+          setTimeout(client);
+          serve(client);
+          close(client);
+        }
+      }
+
+      void serve(int client)
+      {
+        if (!isTrustedPeer(client, 0))
+        {
+          qWarning() << "SlotIPC:" << "Shared memory request of another user was refused";
+          return;
+        }
+
+        quint64 token = 0;
+        if (recv(client, &token, sizeof(token), MSG_WAITALL) != ssize_t(sizeof(token)))
+          return;
+
+        // Entries are only closed by this thread, the descriptor stays valid after unlocking
+        int fd = -1;
+        {
+          QMutexLocker locker(&m_mutex);
+          auto it = m_entries.constFind(token);
+          if (it != m_entries.constEnd())
+            fd = it->fd;
+        }
+
+        char status = fd >= 0 ? 1 : 0;
+        iovec data = { &status, sizeof(status) };
+        union
+        {
+          cmsghdr header;
+          char buffer[CMSG_SPACE(sizeof(int))];
+        } control;
+
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        if (fd >= 0)
+        {
+          memset(&control, 0, sizeof(control));
+          message.msg_control = control.buffer;
+          message.msg_controllen = sizeof(control.buffer);
+
+          cmsghdr* header = CMSG_FIRSTHDR(&message);
+          header->cmsg_level = SOL_SOCKET;
+          header->cmsg_type = SCM_RIGHTS;
+          header->cmsg_len = CMSG_LEN(sizeof(int));
+          memcpy(CMSG_DATA(header), &fd, sizeof(int));
+        }
+
+        if (sendmsg(client, &message, MSG_NOSIGNAL) < 0)
+        {
+          DEBUG << "Failed to pass shared memory:" << strerror(errno);
+          return;
+        }
+
+        // Release the payload once the last reader has it
+        if (fd >= 0)
+        {
+          QMutexLocker locker(&m_mutex);
+          auto it = m_entries.find(token);
+          if (it != m_entries.end() && --it->readers <= 0)
+            release(it);
+        }
+      }
+
+      void expire()
+      {
+        Clock::time_point now = Clock::now();
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+          if (it->deadline <= now)
+            it = release(it);
+          else
+            ++it;
+        }
+      }
+
+      // Called with the mutex locked
+      QHash<quint64, Entry>::iterator release(QHash<quint64, Entry>::iterator it)
+      {
+        close(it->fd);
+        m_retained -= it->size;
+        return m_entries.erase(it);
+      }
+
+      int m_fd = -1;
+      QMutex m_mutex;
+      QHash<quint64, Entry> m_entries;
+      qint64 m_retained = 0;
+  };
+
+
+  // Ask the process of handle for the descriptor, -1 on failure
+  int fetch(const SlotIPCSharedMemory::Handle& handle)
+  {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      return -1;
+    setTimeout(fd);
+
+    sockaddr_un address;
+    socklen_t length = serverAddress(handle.pid, address);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), length) != 0 || !isTrustedPeer(fd, handle.pid)
+        || send(fd, &handle.token, sizeof(handle.token), MSG_NOSIGNAL) != ssize_t(sizeof(handle.token)))
+    {
+      close(fd);
+      return -1;
+    }
+
+    char status = 0;
+    iovec data = { &status, sizeof(status) };
+    union
+    {
+      cmsghdr header;
+      char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    ssize_t received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    close(fd);
+
+    int payload = -1;
+    cmsghdr* header = received > 0 ? CMSG_FIRSTHDR(&message) : 0;
+    if (header && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS
+        && header->cmsg_len == CMSG_LEN(sizeof(int)))
+      memcpy(&payload, CMSG_DATA(header), sizeof(int));
+
+    if (status != 1 || (message.msg_flags & MSG_CTRUNC))
+    {
+      if (payload >= 0)
+        close(payload);
+      return -1;
+    }
+    return payload;
+  }
+}
+
+
+static bool isEnabled()
+{
+  static const bool enabled = qgetenv("SLOTIPC_SHARED_MEMORY") != "0"
+                              && DescriptorServer::instance()->isListening();
+  return enabled;
+}
+
+
+bool SlotIPCSharedMemory::shouldShare(qint64 size)
+{
+  if (size < kThreshold)
+    return false;
+
+  // Checked again when published, this only saves writing a payload that does not fit
+  return isEnabled() && DescriptorServer::instance()->hasRoom(size);
+}
+
+
+bool SlotIPCSharedMemory::publish(const Writer& writer, int readers, Handle& handle)
+{
+  if (readers <= 0)
+    return false;
+
+  int fd = memfd_create("slotipc", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0)
+  {
+    DEBUG << "memfd is not available:" << strerror(errno);
+    return false;
+  }
+
+  bool written;
+  {
+    QFile file;
+    written = file.open(fd, QIODevice::WriteOnly, QFileDevice::DontCloseHandle) && writer(file) && file.flush();
+  }
+
+  struct stat status;
+  if (!written || fcntl(fd, F_ADD_SEALS, kSeals | F_SEAL_SEAL) != 0 || fstat(fd, &status) != 0)
+  {
+    qWarning() << "SlotIPC:" << "Failed to write shared memory:" << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  handle.token = QRandomGenerator::system()->generate64();
+  handle.pid = getpid();
+  handle.size = status.st_size;
+  if (!DescriptorServer::instance()->publish(handle.token, fd, handle.size, readers))
+  {
+    DEBUG << "Shared memory is full, the payload is written inline";
+    close(fd);
+    return false;
+  }
+  return true;
+}
+
+
+uchar* SlotIPCSharedMemory::map(const Handle& handle)
+{
+  if (handle.size <= 0)
+    return 0;
+
+  int fd = fetch(handle);
+  if (fd < 0)
+  {
+    qWarning() << "SlotIPC:" << "Failed to fetch shared memory of process" << handle.pid;
+    return 0;
+  }
+
+  // The seals guarantee the sender can neither change nor truncate the payload
+  struct stat status;
+  void* data = MAP_FAILED;
+  if ((fcntl(fd, F_GET_SEALS) & kSeals) == kSeals && fstat(fd, &status) == 0 && status.st_size >= handle.size)
+    data = mmap(0, size_t(handle.size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (data == MAP_FAILED)
+  {
+    qWarning() << "SlotIPC:" << "Invalid shared memory of process" << handle.pid;
+    return 0;
+  }
+  return static_cast<uchar*>(data);
+}
+
+
+void SlotIPCSharedMemory::unmap(uchar* data, qint64 size)
+{
+  if (data)
+    munmap(data, size_t(size));
+}
+
+
+bool SlotIPCSharedMemory::publishProbe(Handle& handle)
+{
+  if (!isEnabled())
+    return false;
+
+  return publish([](QIODevice& device) {
+    return device.write(kProbe, sizeof(kProbe)) == qint64(sizeof(kProbe));
+  }, 1, handle);
+}
+
+
+bool SlotIPCSharedMemory::readProbe(const Handle& handle)
+{
+  if (handle.size != qint64(sizeof(kProbe)))
+    return false;
+
+  uchar* data = map(handle);
+  bool ok = data && memcmp(data, kProbe, sizeof(kProbe)) == 0;
+  unmap(data, handle.size);
+  return ok;
+}
+
+#else
+
+bool SlotIPCSharedMemory::shouldShare(qint64)
+{
+  return false;
+}
+
+
+bool SlotIPCSharedMemory::publish(const Writer&, int, Handle&)
+{
+  return false;
+}
+
+
+uchar* SlotIPCSharedMemory::map(const Handle&)
+{
+  return 0;
+}
+
+
+void SlotIPCSharedMemory::unmap(uchar*, qint64)
+{}
+
+
+bool SlotIPCSharedMemory::publishProbe(Handle&)
+{
+  return false;
+}
+
+
+bool SlotIPCSharedMemory::readProbe(const Handle&)
+{
+  return false;
+}
+
+#endif
+
+
+QDataStream& operator<<(QDataStream& stream, const SlotIPCSharedMemory::Handle& handle)
+{
+  return stream << handle.token << handle.pid << handle.size;
+}
+
+
+QDataStream& operator>>(QDataStream& stream, SlotIPCSharedMemory::Handle& handle)
+{
+  return stream >> handle.token >> handle.pid >> handle.size;
+}
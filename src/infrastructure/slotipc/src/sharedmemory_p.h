@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SHAREDMEMORY_P_H
+#define SHAREDMEMORY_P_H
+
+
+#include <QtGlobal>
+class QDataStream;
+class QIODevice;
+
+#include <functional>
+
+
+// Large argument payloads of local connections.
+//
+// The payload is written once to a sealed memfd and only a small handle goes
+// through the socket. The receiver fetches the descriptor with SCM_RIGHTS from
+// the descriptor server of the sending process and maps it, so the cost of a
+// message does not depend on the payload size.
+//
+// Qt sockets read the connection with read(), which drops the passed
+// descriptors, so they are passed over a socket of their own. A signal goes
+// to every listener with the same handle, so the descriptor is kept until each
+// reader fetched it, or a limited time if one of them never does. The retained
+// payloads are capped, above the cap the payload is written inline.
+//
+// A payload the reader cannot fetch is lost, e.g. across pid namespaces, so a
+// connection only shares payloads after its peer read a probe of this process.
+class SlotIPCSharedMemory
+{
+  public:
+    struct Handle
+    {
+      quint64 token = 0;
+      qint64 pid = 0;
+      qint64 size = 0;
+    };
+
+    typedef std::function<bool(QIODevice&)> Writer;
+
+    // Whether a payload of size is worth sharing and sharing is available
+    static bool shouldShare(qint64 size);
+
+    // Write a payload with writer to a sealed memfd and publish it under handle,
+    // for the given count of readers. False if it failed or the cap is reached
+    static bool publish(const Writer& writer, int readers, Handle& handle);
+
+    // Map the payload of handle, private and writable, 0 on failure
+    static uchar* map(const Handle& handle);
+    static void unmap(uchar* data, qint64 size);
+
+    // Publish a small payload for one reader, a peer reading it can read the payloads of this process
+    static bool publishProbe(Handle& handle);
+    // Whether the probe of handle can be fetched and mapped
+    static bool readProbe(const Handle& handle);
+};
+
+QDataStream& operator<<(QDataStream& stream, const SlotIPCSharedMemory::Handle& handle);
+QDataStream& operator>>(QDataStream& stream, SlotIPCSharedMemory::Handle& handle);
+
+
+#endif // SHAREDMEMORY_P_H
@@ -55,18 +55,23 @@ void SlotIPCSignalHandler::relaySlot(void** args)
 
   for (int i = 0; i < m_signalParametersInfo.size(); ++i)
   {
-    const QByteArray& type = m_signalParametersInfo[i];
-
     //call arguments are started from index 1
-    messageArguments.push_back(QGenericArgument(qstrdup(QString(type).toLatin1()), args[i+1]));
+    messageArguments.push_back(QGenericArgument(m_signalParametersInfo[i].constData(), args[i+1]));
   }
 
-  SlotIPCMessage message(SlotIPCMessage::MessageSignal, m_signature, messageArguments);
-  QByteArray serializedMessage = SlotIPCMarshaller::marshallMessage(message);
+  // The same data goes to every listener, share large arguments only if all of them confirmed
+  // they read the shared memory, each of them fetches the shared payload once
+  bool shareLargeArguments = !m_listeners.isEmpty();
+  bool compact = !m_listeners.isEmpty();
+  foreach (SlotIPCServiceConnection* listener, m_listeners)
+  {
+    shareLargeArguments = shareLargeArguments && listener->sharesMemory();
+    compact = compact && listener->compactFrames();
+  }
 
-  //cleanup memory
-  foreach (const QGenericArgument& arg, messageArguments)
-    delete[] arg.name();
+  SlotIPCMessage message(SlotIPCMessage::MessageSignal, m_signature, messageArguments);
+  QByteArray serializedMessage = SlotIPCMarshaller::marshallMessage(message, shareLargeArguments ? m_listeners.size() : 0,
+                                                                    compact);
 
   DEBUG << "Send remote signal" << message.method();
 
@@ -2,6 +2,9 @@
 #include "../src/marshaller_p.h"
 #include "../src/message_p.h"
 
+#include <QDataStream>
+#include <QImage>
+
 class MarshallerTest : public ::testing::Test {
 protected:
     SlotIPCMarshaller marshaller;
@@ -33,4 +36,145 @@ TEST_F(MarshallerTest, MessageType) {
     SlotIPCMessage::MessageType type = SlotIPCMarshaller::demarshallMessageType(data);
     
     EXPECT_EQ(type, SlotIPCMessage::MessageSignal);
-}
\ No newline at end of file
+}
+TEST_F(MarshallerTest, SharedByteArray) {
+    // 测试大参数经共享内存传递
+    QByteArray payload(1024 * 1024, 'a');
+    payload[1000] = 'b';
+
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("QByteArray", &payload));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "testSignal(QByteArray)", args);
+
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message, true);
+    EXPECT_LT(data.size(), 1024);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(data);
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(*static_cast<QByteArray*>(result.arguments().at(0).data()), payload);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+}
+
+TEST_F(MarshallerTest, SharedImage) {
+    // 测试大图像经共享内存传递
+    QImage image(512, 512, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    image.setPixel(10, 20, qRgba(1, 2, 3, 4));
+
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("QImage", &image));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "testSignal(QImage)", args);
+
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message, true);
+    EXPECT_LT(data.size(), 1024);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(data);
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(*static_cast<QImage*>(result.arguments().at(0).data()), image);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+}
+
+TEST_F(MarshallerTest, InlineByteArray) {
+    // 测试未启用共享时大参数仍内联传递
+    QByteArray payload(1024 * 1024, 'a');
+
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("QByteArray", &payload));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "testSignal(QByteArray)", args);
+
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message);
+    EXPECT_GT(data.size(), payload.size());
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(data);
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(*static_cast<QByteArray*>(result.arguments().at(0).data()), payload);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+}
+
+TEST_F(MarshallerTest, AsyncRequestId) {
+    // 测试异步调用携带请求编号
+    QString value("value");
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("QString", &value));
+    SlotIPCMessage message(SlotIPCMessage::MessageAsyncCall, "testMethod", args, "QString");
+    message.setRequestId(42);
+
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message);
+    EXPECT_EQ(SlotIPCMarshaller::demarshallMessageType(data), SlotIPCMessage::MessageAsyncCall);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(data);
+    EXPECT_EQ(result.requestId(), 42u);
+    EXPECT_EQ(result.method(), "testMethod");
+    EXPECT_EQ(result.returnType(), "QString");
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(*static_cast<QString*>(result.arguments().at(0).data()), value);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+}
+
+TEST_F(MarshallerTest, CompactArgumentTypes) {
+    // 测试参数类型以类型编号编码
+    QString file("/home/user/Documents/report.odt");
+    qint64 current = 1024;
+    qint64 total = 4096;
+
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("QString", &file));
+    args.append(QGenericArgument("qint64", &current));
+    args.append(QGenericArgument("qint64", &total));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "transferProgress(QString,qint64,qint64)", args);
+
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message, 0, true);
+    EXPECT_TRUE(SlotIPCMarshaller::isCompactFrame(data));
+    EXPECT_LT(data.size(), 200);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(data);
+    ASSERT_EQ(result.arguments().size(), 3);
+    EXPECT_EQ(QMetaType::type(result.arguments().at(1).name()), QMetaType::LongLong);
+    EXPECT_EQ(*static_cast<QString*>(result.arguments().at(0).data()), file);
+    EXPECT_EQ(*static_cast<qint64*>(result.arguments().at(2).data()), total);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+}
+
+TEST_F(MarshallerTest, LegacyFrame) {
+    // 测试未协商时使用旧格式，旧版本构造的帧可以解码
+    QByteArray legacy;
+    QDataStream stream(&legacy, QIODevice::WriteOnly);
+    stream << int(SlotIPCMessage::MessageSignal) << QString("progress(qint64)") << QString() << quint32(1);
+    stream << QString("qint64") << qint64(2048);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(legacy);
+    EXPECT_EQ(result.method(), "progress(qint64)");
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(*static_cast<qint64*>(result.arguments().at(0).data()), 2048);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+
+    qint64 value = 2048;
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("qint64", &value));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "progress(qint64)", args);
+    QByteArray data = SlotIPCMarshaller::marshallMessage(message);
+    EXPECT_FALSE(SlotIPCMarshaller::isCompactFrame(data));
+    EXPECT_EQ(data, legacy);
+}
+
+TEST_F(MarshallerTest, CompactTypeTags) {
+    // 测试紧凑格式的类型标签固定，与 QMetaType 编号无关
+    QByteArray compact;
+    QDataStream stream(&compact, QIODevice::WriteOnly);
+    stream << (int(SlotIPCMessage::MessageSignal) | 0x10000) << QByteArray("progress(qint64)") << QByteArray()
+           << quint32(1);
+    stream << quint32(0xc0000004) << qint64(2048);
+
+    SlotIPCMessage result = SlotIPCMarshaller::demarshallMessage(compact);
+    EXPECT_EQ(result.messageType(), SlotIPCMessage::MessageSignal);
+    ASSERT_EQ(result.arguments().size(), 1);
+    EXPECT_EQ(QMetaType::type(result.arguments().at(0).name()), QMetaType::LongLong);
+    EXPECT_EQ(*static_cast<qint64*>(result.arguments().at(0).data()), 2048);
+    SlotIPCMarshaller::freeArguments(result.arguments());
+
+    qint64 value = 2048;
+    SlotIPCMessage::Arguments args;
+    args.append(QGenericArgument("qint64", &value));
+    SlotIPCMessage message(SlotIPCMessage::MessageSignal, "progress(qint64)", args);
+    EXPECT_EQ(SlotIPCMarshaller::marshallMessage(message, 0, true), compact);
+}
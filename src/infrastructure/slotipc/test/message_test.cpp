@@ -38,4 +38,40 @@ TEST_F(MessageTest, ReturnType) {
                       METHOD_ARG(), METHOD_ARG(), METHOD_ARG(),
                       METHOD_ARG(), "QString");
     EXPECT_EQ(msg.returnType(), "QString");
-}
\ No newline at end of file
+}
+
+TEST_F(MessageTest, Handshake) {
+    // 测试能力协商数据的编解码
+    SlotIPCHandshake offer;
+    offer.capabilities = SlotIPCHandshake::SharedMemory;
+    offer.probeRead = true;
+    offer.probe.token = 7;
+    offer.probe.pid = 42;
+    offer.probe.size = 8;
+
+    QString id("id");
+    QByteArray data = offer.toByteArray();
+    SlotIPCMessage msg(SlotIPCMessage::ConnectionInitialize, "", Q_ARG(QString, id), Q_ARG(QByteArray, data));
+
+    SlotIPCHandshake result = SlotIPCHandshake::fromArgument(msg, 1);
+    EXPECT_EQ(result.capabilities, quint32(SlotIPCHandshake::SharedMemory));
+    EXPECT_TRUE(result.probeRead);
+    EXPECT_EQ(result.probe.token, 7u);
+    EXPECT_EQ(result.probe.pid, 42);
+    EXPECT_EQ(result.probe.size, 8);
+
+    // 旧版本的客户端只发送连接编号
+    EXPECT_EQ(SlotIPCHandshake::fromArgument(msg, 2).capabilities, 0u);
+    EXPECT_FALSE(SlotIPCHandshake::fromArgument(msg, 0).probeRead);
+}
+
+TEST_F(MessageTest, SharedMemoryProbe) {
+    // 测试本进程发布的探测数据可以读取
+    SlotIPCSharedMemory::Handle probe;
+    if (!SlotIPCSharedMemory::publishProbe(probe))
+        return; // 不支持 memfd 的系统上不共享
+
+    EXPECT_TRUE(SlotIPCSharedMemory::readProbe(probe));
+    // 探测数据只供一个读取方使用
+    EXPECT_FALSE(SlotIPCSharedMemory::readProbe(probe));
+}
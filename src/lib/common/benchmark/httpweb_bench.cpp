@@ -0,0 +1,452 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Headless benchmark of the HTTPS file transfer stack: a FileServer and a
+// FileClient talk over loopback and download generated datasets.
+//
+// usage: httpweb_bench [--dataset tiny|mixed|huge|all] [--dir <workdir>]
+//                      [--port <port>] [--tiny-count <n>] [--huge-mb <n>]
+//                      [--output <file.json>] [--keep] [--resend] [--delta]
+//
+// --resend downloads every dataset once more into the same folder, where the
+// identical files are expected to be skipped instead of transferred.
+// --delta changes a few KB in the middle of every large file and downloads
+// again, where only the changed blocks are expected to be transferred.
+
+#include "httpweb/fileserver.h"
+#include "httpweb/fileclient.h"
+#include "httpweb/deltasync.h"
+#include "manager/secureconfig.h"
+#include "session/asioservice.h"
+
+#include "filesystem/directory.h"
+#include "filesystem/file.h"
+#include "filesystem/path.h"
+#include "time/timestamp.h"
+#include "trace/metrics.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct Options {
+    std::string dataset { "all" };
+    std::string workdir;
+    std::string output;
+    int port { 51998 };
+    int tinyCount { 2000 };
+    int hugeMB { 512 };
+    bool keep { false };
+    bool resend { false };
+    bool delta { false };
+};
+
+struct Dataset {
+    std::string name;
+    std::vector<std::string> webs; // top level entries to download
+    uint64_t files { 0 };
+    uint64_t bytes { 0 };
+};
+
+struct Result {
+    std::string name;
+    bool success { false };
+    uint64_t files { 0 };
+    uint64_t bytes { 0 };
+    uint64_t transferred { 0 };
+    double seconds { 0 };
+    double cpuSeconds { 0 };
+    long peakRssKB { 0 };
+    uint64_t p50us { 0 };
+    uint64_t p99us { 0 };
+    std::string metrics;
+};
+
+// cpu time (user + system) of the whole process in seconds, and its peak RSS in KB
+void processUsage(double *cpu, long *rss)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    *cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    *rss = usage.ru_maxrss;
+#else
+    *cpu = 0;
+    *rss = 0;
+#endif
+}
+
+class DataGenerator
+{
+public:
+    explicit DataGenerator(const BaseKit::Path &root) : _root(root), _random(20250101) {}
+
+    // write one file of the given size filled with pseudo random data
+    void file(const BaseKit::Path &path, size_t size, Dataset *set)
+    {
+        std::vector<uint32_t> buffer((size + 3) / 4);
+        for (auto &word : buffer)
+            word = _random();
+        BaseKit::File::WriteAllBytes(path, buffer.data(), size);
+        set->files++;
+        set->bytes += size;
+    }
+
+    // many tiny files in one folder
+    Dataset tiny(int count)
+    {
+        Dataset set { "tiny" };
+        BaseKit::Path dir = _root / "tiny";
+        BaseKit::Directory::CreateTree(dir);
+        std::uniform_int_distribution<size_t> sizes(1, 4096);
+        for (int i = 0; i < count; ++i)
+            file(dir / ("t" + std::to_string(i) + ".bin"), sizes(_random), &set);
+        set.webs.push_back("tiny");
+        return set;
+    }
+
+    // three levels of folders with files from a few KB to some MB
+    Dataset mixed()
+    {
+        Dataset set { "mixed" };
+        std::uniform_int_distribution<size_t> sizes(4096, 4 * 1024 * 1024);
+        for (int a = 0; a < 4; ++a) {
+            for (int b = 0; b < 4; ++b) {
+                BaseKit::Path dir = _root / "mixed" / ("d" + std::to_string(a)) / ("s" + std::to_string(b));
+                BaseKit::Directory::CreateTree(dir);
+                for (int i = 0; i < 8; ++i) {
+                    // most files are small, every 8th one is large
+                    size_t size = (i == 7) ? sizes(_random) : sizes(_random) / 64;
+                    file(dir / ("m" + std::to_string(i) + ".bin"), size, &set);
+                }
+            }
+        }
+        set.webs.push_back("mixed");
+        return set;
+    }
+
+    // one single huge file
+    Dataset huge(int megabytes)
+    {
+        Dataset set { "huge" };
+        BaseKit::Path path = _root / "huge.bin";
+        BaseKit::File out(path);
+        out.Create(false, true);
+
+        std::vector<uint32_t> block(1024 * 1024 / 4);
+        for (int i = 0; i < megabytes; ++i) {
+            for (auto &word : block)
+                word = _random();
+            out.Write(block.data(), block.size() * 4);
+        }
+        out.Close();
+
+        set.files = 1;
+        set.bytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+        set.webs.push_back("huge.bin");
+        return set;
+    }
+
+    // overwrite some bytes in the middle of the files large enough for delta
+    void change(const Dataset &set)
+    {
+        std::vector<char> noise(4096);
+        for (auto &byte : noise)
+            byte = static_cast<char>(_random());
+
+        for (const auto &web : set.webs) {
+            BaseKit::Path path = _root / web;
+            std::vector<BaseKit::File> files;
+            if (path.IsDirectory())
+                files = BaseKit::Directory(path).GetFilesRecursive();
+            else
+                files.emplace_back(path);
+
+            for (auto &file : files) {
+                if (file.size() < DeltaMinSize)
+                    continue;
+                file.Open(false, true);
+                file.Seek(file.size() / 2);
+                file.Write(noise.data(), noise.size());
+                file.Close();
+            }
+        }
+    }
+
+private:
+    BaseKit::Path _root;
+    std::mt19937 _random;
+};
+
+// receive side observer: per file latency and completion
+class BenchObserver : public ProgressCallInterface
+{
+public:
+    bool onProgress(uint64_t size) override
+    {
+        return false;
+    }
+
+    void onWebChanged(int state, std::string msg, uint64_t size) override
+    {
+        std::lock_guard<std::mutex> locker(_lock);
+        uint64_t now = BaseKit::Timestamp::nano();
+        if (state < WEB_CONNECTED) {
+            std::cerr << "transfer error " << state << ": " << msg << std::endl;
+            _failed = true;
+            _done = true;
+            _cond.notify_all();
+        } else if (state == WEB_TRANS_START) {
+            _mark = now;
+        } else if (state == WEB_FILE_END) {
+            // files are fetched one by one, so the time since the previous
+            // file includes the manifest, request and first byte latency.
+            _latencies.push_back((now - _mark) / 1000);
+            _mark = now;
+        } else if (state == WEB_TRANS_FINISH) {
+            _done = true;
+            _cond.notify_all();
+        }
+    }
+
+    bool wait(int seconds)
+    {
+        std::unique_lock<std::mutex> locker(_lock);
+        _cond.wait_for(locker, std::chrono::seconds(seconds), [this]() { return _done; });
+        return _done && !_failed;
+    }
+
+    std::vector<uint64_t> latencies()
+    {
+        std::lock_guard<std::mutex> locker(_lock);
+        return _latencies;
+    }
+
+private:
+    std::mutex _lock;
+    std::condition_variable _cond;
+    std::vector<uint64_t> _latencies;
+    uint64_t _mark { 0 };
+    bool _done { false };
+    bool _failed { false };
+};
+
+uint64_t percentile(std::vector<uint64_t> values, double p)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+Result runDataset(const std::shared_ptr<AsioService> &service, const std::shared_ptr<FileServer> &server,
+                  int port, const BaseKit::Path &source, const BaseKit::Path &target, const Dataset &set,
+                  const std::string &suffix)
+{
+    Result result;
+    result.name = set.name + suffix;
+
+    std::string names = "[";
+    for (const auto &web : set.webs) {
+        server->webBind(web, (source / web).string());
+        names += (names.size() > 1 ? ",\"" : "\"") + web + "\"";
+    }
+    names += "]";
+    std::string token = server->genToken(names);
+
+    BaseKit::Path savedir = target / set.name;
+    BaseKit::Directory::CreateTree(savedir);
+
+    auto observer = std::make_shared<BenchObserver>();
+    auto client = std::make_shared<FileClient>(service, SecureConfig::clientContext(), "127.0.0.1", port);
+    client->setCallback(observer);
+    client->setConfig(token, savedir.string());
+
+    BaseKit::Metrics::GetInstance().Reset();
+    double cpuStart = 0;
+    long rss = 0;
+    processUsage(&cpuStart, &rss);
+    uint64_t start = BaseKit::Timestamp::nano();
+
+    client->startFileDownload(client->parseWeb(token));
+    result.success = observer->wait(3600);
+
+    uint64_t elapsed = BaseKit::Timestamp::nano() - start;
+    double cpuEnd = 0;
+    processUsage(&cpuEnd, &result.peakRssKB);
+
+    client->stop();
+    client.reset();
+    for (const auto &web : set.webs)
+        server->webUnbind(web);
+
+    // the last block of a file is not reported as progress, count the written bytes
+    static const size_t received = BaseKit::Metrics::GetInstance().Register("http.client.bytes", BaseKit::MetricKind::COUNTER);
+    static const size_t skipped = BaseKit::Metrics::GetInstance().Register("http.client.skipped.bytes", BaseKit::MetricKind::COUNTER);
+    static const size_t copied = BaseKit::Metrics::GetInstance().Register("http.client.delta.copied.bytes", BaseKit::MetricKind::COUNTER);
+
+    auto latencies = observer->latencies();
+    result.files = latencies.size();
+    // the blocks rebuilt from the old copy are written but not transferred
+    result.transferred = BaseKit::Metrics::GetInstance().counter(received) - BaseKit::Metrics::GetInstance().counter(copied);
+    result.bytes = BaseKit::Metrics::GetInstance().counter(received) + BaseKit::Metrics::GetInstance().counter(skipped);
+    result.seconds = elapsed / 1e9;
+    result.cpuSeconds = cpuEnd - cpuStart;
+    result.p50us = percentile(latencies, 0.50);
+    result.p99us = percentile(latencies, 0.99);
+    result.metrics = BaseKit::Metrics::GetInstance().ToJSON();
+
+    if (result.success && (result.bytes != set.bytes || result.files != set.files)) {
+        std::cerr << set.name << ": received " << result.files << " files / " << result.bytes
+                  << " bytes, expected " << set.files << " files / " << set.bytes << " bytes" << std::endl;
+        result.success = false;
+    }
+    return result;
+}
+
+std::string toJSON(const Result &r)
+{
+    double mb = r.bytes / (1024.0 * 1024.0);
+    double gb = r.bytes / (1024.0 * 1024.0 * 1024.0);
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"dataset\":\"" << r.name << "\""
+        << ",\"success\":" << (r.success ? "true" : "false")
+        << ",\"files\":" << r.files
+        << ",\"bytes\":" << r.bytes
+        << ",\"transferred_bytes\":" << r.transferred
+        << ",\"seconds\":" << r.seconds
+        << ",\"mb_per_sec\":" << (r.seconds > 0 ? mb / r.seconds : 0)
+        << ",\"files_per_sec\":" << (r.seconds > 0 ? r.files / r.seconds : 0)
+        << ",\"cpu_sec_per_gb\":" << (gb > 0 ? r.cpuSeconds / gb : 0)
+        << ",\"peak_rss_kb\":" << r.peakRssKB
+        << ",\"file_latency_p50_us\":" << r.p50us
+        << ",\"file_latency_p99_us\":" << r.p99us
+        << ",\"metrics\":" << r.metrics << "}";
+    return out.str();
+}
+
+bool parseOptions(int argc, char **argv, Options *opts)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1) < argc;
+        if (arg == "--dataset" && hasValue) {
+            opts->dataset = argv[++i];
+        } else if (arg == "--dir" && hasValue) {
+            opts->workdir = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            opts->output = argv[++i];
+        } else if (arg == "--port" && hasValue) {
+            opts->port = std::stoi(argv[++i]);
+        } else if (arg == "--tiny-count" && hasValue) {
+            opts->tinyCount = std::stoi(argv[++i]);
+        } else if (arg == "--huge-mb" && hasValue) {
+            opts->hugeMB = std::stoi(argv[++i]);
+        } else if (arg == "--keep") {
+            opts->keep = true;
+        } else if (arg == "--resend") {
+            opts->resend = true;
+        } else if (arg == "--delta") {
+            opts->delta = true;
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--dataset tiny|mixed|huge|all] [--dir <workdir>] [--port <port>]"
+                      << " [--tiny-count <n>] [--huge-mb <n>] [--output <file.json>] [--keep] [--resend] [--delta]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, &opts))
+        return 1;
+
+    BaseKit::Path workdir = opts.workdir.empty() ? (BaseKit::Path::temp() / BaseKit::Path::unique()) : BaseKit::Path(opts.workdir);
+    BaseKit::Path source = workdir / "source";
+    BaseKit::Path target = workdir / "target";
+    BaseKit::Directory::CreateTree(source);
+    BaseKit::Directory::CreateTree(target);
+
+    DataGenerator generator(source);
+    std::vector<Dataset> datasets;
+    if (opts.dataset == "tiny" || opts.dataset == "all")
+        datasets.push_back(generator.tiny(opts.tinyCount));
+    if (opts.dataset == "mixed" || opts.dataset == "all")
+        datasets.push_back(generator.mixed());
+    if (opts.dataset == "huge" || opts.dataset == "all")
+        datasets.push_back(generator.huge(opts.hugeMB));
+
+    // the server sends file bodies synchronously from its io thread, so the
+    // client must run on its own service as it does in the real peer.
+    auto serverService = std::make_shared<AsioService>();
+    auto clientService = std::make_shared<AsioService>();
+    serverService->Start();
+    clientService->Start();
+
+    auto server = std::make_shared<FileServer>(serverService, SecureConfig::serverContext(), opts.port);
+    if (!server->start()) {
+        std::cerr << "failed to start file server on port " << opts.port << std::endl;
+        return 1;
+    }
+
+    bool success = true;
+    std::string json = "{\"results\":[";
+    std::vector<Result> results;
+    for (const auto &set : datasets) {
+        results.push_back(runDataset(clientService, server, opts.port, source, target, set, ""));
+        if (opts.resend)
+            results.push_back(runDataset(clientService, server, opts.port, source, target, set, "-resend"));
+        if (opts.delta) {
+            generator.change(set);
+            results.push_back(runDataset(clientService, server, opts.port, source, target, set, "-delta"));
+        }
+    }
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &result = results[i];
+        success = success && result.success;
+        json += (i > 0 ? "," : "") + toJSON(result);
+
+        std::cout << "[" << result.name << "] " << (result.success ? "ok" : "FAILED")
+                  << " files: " << result.files << " bytes: " << result.bytes
+                  << " transferred: " << result.transferred
+                  << " time: " << result.seconds << "s p50: " << result.p50us << "us p99: " << result.p99us << "us"
+                  << std::endl;
+    }
+    json += "]}";
+
+    server->stop();
+    clientService->Stop();
+    serverService->Stop();
+
+    if (opts.output.empty()) {
+        std::cout << json << std::endl;
+    } else {
+        std::ofstream out(opts.output);
+        out << json << std::endl;
+    }
+
+    if (!opts.keep)
+        BaseKit::Path::RemoveAll(workdir);
+
+    return success ? 0 : 2;
+}
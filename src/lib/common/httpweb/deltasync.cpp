@@ -0,0 +1,507 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "deltasync.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char SignatureMagic[] = "DSG1";
+constexpr char DeltaMagic[] = "DLT1";
+
+constexpr uint32_t MinBlockSize = 64 * 1024;
+constexpr uint32_t MaxBlockSize = 16 * 1024 * 1024;
+constexpr uint64_t MaxBlocks = 64 * 1024;
+
+// longest literal in one op, longer ones are split
+constexpr uint64_t MaxLiteral = 1 << 30;
+// the encoded delta is sent in pieces of this size
+constexpr size_t SendChunk = 64 * 1024;
+
+// bits of the filter in front of the weak sum index, most windows miss it
+constexpr int FilterBits = 20;
+
+void put32(std::string &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+}
+
+void put64(std::string &out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+}
+
+uint32_t get32(const char *data)
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t get64(const char *data)
+{
+    return get32(data) | (static_cast<uint64_t>(get32(data + 4)) << 32);
+}
+
+// block count of the file, without the overflow of rounding up
+uint64_t blockCount(uint64_t filesize, uint32_t blocksize)
+{
+    return filesize / blocksize + (filesize % blocksize != 0 ? 1 : 0);
+}
+
+uint32_t filterTag(uint32_t weak)
+{
+    return (weak * 0x9E3779B1u) >> (32 - FilterBits);
+}
+
+// read until the buffer is full or the file ends
+size_t readFull(BaseKit::File &file, char *buffer, size_t size)
+{
+    size_t total = 0;
+    while (total < size) {
+        size_t read_sz = file.Read(buffer + total, size - total);
+        if (read_sz == 0)
+            break;
+        total += read_sz;
+    }
+    return total;
+}
+
+} // namespace
+
+//-------------DeltaSignature-----------------
+
+uint32_t DeltaSignature::blockSize(uint64_t filesize)
+{
+    uint32_t size = MinBlockSize;
+    while (size < MaxBlockSize && filesize / size > MaxBlocks)
+        size *= 2;
+    return size;
+}
+
+uint32_t DeltaSignature::weakSum(const char *data, size_t size)
+{
+    // a: sum of the bytes, b: sum of the running a, both mod 2^16
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    uint32_t a = 0;
+    uint32_t b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a += p[i];
+        b += a;
+    }
+    return (a & 0xffff) | (b << 16);
+}
+
+bool DeltaSignature::build(BaseKit::File &file, const std::atomic<bool> *stop)
+{
+    file_size = file.size();
+    block_size = blockSize(file_size);
+    blocks.clear();
+    // too large to be parsed by the sender, download it whole
+    if (file_size > static_cast<uint64_t>(block_size) * MaxBlocks)
+        return false;
+    blocks.reserve(blockCount(file_size, block_size));
+
+    std::vector<char> buff(block_size);
+    uint64_t total = 0;
+    size_t read_sz = 0;
+    while ((read_sz = readFull(file, buff.data(), buff.size())) > 0) {
+        if (stop && stop->load())
+            return false;
+        blocks.push_back({ weakSum(buff.data(), read_sz), BaseKit::XXHash64::Hash(buff.data(), read_sz) });
+        total += read_sz;
+    }
+    // the file changed while signing
+    return total == file_size;
+}
+
+std::string DeltaSignature::serialize() const
+{
+    std::string out(SignatureMagic, 4);
+    out.reserve(16 + blocks.size() * 12);
+    put32(out, block_size);
+    put64(out, file_size);
+    for (const auto &block : blocks) {
+        put32(out, block.weak);
+        put64(out, block.strong);
+    }
+    return out;
+}
+
+bool DeltaSignature::parse(std::string_view data)
+{
+    if (data.size() < 16 || data.compare(0, 4, SignatureMagic) != 0)
+        return false;
+
+    block_size = get32(data.data() + 4);
+    file_size = get64(data.data() + 8);
+    if (block_size < MinBlockSize || block_size > MaxBlockSize)
+        return false;
+    if (file_size > static_cast<uint64_t>(block_size) * MaxBlocks)
+        return false;
+
+    uint64_t count = blockCount(file_size, block_size);
+    if ((data.size() - 16) / 12 != count || (data.size() - 16) % 12 != 0)
+        return false;
+
+    blocks.resize(count);
+    const char *p = data.data() + 16;
+    for (auto &block : blocks) {
+        block.weak = get32(p);
+        block.strong = get64(p + 4);
+        p += 12;
+    }
+    return true;
+}
+
+//-------------DeltaPlan-----------------
+
+bool DeltaPlan::build(BaseKit::File &file, const DeltaSignature &signature, BaseKit::XXHash64 *hasher)
+{
+    _ops.clear();
+    _literal = 0;
+    _block_size = signature.block_size;
+    _base_size = signature.file_size;
+    _file_size = file.size();
+    if (_block_size == 0 || signature.blocks.size() > MaxBlocks
+        || signature.blocks.size() != blockCount(_base_size, _block_size))
+        return false;
+
+    const uint32_t bs = _block_size;
+    const uint64_t tail = _base_size % bs;
+    // the blocks of the validated signature, the short last one only matches at the end
+    const size_t full = signature.blocks.size() - (tail > 0 ? 1 : 0);
+
+    // the full blocks sorted by weak sum
+    std::vector<std::pair<uint32_t, uint32_t>> index;
+    std::vector<bool> filter(size_t(1) << FilterBits);
+    index.reserve(full);
+    for (size_t i = 0; i < full; ++i) {
+        index.emplace_back(signature.blocks[i].weak, static_cast<uint32_t>(i));
+        filter[filterTag(signature.blocks[i].weak)] = true;
+    }
+    std::sort(index.begin(), index.end());
+
+    // window over the file: buff[pos, pos + bs) is at file offset base + pos
+    std::vector<char> buff(std::max<size_t>(size_t(bs) * 4, 1 << 20));
+    uint64_t base = 0;
+    size_t pos = 0;
+    size_t end = 0;
+    auto fill = [&]() {
+        std::memmove(buff.data(), buff.data() + pos, end - pos);
+        base += pos;
+        end -= pos;
+        pos = 0;
+        size_t read_sz = readFull(file, buff.data() + end, buff.size() - end);
+        if (hasher)
+            hasher->Update(buff.data() + end, read_sz);
+        end += read_sz;
+    };
+
+    uint64_t literal = 0; // start of the unmatched bytes
+    int64_t last = -1;
+    bool rolling = false;
+    uint32_t a = 0;
+    uint32_t b = 0;
+
+    file.Seek(0);
+    while (full > 0) {
+        if (end - pos < bs) {
+            fill();
+            if (end - pos < bs)
+                break;
+        }
+
+        const auto *win = reinterpret_cast<const unsigned char *>(buff.data() + pos);
+        if (!rolling) {
+            uint32_t weak = DeltaSignature::weakSum(buff.data() + pos, bs);
+            a = weak & 0xffff;
+            b = weak >> 16;
+            rolling = true;
+        }
+
+        uint32_t weak = (a & 0xffff) | (b << 16);
+        if (filter[filterTag(weak)]) {
+            auto range = std::equal_range(index.begin(), index.end(), std::make_pair(weak, 0u),
+                                          [](const auto &l, const auto &r) { return l.first < r.first; });
+            int64_t found = -1;
+            if (range.first != range.second) {
+                uint64_t strong = BaseKit::XXHash64::Hash(win, bs);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (it->second >= full || signature.blocks[it->second].strong != strong)
+                        continue;
+                    found = it->second;
+                    // prefer the next block, the references coalesce into one op
+                    if (found == last + 1)
+                        break;
+                }
+            }
+            if (found >= 0) {
+                addLiteral(literal, base + pos - literal);
+                addCopy(static_cast<uint32_t>(found));
+                last = found;
+                pos += bs;
+                literal = base + pos;
+                rolling = false;
+                continue;
+            }
+        }
+
+        // slide the window by one byte
+        if (end - pos == bs) {
+            fill();
+            if (end - pos == bs)
+                break;
+            win = reinterpret_cast<const unsigned char *>(buff.data() + pos);
+        }
+        a = a - win[0] + win[bs];
+        b = b - bs * win[0] + a;
+        ++pos;
+    }
+
+    if (tail > 0 && full < signature.blocks.size() && _file_size >= tail && _file_size - tail >= literal) {
+        std::vector<char> last_block(tail);
+        file.Seek(_file_size - tail);
+        if (readFull(file, last_block.data(), tail) == tail) {
+            const auto &block = signature.blocks[full];
+            if (DeltaSignature::weakSum(last_block.data(), tail) == block.weak
+                && BaseKit::XXHash64::Hash(last_block.data(), tail) == block.strong) {
+                addLiteral(literal, _file_size - tail - literal);
+                addCopy(static_cast<uint32_t>(full));
+                literal = _file_size;
+            }
+        }
+    }
+    addLiteral(literal, _file_size - literal);
+    return true;
+}
+
+uint64_t DeltaPlan::encodedSize() const
+{
+    uint64_t size = 12 + 1;
+    for (const auto &op : _ops) {
+        if (op.copy)
+            size += 9;
+        else
+            size += (op.count + MaxLiteral - 1) / MaxLiteral * 5 + op.count;
+    }
+    return size;
+}
+
+bool DeltaPlan::write(BaseKit::File &file, const Sender &send) const
+{
+    Stream stream(*this, file);
+    std::string out;
+    out.reserve(SendChunk);
+    uint64_t progress = 0;
+    while (stream.next(out, progress)) {
+        if (send(out.data(), out.size(), progress))
+            return false;
+    }
+    return !stream.failed();
+}
+
+bool DeltaPlan::Stream::next(std::string &out, uint64_t &progress)
+{
+    out.clear();
+    progress = 0;
+    if (_ended || _failed)
+        return false;
+
+    if (!_started) {
+        out.append(DeltaMagic, 4);
+        put64(out, _plan._file_size);
+        _started = true;
+    }
+
+    while (out.size() < SendChunk) {
+        if (_length > 0) {
+            size_t piece = static_cast<size_t>(std::min<uint64_t>(_length, SendChunk - out.size()));
+            size_t size = out.size();
+            out.resize(size + piece);
+            if (readFull(_file, &out[size], piece) != piece) {
+                // the file shrank while sending
+                _failed = true;
+                return false;
+            }
+            _length -= piece;
+            progress += piece;
+            continue;
+        }
+
+        if (_remain > 0) {
+            // a literal longer than MaxLiteral is split into records
+            _length = std::min(_remain, MaxLiteral);
+            out.push_back('L');
+            put32(out, static_cast<uint32_t>(_length));
+            _remain -= _length;
+            continue;
+        }
+
+        if (_op == _plan._ops.size()) {
+            out.push_back('E');
+            _ended = true;
+            break;
+        }
+
+        const Op &op = _plan._ops[_op++];
+        if (op.copy) {
+            out.push_back('C');
+            put32(out, static_cast<uint32_t>(op.first));
+            put32(out, static_cast<uint32_t>(op.count));
+            uint64_t offset = op.first * _plan._block_size;
+            progress += std::min<uint64_t>(op.count * _plan._block_size, _plan._base_size - offset);
+            continue;
+        }
+
+        _file.Seek(op.first);
+        _remain = op.count;
+    }
+    return true;
+}
+
+void DeltaPlan::addLiteral(uint64_t offset, uint64_t length)
+{
+    if (length == 0)
+        return;
+    _literal += length;
+    if (!_ops.empty() && !_ops.back().copy && _ops.back().first + _ops.back().count == offset) {
+        _ops.back().count += length;
+        return;
+    }
+    _ops.push_back({ false, offset, length });
+}
+
+void DeltaPlan::addCopy(uint32_t block)
+{
+    if (!_ops.empty() && _ops.back().copy && _ops.back().first + _ops.back().count == block) {
+        _ops.back().count++;
+        return;
+    }
+    _ops.push_back({ true, block, 1 });
+}
+
+//-------------DeltaPatcher-----------------
+
+DeltaPatcher::DeltaPatcher(BaseKit::File &base, const DeltaSignature &signature, Writer out)
+    : _base(base)
+    , _block_size(signature.block_size)
+    , _base_size(signature.file_size)
+    , _base_blocks(signature.blocks.size())
+    , _out(std::move(out))
+{
+}
+
+size_t DeltaPatcher::need() const
+{
+    switch (_state) {
+    case HEADER:
+        return 12;
+    case OPCODE:
+        return 1;
+    case COPY:
+        return 8;
+    case LITERAL_LEN:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+size_t DeltaPatcher::feed(const char *data, size_t size)
+{
+    uint64_t before = _written;
+    while (size > 0 && _state != FINISHED && _state != FAILED) {
+        if (_state == LITERAL) {
+            size_t piece = static_cast<size_t>(std::min<uint64_t>(size, _remain));
+            _out(data, piece);
+            _written += piece;
+            data += piece;
+            size -= piece;
+            _remain -= piece;
+            if (_remain == 0)
+                _state = OPCODE;
+            continue;
+        }
+
+        size_t piece = std::min(size, need() - _field.size());
+        _field.append(data, piece);
+        data += piece;
+        size -= piece;
+        if (_field.size() == need()) {
+            if (!apply())
+                _state = FAILED;
+            _field.clear();
+        }
+    }
+    if (size > 0 || _written > _file_size) {
+        // data after the end or more than announced
+        _state = FAILED;
+    }
+    return static_cast<size_t>(_written - before);
+}
+
+bool DeltaPatcher::apply()
+{
+    switch (_state) {
+    case HEADER:
+        if (_field.compare(0, 4, DeltaMagic) != 0)
+            return false;
+        _file_size = get64(_field.data() + 4);
+        _state = OPCODE;
+        return true;
+    case OPCODE:
+        if (_field[0] == 'C') {
+            _state = COPY;
+        } else if (_field[0] == 'L') {
+            _state = LITERAL_LEN;
+        } else if (_field[0] == 'E') {
+            _state = FINISHED;
+            return _written == _file_size;
+        } else {
+            return false;
+        }
+        return true;
+    case COPY: {
+        uint32_t first = get32(_field.data());
+        uint32_t count = get32(_field.data() + 4);
+        if (count == 0 || static_cast<uint64_t>(first) + count > _base_blocks)
+            return false;
+        _state = OPCODE;
+        return copyBlocks(first, count) > 0;
+    }
+    case LITERAL_LEN:
+        _remain = get32(_field.data());
+        _state = _remain > 0 ? LITERAL : OPCODE;
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t DeltaPatcher::copyBlocks(uint32_t first, uint32_t count)
+{
+    uint64_t offset = static_cast<uint64_t>(first) * _block_size;
+    uint64_t length = std::min<uint64_t>(static_cast<uint64_t>(count) * _block_size, _base_size - offset);
+    if (_buff.empty())
+        _buff.resize(SendChunk * 16);
+
+    _base.Seek(offset);
+    uint64_t remain = length;
+    while (remain > 0) {
+        size_t piece = static_cast<size_t>(std::min<uint64_t>(remain, _buff.size()));
+        if (readFull(_base, _buff.data(), piece) != piece) {
+            // the old copy changed since it was signed
+            return 0;
+        }
+        _out(_buff.data(), piece);
+        remain -= piece;
+    }
+    _written += length;
+    _copied += length;
+    return static_cast<size_t>(length);
+}
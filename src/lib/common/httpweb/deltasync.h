@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DELTASYNC_H
+#define DELTASYNC_H
+
+#include "algorithms/xxhash.h"
+#include "filesystem/file.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// rsync style delta of a file against the old copy kept by the receiver.
+//
+// The receiver signs its copy in fixed size blocks with a rolling weak sum and
+// a strong hash. The sender slides a window over its own file, finds those
+// blocks at any offset and replies the file as block references plus the
+// literal bytes between them, so only the changed parts travel.
+//
+// signature: "DSG1" u32 block_size, u64 file_size, { u32 weak, u64 strong } * blocks
+// delta:     "DLT1" u64 file_size, { 'C' u32 first, u32 count | 'L' u32 len, bytes } *, 'E'
+// all integers are little endian.
+
+// smaller files are downloaded whole
+inline constexpr uint64_t DeltaMinSize = 4 * 1024 * 1024;
+
+class DeltaSignature
+{
+public:
+    struct Block {
+        uint32_t weak;
+        uint64_t strong;
+    };
+
+    // block size for the file: 64K, grown to keep at most 64K blocks
+    static uint32_t blockSize(uint64_t filesize);
+    // rolling checksum of the block, see DeltaPlan for the rolling update
+    static uint32_t weakSum(const char *data, size_t size);
+
+    // sign the opened file from its start, false if stopped
+    bool build(BaseKit::File &file, const std::atomic<bool> *stop = nullptr);
+
+    std::string serialize() const;
+    bool parse(std::string_view data);
+
+    uint32_t block_size { 0 };
+    uint64_t file_size { 0 };
+    std::vector<Block> blocks;
+};
+
+// Sender side: matches the signature against the file and streams the delta.
+class DeltaPlan
+{
+public:
+    // send the encoded bytes, progress is the file bytes they stand for.
+    // return true to cancel.
+    using Sender = std::function<bool(const char *data, size_t size, uint64_t progress)>;
+
+    // find the receiver blocks in the opened file, false if the signature is unusable.
+    // hasher, if given, gets the whole file as it is read once from the start
+    bool build(BaseKit::File &file, const DeltaSignature &signature, BaseKit::XXHash64 *hasher = nullptr);
+
+    // length of the encoded delta, known before it is sent
+    uint64_t encodedSize() const;
+    uint64_t literalBytes() const { return _literal; }
+
+    // stream the delta, reading the literal bytes from the file. false if canceled
+    bool write(BaseKit::File &file, const Sender &send) const;
+
+    // the delta piece by piece, so the sender can pause between the pieces
+    class Stream
+    {
+    public:
+        Stream(const DeltaPlan &plan, BaseKit::File &file) : _plan(plan), _file(file) {}
+
+        // the next piece into out, progress is the file bytes it stands for.
+        // false at the end, or if the file shrank while sending
+        bool next(std::string &out, uint64_t &progress);
+        bool failed() const { return _failed; }
+
+    private:
+        const DeltaPlan &_plan;
+        BaseKit::File &_file;
+        size_t _op { 0 };
+        uint64_t _remain { 0 }; // literal bytes of the op not in a record yet
+        uint64_t _length { 0 }; // bytes of the current literal record to read
+        bool _started { false };
+        bool _ended { false };
+        bool _failed { false };
+    };
+
+private:
+    struct Op {
+        bool copy;
+        uint64_t first; // block index or file offset
+        uint64_t count; // block count or literal length
+    };
+
+    void addLiteral(uint64_t offset, uint64_t length);
+    void addCopy(uint32_t block);
+
+    uint32_t _block_size { 0 };
+    uint64_t _file_size { 0 };
+    uint64_t _base_size { 0 };
+    uint64_t _literal { 0 };
+    std::vector<Op> _ops;
+};
+
+// Receiver side: rebuilds the file from the delta stream and the old copy.
+class DeltaPatcher
+{
+public:
+    using Writer = std::function<void(const char *data, size_t size)>;
+
+    // base must be opened for reading, it is the copy the signature was built from
+    DeltaPatcher(BaseKit::File &base, const DeltaSignature &signature, Writer out);
+
+    // feed the next part of the delta stream, return the file bytes written.
+    // throws FileSystemException if the base can not be read
+    size_t feed(const char *data, size_t size);
+
+    bool failed() const { return _state == FAILED; }
+    bool finished() const { return _state == FINISHED && _written == _file_size; }
+    // bytes taken from the base copy instead of the stream
+    uint64_t copiedBytes() const { return _copied; }
+
+private:
+    enum State { HEADER, OPCODE, COPY, LITERAL_LEN, LITERAL, FINISHED, FAILED };
+
+    size_t need() const;
+    bool apply();
+    size_t copyBlocks(uint32_t first, uint32_t count);
+
+    BaseKit::File &_base;
+    uint32_t _block_size;
+    uint64_t _base_size;
+    uint64_t _base_blocks;
+    Writer _out;
+
+    State _state { HEADER };
+    std::string _field;
+    uint64_t _remain { 0 };
+    uint64_t _file_size { 0 };
+    uint64_t _written { 0 };
+    uint64_t _copied { 0 };
+    std::vector<char> _buff;
+};
+
+#endif // DELTASYNC_H
@@ -4,6 +4,7 @@
 
 #include "fileclient.h"
 #include "tokencache.h"
+#include "deltasync.h"
 
 #include "filesystem/file.h"
 #include "filesystem/path.h"
@@ -11,11 +12,21 @@
 
 #include "http/https_client.h"
 
+#include "trace/metrics.h"
+#include "algorithms/xxhash.h"
+
+#include <algorithm>
 #include <iostream>
 
 // timeout if no data arrived
 inline constexpr int ExitCount = 5000;
 
+// disk write slower than this is counted as a stall
+inline constexpr uint64_t WriteStallUs = 50000;
+
+// bytes per ms a slow sender scans for the delta, it replies after the scan
+inline constexpr int64_t DeltaScanRate = 10 * 1024;
+
 using NetUtil::HTTP::HTTPRequest;
 using NetUtil::HTTP::HTTPResponse;
 
@@ -38,10 +49,18 @@ public:
 protected:
     void onConnected() override
     {
+        _connected = BaseKit::Timestamp::nano();
         // must invoke supper fun, or cause canot connect server.
         HTTPSClientEx::onConnected();
     }
 
+    void onHandshaked() override
+    {
+        static const size_t handshake = BASEKIT_METRIC("tls.client.handshake", BaseKit::MetricKind::HISTOGRAM);
+        BaseKit::Metrics::GetInstance().Record(handshake, (BaseKit::Timestamp::nano() - _connected) / 1000);
+        HTTPSClientEx::onHandshaked();
+    }
+
     void onDisconnected() override
     {
         HTTPSClientEx::onDisconnected();
@@ -144,6 +163,7 @@ protected:
 private:
     ResponseHandler _handler { nullptr };
     std::atomic<bool> _canceled { false };
+    uint64_t _connected { 0 };
 };
 
 FileClient::FileClient(const std::shared_ptr<NetUtil::Asio::Service> &service, const std::shared_ptr<NetUtil::Asio::SSLContext>& context, const std::string &address, int port)
@@ -229,8 +249,11 @@ void FileClient::sendInfobyHeader(uint8_t mask, const std::string &name)
     }
 }
 
-InfoEntry FileClient::requestInfo(const std::string &name)
+InfoEntry FileClient::requestInfo(const std::string &name, bool withHash)
 {
+    // stat and manifest time seen from the receiver, including the round trip
+    BASEKIT_TRACE_SPAN("http.client.manifest");
+
     InfoEntry fileInfo;
 //    std::vector<std::pair<std::string, int64_t>> infos;
     if (_token.empty()) {
@@ -245,6 +268,10 @@ InfoEntry FileClient::requestInfo(const std::string &name)
     std::string ename = BaseKit::Encoding::Base64Encode(name);
     url.append(ename);
     url.append("&token=").append(_token);
+    if (withHash) {
+        // old servers ignore it and reply without hash
+        url.append("&hash=1");
+    }
 
     _httpClient->setResponseHandler(nullptr);
 
@@ -293,11 +320,22 @@ std::string FileClient::getHeadKey(const std::string &headstrs, const std::strin
     return value;
 }
 
-// download the file by name
+// download the file by name, the size is taken from the manifest
 // [GET]download/<name>&token
-bool FileClient::downloadFile(const std::string &name, const std::string &rename)
+bool FileClient::downloadFile(const std::string &name, int64_t fileSize, const std::string &rename)
 {
-    auto avaipath = createNextAvailableName(rename.empty() ? name : rename, true);
+    std::string savename = rename.empty() ? name : rename;
+    // the copy saved before, a changed file is saved beside it as name(1)
+    BaseKit::File local(savePath(savename, true));
+    if (skipIdentical(name, local, fileSize)) {
+        return true;
+    }
+
+    // rebuild a changed large file from the old copy, only the changed blocks are sent
+    DeltaSignature signature;
+    bool delta = !_retried && signLocal(local, fileSize, &signature);
+
+    auto avaipath = createNextAvailableName(savename, true);
     if (avaipath.empty()) {
         //FS exception now
         std::cout << "createNextAvailableName exception now! " << name << std::endl;
@@ -307,14 +345,60 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
         return false;
     }
 
+    static const size_t ttfb = BASEKIT_METRIC("http.client.ttfb", BaseKit::MetricKind::HISTOGRAM);
+    static const size_t received = BASEKIT_METRIC("http.client.bytes", BaseKit::MetricKind::COUNTER);
+    static const size_t diskWrite = BASEKIT_METRIC("disk.write", BaseKit::MetricKind::HISTOGRAM);
+    static const size_t stalls = BASEKIT_METRIC("disk.write.stalls", BaseKit::MetricKind::COUNTER);
+    static const size_t copied = BASEKIT_METRIC("http.client.delta.copied.bytes", BaseKit::MetricKind::COUNTER);
+
+    BASEKIT_TRACE_SPAN("http.client.file");
+
     bool result = false;
+    bool verified = true;
+    bool fallback = false;
     {
         std::atomic<int> timeout_done(0);
+        BaseKit::TraceSpan firstByte(ttfb);
 
         uint64_t offset = 0;
         auto tempFile = BaseKit::File(avaipath);
         //    offset = tempFile.size();
 
+        // hash the written content, verified against the sender after download
+        BaseKit::XXHash64 hasher;
+        bool hashing = false;
+        // the sender's hash from the reply header, empty from old senders
+        std::string expected;
+
+        // write the block into the file, and record the write latency
+        auto writeBlock = [&](const char *data, size_t size) {
+            uint64_t start = BaseKit::Timestamp::nano();
+            tempFile.Write(data, size);
+            if (hashing)
+                hasher.Update(data, size);
+            uint64_t elapsed = (BaseKit::Timestamp::nano() - start) / 1000;
+
+            auto &metrics = BaseKit::Metrics::GetInstance();
+            metrics.Record(diskWrite, elapsed);
+            metrics.Add(received, size);
+            if (elapsed >= WriteStallUs)
+                metrics.Add(stalls);
+        };
+
+        // the delta body is applied on the old copy instead of written as is
+        BaseKit::File base(local);
+        std::unique_ptr<DeltaPatcher> patcher;
+        auto writeBody = [&](const char *data, size_t size) -> size_t {
+            if (!patcher) {
+                writeBlock(data, size);
+                return size;
+            }
+            size_t written = patcher->feed(data, size);
+            if (patcher->failed())
+                fallback = true;
+            return written;
+        };
+
         ResponseHandler cb([&](int status, const char *buffer, size_t size) -> bool {
             timeout_done.store(0); // reset when data arrived
             if (_stop.load()) {
@@ -326,10 +410,15 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
             switch (status)
             {
             case RES_NOTFOUND: {
+                shouldExit = true;
+                if (delta) {
+                    // the sender can not reply the delta, download the whole file
+                    fallback = true;
+                    break;
+                }
                 std::cout << "File not Found!" << std::endl;
 
                 // error：not found
-                shouldExit = true;
                 if (auto callback = _callback.lock()) {
                     callback->onWebChanged(WEB_NOT_FOUND, "not_found");
                 }
@@ -338,6 +427,10 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
             case RES_OKHEADER: {
                 //std::string flag = this->getHeadKey(buffer, "Flag");
                 //std::cout << "head flag: " << flag << std::endl;
+                firstByte.Finish();
+                if (buffer) {
+                    expected = getHeadKey(buffer, "Content-Hash");
+                }
                 try {
                     BaseKit::Path file_path = tempFile.absolute().RemoveExtension();
 
@@ -351,6 +444,12 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
 
                         // set offset and current size
                         tempFile.Seek(cur_off);
+                        // only the whole written file can be verified
+                        hashing = (cur_off == 0);
+                    }
+                    if (delta && !patcher) {
+                        base.Open(true, false);
+                        patcher = std::make_unique<DeltaPatcher>(base, signature, writeBlock);
                     }
 
                     if (auto callback = _callback.lock()) {
@@ -369,10 +468,11 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
                 if (tempFile.IsFileWriteOpened() && buffer && size > 0) {
                     try {
                         // 实现层已循环写全部
-                        tempFile.Write(buffer, size);
+                        // a broken delta is drained, the connection serves the fallback
+                        size_t written = writeBody(buffer, size);
 
                         if (auto callback = _callback.lock()) {
-                            callback->onProgress(size);
+                            callback->onProgress(written);
                         }
                     } catch (const BaseKit::FileSystemException &ex) {
                         std::cout << "Write throw FS exception: " << ex.message() << std::endl;
@@ -397,7 +497,9 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
                 if (tempFile.IsFileWriteOpened()) {
                     try {
                         // 写入最后一块
-                        tempFile.Write(buffer, size);
+                        writeBody(buffer, size);
+                        if (patcher && !patcher->finished())
+                            fallback = true;
                     } catch (const BaseKit::FileSystemException &ex) {
                         std::cout << "Write&Close throw FS exception: " << ex.message() << std::endl;
                         if (auto callback = _callback.lock()) {
@@ -407,6 +509,9 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
                 }
 
                 shouldExit = true;
+                if (fallback)
+                    break;
+                result = true;
                 if (auto callback = _callback.lock()) {
                     callback->onWebChanged(WEB_FILE_END, tempFile.string(), size);
                 }
@@ -428,15 +533,27 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
         // auto self(_httpClient->shared_from_this());
         _httpClient->setResponseHandler(std::move(cb));
 
-        std::string url = "download/";
         // base64 the file name in order to keep original name, which may include '&'
         std::string ename = BaseKit::Encoding::Base64Encode(name);
-        url.append(ename);
-        url.append("&token=").append(_token);
-        url.append("&offset=").append(std::to_string(offset));
 
         try {
-            _httpClient->SendGetRequest(url).get(); // use get to sync download one by one
+            if (delta) {
+                // [POST]delta/<name>&token, the body is the signature of the old copy
+                std::string url = "delta/";
+                url.append(ename);
+                url.append("&token=").append(_token);
+                // the sender scans the whole file before the reply header, wait for it by
+                // the file size. A fixed timeout gives up on a large file on a slow disk
+                auto scan = std::max(BaseKit::Timespan::minutes(1),
+                                     BaseKit::Timespan::milliseconds(fileSize / DeltaScanRate));
+                _httpClient->SendPostRequest(url, signature.serialize(), scan).get();
+            } else {
+                std::string url = "download/";
+                url.append(ename);
+                url.append("&token=").append(_token);
+                url.append("&offset=").append(std::to_string(offset));
+                _httpClient->SendGetRequest(url).get(); // use get to sync download one by one
+            }
         } catch (const std::exception &e) {
             std::cerr << "Exception during file download: " << e.what() << std::endl;
             // 通知回调发生网络错误
@@ -457,6 +574,9 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
             BaseKit::Thread::Sleep(1);
         }
 
+        // no header arrived, do not pollute the time to first byte
+        firstByte.Cancel();
+
         // make sure the file has been closed
         if (tempFile.IsFileWriteOpened()) {
             try {
@@ -469,9 +589,59 @@ bool FileClient::downloadFile(const std::string &name, const std::string &rename
         }
 
         _httpClient->setResponseHandler(nullptr);
+
+        if (base.IsFileOpened()) {
+            try {
+                base.Close();
+            } catch (const BaseKit::FileSystemException &ex) {
+                std::cout << "Close throw FS exception: " << ex.message() << std::endl;
+            }
+        }
+        if (result && patcher) {
+            BaseKit::Metrics::GetInstance().Add(copied, patcher->copiedBytes());
+        }
+
+        if (result && hashing && !_stop.load()) {
+            std::string hash = BaseKit::XXHash64::ToString(hasher.Digest());
+            // ask for the hash only if the sender did not know it before sending
+            verified = expected.empty() ? verifyContent(name, hash) : (expected == hash);
+        }
     }
     // std::cout << "$$$ file end: " << name << std::endl;
 
+    if (fallback && !_stop.load()) {
+        std::cout << "delta failed, download whole file: " << name << std::endl;
+        try {
+            BaseKit::File::Remove(avaipath);
+        } catch (const BaseKit::FileSystemException &ex) {
+            std::cout << "Remove throw FS exception: " << ex.message() << std::endl;
+        }
+
+        _retried = true;
+        result = downloadFile(name, fileSize, rename);
+        _retried = false;
+        return result;
+    }
+
+    if (!verified) {
+        // the content differs from the sender, e.g. changed while sending
+        std::cout << "verify content failed: " << avaipath << std::endl;
+        try {
+            BaseKit::File::Remove(avaipath);
+        } catch (const BaseKit::FileSystemException &ex) {
+            std::cout << "Remove throw FS exception: " << ex.message() << std::endl;
+        }
+
+        result = false;
+        if (!_retried) {
+            _retried = true;
+            result = downloadFile(name, fileSize, rename);
+            _retried = false;
+        } else if (auto callback = _callback.lock()) {
+            callback->onWebChanged(WEB_IO_ERROR, "verify_error");
+        }
+    }
+
     return result;
 }
 
@@ -500,7 +670,7 @@ void FileClient::walkDownload(const std::vector<std::string> &webnames)
 
         // file: size > 0; dir: size < 0; default size = 0
         if (info.size > 0) {
-            downloadFile(name);
+            downloadFile(name, info.size);
         } else {
             walkFolder(name);
         }
@@ -521,8 +691,16 @@ void FileClient::walkDownload(const std::vector<std::string> &webnames)
 
 void FileClient::walkFolder(const std::string &name)
 {
-    // check and create the first index dir, ex. a -> /xx/download/a(1)
-    std::string replacePath = createNextAvailableName(name, false);
+    // reuse the existing dir, so the identical files in it are skipped and only
+    // the changed ones are saved beside as name(1); otherwise create it
+    std::string replacePath;
+    BaseKit::Path existPath = savePath(name, false);
+    if (existPath.IsDirectory()) {
+        replacePath = existPath.string();
+    } else {
+        // check and create the first index dir, ex. a -> /xx/download/a(1)
+        replacePath = createNextAvailableName(name, false);
+    }
     if (replacePath.empty()) {
         // can not get a replace folder, skip.
         std::cout << name << "can not get a replace folder, skip!" << std::endl;
@@ -532,7 +710,7 @@ void FileClient::walkFolder(const std::string &name)
     std::string rename = (name == avainame) ? "" : avainame;
 
     // walk all sub files and folders into queue
-    std::queue<std::string> folderEntryQueue;
+    EntryQueue folderEntryQueue;
 
     {
         // request the fist folder's info
@@ -546,7 +724,7 @@ void FileClient::walkFolder(const std::string &name)
             if (entry.size < 0) {
                 walkFolderEntry(subName, &folderEntryQueue);
             } else if (entry.size > 0) {
-                folderEntryQueue.push(subName);
+                folderEntryQueue.emplace(subName, entry.size);
             } else {
                 std::string saveName = subName;
                 if (!rename.empty()) {
@@ -560,27 +738,32 @@ void FileClient::walkFolder(const std::string &name)
     }
     // std::cout << "folderEntryQueue size: " << folderEntryQueue.size() << std::endl;
 
+    static const size_t queued = BASEKIT_METRIC("http.client.queue", BaseKit::MetricKind::GAUGE);
+
     // download all files and folders in queue
     while (!folderEntryQueue.empty()) {
+        BaseKit::Metrics::GetInstance().Set(queued, folderEntryQueue.size());
         if (_stop.load())
             break;
 
-        std::string subName = folderEntryQueue.front();
+        std::string subName = folderEntryQueue.front().first;
+        int64_t size = folderEntryQueue.front().second;
         folderEntryQueue.pop();
 
         if (rename.empty()) {
             // do not need to change the save dir
-            downloadFile(subName);
+            downloadFile(subName, size);
         } else {
             // replace the first folder name with the new one
             std::string saveName = subName;
             saveName.replace(0, name.length(), rename);
-            downloadFile(subName, saveName);
+            downloadFile(subName, size, saveName);
         }
     }
+    BaseKit::Metrics::GetInstance().Set(queued, 0);
 }
 
-void FileClient::walkFolderEntry(const std::string &name, std::queue<std::string> *entryQueue)
+void FileClient::walkFolderEntry(const std::string &name, EntryQueue *entryQueue)
 {
     // request get sub files's info
     auto info = requestInfo(name);
@@ -594,7 +777,7 @@ void FileClient::walkFolderEntry(const std::string &name, std::queue<std::string
         if (entry.size < 0) {
             walkFolderEntry(subName, entryQueue);
         } else if (entry.size > 0) {
-            entryQueue->push(subName);
+            entryQueue->emplace(subName, entry.size);
         }
     }
 }
@@ -653,7 +836,7 @@ bool FileClient::createNotExistPath(std::string &abspath, bool isfile)
     return false;
 }
 
-std::string FileClient::createNextAvailableName(const std::string &name, bool isfile)
+BaseKit::Path FileClient::savePath(const std::string &name, bool isfile)
 {
     BaseKit::Path path = BaseKit::Path(_savedir) / name;
     path = path.canonical(); // remove all '.' and '..' properly
@@ -671,7 +854,12 @@ std::string FileClient::createNextAvailableName(const std::string &name, bool is
             // std::cout << "IsEquivalent throw FS exception: " << ex.message()<< std::endl;
         }
     }
+    return path;
+}
 
+std::string FileClient::createNextAvailableName(const std::string &name, bool isfile)
+{
+    BaseKit::Path path = savePath(name, isfile);
     auto abspath = path.string();
     if (createNotExistPath(abspath, isfile)) {
         return abspath;
@@ -697,3 +885,71 @@ std::string FileClient::createNextAvailableName(const std::string &name, bool is
         i++;
     }
 }
+
+bool FileClient::skipIdentical(const std::string &name, BaseKit::File &local, int64_t size)
+{
+    try {
+        // a different size is a changed file, ask the sender to hash only the same sized
+        if (size <= 0 || !local.IsFileExists() || local.size() != static_cast<uint64_t>(size))
+            return false;
+
+        InfoEntry remote = requestInfo(name, true);
+        if (remote.size != size || remote.hash.empty())
+            return false;
+
+        BaseKit::XXHash64 hasher;
+        std::vector<char> buff(BLOCK_SIZE * 16);
+        local.Open(true, false);
+        size_t read_sz = 0;
+        while (!_stop.load() && (read_sz = local.Read(buff.data(), buff.size())) > 0) {
+            hasher.Update(buff.data(), read_sz);
+        }
+        local.Close();
+
+        if (hasher.size() != static_cast<uint64_t>(size) || BaseKit::XXHash64::ToString(hasher.Digest()) != remote.hash)
+            return false;
+    } catch (const BaseKit::FileSystemException &ex) {
+        std::cout << "Check identical throw FS exception: " << ex.message() << std::endl;
+        return false;
+    }
+
+    // the same content has been saved, report it as received without download
+    static const size_t skipped = BASEKIT_METRIC("http.client.skipped.bytes", BaseKit::MetricKind::COUNTER);
+    BaseKit::Metrics::GetInstance().Add(skipped, size);
+    if (auto callback = _callback.lock()) {
+        callback->onWebChanged(WEB_FILE_BEGIN, local.string(), size);
+        callback->onProgress(size);
+        callback->onWebChanged(WEB_FILE_END, local.string(), size);
+    }
+    return true;
+}
+
+bool FileClient::signLocal(BaseKit::File &local, int64_t size, DeltaSignature *signature)
+{
+    // an old sender rejects the delta request, then the whole file is downloaded
+    if (size < static_cast<int64_t>(DeltaMinSize))
+        return false;
+
+    try {
+        if (!local.IsFileExists() || local.size() < DeltaMinSize)
+            return false;
+
+        local.Open(true, false);
+        bool signed_ = signature->build(local, &_stop);
+        local.Close();
+        return signed_;
+    } catch (const BaseKit::FileSystemException &ex) {
+        std::cout << "Sign local throw FS exception: " << ex.message() << std::endl;
+        return false;
+    }
+}
+
+bool FileClient::verifyContent(const std::string &name, const std::string &hash)
+{
+    InfoEntry remote = requestInfo(name, true);
+    if (remote.hash.empty()) {
+        // old server without hash support, nothing to verify
+        return true;
+    }
+    return remote.hash == hash;
+}
@@ -10,9 +10,13 @@
 
 #include "webproto.h"
 
+#include "filesystem/file.h"
+#include "filesystem/path.h"
+
 #include <queue>
 
 class HTTPFileClient;
+class DeltaSignature;
 class FileClient : public WebInterface
 {
     friend class HTTPFileClient;
@@ -30,15 +34,21 @@ public:
 
 private:
     void sendInfobyHeader(uint8_t mask, const std::string &name = "");
-    InfoEntry requestInfo(const std::string &name);
+    InfoEntry requestInfo(const std::string &name, bool withHash = false);
     std::string getHeadKey(const std::string &headstrs, const std::string &keyfind);
-    bool downloadFile(const std::string &name, const std::string &rename = "");
+    bool downloadFile(const std::string &name, int64_t fileSize, const std::string &rename = "");
     void walkDownload(const std::vector<std::string> &webnames);
     bool createNotExistPath(std::string &abspath, bool isfile);
+    BaseKit::Path savePath(const std::string &name, bool isfile);
     std::string createNextAvailableName(const std::string &name, bool isfile);
+    bool skipIdentical(const std::string &name, BaseKit::File &local, int64_t size);
+    bool signLocal(BaseKit::File &local, int64_t size, DeltaSignature *signature);
+    bool verifyContent(const std::string &name, const std::string &hash);
 
     void walkFolder(const std::string &foldername);
-    void walkFolderEntry(const std::string &name, std::queue<std::string> *entryQueue);
+    // the queued files with their size from the manifest
+    using EntryQueue = std::queue<std::pair<std::string, int64_t>>;
+    void walkFolderEntry(const std::string &name, EntryQueue *entryQueue);
 
     std::shared_ptr<HTTPFileClient> _httpClient { nullptr };
     std::thread _downloadThread;
@@ -46,6 +56,7 @@ private:
     std::string _token;
     std::string _savedir;
     std::atomic<bool> _stop { false };
+    bool _retried { false }; // download again once if the content verify failed
 };
 
 #endif // FILECLIENT_H
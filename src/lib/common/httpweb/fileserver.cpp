@@ -8,8 +8,92 @@
 
 #include "http/https_session.h"
 #include "http/http_response.h"
+#include "asio/timer.h"
 
 #include "webproto.h"
+#include "deltasync.h"
+
+#include "trace/metrics.h"
+#include "algorithms/xxhash.h"
+#include "algorithms/traffic_shaper.h"
+#include "filesystem/directory_walker.h"
+
+#include <mutex>
+#include <unordered_map>
+
+// files up to this size are hashed before sending, the hash goes in the header
+inline constexpr uint64_t InlineHashSize = 8 * 1024 * 1024;
+
+// Content hashes of the served files, keyed by path and checked by size and
+// modified time. serveContent fills it while streaming, so the hash asked
+// by the receiver after download does not read the file again.
+class ContentHashCache
+{
+public:
+    static ContentHashCache &instance()
+    {
+        static ContentHashCache cache;
+        return cache;
+    }
+
+    std::string hash(const BaseKit::Path &path)
+    {
+        BaseKit::File file(path);
+        return hash(path, file.size(), file.modified().total());
+    }
+
+    // size and modified time already known from the directory scan
+    std::string hash(const BaseKit::Path &path, uint64_t size, uint64_t modified)
+    {
+        std::string result = cached(path, size, modified);
+        if (!result.empty())
+            return result;
+
+        BaseKit::File file(path);
+        BaseKit::XXHash64 hasher;
+        char buff[BLOCK_SIZE * 16];
+        file.Open(true, false);
+        size_t read_sz = 0;
+        while ((read_sz = file.Read(buff, sizeof(buff))) > 0) {
+            hasher.Update(buff, read_sz);
+        }
+        file.Close();
+
+        result = BaseKit::XXHash64::ToString(hasher.Digest());
+        put(path, size, modified, result);
+        return result;
+    }
+
+    // the hash of an unchanged file, empty if it is not known yet
+    std::string cached(const BaseKit::Path &path, uint64_t size, uint64_t modified)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(path.string());
+        if (it != _entries.end() && it->second.size == size && it->second.modified == modified)
+            return it->second.hash;
+        return std::string();
+    }
+
+    void put(const BaseKit::Path &path, uint64_t size, uint64_t modified, const std::string &hash)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_entries.size() >= MaxEntries)
+            _entries.clear();
+        _entries[path.string()] = { size, modified, hash };
+    }
+
+private:
+    static constexpr size_t MaxEntries = 8192;
+
+    struct Entry {
+        uint64_t size;
+        uint64_t modified;
+        std::string hash;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+};
 
 class HTTPFileSession : public NetUtil::HTTP::HTTPSSession
 {
@@ -22,7 +106,21 @@ public:
     }
 
 protected:
-    InfoEntry putFileInfo(const BaseKit::Path &entry)
+    void onConnected() override
+    {
+        _connected = BaseKit::Timestamp::nano();
+        HTTPSSession::onConnected();
+    }
+
+    void onHandshaked() override
+    {
+        static const size_t handshake = BASEKIT_METRIC("tls.server.handshake", BaseKit::MetricKind::HISTOGRAM);
+        BaseKit::Metrics::GetInstance().Record(handshake, (BaseKit::Timestamp::nano() - _connected) / 1000);
+        HTTPSSession::onHandshaked();
+    }
+
+    // entry comes from the walker with its metadata, so no more stat here
+    InfoEntry putFileInfo(const BaseKit::DirectoryEntry &entry, bool withHash)
     {
         InfoEntry info;
         auto name = entry.filename().string();
@@ -30,27 +128,40 @@ protected:
         if (entry.IsDirectory()) {
             info.size = -1; // mask as folder flag.
         } else if (entry.IsRegularFile()) {
-            BaseKit::File temp(entry);
-            info.size = temp.size(); // mask as file flag.
+            info.size = entry.size; // mask as file flag.
+            if (withHash) {
+                try {
+                    info.hash = ContentHashCache::instance().hash(entry.path, entry.size, entry.modified);
+                } catch (const BaseKit::FileSystemException &ex) {
+                    std::cout << "hash file exception: " << ex.message() << std::endl;
+                }
+            }
         } else {
-            std::cout << "this is link file: " << entry.string() << std::endl;
+            std::cout << "this is link file: " << entry.path.string() << std::endl;
         }
 
         return info;
     }
 
-    void serveInfo(const BaseKit::Path &path)
+    void serveInfo(const BaseKit::Path &path, bool withHash)
     {
-        BaseKit::File info(path);
-        if (info.IsExists()) {
-            InfoEntry fileInfo = putFileInfo(info);
-            if (info.IsDirectory()) {
-                for (const auto &item : BaseKit::Directory(path)) {
-                    const BaseKit::Path entry = item.IsSymlink() ? BaseKit::Symlink(item).target() : item;
+        // stat and manifest time of the requested entry
+        BASEKIT_TRACE_SPAN("http.server.stat");
 
-                    InfoEntry subInfo = putFileInfo(entry);
-                    fileInfo.datas.push_back(subInfo);
-                }
+        BaseKit::DirectoryEntry info = BaseKit::DirectoryWalker::Stat(path);
+        if (info.type != BaseKit::FileType::NONE) {
+            InfoEntry fileInfo = putFileInfo(info, withHash);
+            if (info.IsDirectory()) {
+                // one listing with the cached metadata, symlinks are resolved to their targets
+                BaseKit::DirectoryWalker::Options options;
+                options.recursive = false;
+                options.follow_symlinks = true;
+                options.threads = 1;
+                BaseKit::DirectoryWalker walker(options);
+                walker.Walk(path, [this, &fileInfo, withHash](const BaseKit::DirectoryEntry &entry) {
+                    fileInfo.datas.push_back(putFileInfo(entry, withHash));
+                    return false;
+                });
             }
 
             std::string json_str = fileInfo.as_json().serialize();
@@ -76,6 +187,9 @@ protected:
 
                 SendResponseAsync(response());
             } else if (info.IsRegularFile()){
+                // the span ends when the whole body is sent
+                static const size_t fileSpan = BASEKIT_METRIC("http.server.file", BaseKit::MetricKind::HISTOGRAM);
+
                 info.Open(true, false);
                 uint64_t total = 0;
 
@@ -85,7 +199,21 @@ protected:
                     info.Seek(offset); // seek to offset for breakpoint continue
                 }
 
+                uint64_t modified = info.modified().total();
+
                 response().SetContentType(info.extension().string());
+                // the receiver verifies the download by it without asking again. A
+                // small file is hashed now, a large one only if it has been hashed
+                std::string hash;
+                try {
+                    hash = (sz <= InlineHashSize) ? ContentHashCache::instance().hash(path, sz, modified)
+                                                  : ContentHashCache::instance().cached(path, sz, modified);
+                } catch (const BaseKit::FileSystemException &ex) {
+                    std::cout << "hash file exception: " << ex.message() << std::endl;
+                }
+                if (!hash.empty()) {
+                    response().SetHeader("Content-Hash", hash);
+                }
                 response().SetBodyLength(sz - offset); // set the remaining size as body lenght
 
                 total = response().body_length();
@@ -95,24 +223,26 @@ protected:
 
                 _handler(RES_OKHEADER, info.string().data(), total);
 
-                bool cancel = false;
-                size_t read_sz = 0;
-                char buff[BLOCK_SIZE];
-                while (!cancel) {
-                    memset(buff, 0, BLOCK_SIZE);
-                    read_sz = info.Read(buff, sizeof(buff));
-                    if (read_sz <= 0) {
-                        break;
+                // hash the content while streaming it, only the whole file is cached
+                auto file = std::make_shared<BaseKit::File>(std::move(info));
+                auto hasher = std::make_shared<BaseKit::XXHash64>();
+                auto span = std::make_shared<BaseKit::TraceSpan>(fileSpan);
+                streamBody([file, hasher](std::string &chunk, uint64_t &progress) {
+                    chunk.resize(BLOCK_SIZE);
+                    size_t read_sz = file->Read(&chunk[0], chunk.size());
+                    chunk.resize(read_sz);
+                    hasher->Update(chunk.data(), read_sz);
+                    progress = read_sz;
+                    return read_sz > 0;
+                }, [this, file, hasher, span, path, offset, sz, modified, total]() {
+                    file->Close();
+                    if (offset == 0 && hasher->size() == sz) {
+                        ContentHashCache::instance().put(path, sz, modified,
+                                                         BaseKit::XXHash64::ToString(hasher->Digest()));
                     }
-                    SendResponseBody(buff, read_sz);
-                    // notify progress：size total
-                    // return true to cancel download from outside.
-                    cancel = _handler(RES_BODY, nullptr, read_sz);
-                };
-
-                info.Close();
-
-                _handler(RES_FINISH, info.string().data(), total);
+                    span->Finish();
+                    _handler(RES_FINISH, file->string().data(), total);
+                });
             } else {
                 std::cout << "this is link file: " << path.absolute() << std::endl;
             }
@@ -124,6 +254,142 @@ protected:
         //std::cout << "response body end:" << total << std::endl;
     }
 
+    // reply the file as a delta against the receiver's old copy, see deltasync.h
+    void serveDelta(const BaseKit::Path &path, std::string_view body)
+    {
+        DeltaSignature signature;
+        BaseKit::File info(path);
+        if (!info.IsRegularFile() || !signature.parse(body)) {
+            // the receiver falls back to download the whole file
+            SendResponseAsync(response().MakeErrorResponse(404, "Not found."));
+            return;
+        }
+
+        static const size_t literal = BASEKIT_METRIC("http.server.delta.literal.bytes", BaseKit::MetricKind::COUNTER);
+        static const size_t deltaSpan = BASEKIT_METRIC("http.server.delta", BaseKit::MetricKind::HISTOGRAM);
+        auto span = std::make_shared<BaseKit::TraceSpan>(deltaSpan);
+
+        info.Open(true, false);
+        uint64_t total = info.size();
+        uint64_t modified = info.modified().total();
+
+        // the receiver verifies the result by the hash, take it from the scan
+        BaseKit::XXHash64 hasher;
+        auto plan = std::make_shared<DeltaPlan>();
+        if (!plan->build(info, signature, &hasher)) {
+            info.Close();
+            span->Cancel();
+            SendResponseAsync(response().MakeErrorResponse(404, "Not found."));
+            return;
+        }
+        BaseKit::Metrics::GetInstance().Add(literal, plan->literalBytes());
+        std::string hash;
+        if (hasher.size() == total) {
+            hash = BaseKit::XXHash64::ToString(hasher.Digest());
+            ContentHashCache::instance().put(path, total, modified, hash);
+        }
+
+        response().Clear();
+        response().SetBegin(200);
+        if (!hash.empty()) {
+            response().SetHeader("Content-Hash", hash);
+        }
+        response().SetBodyLength(plan->encodedSize());
+        SendResponse(response());
+
+        _handler(RES_OKHEADER, info.string().data(), total);
+
+        // the progress is of the file, not of the delta
+        auto file = std::make_shared<BaseKit::File>(std::move(info));
+        auto stream = std::make_shared<DeltaPlan::Stream>(*plan, *file);
+        streamBody([plan, file, stream](std::string &chunk, uint64_t &progress) {
+            return stream->next(chunk, progress);
+        }, [this, file, span, total]() {
+            file->Close();
+            span->Finish();
+            _handler(RES_FINISH, file->string().data(), total);
+        });
+    }
+
+    // send the body chunk by chunk from the source, then call finish. The
+    // bandwidth limit is waited for on a timer, not on the io thread
+    using BodySource = std::function<bool(std::string &chunk, uint64_t &progress)>;
+    void streamBody(BodySource source, std::function<void()> finish)
+    {
+        _bodySource = std::move(source);
+        _bodyFinish = std::move(finish);
+        _chunk.clear();
+
+        // the adaptive rate follows the round trip to this receiver
+        _shaper = std::make_unique<BaseKit::TrafficShaper::Job>();
+        asio::error_code ec;
+        auto endpoint = socket().remote_endpoint(ec);
+        if (!ec) {
+            _shaper->SetPeer(endpoint.address().to_string());
+        }
+
+        pumpBody();
+    }
+
+    void pumpBody()
+    {
+        static const size_t sent = BASEKIT_METRIC("http.server.bytes", BaseKit::MetricKind::COUNTER);
+
+        while (_bodySource) {
+            if (_chunk.empty()) {
+                bool more = false;
+                try {
+                    more = IsConnected() && _bodySource(_chunk, _progress);
+                } catch (const BaseKit::FileSystemException &ex) {
+                    std::cout << "read file exception: " << ex.message() << std::endl;
+                }
+                if (!more) {
+                    finishBody();
+                    return;
+                }
+
+                uint64_t delay = _shaper->Reserve(_chunk.size());
+                if (delay > 0) {
+                    // resume from the timer, the io thread serves others meanwhile
+                    if (!_timer) {
+                        _timer = std::make_shared<NetUtil::Asio::Timer>(server()->service());
+                    }
+                    auto self(shared_from_this());
+                    _timer->Setup([this, self](bool canceled) {
+                        if (canceled) {
+                            finishBody();
+                            return;
+                        }
+                        pumpBody();
+                    }, BaseKit::Timespan::nanoseconds(static_cast<int64_t>(delay)));
+                    _timer->WaitAsync();
+                    return;
+                }
+            }
+
+            SendResponseBody(_chunk.data(), _chunk.size());
+            BaseKit::Metrics::GetInstance().Add(sent, _chunk.size());
+            _chunk.clear();
+            // notify progress, return true to cancel download from outside.
+            if (_handler(RES_BODY, nullptr, _progress)) {
+                finishBody();
+                return;
+            }
+        }
+    }
+
+    void finishBody()
+    {
+        auto finish = std::move(_bodyFinish);
+        _bodySource = nullptr;
+        _bodyFinish = nullptr;
+        _shaper.reset();
+        _chunk.clear();
+        if (finish) {
+            finish();
+        }
+    }
+
     // 解析URL中的query参数
     std::unordered_map<std::string, std::string> parseQueryParams(const std::string &query)
     {
@@ -191,9 +457,10 @@ protected:
             }
 
             SendResponseAsync(response().MakeHeadResponse());
-        } else if (request.method() == "GET") {
+        } else if (request.method() == "GET" || request.method() == "POST") {
             // std::string url = "info/pathname&token=xxx";
             // std::string url = "download/pathname&token=xxx&offset=xxx";
+            // [POST] std::string url = "delta/pathname&token=xxx", body is the signature
             std::string url = std::string(request.url());
 
             size_t pathEnd = url.find("&token");
@@ -222,8 +489,8 @@ protected:
 
                 // 处理predownload或download请求的name
                 if (method.find("info") != std::string::npos) {
-                    // 处理predownload请求的name
-                    serveInfo(diskpath);
+                    // 处理predownload请求的name, hash=1 要求带上文件内容哈希
+                    serveInfo(diskpath, queryParams["hash"] == "1");
                 } else if (method.find("download") != std::string::npos) {
                     // 处理download请求的name
                     std::string offstr = queryParams["offset"];
@@ -233,6 +500,9 @@ protected:
                     }
 
                     serveContent(diskpath, offset);
+                } else if (method.find("delta") != std::string::npos && request.method() == "POST") {
+                    // 处理delta请求, 只发送接收端旧文件中没有的部分
+                    serveDelta(diskpath, request.body());
                 } else {
                     SendResponseAsync(response().MakeErrorResponse("Unsupported HTTP request: " + method));
                 }
@@ -259,6 +529,15 @@ protected:
 
 private:
     ResponseHandler _handler { nullptr };
+    uint64_t _connected { 0 };
+
+    // the body being sent by streamBody()
+    BodySource _bodySource { nullptr };
+    std::function<void()> _bodyFinish { nullptr };
+    std::unique_ptr<BaseKit::TrafficShaper::Job> _shaper;
+    std::shared_ptr<NetUtil::Asio::Timer> _timer;
+    std::string _chunk;
+    uint64_t _progress { 0 };
 };
 
 FileServer::~FileServer()
@@ -17,6 +17,7 @@
 struct InfoEntry {
     std::string name; // file or dir name
     int64_t size {0};  // file size, dir size set as 0
+    std::string hash; // xxh64 hex of the file content, empty if not requested
     std::vector<InfoEntry> datas; // the array for dir's Entries
 
 
@@ -24,6 +25,9 @@ struct InfoEntry {
     {
         name = obj.get("name").to_str();
         size = obj.get("size").get<int64_t>();
+        if (obj.get("hash").is<std::string>()) {
+            hash = obj.get("hash").get<std::string>();
+        }
         if (obj.get("datas").is<picojson::array>()) {
             const picojson::array &datasArray = obj.get("datas").get<picojson::array>();
             for (const auto &data : datasArray) {
@@ -41,6 +45,9 @@ struct InfoEntry {
         picojson::object obj;
         obj["name"] = picojson::value(name);
         obj["size"] = picojson::value(size);
+        if (!hash.empty()) {
+            obj["hash"] = picojson::value(hash);
+        }
 
         picojson::array datasArray;
         for (const auto &data : datas) {
@@ -5,8 +5,46 @@
 #include "filesizecounter.h"
 #include "common/log.h"
 
-#include <QDir>
+#include "filesystem/directory_walker.h"
+
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QPair>
+#include <QSet>
+
+#include <vector>
+
+// 首次上报部分统计的时间，之后的上报间隔（毫秒）
+static constexpr qint64 FirstProgressMs = 100;
+static constexpr qint64 ProgressIntervalMs = 500;
+
+namespace {
+
+// 按 (dev, inode) 去重的集合，分片加锁，遍历线程之间不再争用同一把锁
+class SeenFiles
+{
+public:
+    // 首次见到该文件时返回 true
+    bool insert(quint64 device, quint64 inode)
+    {
+        Shard &shard = _shards[(inode ^ (device * 0x9e3779b97f4a7c15ULL)) % ShardCount];
+        QMutexLocker locker(&shard.mutex);
+        int before = shard.files.size();
+        shard.files.insert(qMakePair(device, inode));
+        return shard.files.size() != before;
+    }
+
+private:
+    static constexpr int ShardCount = 64;
+    struct Shard
+    {
+        QMutex mutex;
+        QSet<QPair<quint64, quint64>> files;
+    };
+    Shard _shards[ShardCount];
+};
+
+} // namespace
 
 FileSizeCounter::FileSizeCounter(QObject *parent)
     : QThread{parent}
@@ -14,10 +52,23 @@ FileSizeCounter::FileSizeCounter(QObject *parent)
     DLOG << "Initializing file size counter";
 }
 
+FileSizeCounter::~FileSizeCounter()
+{
+    stop();
+    wait();
+}
+
 quint64 FileSizeCounter::countFiles(const QString &targetIp, const QStringList paths)
 {
     DLOG << "Starting file size counting";
 
+    // 上一次统计未结束时先停止它
+    if (isRunning()) {
+        DLOG << "Stopping the previous counting";
+        stop();
+        wait();
+    }
+
     _targetIp = "";
     _paths.clear();
 
@@ -28,6 +79,7 @@ quint64 FileSizeCounter::countFiles(const QString &targetIp, const QStringList p
             DLOG << "Start counting file size in directory";
             _paths = paths;
             _targetIp = targetIp;
+            _stoped = false;
             start();
             return 0;
         } else {
@@ -42,67 +94,87 @@ quint64 FileSizeCounter::countFiles(const QString &targetIp, const QStringList p
 void FileSizeCounter::stop()
 {
     DLOG << "Stopping file size counting";
+    QMutexLocker locker(&_walkerMutex);
     _stoped = true;
+    if (_walker)
+        _walker->Stop();
 }
 
 void FileSizeCounter::run()
 {
     DLOG << "Starting file size counting in thread";
-    _stoped = false;
     _totalSize = 0;
-    QStringList names;
-    foreach (const QString &path, _paths) {
+    _fileCount = 0;
+
+    // 所有目录一起多线程遍历，线程间互相窃取子目录；符号链接跟随到目标，每个目录只遍历一次
+    BaseKit::DirectoryWalker::Options options;
+    options.follow_symlinks = true;
+    BaseKit::DirectoryWalker walker(options);
+    {
+        QMutexLocker locker(&_walkerMutex);
         if (_stoped) {
             DLOG << "File size counting stopped";
             return;
         }
+        _walker = &walker;
+    }
+
+    // 符号链接跟随到目标，同一个文件可能经由选中的文件、硬链接或符号链接多次到达，
+    // 每个文件都按 (dev, inode) 去重，目录由遍历器保证只遍历一次。
+    // 不能只对 st_nlink > 1 的文件去重：符号链接的目标 nlink 为 1，也会被到达两次
+    SeenFiles seen;
+
+    QStringList names;
+    std::vector<BaseKit::Path> dirs;
+    foreach (const QString &path, _paths) {
         QFileInfo fileInfo(path);
         if (fileInfo.isFile()) {
-            _totalSize += fileInfo.size();
+            auto entry = BaseKit::DirectoryWalker::Stat(path.toStdString());
+            if (!entry.stated || seen.insert(entry.device, entry.inode)) {
+                _totalSize += fileInfo.size();
+                ++_fileCount;
+            }
         } else {
-            countFilesInDir(path);
+            dirs.emplace_back(path.toStdString());
         }
         names.append(fileInfo.fileName());
     }
 
-    emit onCountFinish(_targetIp, names, _totalSize);
-}
+    QElapsedTimer timer;
+    timer.start();
+    std::atomic<qint64> nextProgress { FirstProgressMs };
 
-void FileSizeCounter::countFilesInDir(const QString &path)
-{
-    DLOG << "Counting files in directory:" << path.toStdString();
-    if (_stoped) {
-        DLOG << "File size counting stopped in directory";
-        return;
+    walker.Walk(dirs, [&](const BaseKit::DirectoryEntry &entry) {
+        if (!entry.IsRegularFile())
+            return true;
+
+        if (entry.stated && !seen.insert(entry.device, entry.inode))
+            return true;
+
+        _totalSize += entry.size; // 统计文件大小
+        ++_fileCount;
+
+        // 边统计边上报，只有一个线程能抢到本次上报
+        qint64 next = nextProgress.load(std::memory_order_relaxed);
+        qint64 elapsed = timer.elapsed();
+        if (elapsed >= next && nextProgress.compare_exchange_strong(next, elapsed + ProgressIntervalMs))
+            emit onCountProgress(_targetIp, names, _totalSize.load(), _fileCount.load());
+        return true;
+    });
+
+    {
+        QMutexLocker locker(&_walkerMutex);
+        _walker = nullptr;
     }
 
-    QDir dir(path);
-    QFileInfoList infoList = dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
-    foreach (const QFileInfo &info, infoList) {
-        if (_stoped) {
-            DLOG << "File size counting stopped in directory traversal";
-            return;
-        }
+    if (walker.errors() > 0)
+        DLOG << "Skipped unreadable directories:" << walker.errors();
 
-        if (info.isSymLink()) {
-            // DLOG << "Handling symbolic link:" << info.filePath().toStdString();
-            // 处理符号链接
-            QFileInfo targetInfo(info.symLinkTarget());
-            if (targetInfo.exists()) {
-                if (targetInfo.isDir()) {
-                    // DLOG << "Symbolic link target is a directory, recursively counting";
-                    countFilesInDir(targetInfo.filePath());
-                } else {
-                    // DLOG << "Symbolic link target is a file, adding its size";
-                    _totalSize += targetInfo.size();
-                }
-            }
-        } else if (info.isDir()) {
-            // DLOG << "Recursively counting files in subdirectory:" << info.filePath().toStdString();
-            countFilesInDir(info.filePath()); // 递归遍历子目录
-        } else {
-            // DLOG << "Adding file size for:" << info.filePath().toStdString();
-            _totalSize += info.size(); // 统计文件大小
-        }
+    if (_stoped) {
+        DLOG << "File size counting stopped";
+        return;
     }
+
+    DLOG << "Counted files:" << _fileCount.load() << "total size:" << _totalSize.load() << "in" << timer.elapsed() << "ms";
+    emit onCountFinish(_targetIp, names, _totalSize.load());
 }
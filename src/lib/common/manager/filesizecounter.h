@@ -5,30 +5,43 @@
 #ifndef FILESIZECOUNTER_H
 #define FILESIZECOUNTER_H
 
+#include <QMutex>
 #include <QThread>
 
+#include <atomic>
+
+namespace BaseKit {
+class DirectoryWalker;
+}
+
 class FileSizeCounter : public QThread
 {
     Q_OBJECT
 public:
     explicit FileSizeCounter(QObject *parent = nullptr);
+    ~FileSizeCounter() override;
 
     quint64 countFiles(const QString &targetIp, const QStringList paths);
     void stop();
 
 signals:
+    // partial totals while counting, the first one soon after the start
+    void onCountProgress(const QString targetIp, const QStringList paths, quint64 totalSize, quint64 fileCount);
     void onCountFinish(const QString targetIp, const QStringList paths, quint64 totalSize);
 
 protected:
     void run() override;
 
 private:
-    void countFilesInDir(const QString &path);
-
     QStringList _paths;
     QString _targetIp;
-    quint64 _totalSize {0};
-    bool _stoped { true };
+    std::atomic<quint64> _totalSize {0};
+    std::atomic<quint64> _fileCount {0};
+    std::atomic<bool> _stoped { true };
+
+    // the running walk, stopped at once by stop()
+    QMutex _walkerMutex;
+    BaseKit::DirectoryWalker *_walker { nullptr };
 };
 
 #endif // FILESIZECOUNTER_H
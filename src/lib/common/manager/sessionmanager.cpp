@@ -11,6 +11,9 @@
 #include "transferworker.h"
 #include "filesizecounter.h"
 
+#include "trace/metrics.h"
+#include "algorithms/traffic_shaper.h"
+
 #include <QDir>
 #include <QStandardPaths>
 #include <QCoreApplication>
@@ -28,6 +31,7 @@ SessionManager::SessionManager(QObject *parent) : QObject(parent)
     connect(_session_worker.get(), &SessionWorker::onRpcResult, this, &SessionManager::handleRpcResult, Qt::QueuedConnection);
 
     _file_counter = std::make_shared<FileSizeCounter>(this);
+    connect(_file_counter.get(), &FileSizeCounter::onCountProgress, this, &SessionManager::handleFileCounting, Qt::QueuedConnection);
     connect(_file_counter.get(), &FileSizeCounter::onCountFinish, this, &SessionManager::handleFileCounted, Qt::QueuedConnection);
 }
 
@@ -76,6 +80,14 @@ void SessionManager::setStorageRoot(const QString &root)
     _save_root = QString(root);
 }
 
+void SessionManager::setTransferLimits(quint64 global, quint64 job, bool adaptive)
+{
+    DLOG << "setTransferLimits: " << global << " job: " << job << " adaptive: " << adaptive;
+    auto &shaper = BaseKit::TrafficShaper::GetInstance();
+    shaper.SetLimits(global, job);
+    shaper.SetAdaptive(adaptive);
+}
+
 void SessionManager::updateSaveFolder(const QString &folder)
 {
     DLOG << "updateSaveFolder: " << folder.toStdString();
@@ -275,17 +287,18 @@ void SessionManager::handleTransData(const QString endpoint, const QStringList n
     }
 }
 
-void SessionManager::handleTransCount(const QString names, quint64 size)
+void SessionManager::handleTransCount(const QString names, quint64 size, bool counting)
 {
-    DLOG << "handleTransCount names: " << names.toStdString();
-    // TRANS_COUNT_SIZE = 50
-    emit notifyTransChanged(50, names, size);
+    DLOG << "handleTransCount names: " << names.toStdString() << " counting: " << counting;
+    // TRANS_COUNTING = 57, TRANS_COUNT_SIZE = 50
+    emit notifyTransChanged(counting ? 57 : 50, names, size);
 }
 
 void SessionManager::handleCancelTrans(const QString jobid, const QString reason)
 {
     DLOG << "handleCancelTrans jobid: " << jobid.toStdString();
-    // stop & release the worker
+    // stop the size counting and release the worker
+    _file_counter->stop();
     releaseTransWorker(jobid);
 
     if (!reason.isEmpty()) {
@@ -299,9 +312,21 @@ void SessionManager::handleCancelTrans(const QString jobid, const QString reason
     }
 }
 
+void SessionManager::handleFileCounting(const QString ip, const QStringList paths, quint64 totalSize, quint64 fileCount)
+{
+    DLOG << "handleFileCounting ip: " << ip.toStdString() << " files: " << fileCount << " size: " << totalSize;
+    // the partial total, so the remote shows the progress before the whole scan
+    sendTransCount(ip, paths, totalSize, true);
+}
+
 void SessionManager::handleFileCounted(const QString ip, const QStringList paths, quint64 totalSize)
 {
     DLOG << "handleFileCounted ip: " << ip.toStdString();
+    sendTransCount(ip, paths, totalSize, false);
+}
+
+void SessionManager::sendTransCount(const QString &ip, const QStringList &paths, quint64 totalSize, bool counting)
+{
     if (ip.isEmpty()) {
         WLOG << "empty target address for file counted.";
         return;
@@ -316,7 +341,7 @@ void SessionManager::handleFileCounted(const QString ip, const QStringList paths
     req.id = ip.toStdString();
     req.names = nameVector;
     req.endpoint = "::";
-    req.flag = false; // no need count
+    req.flag = counting; // still counting or the final total
     req.size = totalSize;
 
     QString jsonMsg = req.as_json().serialize().c_str();
@@ -325,10 +350,15 @@ void SessionManager::handleFileCounted(const QString ip, const QStringList paths
     // notify local
     DLOG << "Notifying local about file count";
     QString oneName = paths.join(";");
-    handleTransCount(oneName, totalSize);
+    handleTransCount(oneName, totalSize, counting);
 }
 
 
+QString SessionManager::metricsSnapshot() const
+{
+    return QString::fromStdString(BaseKit::Metrics::GetInstance().ToJSON());
+}
+
 void SessionManager::handleRpcResult(int32_t type, const QString &response)
 {
 #ifdef QT_DEBUG
@@ -24,6 +24,8 @@ public:
     void updatePin(QString code);
     void setStorageRoot(const QString &root);
     void updateSaveFolder(const QString &folder);
+    // bandwidth limits of the transfers in bytes per second, 0 is unlimited
+    void setTransferLimits(quint64 global, quint64 job, bool adaptive);
     void updateLoginStatus(QString &ip, bool logined);
 
     void sessionListen(int port);
@@ -36,6 +38,9 @@ public:
 
     void sendRpcRequest(const QString &target, int type, const QString &reqJson);
 
+    // local transfer metrics snapshot, request REQ_TRANS_METRICS for the remote one
+    QString metricsSnapshot() const;
+
 signals:
     void notifyCancelWeb();
     void notifyConnection(int result, QString reason);
@@ -46,8 +51,9 @@ signals:
 
 public slots:
     void handleTransData(const QString endpoint, const QStringList nameVector);
-    void handleTransCount(const QString names, quint64 size);
+    void handleTransCount(const QString names, quint64 size, bool counting = false);
     void handleCancelTrans(const QString jobid, const QString reason);
+    void handleFileCounting(const QString ip, const QStringList paths, quint64 totalSize, quint64 fileCount);
     void handleFileCounted(const QString ip, const QStringList paths, quint64 totalSize);
     void handleRpcResult(int32_t type, const QString &response);
     void handleTransException(const QString jobid, const QString reason);
@@ -56,6 +62,7 @@ public slots:
 private:
     std::shared_ptr<TransferWorker> createTransWorker(const QString &jobid);
     void releaseTransWorker(const QString &jobid);
+    void sendTransCount(const QString &ip, const QStringList &paths, quint64 totalSize, bool counting);
 
 private:
     // session worker
@@ -36,6 +36,7 @@ typedef enum dt_type_t {
     REQ_TRANS_CANCLE = 1003,
     CAST_INFO = 1004,
     INFO_TRANS_COUNT = 1005,
+    REQ_TRANS_METRICS = 1006, // 获取对端传输耗时统计(JSON)
 } ComType;
 
 typedef enum apply_flag_t {
@@ -9,6 +9,8 @@
 #include "common/log.h"
 #include "common/commonutils.h"
 
+#include "trace/metrics.h"
+
 #include <QHostInfo>
 #include <QStandardPaths>
 #include <QCoreApplication>
@@ -131,7 +133,7 @@ void SessionWorker::onReceivedMessage(const proto::OriginMessage &request, proto
         if (total > 0) {
             DLOG << "Total transfer size is known:" << total;
             QString oneName = nameList.join(";");
-            emit onTransCount(oneName, total);
+            emit onTransCount(oneName, total, false);
         }
         return;
     }
@@ -175,7 +177,14 @@ void SessionWorker::onReceivedMessage(const proto::OriginMessage &request, proto
         res.size = total;
         response->json_msg = res.as_json().serialize();
 
-        emit onTransCount(oneName, total);
+        // flag: still counting, the total is partial until the final one
+        emit onTransCount(oneName, total, req.flag);
+        return;
+    }
+    break;
+    case REQ_TRANS_METRICS: {
+        DLOG << "Handling REQ_TRANS_METRICS";
+        response->json_msg = BaseKit::Metrics::GetInstance().ToJSON();
         return;
     }
     break;
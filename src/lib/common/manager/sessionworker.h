@@ -45,7 +45,8 @@ public:
 
 signals:
     void onTransData(const QString endpoint, const QStringList nameVector);
-    void onTransCount(const QString names, quint64 size);
+    // counting: the size is a partial total, the final one follows
+    void onTransCount(const QString names, quint64 size, bool counting);
     void onCancelJob(const QString jobid, const QString reason);
     void onConnectChanged(int result, QString reason);
 
@@ -9,6 +9,8 @@
 #include "common/log.h"
 #include "common/constant.h"
 
+#include "trace/metrics.h"
+
 #include <QFile>
 #include <QStorageInfo>
 
@@ -50,7 +52,7 @@ TransferWorker::~TransferWorker()
 // return true -> cancel
 bool TransferWorker::onProgress(uint64_t size)
 {
-    DLOG << "Transfer progress update, size:" << size;
+    DLOGF("Transfer progress update, size: {}", size);
     _status.secsize.fetch_add(size);
 
     return _canceled;
@@ -251,6 +253,9 @@ void TransferWorker::doCalculateSpeed()
     int64_t bytesize = _status.secsize.load();
     _status.secsize.store(0); // reset every second
 
+    static const size_t speed = BASEKIT_METRIC("transfer.speed", BaseKit::MetricKind::GAUGE);
+    BaseKit::Metrics::GetInstance().Set(speed, bytesize);
+
 //    if (_noDataCount > 10) {
 //        DLOG << "10s no data transfer, whole finished!";
 //        // 10 seconds did not receive any data.
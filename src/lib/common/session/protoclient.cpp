@@ -4,6 +4,9 @@
 
 #include "protoclient.h"
 
+#include "algorithms/traffic_shaper.h"
+#include "time/timestamp.h"
+
 void ProtoClient::DisconnectAndStop()
 {
     _stop = true;
@@ -42,6 +45,12 @@ void ProtoClient::handlePong(const std::string &remote)
     // std::cout << "client pong: " << remote << std::endl;
     _connected_host = remote;
     _nopong_count.store(0);
+
+    // the round trip of the heartbeat drives the adaptive bandwidth of transfers
+    uint64_t sent = _ping_sent.exchange(0);
+    if (sent > 0) {
+        BaseKit::TrafficShaper::GetInstance().ReportRtt(remote, (BaseKit::Timestamp::nano() - sent) / 1000);
+    }
 }
 
 bool ProtoClient::pingMessageStart()
@@ -53,6 +62,7 @@ bool ProtoClient::pingMessageStart()
 
     proto::MessageNotify ping;
     ping.notification = "ping";
+    _ping_sent.store(BaseKit::Timestamp::nano());
     send(ping);
 
     _ping_timer->Setup(BaseKit::Timespan::seconds(HEARTBEAT_INTERVAL));
@@ -63,6 +63,8 @@ private:
     // heartbeat: ping <-> pong
     std::shared_ptr<Timer> _ping_timer { nullptr };
     std::atomic<int> _nopong_count { 0 };
+    // time of the ping waiting for its pong
+    std::atomic<uint64_t> _ping_sent { 0 };
 };
 
 #endif // PROTOCLIENT_H
@@ -12,6 +12,8 @@
 #endif
 #include "net/helper/transferhelper.h"
 #include "net/helper/sharehelper.h"
+#include "share/sharecooperationservicemanager.h"
+#include "gui/widgets/sharelatencyview.h"
 #ifdef ENABLE_PHONE
 #include "net/helper/phonehelper.h"
 #endif
@@ -142,6 +144,15 @@ bool CooperaionCorePlugin::start()
         ShareHelper::instance()->registConnectBtn();
         DLOG << "Share connect buttons registered";
 
+        // live latency of the keyboard and mouse sharing, to diagnose lag on a machine
+        if (qEnvironmentVariableIntValue("DDE_COOPERATION_LATENCY_VIEW") == 1) {
+            auto view = new ShareLatencyView(dMain.get());
+            auto manager = ShareCooperationServiceManager::instance();
+            connect(manager->server().data(), &ShareCooperationService::metricsChanged, view, &ShareLatencyView::onMetricsChanged);
+            connect(manager->client().data(), &ShareCooperationService::metricsChanged, view, &ShareLatencyView::onMetricsChanged);
+            DLOG << "Share latency view enabled";
+        }
+
         // bind search&refresh click and other status
         connect(dMain.get(), &MainWindow::searchDevice, NetworkUtil::instance(), &NetworkUtil::trySearchDevice);
         connect(dMain.get(), &MainWindow::refreshDevices, DiscoverController::instance(), &DiscoverController::startDiscover);
@@ -151,6 +162,10 @@ bool CooperaionCorePlugin::start()
         connect(CooperationUtil::instance(), &CooperationUtil::storageConfig, NetworkUtil::instance(), &NetworkUtil::updateStorageConfig);
         DLOG << "Connected storage config signal";
 
+        // bind transfer bandwidth setting, and apply the saved one
+        connect(CooperationUtil::instance(), &CooperationUtil::transferLimitConfig, NetworkUtil::instance(), &NetworkUtil::updateTransferLimits);
+        CooperationUtil::instance()->setTransferLimitConfig();
+
         // bind device change with UI
         connect(CooperationUtil::instance(), &CooperationUtil::onlineStateChanged, dMain.get(), &MainWindow::onlineStateChanged);
         connect(DiscoverController::instance(), &DiscoverController::deviceOnline, dMain.get(), &MainWindow::addDevice);
@@ -4,6 +4,7 @@
 
 #include "discovercontroller.h"
 #include "discovercontroller_p.h"
+#include "zeroconfmonitor.h"
 #include "utils/cooperationutil.h"
 #include "utils/historymanager.h"
 #include "common/log.h"
@@ -20,6 +21,96 @@
 
 using namespace cooperation_core;
 
+// How long to wait for the zeroconf daemon which was just started
+inline constexpr int kServiceWaitTimeout { 10 * 1000 };
+
+DeviceInfoPointer DeviceRegistry::find(const QString &ip) const
+{
+    return entries.value(ip).info;
+}
+
+QString DeviceRegistry::ipOfService(const QString &serviceName) const
+{
+    return services.value(serviceName);
+}
+
+quint64 DeviceRegistry::version(const QString &ip) const
+{
+    return entries.value(ip).version;
+}
+
+QList<DeviceInfoPointer> DeviceRegistry::devices() const
+{
+    QList<DeviceInfoPointer> list;
+    list.reserve(entries.size());
+    for (const auto &entry : entries)
+        list.append(entry.info);
+    return list;
+}
+
+bool DeviceRegistry::isSame(const DeviceInfoPointer &a, const DeviceInfoPointer &b)
+{
+    if (a == b)
+        return true;
+    return a->connectStatus() == b->connectStatus() && a->deviceType() == b->deviceType()
+            && a->toVariantMap() == b->toVariantMap();
+}
+
+bool DeviceRegistry::update(const DeviceInfoPointer &info, const QString &serviceName)
+{
+    const QString ip = info->ipAddress();
+    auto it = entries.find(ip);
+    if (it == entries.end()) {
+        entries.insert(ip, Entry { info, serviceName, ++lastVersion });
+        if (!serviceName.isEmpty())
+            services.insert(serviceName, ip);
+        return true;
+    }
+
+    // a device found by another source keeps its service name
+    if (!serviceName.isEmpty() && it->serviceName != serviceName) {
+        services.remove(it->serviceName);
+        services.insert(serviceName, ip);
+        it->serviceName = serviceName;
+    }
+
+    if (isSame(it->info, info))
+        return false;
+
+    it->info = info;
+    it->version = ++lastVersion;
+    return true;
+}
+
+bool DeviceRegistry::remove(const QString &ip)
+{
+    auto it = entries.find(ip);
+    if (it == entries.end())
+        return false;
+
+    if (!it->serviceName.isEmpty())
+        services.remove(it->serviceName);
+    entries.erase(it);
+    return true;
+}
+
+QStringList DeviceRegistry::merge(const DeviceRegistry &other, QList<DeviceInfoPointer> *changed)
+{
+    QStringList removed;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        if (!other.entries.contains(it.key()))
+            removed.append(it.key());
+    }
+    for (const QString &ip : removed)
+        remove(ip);
+
+    for (const auto &entry : other.entries) {
+        if (update(entry.info, entry.serviceName) && changed)
+            changed->append(entry.info);
+    }
+    return removed;
+}
+
 DiscoverControllerPrivate::DiscoverControllerPrivate(DiscoverController *qq)
     : q(qq)
 {
@@ -32,6 +123,7 @@ DiscoverController::DiscoverController(QObject *parent)
 {
     DLOG << "DiscoverController created";
     qRegisterMetaType<StringMap>("StringMap");
+    d->daemonMonitor = new ZeroConfMonitor(this);
 }
 
 DiscoverController::~DiscoverController()
@@ -79,42 +171,38 @@ void DiscoverController::init()
 
 void DiscoverController::startServiceWaitLoop()
 {
-    DLOG << "Starting service wait loop";
-    QTimer *serviceTimer = new QTimer(this);
-    int retryCount = 0;
-    const int maxRetries = 5; // 5 retries with 2 second intervals = 10 seconds total
-
-    connect(serviceTimer, &QTimer::timeout, this, [serviceTimer, retryCount, maxRetries, this]() mutable {
-        retryCount++;
-
-        if (isZeroConfDaemonActive()) {
-            serviceTimer->stop();
-            DLOG << "Avahi service became active after" << retryCount << "retries";
-            
-            // Start browser when service becomes available
-            if (!d->zeroConf->browserExists()) {
-                DLOG << "Starting ZeroConf browser";
-                d->zeroConf->startBrowser(UNI_CHANNEL);
-            }
-            
-            // Update publishing when service becomes available
-            updatePublish();
-            // Start discovery
-            QTimer::singleShot(500, this, [this]() {
-                startDiscover();
-            });
+    DLOG << "Waiting for avahi service to become active";
+    // onZeroConfDaemonChanged() starts the discovery as soon as the daemon is up
+    QTimer::singleShot(kServiceWaitTimeout, this, [this]() {
+        if (isZeroConfDaemonActive())
             return;
-        }
 
-        if (retryCount >= maxRetries) {
-            serviceTimer->stop();
-            WLOG << "Avahi service startup timeout after" << maxRetries << "retries";
-            // Start discovery anyway for compatibility mode
-            startDiscover();
-        }
+        WLOG << "Avahi service startup timeout after" << kServiceWaitTimeout << "ms";
+        // Start discovery anyway for compatibility mode
+        startDiscover();
     });
+}
 
-    serviceTimer->start(2000); // Check every 2 seconds
+void DiscoverController::onZeroConfDaemonChanged(bool active)
+{
+    if (!active) {
+        WLOG << "Avahi service stopped";
+        return;
+    }
+
+    DLOG << "Avahi service became active";
+    // Start browser when service becomes available
+    if (d->zeroConf && !d->zeroConf->browserExists()) {
+        DLOG << "Starting ZeroConf browser";
+        d->zeroConf->startBrowser(UNI_CHANNEL);
+    }
+
+    // Update publishing when service becomes available
+    updatePublish();
+    // Start discovery
+    QTimer::singleShot(500, this, [this]() {
+        startDiscover();
+    });
 }
 
 void DiscoverController::initZeroConf()
@@ -171,6 +259,7 @@ void DiscoverController::initConnect()
     connect(DConfigManager::instance(), &DConfigManager::valueChanged, this, &DiscoverController::onDConfigValueChanged);
 #endif
     connect(ConfigManager::instance(), &ConfigManager::appAttributeChanged, this, &DiscoverController::onAppAttributeChanged);
+    connect(d->daemonMonitor, &ZeroConfMonitor::activeChanged, this, &DiscoverController::onZeroConfDaemonChanged);
 
     // ZeroConf related connections need to be established after ZeroConf initialization
     // These connections will be established when needed through connectZeroConfSignals() method
@@ -251,13 +340,15 @@ void DiscoverController::deviceLosted(const QString &ip)
     if (oldinfo) {
         if (_historyDevices.contains(ip)) {
             DLOG << "Device is in history, setting status to Offline";
-            // just need to update status
-            oldinfo->setConnectStatus(DeviceInfo::Offline);
-            Q_EMIT deviceOnline({oldinfo});
+            // just need to update status, on a copy so the list sees the change
+            DeviceInfoPointer offlineInfo(new DeviceInfo(*oldinfo));
+            offlineInfo->setConnectStatus(DeviceInfo::Offline);
+            if (d->deviceRegistry.update(offlineInfo))
+                Q_EMIT deviceOnline({ offlineInfo });
             return;
         } else {
             DLOG << "Device is not in history, removing from online list";
-            d->onlineDeviceList.removeOne(oldinfo);
+            d->deviceRegistry.remove(ip);
         }
     }
 
@@ -267,8 +358,8 @@ void DiscoverController::deviceLosted(const QString &ip)
 
 QList<DeviceInfoPointer> DiscoverController::getOnlineDeviceList() const
 {
-    DLOG << "Getting online device list, count:" << d->onlineDeviceList.size();
-    return d->onlineDeviceList;
+    DLOG << "Getting online device list, count:" << d->deviceRegistry.size();
+    return d->deviceRegistry.devices();
 }
 
 bool DiscoverController::openZeroConfDaemonDailog()
@@ -303,58 +394,13 @@ bool DiscoverController::openZeroConfDaemonDailog()
 
 bool DiscoverController::isZeroConfDaemonActive()
 {
-    DLOG << "Checking if ZeroConf daemon is active";
-#ifdef __linux__
-    QProcess process;
-    process.start("systemctl", QStringList() << "is-active"
-                                             << "avahi-daemon.service");
-    process.waitForFinished();
-
-    QString output = process.readAllStandardOutput();
-    QString error = process.readAllStandardError();
-
-    if (process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0) {
-        if (output.contains("active")) {
-            LOG << "Avahi service is running";
-            return true;
-        } else {
-            WLOG << "Avahi service is not running";
-            return false;
-        }
-    } else {
-        ELOG << "Error: " << error.toStdString();
-        return false;
-    }
-
-#else
-    QProcess process;
-    process.start("sc query \"Bonjour Service\"");
-    process.waitForFinished();
-    QByteArray output = process.readAllStandardOutput();
-    QString res = QString::fromLocal8Bit(output);
-
-    if (res.contains("RUNNING")) {
-        DLOG << "Bonjour service is running";
-        return true;
-    } else {
-        DLOG << "Bonjour service is not running";
-        return false;
-    }
-#endif
+    // cached by the monitor, the daemon state changes are pushed to it
+    return instance()->d->daemonMonitor->isActive();
 }
 
 DeviceInfoPointer DiscoverController::findDeviceByIP(const QString &ip)
 {
-    DLOG << "Finding device by IP:" << ip.toStdString();
-    for (int i = 0; i < d->onlineDeviceList.size(); ++i) {
-        auto info = d->onlineDeviceList[i];
-        if (info->ipAddress() == ip) {
-            DLOG << "Device found";
-            return info;
-        }
-    }
-    DLOG << "Device not found";
-    return nullptr;
+    return d->deviceRegistry.find(ip);
 }
 
 DeviceInfoPointer DiscoverController::selfInfo()
@@ -366,12 +412,6 @@ DeviceInfoPointer DiscoverController::selfInfo()
 void DiscoverController::updateDeviceState(const DeviceInfoPointer info)
 {
     DLOG << "Updating device state for IP:" << info->ipAddress().toStdString();
-    auto oldinfo = findDeviceByIP(info->ipAddress());
-    if (oldinfo) {
-        DLOG << "Removing old device info";
-        d->onlineDeviceList.removeOne(oldinfo);
-    }
-
     if (DeviceInfo::Connected == info->connectStatus()) {
         DLOG << "Device is connected, updating connected device IP";
         //record the connected status IP
@@ -381,8 +421,8 @@ void DiscoverController::updateDeviceState(const DeviceInfoPointer info)
         _connectedDevice = "";
     }
 
-    d->onlineDeviceList.append(info);
-    Q_EMIT deviceOnline({ info });
+    if (d->deviceRegistry.update(info))
+        Q_EMIT deviceOnline({ info });
 }
 
 void DiscoverController::onDConfigValueChanged(const QString &config, const QString &key)
@@ -410,6 +450,12 @@ void DiscoverController::onAppAttributeChanged(const QString &group, const QStri
         CooperationUtil::instance()->setStorageConfig(value.toString());
     }
 
+    if (key == AppSettings::TransferRateLimitKey || key == AppSettings::TransferJobRateLimitKey
+        || key == AppSettings::TransferAdaptiveKey) {
+        DLOG << "Transfer limit changed, updating config";
+        CooperationUtil::instance()->setTransferLimitConfig();
+    }
+
     updatePublish();
 }
 
@@ -422,11 +468,8 @@ void DiscoverController::onConnectHistoryUpdated()
     // 1. Remove obsolete history devices (send deviceOffline signal)
     for (const QString &oldIP : _historyDevices) {
         if (!newConnectHistory.contains(oldIP)) {
-            auto device = findDeviceByIP(oldIP);
-            if (device) {
-                d->onlineDeviceList.removeOne(device);
+            if (d->deviceRegistry.remove(oldIP))
                 Q_EMIT deviceOffline(oldIP);
-            }
         }
     }
 
@@ -446,7 +489,7 @@ void DiscoverController::onConnectHistoryUpdated()
         if (!findDeviceByIP(ip)) {
             DeviceInfoPointer info(new DeviceInfo(ip, deviceName));
             info->setConnectStatus(DeviceInfo::Offline);
-            d->onlineDeviceList.append(info);
+            d->deviceRegistry.update(info);
             newDevices.append(info);
         }
     }
@@ -470,8 +513,8 @@ void DiscoverController::addService(QZeroConfService zcs)
         return;
     }
 
-    d->onlineDeviceList.append(devInfo);
-    Q_EMIT deviceOnline({ devInfo });
+    if (d->deviceRegistry.update(devInfo, zcs->name()))
+        Q_EMIT deviceOnline({ devInfo });
 }
 
 void DiscoverController::updateService(QZeroConfService zcs)
@@ -487,27 +530,31 @@ void DiscoverController::updateService(QZeroConfService zcs)
         DLOG << "Parsed device info is invalid, ignoring";
         return;
     }
-    auto oldinfo = findDeviceByIP(devInfo->ipAddress());
-    if (oldinfo) {
-        DLOG << "Removing old device info before updating";
-        d->onlineDeviceList.removeOne(oldinfo);
-    }
 
-    d->onlineDeviceList.append(devInfo);
-    Q_EMIT deviceOnline({ devInfo });
+    // the service may have moved to another address
+    const QString oldIP = d->deviceRegistry.ipOfService(zcs->name());
+    if (!oldIP.isEmpty() && oldIP != devInfo->ipAddress())
+        deviceLosted(oldIP);
+
+    if (d->deviceRegistry.update(devInfo, zcs->name()))
+        Q_EMIT deviceOnline({ devInfo });
 }
 
 void DiscoverController::removeService(QZeroConfService zcs)
 {
     DLOG << "Removing service:" << zcs->name().toStdString();
-    auto devInfo = parseDeviceService(zcs);
-
-    if (!devInfo) {
-        DLOG << "Parsed device info is invalid, ignoring";
-        return;
+    // the txt records of a removed service may already be gone
+    QString ip = d->deviceRegistry.ipOfService(zcs->name());
+    if (ip.isEmpty()) {
+        auto devInfo = parseDeviceService(zcs);
+        if (!devInfo) {
+            DLOG << "Parsed device info is invalid, ignoring";
+            return;
+        }
+        ip = devInfo->ipAddress();
     }
 
-    deviceLosted(devInfo->ipAddress());
+    deviceLosted(ip);
 }
 
 void DiscoverController::updateHistoryDevices(const QMap<QString, QString> &connectMap)
@@ -532,7 +579,7 @@ void DiscoverController::updateHistoryDevices(const QMap<QString, QString> &conn
 
         DeviceInfoPointer info(new DeviceInfo(ip, deviceName));
         info->setConnectStatus(DeviceInfo::Offline);
-        d->onlineDeviceList.append(info);
+        d->deviceRegistry.update(info);
         offlineDevList << info;
     }
 
@@ -615,7 +662,7 @@ void DiscoverController::refresh()
 
     DLOG << "Refreshing discovered devices list";
 
-    // Clear current list and collect new devices
+    // Collect the devices again and pass on the changes
     refreshDeviceList();
 
     // Notify results
@@ -625,43 +672,54 @@ void DiscoverController::refresh()
 void DiscoverController::refreshDeviceList()
 {
     DLOG << "Refreshing device list";
-    // Preserve current online/connected history devices before clearing
-    QList<DeviceInfoPointer> preservedHistoryDevices;
-    for (const auto &device : d->onlineDeviceList) {
-        if (_historyDevices.contains(device->ipAddress()) && 
-            device->connectStatus() != DeviceInfo::Offline) {
-            preservedHistoryDevices.append(device);
-            DLOG << "Preserving online history device:" << device->ipAddress().toStdString();
-        }
-    }
+    // Collect devices from different sources into a new registry
+    DeviceRegistry registry;
+    collectAvahiDevices(registry);
+    addPreservedHistoryDevices(registry);
+    // Known history devices stay in the list while the history is read again
+    // via refreshHistory() -> updateHistoryDevices(), so they do not flicker
+    collectOfflineHistoryDevices(registry);
+    addSearchDeviceIfExists(registry);
 
-    d->onlineDeviceList.clear();
+    applyDeviceList(registry);
+}
+
+void DiscoverController::applyDeviceList(const DeviceRegistry &registry)
+{
+    QList<DeviceInfoPointer> changedDevices;
+    const QStringList removedIPs = d->deviceRegistry.merge(registry, &changedDevices);
+    DLOG << "Device list changes, removed:" << removedIPs.size() << "changed:" << changedDevices.size();
 
-    // Collect devices from different sources
-    collectAvahiDevices();
-    addPreservedHistoryDevices(preservedHistoryDevices);
-    // Note: collectOfflineHistoryDevices() will be called later via refreshHistory() -> updateHistoryDevices()
-    // This ensures we use the latest history data from config, not cached data
-    addSearchDeviceIfExists();
+    for (const QString &ip : removedIPs)
+        Q_EMIT deviceOffline(ip);
+
+    for (const auto &info : changedDevices)
+        DLOG << "Device changed:" << info->ipAddress().toStdString() << "version:" << d->deviceRegistry.version(info->ipAddress());
+
+    if (!changedDevices.isEmpty())
+        Q_EMIT deviceOnline(changedDevices);
 }
 
-void DiscoverController::addPreservedHistoryDevices(const QList<DeviceInfoPointer> &preservedDevices)
+void DiscoverController::addPreservedHistoryDevices(DeviceRegistry &registry)
 {
-    DLOG << "Adding preserved history devices, count:" << preservedDevices.size();
-    for (const auto &device : preservedDevices) {
+    DLOG << "Adding preserved history devices";
+    for (const QString &historyIP : _historyDevices) {
+        auto device = findDeviceByIP(historyIP);
+        if (!device || device->connectStatus() == DeviceInfo::Offline)
+            continue;
+
         // Check if device was found by avahi (might have updated status)
-        auto existingDevice = findDeviceByIP(device->ipAddress());
-        if (!existingDevice) {
+        if (!registry.find(historyIP)) {
             // Device not found by avahi, keep its previous status
-            d->onlineDeviceList.append(device);
-            DLOG << "Re-added preserved history device:" << device->ipAddress().toStdString();
+            registry.update(device);
+            DLOG << "Preserved online history device:" << historyIP.toStdString();
         } else {
-            DLOG << "History device found by avahi, using avahi info:" << device->ipAddress().toStdString();
+            DLOG << "History device found by avahi, using avahi info:" << historyIP.toStdString();
         }
     }
 }
 
-void DiscoverController::collectOfflineHistoryDevices()
+void DiscoverController::collectOfflineHistoryDevices(DeviceRegistry &registry)
 {
     DLOG << "Collecting offline history devices, count:" << _historyDevices.size();
 
@@ -673,24 +731,28 @@ void DiscoverController::collectOfflineHistoryDevices()
     // Add offline history devices that are not already in the list
     int addedCount = 0;
     for (const QString &historyIP : _historyDevices) {
-        if (findDeviceByIP(historyIP)) {
+        if (registry.find(historyIP)) {
             DLOG << "History device already in list:" << historyIP.toStdString();
             continue; // Already in list (from avahi, search, or preserved)
         }
 
-        // Get complete device info from stored map
-        QString deviceName = d->historyDeviceMap.value(historyIP, "Unknown Device");
-        DeviceInfoPointer historyDevice(new DeviceInfo(historyIP, deviceName));
-        historyDevice->setConnectStatus(DeviceInfo::Offline);
-        d->onlineDeviceList.append(historyDevice);
+        // Reuse the known entry, so an unchanged device is not reported again
+        auto historyDevice = findDeviceByIP(historyIP);
+        if (!historyDevice || historyDevice->connectStatus() != DeviceInfo::Offline) {
+            // Get complete device info from stored map
+            QString deviceName = d->historyDeviceMap.value(historyIP, "Unknown Device");
+            historyDevice.reset(new DeviceInfo(historyIP, deviceName));
+            historyDevice->setConnectStatus(DeviceInfo::Offline);
+        }
+        registry.update(historyDevice);
         addedCount++;
-        DLOG << "Added offline history device:" << historyIP.toStdString() << "name:" << deviceName.toStdString();
+        DLOG << "Added offline history device:" << historyIP.toStdString();
     }
 
     DLOG << "Collected" << addedCount << "offline history devices";
 }
 
-void DiscoverController::collectAvahiDevices()
+void DiscoverController::collectAvahiDevices(DeviceRegistry &registry)
 {
     DLOG << "Collecting Avahi devices";
     // Check if avahi service is available for actual discovery
@@ -702,36 +764,29 @@ void DiscoverController::collectAvahiDevices()
     auto allServices = d->zeroConf->getServices();
     DLOG << "Found" << allServices.size() << "avahi services";
 
-    for (const auto &key : allServices.keys()) {
-        QZeroConfService zcs = allServices.value(key);
+    const QString localIP = CooperationUtil::localIPAddress();
+    for (auto it = allServices.cbegin(); it != allServices.cend(); ++it) {
+        QZeroConfService zcs = it.value();
         auto devInfo = parseDeviceService(zcs);
 
-        if (!devInfo || devInfo->ipAddress() == CooperationUtil::localIPAddress()) {
+        if (!devInfo || devInfo->ipAddress() == localIP) {
             DLOG << "Ignoring self or invalid device";
             continue;
         }
 
-        // Check if device already exists and merge status
-        auto existingDevice = findDeviceByIP(devInfo->ipAddress());
-        if (existingDevice) {
-            // Update existing device with latest avahi info
-            existingDevice->setConnectStatus(devInfo->connectStatus());
-            DLOG << "Updated existing device:" << devInfo->ipAddress().toStdString();
-            continue;
-        }
-
         // Update connection status for known connected device
         if (_connectedDevice == devInfo->ipAddress()) {
             DLOG << "Device is the connected device, setting status to Connected";
             devInfo->setConnectStatus(DeviceInfo::Connected);
         }
 
-        d->onlineDeviceList.append(devInfo);
+        // A later service of the same address replaces the earlier one
+        registry.update(devInfo, zcs->name());
         DLOG << "Added avahi device:" << devInfo->ipAddress().toStdString();
     }
 }
 
-void DiscoverController::addSearchDeviceIfExists()
+void DiscoverController::addSearchDeviceIfExists(DeviceRegistry &registry)
 {
     DLOG << "Adding search device if it exists";
     if (!d->searchDevice) {
@@ -740,22 +795,20 @@ void DiscoverController::addSearchDeviceIfExists()
     }
 
     // Check if search device is already in the list
-    auto existingDevice = findDeviceByIP(d->searchDevice->ipAddress());
-    if (existingDevice) {
+    if (registry.find(d->searchDevice->ipAddress())) {
         DLOG << "Search device already exists in list, skipping";
         return;
     }
 
     DLOG << "Adding search device to list:" << d->searchDevice->ipAddress().toStdString();
-    d->onlineDeviceList.append(d->searchDevice);
+    registry.update(d->searchDevice);
 }
 
 void DiscoverController::finishDiscovery()
 {
     DLOG << "Finishing discovery";
-    Q_EMIT deviceOnline({ d->onlineDeviceList });
-    bool hasFound = !d->onlineDeviceList.isEmpty();
-    DLOG << "Discovery finished, found" << d->onlineDeviceList.size() << "devices";
+    bool hasFound = !d->deviceRegistry.isEmpty();
+    DLOG << "Discovery finished, found" << d->deviceRegistry.size() << "devices";
     Q_EMIT discoveryFinished(hasFound);
 }
 
@@ -770,6 +823,8 @@ void DiscoverController::addSearchDeivce(const QString &info)
     d->searchDevice = devInfo;
     if (devInfo->isValid()) {
         DLOG << "Search device is valid, emitting deviceOnline signal";
+        // always reported, the user is waiting for the result
+        d->deviceRegistry.update(d->searchDevice);
         Q_EMIT deviceOnline({ d->searchDevice });
     }
 }
@@ -809,8 +864,8 @@ void DiscoverController::compatAddDeivces(StringMap infoMap)
             if (sharedip == CooperationUtil::localIPAddress() || _connectedDevice == devInfo->ipAddress())
                 devInfo->setConnectStatus(DeviceInfo::Connected);
 
-            d->onlineDeviceList.append(devInfo);
-            addedList.append(devInfo);
+            if (d->deviceRegistry.update(devInfo))
+                addedList.append(devInfo);
         }
     }
 
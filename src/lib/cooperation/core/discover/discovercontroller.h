@@ -16,6 +16,7 @@ Q_DECLARE_METATYPE(StringMap)
 namespace cooperation_core {
 
 class DiscoverControllerPrivate;
+class DeviceRegistry;
 class DiscoverController : public QObject
 {
     Q_OBJECT
@@ -59,6 +60,7 @@ private Q_SLOTS:
 
     void onDConfigValueChanged(const QString &config, const QString &key);
     void onAppAttributeChanged(const QString &group, const QString &key, const QVariant &value);
+    void onZeroConfDaemonChanged(bool active);
 
     void addSearchDeivce(const QString &info);
     void compatAddDeivces(StringMap infoMap);
@@ -72,11 +74,12 @@ private:
     void initConnect();
     void connectZeroConfSignals();
     void startServiceWaitLoop();
-    void collectAvahiDevices();
-    void collectOfflineHistoryDevices();
-    void addPreservedHistoryDevices(const QList<DeviceInfoPointer> &preservedDevices);
-    void addSearchDeviceIfExists();
+    void collectAvahiDevices(DeviceRegistry &registry);
+    void collectOfflineHistoryDevices(DeviceRegistry &registry);
+    void addPreservedHistoryDevices(DeviceRegistry &registry);
+    void addSearchDeviceIfExists(DeviceRegistry &registry);
     void refreshDeviceList();
+    void applyDeviceList(const DeviceRegistry &registry);
     void finishDiscovery();
     void finishDiscoveryWithError(const QString &errorMsg);
     bool isVaildDevice(const DeviceInfoPointer info);
@@ -8,8 +8,46 @@
 #include "discovercontroller.h"
 #include "qzeroconf.h"
 
+#include <QHash>
+
 namespace cooperation_core {
 
+// Known devices indexed by IP and by zeroconf service name.
+// Every change of an entry gets a new version, so only the devices
+// which really changed are passed on to the device list.
+class DeviceRegistry
+{
+public:
+    struct Entry
+    {
+        DeviceInfoPointer info;
+        QString serviceName;
+        quint64 version { 0 };
+    };
+
+    DeviceInfoPointer find(const QString &ip) const;
+    QString ipOfService(const QString &serviceName) const;
+    quint64 version(const QString &ip) const;
+    QList<DeviceInfoPointer> devices() const;
+    bool isEmpty() const { return entries.isEmpty(); }
+    int size() const { return entries.size(); }
+
+    // Insert or replace the device, false if nothing changed
+    bool update(const DeviceInfoPointer &info, const QString &serviceName = QString());
+    bool remove(const QString &ip);
+
+    // Take over the devices of other, returns the IPs which are gone
+    QStringList merge(const DeviceRegistry &other, QList<DeviceInfoPointer> *changed);
+
+private:
+    static bool isSame(const DeviceInfoPointer &a, const DeviceInfoPointer &b);
+
+    QHash<QString, Entry> entries;
+    QHash<QString, QString> services;
+    quint64 lastVersion { 0 };
+};
+
+class ZeroConfMonitor;
 class DiscoverControllerPrivate
 {
     friend class DiscoverController;
@@ -20,7 +58,8 @@ public:
 private:
     DiscoverController *q;
     QZeroConf *zeroConf = { nullptr };
-    QList<DeviceInfoPointer> onlineDeviceList;
+    ZeroConfMonitor *daemonMonitor = { nullptr };
+    DeviceRegistry deviceRegistry;
     DeviceInfoPointer searchDevice;
     //过滤非同子网段
     QString ipfilter;
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "zeroconfmonitor.h"
+#include "common/log.h"
+
+#ifdef __linux__
+#    include <QDBusConnection>
+#    include <QDBusConnectionInterface>
+#    include <QDBusServiceWatcher>
+#else
+#    include <QProcess>
+#endif
+
+#ifdef __linux__
+inline constexpr char AvahiServerName[] { "org.freedesktop.Avahi" };
+#else
+// Bonjour has no change notification, its service state is polled
+inline constexpr int kBonjourPollInterval { 5 * 1000 };
+#endif
+
+using namespace cooperation_core;
+
+ZeroConfMonitor::ZeroConfMonitor(QObject *parent)
+    : QObject(parent)
+{
+#ifdef __linux__
+    // avahi-daemon owns its name on the system bus while it is running
+    auto bus = QDBusConnection::systemBus();
+    auto watcher = new QDBusServiceWatcher(AvahiServerName, bus,
+                                           QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(watcher, &QDBusServiceWatcher::serviceRegistered, this, [this]() { setActive(true); });
+    connect(watcher, &QDBusServiceWatcher::serviceUnregistered, this, [this]() { setActive(false); });
+
+    // one bus round trip for the initial state, later changes are pushed
+    active = bus.isConnected() && bus.interface()->isServiceRegistered(AvahiServerName);
+    LOG << "Avahi service is" << (active ? "running" : "not running");
+#else
+    // the first answer is needed by init(), later queries do not wait
+    QProcess process;
+    process.start("sc", QStringList() << "query" << "Bonjour Service");
+    process.waitForFinished();
+    active = QString::fromLocal8Bit(process.readAllStandardOutput()).contains("RUNNING");
+    DLOG << "Bonjour service is" << (active ? "running" : "not running");
+
+    connect(&pollTimer, &QTimer::timeout, this, &ZeroConfMonitor::startQuery);
+    pollTimer.start(kBonjourPollInterval);
+#endif
+}
+
+void ZeroConfMonitor::setActive(bool value)
+{
+    if (active == value)
+        return;
+
+    LOG << "Zeroconf daemon is" << (value ? "running" : "not running");
+    active = value;
+    Q_EMIT activeChanged(active);
+}
+
+#ifndef __linux__
+void ZeroConfMonitor::startQuery()
+{
+    if (queryProcess)
+        return;
+
+    queryProcess = new QProcess(this);
+    connect(queryProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &ZeroConfMonitor::onQueryFinished);
+    connect(queryProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            onQueryFinished();
+    });
+    queryProcess->start("sc", QStringList() << "query" << "Bonjour Service");
+}
+
+void ZeroConfMonitor::onQueryFinished()
+{
+    QString res = QString::fromLocal8Bit(queryProcess->readAllStandardOutput());
+    queryProcess->deleteLater();
+    queryProcess = nullptr;
+
+    setActive(res.contains("RUNNING"));
+}
+#endif
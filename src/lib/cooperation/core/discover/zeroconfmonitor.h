@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ZEROCONFMONITOR_H
+#define ZEROCONFMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+
+class QProcess;
+namespace cooperation_core {
+
+// Watches whether the zeroconf daemon (avahi or Bonjour) is running.
+// The state is cached, so asking for it never blocks the caller.
+class ZeroConfMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ZeroConfMonitor(QObject *parent = nullptr);
+
+    bool isActive() const { return active; }
+
+Q_SIGNALS:
+    void activeChanged(bool active);
+
+private Q_SLOTS:
+    void setActive(bool active);
+#ifndef __linux__
+    void startQuery();
+    void onQueryFinished();
+#endif
+
+private:
+    bool active { false };
+#ifndef __linux__
+    QProcess *queryProcess { nullptr };
+    QTimer pollTimer;
+#endif
+};
+
+}   // namespace cooperation_core
+
+#endif   // ZEROCONFMONITOR_H
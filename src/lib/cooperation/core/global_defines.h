@@ -108,6 +108,10 @@ inline constexpr char TransferModeKey[] { "TransferMode" };
 inline constexpr char StoragePathKey[] { "StoragePath" };
 inline constexpr char ClipboardShareKey[] { "ClipboardShare" };
 inline constexpr char CooperationEnabled[] { "CooperationEnabled" };
+// bandwidth of the file transfers in KB/s, 0 is unlimited
+inline constexpr char TransferRateLimitKey[] { "TransferRateLimit" };
+inline constexpr char TransferJobRateLimitKey[] { "TransferJobRateLimit" };
+inline constexpr char TransferAdaptiveKey[] { "TransferAdaptive" };
 
 inline constexpr char CacheGroup[] { "Cache" };
 inline constexpr char TransHistoryKey[] { "TransHistory" };
@@ -282,15 +282,62 @@ void SettingDialogPrivate::createTransferWidget()
     SettingItem *fileSaveItem = new SettingItem(q);
     fileSaveItem->setItemInfo(tr("File save location"), chooserEdit);
 
+    rateLimitCB = createRateLimitComboBox();
+    connect(rateLimitCB, qOverload<int>(&QComboBox::currentIndexChanged), this, &SettingDialogPrivate::onRateLimitComboBoxValueChanged);
+    SettingItem *rateLimitItem = new SettingItem(q);
+    rateLimitItem->setItemInfo(tr("Transfer speed limit"), rateLimitCB);
+
+    jobRateLimitCB = createRateLimitComboBox();
+    connect(jobRateLimitCB, qOverload<int>(&QComboBox::currentIndexChanged), this, &SettingDialogPrivate::onJobRateLimitComboBoxValueChanged);
+    SettingItem *jobRateLimitItem = new SettingItem(q);
+    jobRateLimitItem->setItemInfo(tr("Speed limit of each transfer"), jobRateLimitCB);
+
+    adaptiveLimitSwitchBtn = new CooperationSwitchButton(q);
+    connect(adaptiveLimitSwitchBtn, &CooperationSwitchButton::clicked, this, &SettingDialogPrivate::onAdaptiveLimitButtonClicked);
+    SettingItem *adaptiveLimitItem = new SettingItem(q);
+    adaptiveLimitItem->setItemInfo(tr("Slow down when the network is busy"), adaptiveLimitSwitchBtn);
+
     contentLayout->addWidget(transferItem);
     contentLayout->addSpacing(12);
     contentLayout->addWidget(fileSaveItem);
     contentLayout->addSpacing(12);
+    contentLayout->addWidget(rateLimitItem);
+    contentLayout->addSpacing(12);
+    contentLayout->addWidget(jobRateLimitItem);
+    contentLayout->addSpacing(12);
+    contentLayout->addWidget(adaptiveLimitItem);
+    contentLayout->addSpacing(12);
 #ifndef linux
     setQComboxWinStyle(transferCB);
 #endif
 }
 
+QComboBox *SettingDialogPrivate::createRateLimitComboBox()
+{
+    // the limits are stored in KB/s, 0 is unlimited
+    QComboBox *combox = new QComboBox(q);
+    combox->addItem(tr("Unlimited"), 0);
+    for (int mb : { 1, 5, 10, 50 })
+        combox->addItem(QString("%1 MB/s").arg(mb), mb * 1024);
+    combox->setFixedWidth(280);
+#ifndef linux
+    setQComboxWinStyle(combox);
+#endif
+    return combox;
+}
+
+void SettingDialogPrivate::setRateLimit(QComboBox *combox, const QVariant &value)
+{
+    qulonglong rate = value.isValid() ? value.toULongLong() : 0;
+    int index = combox->findData(rate);
+    if (index < 0) {
+        // keep a limit set outside of the dialog selectable
+        combox->addItem(QString("%1 KB/s").arg(rate), rate);
+        index = combox->count() - 1;
+    }
+    combox->setCurrentIndex(index);
+}
+
 void SettingDialogPrivate::createClipboardShareWidget()
 {
     DLOG << "Creating clipboard share widget";
@@ -350,6 +397,24 @@ void SettingDialogPrivate::onTransferComboBoxValueChanged(int index)
 #endif
 }
 
+void SettingDialogPrivate::onRateLimitComboBoxValueChanged(int index)
+{
+    DLOG << "Transfer rate limit changed to index:" << index;
+    ConfigManager::instance()->setAppAttribute(AppSettings::GenericGroup, AppSettings::TransferRateLimitKey, rateLimitCB->itemData(index));
+}
+
+void SettingDialogPrivate::onJobRateLimitComboBoxValueChanged(int index)
+{
+    DLOG << "Transfer job rate limit changed to index:" << index;
+    ConfigManager::instance()->setAppAttribute(AppSettings::GenericGroup, AppSettings::TransferJobRateLimitKey, jobRateLimitCB->itemData(index));
+}
+
+void SettingDialogPrivate::onAdaptiveLimitButtonClicked(bool clicked)
+{
+    DLOG << "Adaptive transfer limit changed to:" << clicked;
+    ConfigManager::instance()->setAppAttribute(AppSettings::GenericGroup, AppSettings::TransferAdaptiveKey, clicked);
+}
+
 bool SettingDialogPrivate::checkNameValid()
 {
     DLOG << "Checking if device name is valid";
@@ -669,6 +734,13 @@ void SettingDialog::loadConfig()
         ConfigManager::instance()->setAppAttribute(AppSettings::GenericGroup, AppSettings::StoragePathKey, defaultPath);
     }
 
+    value = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferRateLimitKey);
+    d->setRateLimit(d->rateLimitCB, value);
+    value = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferJobRateLimitKey);
+    d->setRateLimit(d->jobRateLimitCB, value);
+    value = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferAdaptiveKey);
+    d->adaptiveLimitSwitchBtn->setChecked(value.isValid() ? value.toBool() : false);
+
     value = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::ClipboardShareKey);
     if (value.isValid()) {
         d->clipShareSwitchBtn->setChecked(value.toBool());
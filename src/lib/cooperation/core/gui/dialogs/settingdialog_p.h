@@ -37,6 +37,9 @@ public Q_SLOTS:
     void onFindComboBoxValueChanged(int index);
     void onConnectComboBoxValueChanged(int index);
     void onTransferComboBoxValueChanged(int index);
+    void onRateLimitComboBoxValueChanged(int index);
+    void onJobRateLimitComboBoxValueChanged(int index);
+    void onAdaptiveLimitButtonClicked(bool clicked);
     void onEditFinished();
     void onNameChanged(const QString &text);
     void onDeviceShareButtonClicked(bool clicked);
@@ -50,6 +53,8 @@ private:
     void createDeviceShareWidget();
     void createTransferWidget();
     void createClipboardShareWidget();
+    QComboBox *createRateLimitComboBox();
+    void setRateLimit(QComboBox *combox, const QVariant &value);
     bool checkNameValid();
 
 private:
@@ -60,6 +65,9 @@ private:
     QComboBox *findCB { nullptr };
     QComboBox *connectCB { nullptr };
     QComboBox *transferCB { nullptr };
+    QComboBox *rateLimitCB { nullptr };
+    QComboBox *jobRateLimitCB { nullptr };
+    CooperationSwitchButton *adaptiveLimitSwitchBtn { nullptr };
     CooperationLineEdit *nameEdit { nullptr };
     CooperationSwitchButton *devShareSwitchBtn { nullptr };
     CooperationSwitchButton *clipShareSwitchBtn { nullptr };
@@ -9,6 +9,7 @@
 #include "widgets/cooperationstatewidget.h"
 #include "common/log.h"
 #include "net/helper/phonehelper.h"
+#include "discover/discovercontroller.h"
 
 #include <QScreen>
 #include <QUrl>
@@ -149,6 +150,7 @@ void MainWindow::onlineStateChanged(const QString &validIP)
     if (offline) {
         DLOG << "Device is offline";
         d->workspaceWidget->clear();
+        _deviceListCleared = true;
         d->workspaceWidget->switchWidget(WorkspaceWidget::kNoNetworkWidget);
         d->setIP("---");
     } else {
@@ -173,13 +175,14 @@ void MainWindow::onLookingForDevices()
     if (!isNetworkConnected) {
         DLOG << "Network is not connected, showing network disconnected page";
         d->workspaceWidget->clear();
+        _deviceListCleared = true;
         d->workspaceWidget->switchWidget(WorkspaceWidget::kNoNetworkWidget);
         return;
     }
 
     _userAction = true;
     emit refreshDevices();
-    d->workspaceWidget->clear();
+    // the list is kept, discovery only reports the devices which changed
     d->workspaceWidget->switchWidget(WorkspaceWidget::kLookignForDeviceWidget);
     DLOG << "Device search started";
 }
@@ -206,6 +209,14 @@ void MainWindow::onDiscoveryFinished(bool hasFound)
         d->workspaceWidget->switchWidget(WorkspaceWidget::kNoResultWidget);
     }
 
+    if (hasFound && (_userAction || _deviceListCleared)) {
+        DLOG << "Showing the device list";
+        d->workspaceWidget->switchWidget(WorkspaceWidget::kDeviceListWidget);
+        if (_deviceListCleared)
+            d->workspaceWidget->addDeviceInfos(DiscoverController::instance()->getOnlineDeviceList());
+    }
+    _deviceListCleared = false;
+
     _userAction = false;
     DLOG << "Discovery process completed";
 }
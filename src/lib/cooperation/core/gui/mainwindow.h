@@ -64,6 +64,8 @@ private:
     QScopedPointer<MainWindowPrivate> d;
 
     bool _userAction { false };
+    // the list was cleared, the next discovery shows all devices again
+    bool _deviceListCleared { false };
 };
 
 }   // namespace cooperation_core
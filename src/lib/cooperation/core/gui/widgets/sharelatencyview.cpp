@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sharelatencyview.h"
+#include "gui/utils/cooperationguihelper.h"
+#include "common/log.h"
+
+#include <QLabel>
+#include <QLocale>
+#include <QPainter>
+#include <QPainterPath>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+using namespace cooperation_core;
+
+namespace {
+// one sample a second, the last two minutes
+const int kHistorySize = 120;
+// the graph is never scaled below this round trip in ms
+const double kMinScale = 20;
+}
+
+LatencyGraph::LatencyGraph(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(240, 80);
+}
+
+void LatencyGraph::addSample(double rtt)
+{
+    samples.append(rtt);
+    if (samples.size() > kHistorySize)
+        samples.removeFirst();
+    update();
+}
+
+void LatencyGraph::clear()
+{
+    samples.clear();
+    update();
+}
+
+void LatencyGraph::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QColor color = CooperationGuiHelper::instance()->isDarkTheme() ? QColor(189, 222, 255) : QColor(33, 138, 244);
+    QRectF area = QRectF(rect()).adjusted(1, 1, -1, -1);
+
+    color.setAlphaF(0.17);
+    painter.setPen(color);
+    painter.drawRect(area);
+
+    double scale = kMinScale;
+    for (double rtt : samples)
+        scale = std::max(scale, rtt);
+    painter.drawText(area.adjusted(4, 2, -4, -2), Qt::AlignTop | Qt::AlignLeft,
+                     QString("%1 ms").arg(scale, 0, 'f', 0));
+
+    // unknown round trips leave a gap
+    QPainterPath path;
+    bool drawing = false;
+    double step = area.width() / (kHistorySize - 1);
+    double x = area.right() - step * (samples.size() - 1);
+    for (double rtt : samples) {
+        if (rtt < 0) {
+            drawing = false;
+        } else {
+            QPointF point(x, area.bottom() - area.height() * rtt / scale);
+            if (drawing)
+                path.lineTo(point);
+            else
+                path.moveTo(point);
+            drawing = true;
+        }
+        x += step;
+    }
+
+    color.setAlphaF(1.0);
+    painter.setPen(QPen(color, 1.5));
+    painter.drawPath(path);
+}
+
+ShareLatencyView::ShareLatencyView(QWidget *parent)
+    : QWidget(parent, Qt::Tool)
+{
+    DLOG << "Initializing share latency view";
+    initUI();
+}
+
+void ShareLatencyView::initUI()
+{
+    setWindowTitle(tr("Keyboard and mouse sharing latency"));
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setTextFormat(Qt::PlainText);
+    graph = new LatencyGraph(this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(10, 10, 10, 10);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(graph, 1);
+}
+
+void ShareLatencyView::onMetricsChanged(const ShareMetrics &metrics)
+{
+    if (!metrics.reporting) {
+        graph->clear();
+        hide();
+        return;
+    }
+
+    QLocale locale;
+    QString rtt = metrics.rtt < 0 ? tr("unknown") : QString("%1 ms").arg(metrics.rtt, 0, 'f', 1);
+    QString clipboardTime = metrics.clipboardTime < 0 ? tr("none") : QString("%1 ms").arg(metrics.clipboardTime, 0, 'f', 0);
+    summaryLabel->setText(tr("Round trip: %1\nEvents: %2/s\nQueued: %3\nClipboard: %4/s, last took %5")
+                                  .arg(rtt)
+                                  .arg(metrics.eventRate, 0, 'f', 0)
+                                  .arg(locale.formattedDataSize(static_cast<qint64>(metrics.queueDepth)))
+                                  .arg(locale.formattedDataSize(static_cast<qint64>(metrics.clipboardRate)))
+                                  .arg(clipboardTime));
+    graph->addSample(metrics.rtt);
+
+    if (!isVisible())
+        show();
+}
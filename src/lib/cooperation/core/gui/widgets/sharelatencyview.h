@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SHARELATENCYVIEW_H
+#define SHARELATENCYVIEW_H
+
+#include "share/sharecooperationservice.h"
+
+#include <QVector>
+#include <QWidget>
+
+class QLabel;
+
+namespace cooperation_core {
+
+class LatencyGraph : public QWidget
+{
+public:
+    explicit LatencyGraph(QWidget *parent = nullptr);
+
+    void addSample(double rtt);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QVector<double> samples;
+};
+
+// Live counters of the keyboard and mouse sharing, shown while barrier reports them
+class ShareLatencyView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ShareLatencyView(QWidget *parent = nullptr);
+
+public Q_SLOTS:
+    void onMetricsChanged(const ShareMetrics &metrics);
+
+private:
+    void initUI();
+
+    QLabel *summaryLabel { nullptr };
+    LatencyGraph *graph { nullptr };
+};
+
+}   // namespace cooperation_core
+
+#endif   // SHARELATENCYVIEW_H
@@ -20,6 +20,12 @@ namespace ipc {
 
 inline const char CooperRegisterName[] { "daemon-cooperation" };
 
+// app config keys of the compat daemon, same as KEY_APP_* in compat/common/constant.h
+inline const char KEY_APP_STORAGE_DIR[] { "storagedir" };
+inline const char KEY_APP_RATE_LIMIT[] { "ratelimit" };
+inline const char KEY_APP_JOB_RATE_LIMIT[] { "jobratelimit" };
+inline const char KEY_APP_ADAPTIVE_LIMIT[] { "adaptivelimit" };
+
 typedef enum ipc_type_t {
     IPC_PING = 10,
     MISC_MSG = 11,
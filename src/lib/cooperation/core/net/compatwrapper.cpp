@@ -49,9 +49,14 @@ void CompatWrapperPrivate::onTimeConnectBackend()
         ipcInterface->remoteConnect(SIGNAL(cooperationSignal(int, QString)), this, SLOT(ipcCompatSlot(int, QString)));
 
         QString who = qApp->applicationName();
-        ipcInterface->call("bindSignal", Q_RETURN_ARG(QString, sessionId), Q_ARG(QString, who), Q_ARG(QString, "cooperationSignal"));
-
-        LOG << "ping return ID:" << sessionId.toStdString();
+        ipcInterface->callAsync("bindSignal", "QString", [this](bool ok, const QVariant &result) {
+            if (!ok) {
+                WLOG << "Failed to bind the daemon signal: " << result.toString().toStdString();
+                return;
+            }
+            sessionId = result.toString();
+            LOG << "ping return ID:" << sessionId.toStdString();
+        }, Q_ARG(QString, who), Q_ARG(QString, "cooperationSignal"));
     } else {
         //WLOG << "can not connect to daemon backend";
         ipcTimer->start(2000);
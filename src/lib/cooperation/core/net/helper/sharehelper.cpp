@@ -374,7 +374,14 @@ void ShareHelper::notifyConnectRequest(const QString &info)
 {
     DLOG << "Received connection request:" << info.toStdString();
 
-    bool isCooperating = NetworkUtil::instance()->isCurrentlyCooperating();
+    // 协同状态查询完成后再处理请求
+    NetworkUtil::instance()->checkCurrentlyCooperating([this, info](bool isCooperating) {
+        handleConnectRequest(info, isCooperating);
+    });
+}
+
+void ShareHelper::handleConnectRequest(const QString &info, bool isCooperating)
+{
     // 检查是否正在协同中
     if (isCooperating) {
         WLOG << "Device is currently cooperating, rejecting new request immediately";
@@ -47,6 +47,8 @@ private:
     explicit ShareHelper(QObject *parent = nullptr);
     ~ShareHelper();
 
+    void handleConnectRequest(const QString &info, bool isCooperating);
+
     QSharedPointer<ShareHelperPrivate> d { nullptr };
 };
 
@@ -514,6 +514,15 @@ void TransferHelper::onTransChanged(int status, const QString &path, quint64 siz
         DLOG << "Transfer count size updated";
         // only update the total size while rpc notice
         d->transferInfo.totalSize = size;
+        d->transferInfo.counting = false;
+        break;
+    case TRANS_COUNTING:
+        DLOG << "Transfer partial count size:" << size;
+        // a partial total arriving late must not replace the final one
+        if (d->transferInfo.counting || d->transferInfo.totalSize < 1) {
+            d->transferInfo.totalSize = size;
+            d->transferInfo.counting = true;
+        }
         break;
     case TRANS_WHOLE_START:
         DLOG << "Transfer started successfully";
@@ -574,6 +583,10 @@ void TransferHelper::updateTransProgress(uint64_t current)
     int remain_time;
     if (progressValue <= 0) {
         return;
+    } else if (d->transferInfo.counting && progressValue >= 99) {
+        // the partial total has been passed, wait for the final one
+        progressValue = 99;
+        remain_time = 0;
     } else if (progressValue >= 100) {
         progressValue = 100;
         remain_time = 0;
@@ -28,6 +28,18 @@
 #include <QScreen>
 
 using namespace cooperation_core;
+
+#ifdef ENABLE_COMPAT
+// The daemon is called asynchronously, only a failed call is worth noting
+static SlotIPCInterface::CallFinished compatReply(const char *method)
+{
+    return [method](bool ok, const QVariant &result) {
+        if (!ok)
+            WLOG << "Compat call " << method << " failed: " << result.toString().toStdString();
+    };
+}
+#endif
+
 NetworkUtilPrivate::NetworkUtilPrivate(NetworkUtil *qq)
     : q(qq)
 {
@@ -474,10 +486,12 @@ void NetworkUtil::handleCompatRegister(bool reg, const QString &infoJson)
     auto ipc = CompatWrapper::instance()->ipcInterface();
     if (reg) {
         DLOG << "Registering discovery";
-        ipc->call("registerDiscovery", Q_ARG(bool, false), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, infoJson));
+        ipc->callAsync("registerDiscovery", QString(), compatReply("registerDiscovery"),
+                       Q_ARG(bool, false), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, infoJson));
     } else {
         DLOG << "Unregistering discovery";
-        ipc->call("registerDiscovery", Q_ARG(bool, true), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ""));
+        ipc->callAsync("registerDiscovery", QString(), compatReply("registerDiscovery"),
+                       Q_ARG(bool, true), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ""));
     }
 }
 
@@ -485,9 +499,17 @@ void NetworkUtil::handleCompatDiscover()
 {
     DLOG << "Handling compat discover";
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    QString nodesJson;
-    ipc->call("getDiscovery", Q_RETURN_ARG(QString, nodesJson));
+    ipc->callAsync("getDiscovery", "QString", [this](bool ok, const QVariant &result) {
+        if (!ok) {
+            WLOG << "Failed to get the compat discovery: " << result.toString().toStdString();
+            return;
+        }
+        addCompatDevices(result.toString());
+    });
+}
 
+void NetworkUtil::addCompatDevices(const QString &nodesJson)
+{
     // DLOG << "discovery return:" << nodesJson.toStdString();
     if (!nodesJson.isEmpty()) {
         DLOG << "Nodes JSON is not empty";
@@ -548,12 +570,31 @@ void NetworkUtil::updateStorageConfig(const QString &value)
     DLOG << "Updating compat storage config";
     //update the storage dir for old protocol
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("saveAppConfig", Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, "storagedir"), Q_ARG(QString, value));
+    ipc->callAsync("saveAppConfig", QString(), compatReply("saveAppConfig"),
+                   Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::KEY_APP_STORAGE_DIR), Q_ARG(QString, value));
 #else
     DLOG << "Compat mode not enabled, skipping compat storage config update";
 #endif
 }
 
+void NetworkUtil::updateTransferLimits(quint64 global, quint64 job, bool adaptive)
+{
+    DLOG << "Updating transfer limits, global:" << global << "job:" << job << "adaptive:" << adaptive;
+    d->sessionManager->setTransferLimits(global, job, adaptive);
+
+#ifdef ENABLE_COMPAT
+    DLOG << "Updating compat transfer limits";
+    //update the limits for old protocol, applied when its transfer job starts
+    auto ipc = CompatWrapper::instance()->ipcInterface();
+    ipc->callAsync("saveAppConfig", QString(), compatReply("saveAppConfig"),
+                   Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::KEY_APP_RATE_LIMIT), Q_ARG(QString, QString::number(global)));
+    ipc->callAsync("saveAppConfig", QString(), compatReply("saveAppConfig"),
+                   Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::KEY_APP_JOB_RATE_LIMIT), Q_ARG(QString, QString::number(job)));
+    ipc->callAsync("saveAppConfig", QString(), compatReply("saveAppConfig"),
+                   Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::KEY_APP_ADAPTIVE_LIMIT), Q_ARG(QString, adaptive ? "true" : "false"));
+#endif
+}
+
 void NetworkUtil::setStorageFolder(const QString &folder)
 {
     DLOG << "Setting storage folder:" << folder.toStdString();
@@ -606,7 +647,7 @@ void NetworkUtil::reqTargetInfo(const QString &ip, bool compat)
         DLOG << "Compat mode enabled, trying with old protocol by daemon";
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doAsyncSearch", Q_ARG(QString, ip), Q_ARG(bool, false));
+        ipc->callAsync("doAsyncSearch", QString(), compatReply("doAsyncSearch"), Q_ARG(QString, ip), Q_ARG(bool, false));
 #else
         DLOG << "Compat mode not enabled, cannot request target info with compat";
 #endif
@@ -635,8 +676,9 @@ void NetworkUtil::compatLogin(const QString &ip)
     auto appName = qAppName();
     // try connect with old protocol by daemon
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("doTryConnect", Q_ARG(QString, appName), Q_ARG(QString, ipc::CooperRegisterName),
-              Q_ARG(QString, ip), Q_ARG(QString, ""));
+    ipc->callAsync("doTryConnect", QString(), compatReply("doTryConnect"),
+                   Q_ARG(QString, appName), Q_ARG(QString, ipc::CooperRegisterName),
+                   Q_ARG(QString, ip), Q_ARG(QString, ""));
 #else
     DLOG << "Compat mode not enabled, cannot perform compat login";
 #endif
@@ -707,7 +749,8 @@ void NetworkUtil::sendTransApply(const QString &ip, bool compat)
         auto appName = qAppName();
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doApplyTransfer", Q_ARG(QString, appName), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, deviceName));
+        ipc->callAsync("doApplyTransfer", QString(), compatReply("doApplyTransfer"),
+                       Q_ARG(QString, appName), Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, deviceName));
 #else
         DLOG << "Compat mode not enabled, cannot send transfer apply with compat";
 #endif
@@ -759,7 +802,8 @@ void NetworkUtil::sendShareApply(const QString &ip, bool compat)
         auto appName = qAppName();
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doApplyShare", Q_ARG(QString, appName), Q_ARG(QString, appName), Q_ARG(QString, ip), Q_ARG(QString, data));
+        ipc->callAsync("doApplyShare", QString(), compatReply("doApplyShare"),
+                       Q_ARG(QString, appName), Q_ARG(QString, appName), Q_ARG(QString, ip), Q_ARG(QString, data));
 #else
         DLOG << "Compat mode not enabled, cannot send share apply with compat";
 #endif
@@ -797,7 +841,8 @@ void NetworkUtil::sendDisconnectShareEvents(const QString &ip)
         DLOG << "Compat mode enabled, trying with old protocol by daemon";
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doDisconnectShare", Q_ARG(QString, qAppName()), Q_ARG(QString, qAppName()), Q_ARG(QString, selfinfo->deviceName()));
+        ipc->callAsync("doDisconnectShare", QString(), compatReply("doDisconnectShare"),
+                       Q_ARG(QString, qAppName()), Q_ARG(QString, qAppName()), Q_ARG(QString, selfinfo->deviceName()));
 #else
         DLOG << "Compat mode not enabled, cannot send disconnect share events";
 #endif
@@ -825,8 +870,9 @@ void NetworkUtil::replyTransRequest(bool agree, const QString &targetIp)
         auto deviceName = CooperationUtil::deviceInfo().value(AppSettings::DeviceNameKey).toString();
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doReplyTransfer", Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::CooperRegisterName),
-                  Q_ARG(QString, deviceName), Q_ARG(bool, agree));
+        ipc->callAsync("doReplyTransfer", QString(), compatReply("doReplyTransfer"),
+                       Q_ARG(QString, ipc::CooperRegisterName), Q_ARG(QString, ipc::CooperRegisterName),
+                       Q_ARG(QString, deviceName), Q_ARG(bool, agree));
 #else
         DLOG << "Compat mode not enabled, cannot reply transfer request";
 #endif
@@ -853,7 +899,8 @@ void NetworkUtil::replyShareRequest(bool agree, const QString &selfprint, const
         int reply = agree ? SHARE_CONNECT_COMFIRM : SHARE_CONNECT_REFUSE;
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doReplyShare", Q_ARG(QString, qAppName()), Q_ARG(QString, qAppName()), Q_ARG(int, reply));
+        ipc->callAsync("doReplyShare", QString(), compatReply("doReplyShare"),
+                       Q_ARG(QString, qAppName()), Q_ARG(QString, qAppName()), Q_ARG(int, reply));
 #else
         DLOG << "Compat mode not enabled, cannot reply share request";
 #endif
@@ -891,7 +938,7 @@ void NetworkUtil::cancelApply(const QString &type, const QString &targetIp)
         // FIXME: cancel trans apply
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doCancelShareApply", Q_ARG(QString, qAppName()));
+        ipc->callAsync("doCancelShareApply", QString(), compatReply("doCancelShareApply"), Q_ARG(QString, qAppName()));
 #else
         DLOG << "Compat mode not enabled, cannot cancel apply";
 #endif
@@ -908,10 +955,10 @@ void NetworkUtil::cancelTrans(const QString &targetIp)
 #ifdef ENABLE_COMPAT
         DLOG << "Compat mode enabled, trying with old protocol by daemon";
         // TRANS_CANCEL 1008; coopertion jobid: 1000
-        bool res = false;
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doOperateJob", Q_RETURN_ARG(bool, res), Q_ARG(int, 1008), Q_ARG(int, 1000), Q_ARG(QString, qAppName()));
+        ipc->callAsync("doOperateJob", "bool", compatReply("doOperateJob"),
+                       Q_ARG(int, 1008), Q_ARG(int, 1000), Q_ARG(QString, qAppName()));
 #else
         DLOG << "Compat mode not enabled, cannot cancel transfer";
 #endif
@@ -933,16 +980,17 @@ void NetworkUtil::doSendFiles(const QStringList &fileList, const QString &target
         QString saveDir = (deviceName + "(%1)").arg(CooperationUtil::localIPAddress());
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doTransferFile", Q_ARG(QString, session), Q_ARG(QString, ipc::CooperRegisterName),
-                  Q_ARG(int, 1000), Q_ARG(QStringList, fileList), Q_ARG(bool, true),
-                  Q_ARG(QString, saveDir));
+        ipc->callAsync("doTransferFile", QString(), compatReply("doTransferFile"),
+                       Q_ARG(QString, session), Q_ARG(QString, ipc::CooperRegisterName),
+                       Q_ARG(int, 1000), Q_ARG(QStringList, fileList), Q_ARG(bool, true),
+                       Q_ARG(QString, saveDir));
 #else
         DLOG << "Compat mode not enabled, cannot send files";
 #endif
     }
 }
 
-bool NetworkUtil::isCurrentlyCooperating()
+void NetworkUtil::checkCurrentlyCooperating(const std::function<void(bool)> &finished)
 {
     // 检查非兼容模式状态
     auto server = ShareCooperationServiceManager::instance()->server();
@@ -951,21 +999,33 @@ bool NetworkUtil::isCurrentlyCooperating()
     bool clientRunning = client && client->isRunning();
     bool nonCompatCooperating = serverRunning || clientRunning;
 
+    if (nonCompatCooperating) {
+        DLOG << "NetworkUtil cooperation status check - nonCompatCooperating: true";
+        finished(true);
+        return;
+    }
 
-    // 检查兼容模式状态（通过IPC获取Comshare状态）
-    bool compatCooperating = false;
 #ifdef ENABLE_COMPAT
+    // 检查兼容模式状态：守护进程自己也会进入协同状态，必须等待它的回复
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("getCurrentCooperationStatus", Q_RETURN_ARG(bool, compatCooperating));
-#endif
-
-    bool isCooperating = nonCompatCooperating || compatCooperating;
-
-    DLOG << "NetworkUtil cooperation status check - nonCompatCooperating:" << nonCompatCooperating
-         << " compatCooperating:" << compatCooperating
-         << " isCooperating:" << isCooperating;
+    quint64 request = ipc->callAsync("getCurrentCooperationStatus", "bool", [this, finished](bool ok, const QVariant &result) {
+        if (ok)
+            _compatCooperating = result.toBool();
+        else
+            WLOG << "Compat call getCurrentCooperationStatus failed: " << result.toString().toStdString();
+
+        DLOG << "NetworkUtil cooperation status check - compatCooperating:" << _compatCooperating;
+        finished(_compatCooperating);
+    });
 
-    return isCooperating;
+    if (request == 0) {
+        DLOG << "NetworkUtil cooperation status check - daemon unreachable, compatCooperating:" << _compatCooperating;
+        finished(_compatCooperating);
+    }
+#else
+    DLOG << "NetworkUtil cooperation status check - isCooperating: false";
+    finished(false);
+#endif
 }
 
 QString NetworkUtil::deviceInfoStr()
@@ -1003,20 +1063,24 @@ void NetworkUtil::compatSendStartShare(const QString &screenName)
 {
     DLOG << "Compat send start share for screen:" << screenName.toStdString();
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("doStartShare", Q_ARG(QString, qAppName()), Q_ARG(QString, screenName));
+    ipc->callAsync("doStartShare", QString(), compatReply("doStartShare"),
+                   Q_ARG(QString, qAppName()), Q_ARG(QString, screenName));
 }
 
 void NetworkUtil::compatAppExit()
 {
     DLOG << "Stopping NetworkUtil";
     auto ipc = CompatWrapper::instance()->ipcInterface();
+    // blocking, the process may quit right after
     ipc->call("appExit");
 }
 
 void NetworkUtil::updateCooperationStatus(int status)
 {
     DLOG << "NetworkUtil updating cooperation status to:" << status;
+    // 6 = CURRENT_STATUS_SHARE_START
+    _compatCooperating = status == 6;
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("updateCooperationStatus", Q_ARG(int, status));
+    ipc->callAsync("updateCooperationStatus", QString(), compatReply("updateCooperationStatus"), Q_ARG(int, status));
 }
 #endif
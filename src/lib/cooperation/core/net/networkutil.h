@@ -9,6 +9,8 @@
 #include <QObject>
 #include <QSharedPointer>
 
+#include <functional>
+
 namespace cooperation_core {
 
 class NetworkUtilPrivate;
@@ -48,7 +50,8 @@ public:
 
     QString deviceInfoStr();
 
-    bool isCurrentlyCooperating();
+    // finished gets whether a cooperation is running, in compat mode once the daemon answered
+    void checkCurrentlyCooperating(const std::function<void(bool)> &finished);
 
     void stop();
 #ifdef ENABLE_COMPAT
@@ -67,15 +70,22 @@ public slots:
 
     void trySearchDevice(const QString &ip);
     void updateStorageConfig(const QString &value);
+    void updateTransferLimits(quint64 global, quint64 job, bool adaptive);
 
 private:
     explicit NetworkUtil(QObject *parent = nullptr);
     ~NetworkUtil();
 
 private:
+#ifdef ENABLE_COMPAT
+    void addCompatDevices(const QString &nodesJson);
+#endif
+
     QSharedPointer<NetworkUtilPrivate> d { nullptr };
     QString _selfFingerPrint;
     QPair<int, QString> _nextCombi;
+    // the status this process last set or got, used when the daemon does not answer
+    bool _compatCooperating { false };
 };
 
 }   // namespace cooperation_core
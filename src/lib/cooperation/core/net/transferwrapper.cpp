@@ -69,8 +69,10 @@ void TransferWrapper::onDeviceOnline(const QList<DeviceInfoPointer> &infoList)
         DLOG << "Emitting searched signal for single device";
         Q_EMIT searched(devList.first());
     } else {
-        DLOG << "Emitting refreshed signal for multiple devices";
-        Q_EMIT refreshed(devList);
+        // changes of a discovery, the whole list follows when it finishes
+        DLOG << "Emitting changed signal for multiple devices";
+        for (const QString &dev : devList)
+            Q_EMIT deviceChanged(true, dev);
     }
 }
 
@@ -86,7 +88,14 @@ void TransferWrapper::onFinishedDiscovery(bool hasFound)
     if (!hasFound) {
         DLOG << "Emitting empty searched signal";
         Q_EMIT searched("");
+        return;
     }
+
+    // only changes are reported while discovering, the helper wants the whole list
+    QStringList devList;
+    for (auto info : DiscoverController::instance()->getOnlineDeviceList())
+        devList << variantMapToQString(info->toVariantMap());
+    Q_EMIT refreshed(devList);
 }
 
 
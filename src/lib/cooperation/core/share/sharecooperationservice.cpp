@@ -13,6 +13,9 @@
 #include <QDir>
 #include <QFile>
 #include <QHostInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcessEnvironment>
 #include <QStandardPaths>
 #include <QTimer>
 
@@ -209,6 +212,15 @@ bool ShareCooperationService::startBarrier()
     connect(barrierProcess(), SIGNAL(readyReadStandardOutput()), this, SLOT(logOutput()));
     connect(barrierProcess(), SIGNAL(readyReadStandardError()), this, SLOT(logError()));
 
+#if !defined(Q_OS_WIN)
+    // barrier reports its input and clipboard counters to this socket
+    if (listenMetrics()) {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("BARRIER_METRICS_SOCKET", _metricsServer->fullServerName());
+        barrierProcess()->setProcessEnvironment(env);
+    }
+#endif
+
     LOG << "starting " << QString(barrierType() == BarrierType::Server ? "server" : "client").toStdString();
     LOG << QString("command: %1 %2").arg(app, args.join(" ")).toStdString();
 
@@ -237,6 +249,7 @@ void ShareCooperationService::stopBarrier()
     // This may cause abort while app exit.
     // LOG << "stopping process";
     _expectedRunning = false;
+    closeMetrics();
 
     if (!barrierProcess()) {
         DLOG << "No barrier process, terminating all existing barriers";
@@ -433,6 +446,103 @@ QString ShareCooperationService::appPath(const QString &name)
     return cooConfig().barrierProgramDir() + name;
 }
 
+QString ShareCooperationService::metricsSocketPath()
+{
+    // the client and server services share the profile dir
+    QString name = barrierType() == BarrierType::Server ? "barriers-metrics" : "barrierc-metrics";
+    return cooConfig().profileDir() + "/" + name;
+}
+
+bool ShareCooperationService::listenMetrics()
+{
+    if (!_metricsServer) {
+        _metricsServer = new QLocalServer(this);
+        _metricsServer->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(_metricsServer, &QLocalServer::newConnection, this, &ShareCooperationService::onMetricsConnection);
+    }
+
+    if (_metricsServer->isListening())
+        return true;
+
+    QString path = metricsSocketPath();
+    QLocalServer::removeServer(path);
+    if (!_metricsServer->listen(path)) {
+        WLOG << "Failed to listen for barrier metrics: " << _metricsServer->errorString().toStdString();
+        return false;
+    }
+    return true;
+}
+
+void ShareCooperationService::closeMetrics()
+{
+    if (_metricsSocket) {
+        _metricsSocket->disconnect(this);
+        _metricsSocket->deleteLater();
+        _metricsSocket = nullptr;
+    }
+
+    if (_metrics.reporting) {
+        _metrics = ShareMetrics();
+        emit metricsChanged(_metrics);
+    }
+}
+
+void ShareCooperationService::onMetricsConnection()
+{
+    while (QLocalSocket *socket = _metricsServer->nextPendingConnection()) {
+        // a restarted barrier replaces the previous connection
+        closeMetrics();
+        _metricsSocket = socket;
+        connect(socket, &QLocalSocket::readyRead, this, &ShareCooperationService::onMetricsReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket] {
+            if (socket == _metricsSocket)
+                closeMetrics();
+        });
+    }
+}
+
+void ShareCooperationService::onMetricsReadyRead()
+{
+    if (!_metricsSocket)
+        return;
+
+    // only the latest complete line matters
+    QByteArray line;
+    while (_metricsSocket->canReadLine())
+        line = _metricsSocket->readLine();
+
+    if (!line.isEmpty())
+        parseMetrics(line.trimmed());
+}
+
+void ShareCooperationService::parseMetrics(const QByteArray &line)
+{
+    // events=120.0 queue=0 rtt=1.8 clipboard=0 clipboard_ms=-1.0
+    ShareMetrics metrics;
+    metrics.reporting = true;
+    for (const QByteArray &pair : line.split(' ')) {
+        int sep = pair.indexOf('=');
+        if (sep <= 0)
+            continue;
+
+        QByteArray key = pair.left(sep);
+        QByteArray value = pair.mid(sep + 1);
+        if (key == "events")
+            metrics.eventRate = value.toDouble();
+        else if (key == "queue")
+            metrics.queueDepth = value.toULongLong();
+        else if (key == "rtt")
+            metrics.rtt = value.toDouble();
+        else if (key == "clipboard")
+            metrics.clipboardRate = value.toDouble();
+        else if (key == "clipboard_ms")
+            metrics.clipboardTime = value.toDouble();
+    }
+
+    _metrics = metrics;
+    emit metricsChanged(_metrics);
+}
+
 void ShareCooperationService::barrierFinished(int exitCode, QProcess::ExitStatus)
 {
     if (exitCode == 0) {
@@ -44,7 +44,20 @@ struct ShareServerConfig
     int switchCornerSize { 0 };
 };
 
+// Counters reported by the barrier process once a second
+struct ShareMetrics
+{
+    bool reporting { false };   // a barrier process is connected
+    double eventRate { 0 };   // key and mouse events per second
+    quint64 queueDepth { 0 };   // bytes waiting to be sent to the peer
+    double rtt { -1 };   // keep alive round trip in ms, -1 if unknown
+    double clipboardRate { 0 };   // clipboard bytes per second
+    double clipboardTime { -1 };   // ms to receive the last clipboard, -1 if none
+};
+
 class CooConfig;
+class QLocalServer;
+class QLocalSocket;
 class ShareCooperationService : public QObject
 {
     Q_OBJECT
@@ -67,6 +80,12 @@ public:
     bool isRunning();
     void terminateAllBarriers();
 
+    // latest counters of the running barrier
+    ShareMetrics metrics() const { return _metrics; }
+
+signals:
+    void metricsChanged(const ShareMetrics &metrics);
+
 public slots:
     bool restartBarrier();
     bool startBarrier();
@@ -77,6 +96,8 @@ protected slots:
     void appendLogRaw(const QString &text, bool error);
     void logOutput();
     void logError();
+    void onMetricsConnection();
+    void onMetricsReadyRead();
 
 private:
     explicit ShareCooperationService(QObject *parent = nullptr);
@@ -96,6 +117,11 @@ protected:
     void setScreen(const ShareServerConfig &config, QTextStream *stream);
     void setScreenLink(const ShareServerConfig &config, QTextStream *stream);
     void setScreenOptions(const ShareServerConfig &config, QTextStream *stream);
+
+    QString metricsSocketPath();
+    bool listenMetrics();
+    void closeMetrics();
+    void parseMetrics(const QByteArray &line);
 private:
     CooConfig *_cooConfig { nullptr };
     QProcess *_pBarrier { nullptr };
@@ -103,6 +129,10 @@ private:
     QString _barrierConfig;
 
     bool _expectedRunning = false;
+
+    QLocalServer *_metricsServer { nullptr };
+    QLocalSocket *_metricsSocket { nullptr };
+    ShareMetrics _metrics;
 };
 
 #endif   // SHARECOOPERATIONSERVICE_H
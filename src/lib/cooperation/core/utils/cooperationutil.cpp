@@ -106,6 +106,20 @@ void CooperationUtil::setStorageConfig(const QString &value)
     emit storageConfig(value);
 }
 
+void CooperationUtil::setTransferLimitConfig()
+{
+    auto global = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferRateLimitKey);
+    auto job = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferJobRateLimitKey);
+    auto adaptive = ConfigManager::instance()->appAttribute(AppSettings::GenericGroup, AppSettings::TransferAdaptiveKey);
+
+    // KB/s in settings, bytes/s for the transfers
+    quint64 globalRate = global.isValid() ? global.toULongLong() * 1024 : 0;
+    quint64 jobRate = job.isValid() ? job.toULongLong() * 1024 : 0;
+    bool adaptiveRate = adaptive.isValid() ? adaptive.toBool() : false;
+    DLOG << "Emitting transfer limit config:" << globalRate << jobRate << adaptiveRate;
+    emit transferLimitConfig(globalRate, jobRate, adaptiveRate);
+}
+
 QVariantMap CooperationUtil::deviceInfo()
 {
     DLOG << "Getting device info";
@@ -29,6 +29,7 @@ public:
     void registerDeviceOperation(const QVariantMap &map);
 
     void setStorageConfig(const QString &value);
+    void setTransferLimitConfig();
 
     void showFeatureDisplayDialog(QDialog *dlg);
 
@@ -42,6 +43,7 @@ public:
 Q_SIGNALS:
     void onlineStateChanged(const QString &validIP);
     void storageConfig(const QString &value);
+    void transferLimitConfig(quint64 global, quint64 job, bool adaptive);
 
 private:
     explicit CooperationUtil(QObject *parent = nullptr);
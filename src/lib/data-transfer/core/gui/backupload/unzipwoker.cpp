@@ -13,6 +13,8 @@
 #include <QTimer>
 #include <zip.h>
 
+#include "quazip/parallelzipextractor.h"
+
 inline constexpr char datajson[] { "transfer.json" };
 
 UnzipWorker::UnzipWorker(QString filepath)
@@ -119,6 +121,37 @@ bool UnzipWorker::isValid(QString filepath)
 bool UnzipWorker::extract()
 {
     LOG << "UnzipWorker::extract started with file:" << filepath.toStdString();
+
+    // inflate the entries on all cores, the unzip tool handles the archives it can not read
+    ParallelZipExtractor extractor(filepath);
+    if (!extractor.open()) {
+        WLOG << "Parallel extraction is not supported for this file, using unzip";
+        return extractByProcess();
+    }
+
+    totalSize = extractor.totalSize();
+    currentTotal = 0;
+    previousTotal = 0;
+    emit TransferHelper::instance()->transferContent(tr("Decompressing"), targetDir, 0, 0);
+
+    extractor.setProgress([this](const QString &name, qint64 bytes) {
+        currentTotal += bytes;
+        qint64 done = currentTotal;
+        int progressbar = totalSize > 0 ? static_cast<int>(done * 100 / totalSize) - 1 : 0;
+        int estimatedtime = speed > 0 ? static_cast<int>((totalSize - done) / speed / 2) + 1 : 0;
+        emit TransferHelper::instance()->transferContent(tr("Decompressing"), name, progressbar, estimatedtime);
+    });
+
+    bool ok = extractor.extract(targetDir);
+    if (!ok)
+        WLOG << "Parallel extraction failed at:" << extractor.failedFile().toStdString();
+    LOG << "UnzipWorker::extract extraction result:" << ok;
+    return ok;
+}
+
+bool UnzipWorker::extractByProcess()
+{
+    LOG << "UnzipWorker::extractByProcess started with file:" << filepath.toStdString();
     QStringList arguments;
     arguments << "-O"
               << "utf-8"
@@ -147,7 +180,7 @@ bool UnzipWorker::extract()
             currentTotal++;
             double value = static_cast<double>(currentTotal) / count;
             int progressbar = static_cast<int>(value * 100) - 1;
-            int estimatedtime = (count - currentTotal) / speed / 2 + 1;
+            int estimatedtime = static_cast<int>((count - currentTotal) / speed / 2) + 1;
             emit TransferHelper::instance()->transferContent(tr("Decompressing"), outputText, progressbar, estimatedtime);
             LOG << value << outputText.toStdString();
         }
@@ -6,6 +6,8 @@
 #include <QThread>
 #include <QTimer>
 
+#include <atomic>
+
 class UnzipWorker : public QThread
 {
     Q_OBJECT
@@ -24,6 +26,7 @@ public:
 
 private:
     bool setUesrFile(QJsonObject jsonObj);
+    bool extractByProcess();
 
 private:
     QString filepath;
@@ -31,16 +34,19 @@ private:
     QTimer *timer = nullptr;
 
     //Number of decompression completed in the previous second
-    int previousTotal = 0;
+    qint64 previousTotal = 0;
 
-    // Number of files that have been decompressed right now
-    int currentTotal = 0;
+    // Number of files (bytes for the parallel extraction) that have been decompressed right now
+    std::atomic<qint64> currentTotal { 0 };
 
-    // Number of files decompressed per second
-    int speed = -1;
+    // Number of files (bytes) decompressed per half second
+    qint64 speed = -1;
 
     // Number of zip files
     int count = 0;
+
+    // Uncompressed size of the zip
+    qint64 totalSize = 0;
 };
 
 #endif
@@ -8,6 +8,7 @@
 #include "zipworker.h"
 #include "../win/drapwindowsdata.h"
 #include "compressutil.h"
+#include "parallelzipwriter.h"
 #include <common/commonutils.h>
 #include <QProcess>
 #include <QDebug>
@@ -21,7 +22,6 @@
 #include <QElapsedTimer>
 #include <QDirIterator>
 #include <QCoreApplication>
-#include <QDataStream>
 
 #define BUFFER_SIZE 8 * 1024
 ZipWork::ZipWork(QObject *parent) : QThread(parent)
@@ -63,108 +63,21 @@ void ZipWork::getUserDataPackagingFile()
     DLOG << "User data packaging completed";
 }
 
-int ZipWork::getPathFileNum(const QString &filePath)
-{
-    if (QFileInfo(filePath).isFile()) {
-        DLOG << "File path is a file, returning 1";
-        return 1;
-    }
-    int fileCount = 0;
-    QDir dir(filePath);
-    QFileInfoList entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
-
-    for (const QFileInfo &entry : entries) {
-        if (entry.isDir()) {
-            // DLOG << "Entry is a directory, recursively counting files:" << entry.absoluteFilePath().toStdString();
-            fileCount += getPathFileNum(entry.absoluteFilePath());
-        } else {
-            // DLOG << "Entry is a file, incrementing count:" << entry.absoluteFilePath().toStdString();
-            fileCount++;
-        }
-    }
-
-    DLOG << "File count for path" << filePath.toStdString() << ":" << fileCount;
-    return fileCount;
-}
-
-int ZipWork::getAllFileNum(const QStringList &fileList)
-{
-    int fileNum = 0;
-
-    for (const QString &filePath : fileList) {
-        int curPathFileNum = getPathFileNum(filePath);
-        fileNum += curPathFileNum;
-        // DLOG << "Current path file count:" << curPathFileNum << "Total file count:" << fileNum;
-    }
-    DLOG << "Total files counted:" << fileNum;
-    return fileNum;
-}
-
-bool ZipWork::addFileToZip(const QString &filePath, const QString &relativeTo, QuaZip &zip,
-                           QElapsedTimer &timer)
+bool ZipWork::addFileToZip(const QString &filePath, const QString &relativeTo, ParallelZipWriter &writer)
 {
     DLOG << "Adding file to zip:" << filePath.toStdString();
     if (abort) {
         DLOG << "Aborting addFileToZip due to abort flag";
-        zip.close();
-        QFile::remove(zipFile);
+        writer.cancel();
         return false;
     }
 
-    QFile sourceFile(filePath);
-    if (!sourceFile.open(QIODevice::ReadOnly)) {
-        DLOG << "Failed to open source file for reading:" << filePath.toStdString();
-        // backup file false
-        sendBackupFileFailMessage(filePath);
-        return false;
-    }
-
-    QuaZipFile destinationFile(&zip);
+    // read, checksum and deflate run on the writer's thread pool
     QString destinationFileName = QDir(relativeTo).relativeFilePath(filePath);
-    QuaZipNewInfo newInfo(destinationFileName, sourceFile.fileName());
-    if (!destinationFile.open(QIODevice::WriteOnly, newInfo)) {
-        DLOG << "Failed to open destination file in ZIP for writing:" << filePath.toStdString();
-        // backup file false
-
-        sendBackupFileFailMessage(filePath);
-        return false;
-    }
-
-    QDataStream in(&sourceFile);
-    char *buffer = reinterpret_cast<char *>(malloc(BUFFER_SIZE));
-    while (!in.atEnd()) {
-        memset(buffer, 0, BUFFER_SIZE);
-        qint64 bytesRead = in.readRawData(buffer, BUFFER_SIZE);
-        if (bytesRead == -1) {
-            DLOG << "Error reading from source file:" << filePath.toStdString();
-            free(buffer);
-            destinationFile.close();
-            sourceFile.close();
-            sendBackupFileFailMessage(filePath);
-            return false;
-        }
-
-        qint64 bytesWritten = destinationFile.write(buffer, bytesRead);
-        if (bytesWritten == -1) {
-            DLOG << "Error writing to ZIP file for:" << filePath.toStdString();
-            free(buffer);
-            destinationFile.close();
-            sourceFile.close();
-            sendBackupFileFailMessage(filePath);
-            return false;
-        }
-
-        sendBackupFileProcess(filePath, timer, bytesRead);
-    }
-    free(buffer);
-    destinationFile.close();
-    sourceFile.close();
-
-    return true;
+    return writer.addFile(filePath, destinationFileName);
 }
 
-bool ZipWork::addFolderToZip(const QString &sourceFolder, const QString &relativeTo, QuaZip &zip,
-                             QElapsedTimer &timer)
+bool ZipWork::addFolderToZip(const QString &sourceFolder, const QString &relativeTo, ParallelZipWriter &writer)
 {
     DLOG << "Adding folder to zip:" << sourceFolder.toStdString();
 
@@ -174,12 +87,12 @@ bool ZipWork::addFolderToZip(const QString &sourceFolder, const QString &relativ
     for (QFileInfo entry : entries) {
         if (entry.isDir()) {
             DLOG << "Entry is a directory, recursively adding folder to zip:" << entry.absoluteFilePath().toStdString();
-            if (!addFolderToZip(entry.absoluteFilePath(), relativeTo, zip, timer)) {
+            if (!addFolderToZip(entry.absoluteFilePath(), relativeTo, writer)) {
                 return false;
             }
         } else {
             DLOG << "Entry is a file, adding file to zip:" << entry.absoluteFilePath().toStdString();
-            if (!addFileToZip(entry.absoluteFilePath(), relativeTo, zip, timer)) {
+            if (!addFileToZip(entry.absoluteFilePath(), relativeTo, writer)) {
                 return false;
             }
         }
@@ -188,11 +101,8 @@ bool ZipWork::addFolderToZip(const QString &sourceFolder, const QString &relativ
     // If the current folder is empty, then create an empty directory
     if (entries.isEmpty()) {
         DLOG << "Folder is empty, creating empty directory in zip";
-        QuaZipFile dirZipFile(&zip);
         QString dirFileName = QDir(relativeTo).relativeFilePath(sourceFolder) + "/";
-        QuaZipNewInfo newInfo(dirFileName);
-        dirZipFile.open(QIODevice::WriteOnly, newInfo);
-        dirZipFile.close();
+        return writer.addDirectory(dirFileName);
     }
 
     return true;
@@ -213,7 +123,16 @@ bool ZipWork::backupFile(const QStringList &entries, const QString &destinationZ
         return false;
     }
 
+    // compress on all cores, the archive is written in order on this thread
+    ParallelZipWriter writer(&zip);
+    writer.setProgress([this, &writer, &timer](const QString &filePath, qint64 bytes) {
+        if (abort)
+            writer.cancel();
+        sendBackupFileProcess(filePath, timer, static_cast<int>(bytes));
+    });
+
     DLOG << "ZIP file created successfully, starting compression...";
+    bool success = true;
     for (QString entry : entries) {
 
         QFileInfo fileInfo(entry);
@@ -221,21 +140,39 @@ bool ZipWork::backupFile(const QStringList &entries, const QString &destinationZ
             DLOG << "Entry is a directory:" << entry.toStdString();
             QDir parent = QDir(entry);
             parent.cdUp();
-            if (!addFolderToZip(entry, QDir(parent).absolutePath(), zip, timer)) {
+            if (!addFolderToZip(entry, QDir(parent).absolutePath(), writer)) {
                 DLOG << "Failed to add folder to zip:" << entry.toStdString();
-                return false;
+                success = false;
+                break;
             }
         } else if (fileInfo.isFile()) {
             DLOG << "Entry is a file:" << entry.toStdString();
-            if (!addFileToZip(entry, fileInfo.absolutePath(), zip, timer)) {
+            if (!addFileToZip(entry, fileInfo.absolutePath(), writer)) {
                 DLOG << "Failed to add file to zip:" << entry.toStdString();
-                return false;
+                success = false;
+                break;
             }
         } else {
             DLOG << "Entry is neither a file nor a directory:" << entry.toStdString();
         }
     }
 
+    if (success)
+        success = writer.finish();
+
+    if (!success) {
+        if (abort || (writer.isCanceled() && writer.failedFile().isEmpty())) {
+            DLOG << "Backup aborted, removing the archive";
+            writer.cancel();
+            zip.close();
+            QFile::remove(zipFile);
+        } else {
+            // backup file false
+            sendBackupFileFailMessage(writer.failedFile().isEmpty() ? destinationZipFile : writer.failedFile());
+        }
+        return false;
+    }
+
     zip.close();
     DLOG << "ZIP file closed, verifying integrity...";
 
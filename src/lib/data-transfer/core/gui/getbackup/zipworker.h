@@ -4,7 +4,7 @@
 #include <QThread>
 
 class QElapsedTimer;
-class QuaZip;
+class ParallelZipWriter;
 class ZipWork : public QThread
 {
     Q_OBJECT
@@ -17,13 +17,8 @@ public:
 private:
     void getUserDataPackagingFile();
 
-    int getPathFileNum(const QString &filePath);
-    int getAllFileNum(const QStringList &fileList);
-
-    bool addFileToZip(const QString &filePath, const QString &relativeTo, QuaZip &zip,
-                      QElapsedTimer &timer);
-    bool addFolderToZip(const QString &sourceFolder, const QString &relativeTo, QuaZip &zip,
-                        QElapsedTimer &timer);
+    bool addFileToZip(const QString &filePath, const QString &relativeTo, ParallelZipWriter &writer);
+    bool addFolderToZip(const QString &sourceFolder, const QString &relativeTo, ParallelZipWriter &writer);
     bool backupFile(const QStringList &sourceFilePath, const QString &zipFileSave);
 
     void sendBackupFileProcess(const QString &filePath, QElapsedTimer &timer,int size);
@@ -28,6 +28,15 @@
 
 #ifdef ENABLE_COMPAT
 using namespace cooperation_core;
+
+// The daemon is called asynchronously, only a failed call is worth noting
+static SlotIPCInterface::CallFinished compatReply(const char *method)
+{
+    return [method](bool ok, const QVariant &result) {
+        if (!ok)
+            WLOG << "Compat call " << method << " failed: " << result.toString().toStdString();
+    };
+}
 #endif
 NetworkUtilPrivate::NetworkUtilPrivate(NetworkUtil *qq)
     : q(qq)
@@ -118,6 +127,14 @@ void NetworkUtilPrivate::handleTransChanged(int status, const QString &path, qui
     case TRANS_COUNT_SIZE:
         // only update the total size while rpc notice
         transferInfo.totalSize = size;
+        transferInfo.counting = false;
+        break;
+    case TRANS_COUNTING:
+        // a partial total arriving late must not replace the final one
+        if (transferInfo.counting || transferInfo.totalSize < 1) {
+            transferInfo.totalSize = size;
+            transferInfo.counting = true;
+        }
         break;
     case TRANS_WHOLE_START:
         emit TransferHelper::instance()->transferring();
@@ -160,6 +177,10 @@ void NetworkUtilPrivate::updateTransProgress(uint64_t current, const QString &pa
     int remain_time;
     if (progressValue <= 0) {
         return;
+    } else if (transferInfo.counting && progressValue >= 99) {
+        // the partial total has been passed, wait for the final one
+        progressValue = 99;
+        remain_time = 0;
     } else if (progressValue >= 100) {
         progressValue = 100;
         remain_time = 0;
@@ -247,7 +268,8 @@ void NetworkUtil::updateStorageConfig()
         auto fullstorpath = TransferUtil::DownLoadDir(true);
         //update the storage dir for old protocol
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("saveAppConfig", Q_ARG(QString, appName), Q_ARG(QString, "storagedir"), Q_ARG(QString, fullstorpath));
+        ipc->callAsync("saveAppConfig", QString(), compatReply("saveAppConfig"),
+                       Q_ARG(QString, appName), Q_ARG(QString, "storagedir"), Q_ARG(QString, fullstorpath));
     }
 #endif
 }
@@ -258,7 +280,7 @@ void NetworkUtil::updatePassword(const QString &code)
 #ifdef ENABLE_COMPAT
     //update the pincode for old protocol
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("setAuthPassword", Q_ARG(QString, code));
+    ipc->callAsync("setAuthPassword", QString(), compatReply("setAuthPassword"), Q_ARG(QString, code));
 #endif
 }
 
@@ -290,7 +312,7 @@ void NetworkUtil::disConnect()
     else {
         auto appName = qAppName();
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doDisconnectCallback", Q_ARG(QString, appName));
+        ipc->callAsync("doDisconnectCallback", QString(), compatReply("doDisconnectCallback"), Q_ARG(QString, appName));
     }
 #endif
 }
@@ -312,7 +334,8 @@ bool NetworkUtil::sendMessage(const QString &message)
 
         auto appName = qAppName();
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("sendMiscMessage", Q_ARG(QString, appName), Q_ARG(QString, msg));
+        ipc->callAsync("sendMiscMessage", QString(), compatReply("sendMiscMessage"),
+                       Q_ARG(QString, appName), Q_ARG(QString, msg));
     }
 #endif
 
@@ -329,10 +352,10 @@ void NetworkUtil::cancelTrans(const QString &reason)
         auto appName = qAppName();
         auto jobid = appName.length();
         // TRANS_CANCEL 1008; data transfer jobid: name's length
-        bool res =  false;
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doOperateJob", Q_RETURN_ARG(bool, res), Q_ARG(int, 1008), Q_ARG(int, jobid), Q_ARG(QString, appName));
+        ipc->callAsync("doOperateJob", "bool", compatReply("doOperateJob"),
+                       Q_ARG(int, 1008), Q_ARG(int, jobid), Q_ARG(QString, appName));
     }
 #endif
 }
@@ -353,9 +376,10 @@ void NetworkUtil::doSendFiles(const QStringList &fileList)
         // QString saveDir = (deviceName + "(%1)").arg(CooperationUtil::localIPAddress());
         // try again with old protocol by daemon
         auto ipc = CompatWrapper::instance()->ipcInterface();
-        ipc->call("doTransferFile", Q_ARG(QString, session), Q_ARG(QString, appName),
-                  Q_ARG(int, jobid), Q_ARG(QStringList, fileList), Q_ARG(bool, true),
-                  Q_ARG(QString, ""));
+        ipc->callAsync("doTransferFile", QString(), compatReply("doTransferFile"),
+                       Q_ARG(QString, session), Q_ARG(QString, appName),
+                       Q_ARG(int, jobid), Q_ARG(QStringList, fileList), Q_ARG(bool, true),
+                       Q_ARG(QString, ""));
     }
 #endif
 }
@@ -369,8 +393,9 @@ void NetworkUtil::compatLogin()
     auto appName = qAppName();
     // try connect with old protocol by daemon
     auto ipc = CompatWrapper::instance()->ipcInterface();
-    ipc->call("doTryConnect", Q_ARG(QString, appName), Q_ARG(QString, appName),
-              Q_ARG(QString, ip), Q_ARG(QString, pwd));
+    ipc->callAsync("doTryConnect", QString(), compatReply("doTryConnect"),
+                   Q_ARG(QString, appName), Q_ARG(QString, appName),
+                   Q_ARG(QString, ip), Q_ARG(QString, pwd));
 #endif
 }
 
@@ -474,6 +499,7 @@ void NetworkUtil::compatFileTransStatusChanged(const QString &path, quint64 tota
 void NetworkUtil::stop()
 {
     auto ipc = CompatWrapper::instance()->ipcInterface();
+    // blocking, the process may quit right after
     ipc->call("appExit");
 }
 #endif
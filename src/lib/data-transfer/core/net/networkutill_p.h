@@ -16,12 +16,14 @@ class NetworkUtilPrivate : public QObject
         int64_t totalSize = 0;   // 总量
         int64_t transferSize = 0;   // 当前传输量
         int64_t maxTimeS = 0;   // 耗时
+        bool counting = false;   // 总量是部分统计结果，发送端仍在统计
 
         void clear()
         {
             totalSize = 0;
             transferSize = 0;
             maxTimeS = 0;
+            counting = false;
         }
     };
 
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "compressutil.h"
+#include "parallelzipextractor.h"
 #include <QDebug>
 
 static bool copyData(QIODevice &inFile, QIODevice &outFile)
@@ -414,6 +415,17 @@ QStringList CompressUtil::extractFiles(QuaZip &zip, const QStringList &files, co
 
 QStringList CompressUtil::extractDir(QString fileCompressed, QString dir) {
     qInfo() << "Extracting entire directory from archive:" << fileCompressed << "to:" << dir;
+    // Inflate the entries on all cores when the archive allows it
+    ParallelZipExtractor extractor(fileCompressed);
+    if (extractor.open()) {
+        if (!extractor.extract(dir)) {
+            qInfo() << "parallel extract failed:" << extractor.failedFile();
+            removeFile(extractor.files());
+            return QStringList();
+        }
+        return extractor.files();
+    }
+
     // Apro lo zip
     QuaZip zip(fileCompressed);
     return extractDir(zip, dir);
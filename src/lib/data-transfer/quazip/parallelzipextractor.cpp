@@ -0,0 +1,531 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "parallelzipextractor.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QtEndian>
+
+#include <climits>
+#include <cstring>
+
+#include <zlib.h>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Buffer size of the reads and writes of one task
+static const qint64 kBlockSize = 256 * 1024;
+// Progress of a large entry is reported after this many bytes
+static const qint64 kReportSize = 4 * 1024 * 1024;
+
+static const quint32 kLocalHeaderSig = 0x04034b50;
+static const quint32 kCentralHeaderSig = 0x02014b50;
+static const quint32 kEndSig = 0x06054b50;
+static const quint32 kEnd64LocatorSig = 0x07064b50;
+static const quint32 kEnd64Sig = 0x06064b50;
+
+static const int kLocalHeaderSize = 30;
+static const int kCentralHeaderSize = 46;
+static const int kEndSize = 22;
+static const int kEnd64LocatorSize = 20;
+static const int kEnd64Size = 56;
+
+// Unix file type bits of the external attributes
+static const quint32 kTypeMask = 0170000;
+static const quint32 kTypeSymlink = 0120000;
+static const quint32 kTypeDirectory = 0040000;
+
+struct ParallelZipExtractor::Entry {
+    QString name;
+    QString path;
+    qint64 offset { 0 };
+    qint64 csize { 0 };
+    qint64 usize { 0 };
+    quint32 crc { 0 };
+    quint32 dosTime { 0 };
+    quint32 mode { 0 };
+    quint16 method { 0 };
+    bool directory { false };
+    bool symlink { false };
+};
+
+namespace {
+
+class EntryTask : public QRunnable
+{
+public:
+    explicit EntryTask(std::function<void()> fn) : _fn(std::move(fn)) {}
+    void run() override { _fn(); }
+
+private:
+    std::function<void()> _fn;
+};
+
+template <typename T>
+T readLE(const char *data)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar *>(data));
+}
+
+QFile::Permissions permissionsFromMode(quint32 mode)
+{
+    QFile::Permissions perm;
+    if (mode & 0400)
+        perm |= QFile::ReadOwner | QFile::ReadUser;
+    if (mode & 0200)
+        perm |= QFile::WriteOwner | QFile::WriteUser;
+    if (mode & 0100)
+        perm |= QFile::ExeOwner | QFile::ExeUser;
+    if (mode & 0040)
+        perm |= QFile::ReadGroup;
+    if (mode & 0020)
+        perm |= QFile::WriteGroup;
+    if (mode & 0010)
+        perm |= QFile::ExeGroup;
+    if (mode & 0004)
+        perm |= QFile::ReadOther;
+    if (mode & 0002)
+        perm |= QFile::WriteOther;
+    if (mode & 0001)
+        perm |= QFile::ExeOther;
+    return perm;
+}
+
+QDateTime dateTimeFromDos(quint32 dosTime)
+{
+    QDate date(static_cast<int>((dosTime >> 25) + 1980), static_cast<int>((dosTime >> 21) & 0x0f),
+               static_cast<int>((dosTime >> 16) & 0x1f));
+    QTime time(static_cast<int>((dosTime >> 11) & 0x1f), static_cast<int>((dosTime >> 5) & 0x3f),
+               static_cast<int>((dosTime & 0x1f) * 2));
+    return QDateTime(date, time);
+}
+
+// Relative name which stays below the destination directory
+bool isSafeName(const QString &name)
+{
+    if (name.isEmpty() || name.startsWith('/') || name.startsWith('\\'))
+        return false;
+    const QString clean = QDir::cleanPath(name);
+    return clean != ".." && !clean.startsWith("../");
+}
+
+} // namespace
+
+ParallelZipExtractor::ParallelZipExtractor(const QString &archive, int threads)
+    : _archivePath(archive)
+{
+    if (threads <= 0)
+        threads = qMax(QThread::idealThreadCount(), 1);
+    _pool.setMaxThreadCount(threads);
+    qInfo() << "Parallel zip extractor with" << threads << "threads";
+}
+
+ParallelZipExtractor::~ParallelZipExtractor()
+{
+    cancel();
+    _pool.waitForDone();
+}
+
+void ParallelZipExtractor::setProgress(Progress progress)
+{
+    _progress = std::move(progress);
+}
+
+QStringList ParallelZipExtractor::entryNames() const
+{
+    QStringList names;
+    names.reserve(_entries.size());
+    for (const Entry &entry : _entries)
+        names.append(entry.name);
+    return names;
+}
+
+bool ParallelZipExtractor::open()
+{
+    _archive.setFileName(_archivePath);
+    if (!_archive.open(QIODevice::ReadOnly)) {
+        qWarning() << "open archive failed:" << _archivePath;
+        return false;
+    }
+    _fd = _archive.handle();
+
+    if (!readCentralDirectory()) {
+        qWarning() << "unsupported archive:" << _archivePath;
+        _entries.clear();
+        _archive.close();
+        return false;
+    }
+    qInfo() << "Archive has" << _entries.size() << "entries," << _totalSize << "bytes";
+    return true;
+}
+
+bool ParallelZipExtractor::readCentralDirectory()
+{
+    // the end record is at the end, before a comment of at most 64 KB
+    const qint64 archiveSize = _archive.size();
+    const qint64 tailSize = qMin<qint64>(archiveSize, kEndSize + 0xffff);
+    if (tailSize < kEndSize)
+        return false;
+    QByteArray tail(static_cast<int>(tailSize), Qt::Uninitialized);
+    if (!readAt(archiveSize - tailSize, tail.data(), tailSize))
+        return false;
+
+    int end = -1;
+    for (int i = static_cast<int>(tailSize) - kEndSize; i >= 0; --i) {
+        if (readLE<quint32>(tail.constData() + i) == kEndSig) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0)
+        return false;
+
+    const char *rec = tail.constData() + end;
+    if (readLE<quint16>(rec + 4) != 0 || readLE<quint16>(rec + 6) != 0)
+        return false; // split archive
+    qint64 count = readLE<quint16>(rec + 10);
+    qint64 cdSize = readLE<quint32>(rec + 12);
+    qint64 cdOffset = readLE<quint32>(rec + 16);
+
+    // zip64 end record, found through its locator right before the end record
+    const qint64 endOffset = archiveSize - tailSize + end;
+    if (endOffset >= kEnd64LocatorSize) {
+        char locator[kEnd64LocatorSize];
+        if (readAt(endOffset - kEnd64LocatorSize, locator, kEnd64LocatorSize)
+            && readLE<quint32>(locator) == kEnd64LocatorSig) {
+            char end64[kEnd64Size];
+            const qint64 end64Offset = static_cast<qint64>(readLE<quint64>(locator + 8));
+            if (!readAt(end64Offset, end64, kEnd64Size) || readLE<quint32>(end64) != kEnd64Sig)
+                return false;
+            count = static_cast<qint64>(readLE<quint64>(end64 + 32));
+            cdSize = static_cast<qint64>(readLE<quint64>(end64 + 40));
+            cdOffset = static_cast<qint64>(readLE<quint64>(end64 + 48));
+        }
+    }
+
+    if (cdOffset < 0 || cdSize < 0 || cdOffset + cdSize > archiveSize || cdSize > INT_MAX)
+        return false;
+
+    // the whole central directory in one read
+    QByteArray cd(static_cast<int>(cdSize), Qt::Uninitialized);
+    if (!readAt(cdOffset, cd.data(), cdSize))
+        return false;
+
+    _entries.clear();
+    _entries.reserve(static_cast<int>(qMin<qint64>(count, cdSize / kCentralHeaderSize)));
+    _totalSize = 0;
+
+    qint64 pos = 0;
+    for (qint64 i = 0; i < count; ++i) {
+        if (pos + kCentralHeaderSize > cdSize)
+            return false;
+        const char *hdr = cd.constData() + pos;
+        if (readLE<quint32>(hdr) != kCentralHeaderSig)
+            return false;
+
+        const quint16 madeBy = readLE<quint16>(hdr + 4);
+        const quint16 flags = readLE<quint16>(hdr + 8);
+        const int nameLen = readLE<quint16>(hdr + 28);
+        const int extraLen = readLE<quint16>(hdr + 30);
+        const int commentLen = readLE<quint16>(hdr + 32);
+        if (pos + kCentralHeaderSize + nameLen + extraLen + commentLen > cdSize)
+            return false;
+        if (flags & 0x0001)
+            return false; // encrypted
+
+        Entry entry;
+        entry.method = readLE<quint16>(hdr + 10);
+        entry.dosTime = readLE<quint32>(hdr + 12);
+        entry.crc = readLE<quint32>(hdr + 16);
+        entry.csize = readLE<quint32>(hdr + 20);
+        entry.usize = readLE<quint32>(hdr + 24);
+        entry.offset = readLE<quint32>(hdr + 42);
+        // names are written as utf-8 by the backup
+        entry.name = QString::fromUtf8(hdr + kCentralHeaderSize, nameLen);
+        if ((madeBy >> 8) == 3)
+            entry.mode = readLE<quint32>(hdr + 38) >> 16;
+        entry.directory = entry.name.endsWith('/') || (entry.mode & kTypeMask) == kTypeDirectory;
+        entry.symlink = (entry.mode & kTypeMask) == kTypeSymlink;
+
+        // the zip64 extra field holds the sizes and offset which did not fit
+        const char *extra = hdr + kCentralHeaderSize + nameLen;
+        for (int e = 0; e + 4 <= extraLen;) {
+            const quint16 id = readLE<quint16>(extra + e);
+            const int size = readLE<quint16>(extra + e + 2);
+            if (e + 4 + size > extraLen)
+                break;
+            if (id == 0x0001) {
+                int f = e + 4;
+                if (entry.usize == 0xffffffffLL && f + 8 <= e + 4 + size) {
+                    entry.usize = static_cast<qint64>(readLE<quint64>(extra + f));
+                    f += 8;
+                }
+                if (entry.csize == 0xffffffffLL && f + 8 <= e + 4 + size) {
+                    entry.csize = static_cast<qint64>(readLE<quint64>(extra + f));
+                    f += 8;
+                }
+                if (entry.offset == 0xffffffffLL && f + 8 <= e + 4 + size)
+                    entry.offset = static_cast<qint64>(readLE<quint64>(extra + f));
+                break;
+            }
+            e += 4 + size;
+        }
+
+        if (!entry.directory && entry.method != 0 && entry.method != Z_DEFLATED) {
+            qWarning() << "unsupported compression method:" << entry.method << entry.name;
+            return false;
+        }
+        if (entry.offset < 0 || entry.csize < 0 || entry.usize < 0 || entry.offset + entry.csize > archiveSize)
+            return false;
+
+        _totalSize += entry.usize;
+        _entries.append(entry);
+        pos += kCentralHeaderSize + nameLen + extraLen + commentLen;
+    }
+    return true;
+}
+
+bool ParallelZipExtractor::readAt(qint64 offset, char *data, qint64 size)
+{
+#ifdef Q_OS_UNIX
+    // positional reads share the handle between the threads without a lock
+    qint64 done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(_fd, data + done, static_cast<size_t>(size - done), static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        done += n;
+    }
+    return true;
+#else
+    QMutexLocker locker(&_readMutex);
+    return _archive.seek(offset) && _archive.read(data, size) == size;
+#endif
+}
+
+bool ParallelZipExtractor::extract(const QString &dir)
+{
+    if (!_archive.isOpen() && !open())
+        return false;
+
+    // directories are made first, so the tasks only create files
+    QDir directory(dir);
+    QSet<QString> dirs;
+    _files.clear();
+    for (Entry &entry : _entries) {
+        if (!isSafeName(entry.name)) {
+            qWarning() << "entry outside of the destination:" << entry.name;
+            fail(entry.name);
+            return false;
+        }
+        entry.path = directory.absoluteFilePath(entry.name);
+        _files.append(entry.path);
+        dirs.insert(entry.directory ? entry.path : QFileInfo(entry.path).absolutePath());
+    }
+    for (const QString &path : dirs) {
+        if (!QDir().mkpath(path)) {
+            qWarning() << "mkpath failed:" << path;
+            fail(QString());
+            return false;
+        }
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        _remaining = 0;
+        _events.clear();
+    }
+    for (const Entry &entry : _entries) {
+        if (entry.directory) {
+            if (entry.mode & 0777)
+                QFile(entry.path).setPermissions(permissionsFromMode(entry.mode));
+            continue;
+        }
+        if (entry.symlink) {
+            qWarning() << "skip symbolic link:" << entry.name;
+            continue;
+        }
+
+        {
+            QMutexLocker locker(&_mutex);
+            ++_remaining;
+        }
+        const Entry *task = &entry;
+        _pool.start(new EntryTask([this, task]() {
+            if (!isCanceled() && !extractEntry(*task))
+                fail(task->name);
+            QMutexLocker locker(&_mutex);
+            --_remaining;
+            _changed.wakeAll();
+        }));
+    }
+
+    // report in this thread while the pool works
+    QVector<QPair<QString, qint64>> events;
+    bool running = true;
+    while (running) {
+        {
+            QMutexLocker locker(&_mutex);
+            while (_events.isEmpty() && _remaining > 0)
+                _changed.wait(&_mutex);
+            events.swap(_events);
+            running = _remaining > 0;
+        }
+        if (_progress) {
+            for (const auto &event : events)
+                _progress(event.first, event.second);
+        }
+        events.clear();
+    }
+    _pool.waitForDone();
+
+    return !_failed && !isCanceled();
+}
+
+bool ParallelZipExtractor::extractEntry(const Entry &entry)
+{
+    char local[kLocalHeaderSize];
+    if (!readAt(entry.offset, local, kLocalHeaderSize) || readLE<quint32>(local) != kLocalHeaderSig) {
+        qWarning() << "bad local header:" << entry.name;
+        return false;
+    }
+    const qint64 dataOffset = entry.offset + kLocalHeaderSize + readLE<quint16>(local + 26) + readLE<quint16>(local + 28);
+
+    QFile out(entry.path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qWarning() << "open file failed:" << entry.path;
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    // reserve the space at once, a full disk fails here and not halfway
+    if (entry.usize > 0 && posix_fallocate(out.handle(), 0, static_cast<off_t>(entry.usize)) == ENOSPC) {
+        qWarning() << "no space left for:" << entry.path;
+        out.close();
+        out.remove();
+        return false;
+    }
+#endif
+
+    if (!inflateEntry(entry, dataOffset, out)) {
+        out.close();
+        out.remove();
+        return false;
+    }
+
+    if (entry.dosTime != 0)
+        out.setFileTime(dateTimeFromDos(entry.dosTime), QFileDevice::FileModificationTime);
+    out.close();
+    if (entry.mode & 0777)
+        out.setPermissions(permissionsFromMode(entry.mode));
+    return true;
+}
+
+bool ParallelZipExtractor::inflateEntry(const Entry &entry, qint64 offset, QFile &out)
+{
+    QByteArray in(static_cast<int>(kBlockSize), Qt::Uninitialized);
+    QByteArray buf;
+    quint32 crc = 0;
+    qint64 read = 0;
+    qint64 written = 0;
+    qint64 reported = 0;
+
+    auto writeOut = [&](const char *data, qint64 size) {
+        if (out.write(data, size) != size) {
+            qWarning() << "write file failed:" << entry.path;
+            return false;
+        }
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(size));
+        written += size;
+        if (written - reported >= kReportSize) {
+            report(entry.name, written - reported);
+            reported = written;
+        }
+        return true;
+    };
+
+    if (entry.method == 0) {
+        while (read < entry.csize) {
+            if (isCanceled())
+                return false;
+            const qint64 size = qMin(kBlockSize, entry.csize - read);
+            if (!readAt(offset + read, in.data(), size) || !writeOut(in.constData(), size))
+                return false;
+            read += size;
+        }
+    } else {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            return false;
+
+        buf.resize(static_cast<int>(kBlockSize));
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END) {
+            if (isCanceled())
+                break;
+            if (stream.avail_in == 0) {
+                const qint64 size = qMin(kBlockSize, entry.csize - read);
+                if (size <= 0 || !readAt(offset + read, in.data(), size))
+                    break;
+                read += size;
+                stream.next_in = reinterpret_cast<Bytef *>(in.data());
+                stream.avail_in = static_cast<uInt>(size);
+            }
+            stream.next_out = reinterpret_cast<Bytef *>(buf.data());
+            stream.avail_out = static_cast<uInt>(buf.size());
+            ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END)
+                break;
+            if (!writeOut(buf.constData(), buf.size() - stream.avail_out))
+                break;
+        }
+        inflateEnd(&stream);
+        if (ret != Z_STREAM_END) {
+            if (!isCanceled())
+                qWarning() << "inflate failed:" << ret << entry.name;
+            return false;
+        }
+    }
+
+    if (written != entry.usize || crc != entry.crc) {
+        qWarning() << "crc or size mismatch:" << entry.name;
+        return false;
+    }
+    report(entry.name, written - reported);
+    return true;
+}
+
+void ParallelZipExtractor::report(const QString &name, qint64 bytes)
+{
+    QMutexLocker locker(&_mutex);
+    _events.append(qMakePair(name, bytes));
+    _changed.wakeAll();
+}
+
+void ParallelZipExtractor::cancel()
+{
+    _canceled.store(true);
+}
+
+void ParallelZipExtractor::fail(const QString &name)
+{
+    qWarning() << "parallel unzip failed at:" << (name.isEmpty() ? QString("archive") : name);
+    QMutexLocker locker(&_mutex);
+    if (!_failed.exchange(true))
+        _failedFile = name;
+    cancel();
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PARALLELZIPEXTRACTOR_H_
+#define PARALLELZIPEXTRACTOR_H_
+
+#include "exportdefine.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+
+// Extracts a whole zip with the entries inflated concurrently.
+//
+// The central directory is read once when the archive is opened. Each file
+// entry is then a task of the pool: it reads its compressed data with
+// positional reads from the shared archive handle, inflates it, checks the
+// crc and writes it to a preallocated file. Memory stays at a few buffers per
+// thread whatever the archive size.
+//
+// Stored and deflated entries are supported. Encrypted or split archives
+// fail to open, so the caller can fall back to QuaZip.
+class DLL_EXPORT ParallelZipExtractor {
+public:
+    // Called in the calling thread with the bytes written for an entry
+    using Progress = std::function<void(const QString &name, qint64 bytes)>;
+
+    // threads 0 is the ideal thread count
+    explicit ParallelZipExtractor(const QString &archive, int threads = 0);
+    ~ParallelZipExtractor();
+
+    void setProgress(Progress progress);
+
+    // Read the central directory, false if the archive is not supported
+    bool open();
+    // Extract all entries below dir, false on failure or cancel
+    bool extract(const QString &dir);
+    // Stop the work, may be called from any thread
+    void cancel();
+
+    bool isCanceled() const { return _canceled.load(); }
+    // Uncompressed size of all entries, valid after open()
+    qint64 totalSize() const { return _totalSize; }
+    // Entry names in the archive order, valid after open()
+    QStringList entryNames() const;
+    // Destination paths of the entries, valid after extract()
+    QStringList files() const { return _files; }
+    // Entry which failed, empty if the archive failed
+    QString failedFile() const { return _failedFile; }
+
+private:
+    struct Entry;
+
+    bool readCentralDirectory();
+    bool readAt(qint64 offset, char *data, qint64 size);
+    bool extractEntry(const Entry &entry);
+    bool inflateEntry(const Entry &entry, qint64 offset, QFile &out);
+    void report(const QString &name, qint64 bytes);
+    void fail(const QString &name);
+
+    QString _archivePath;
+    QFile _archive;
+    int _fd { -1 };
+    QMutex _readMutex;
+
+    QVector<Entry> _entries;
+    qint64 _totalSize { 0 };
+    QStringList _files;
+    QString _failedFile;
+    Progress _progress;
+    std::atomic<bool> _canceled { false };
+    std::atomic<bool> _failed { false };
+
+    // progress of the pool, drained by the calling thread
+    QMutex _mutex;
+    QWaitCondition _changed;
+    QVector<QPair<QString, qint64>> _events;
+    int _remaining { 0 };
+    QThreadPool _pool;
+};
+
+#endif /* PARALLELZIPEXTRACTOR_H_ */
@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "parallelzipwriter.h"
+#include "quazipfile.h"
+#include "quazipnewinfo.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QVector>
+
+#include <cstring>
+
+#include <zlib.h>
+
+// Source bytes of one chunk, the unit of the parallel work
+static const qint64 kChunkSize = 1024 * 1024;
+// Chunks compressed ahead of the writing for each thread
+static const int kChunksPerThread = 8;
+// Above this size the entry needs the zip64 extension
+static const qint64 kZip64Size = 0xffffffffLL;
+
+struct ParallelZipWriter::Chunk {
+    qint64 offset { 0 };
+    qint64 size { 0 };
+    bool last { false };
+
+    // filled by the pool
+    QByteArray data;
+    quint32 crc { 0 };
+    bool stored { false };
+    bool done { false };
+    bool failed { false };
+};
+
+struct ParallelZipWriter::Job {
+    QString filePath;
+    QString name;
+    qint64 size { 0 };
+    bool directory { false };
+    bool store { false };
+    QVector<QSharedPointer<Chunk>> chunks;
+
+    // writing state
+    int written { 0 };
+    qint64 usize { 0 };
+    quint32 crc { 0 };
+};
+
+namespace {
+
+class ChunkTask : public QRunnable
+{
+public:
+    explicit ChunkTask(std::function<void()> fn) : _fn(std::move(fn)) {}
+    void run() override { _fn(); }
+
+private:
+    std::function<void()> _fn;
+};
+
+} // namespace
+
+ParallelZipWriter::ParallelZipWriter(QuaZip *zip, int threads)
+    : _zip(zip)
+{
+    if (threads <= 0)
+        threads = qMax(QThread::idealThreadCount(), 1);
+    _pool.setMaxThreadCount(threads);
+    _maxPending = threads * kChunksPerThread;
+    qInfo() << "Parallel zip writer with" << threads << "threads";
+}
+
+ParallelZipWriter::~ParallelZipWriter()
+{
+    cancel();
+    _pool.waitForDone();
+    if (_entry && _entry->isOpen())
+        _entry->close();
+}
+
+void ParallelZipWriter::setProgress(Progress progress)
+{
+    _progress = std::move(progress);
+}
+
+bool ParallelZipWriter::isCompressed(const QString &filePath)
+{
+    static const QSet<QString> suffixes = {
+        // images
+        "jpg", "jpeg", "png", "gif", "webp", "heic", "heif", "avif",
+        // audio and video
+        "mp3", "m4a", "aac", "ogg", "opus", "flac", "wma",
+        "mp4", "m4v", "mkv", "avi", "mov", "wmv", "webm", "flv", "rmvb",
+        // archives and packages
+        "zip", "gz", "tgz", "bz2", "xz", "txz", "zst", "7z", "rar", "lz4",
+        "deb", "rpm", "apk", "jar", "cab", "msi",
+        // office documents are zip files
+        "docx", "xlsx", "pptx", "odt", "ods", "odp", "epub"
+    };
+    return suffixes.contains(QFileInfo(filePath).suffix().toLower());
+}
+
+bool ParallelZipWriter::addFile(const QString &filePath, const QString &name)
+{
+    if (_failed || isCanceled())
+        return false;
+
+    QSharedPointer<Job> job(new Job);
+    job->filePath = filePath;
+    job->name = name;
+    job->size = QFileInfo(filePath).size();
+    job->store = (job->size == 0) || isCompressed(filePath);
+
+    qint64 offset = 0;
+    do {
+        QSharedPointer<Chunk> chunk(new Chunk);
+        chunk->offset = offset;
+        chunk->size = qMin(kChunkSize, job->size - offset);
+        offset += chunk->size;
+        chunk->last = (offset >= job->size);
+        job->chunks.append(chunk);
+    } while (offset < job->size);
+
+    _jobs.push_back(job);
+
+    for (const auto &chunk : job->chunks) {
+        // write the finished chunks first while too many wait
+        while (_pending >= _maxPending) {
+            if (!writeNext(true))
+                return false;
+        }
+
+        ++_pending;
+        _pool.start(new ChunkTask([this, job, chunk]() {
+            bool ok = !isCanceled() && compress(*job, *chunk);
+            QMutexLocker locker(&_mutex);
+            chunk->failed = !ok;
+            chunk->done = true;
+            _done.wakeAll();
+        }));
+    }
+
+    // write what is ready without waiting
+    while (writeNext(false) && !_jobs.empty()) {
+    }
+    return !_failed && !isCanceled();
+}
+
+bool ParallelZipWriter::addDirectory(const QString &name)
+{
+    if (_failed || isCanceled())
+        return false;
+
+    QSharedPointer<Job> job(new Job);
+    job->name = name;
+    job->directory = true;
+    _jobs.push_back(job);
+    return true;
+}
+
+bool ParallelZipWriter::finish()
+{
+    while (!_jobs.empty()) {
+        if (!writeNext(true))
+            break;
+    }
+    _pool.waitForDone();
+    return !_failed && !isCanceled();
+}
+
+void ParallelZipWriter::cancel()
+{
+    _canceled.store(true);
+}
+
+bool ParallelZipWriter::compress(const Job &job, Chunk &chunk)
+{
+    QFile file(job.filePath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(chunk.offset)) {
+        qWarning() << "open file failed:" << job.filePath;
+        return false;
+    }
+
+    // a file changed meanwhile keeps its size from the start of the backup,
+    // a shorter read is archived as it is
+    QByteArray raw(static_cast<int>(chunk.size), Qt::Uninitialized);
+    qint64 bytesRead = file.read(raw.data(), chunk.size);
+    if (bytesRead < 0) {
+        qWarning() << "read file failed:" << job.filePath;
+        return false;
+    }
+    raw.resize(static_cast<int>(bytesRead));
+    chunk.size = bytesRead;
+    chunk.crc = crc32(0, reinterpret_cast<const Bytef *>(raw.constData()), static_cast<uInt>(raw.size()));
+
+    if (job.store) {
+        chunk.data = raw;
+        chunk.stored = true;
+        return true;
+    }
+
+    // raw deflate stream of this chunk alone, the sync flush keeps it open
+    // and byte aligned for the next chunk
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    chunk.data.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(raw.size())) + 16));
+    stream.next_in = reinterpret_cast<Bytef *>(raw.data());
+    stream.avail_in = static_cast<uInt>(raw.size());
+    stream.next_out = reinterpret_cast<Bytef *>(chunk.data.data());
+    stream.avail_out = static_cast<uInt>(chunk.data.size());
+    int ret = deflate(&stream, chunk.last ? Z_FINISH : Z_SYNC_FLUSH);
+    chunk.data.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    if (ret != (chunk.last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0) {
+        qWarning() << "deflate failed:" << ret << job.filePath;
+        return false;
+    }
+
+    // a single chunk file which does not get smaller is stored
+    if (chunk.offset == 0 && chunk.last && chunk.data.size() >= raw.size()) {
+        chunk.data = raw;
+        chunk.stored = true;
+    }
+    return true;
+}
+
+bool ParallelZipWriter::openEntry(Job &job, bool stored)
+{
+    if (job.size >= kZip64Size && !_zip->isZip64Enabled())
+        _zip->setZip64Enabled(true);
+
+    QuaZipNewInfo info(job.name, job.filePath);
+    _entry.reset(new QuaZipFile(_zip));
+    if (!_entry->open(QIODevice::WriteOnly, info, nullptr, 0,
+                      stored ? 0 : Z_DEFLATED, Z_DEFAULT_COMPRESSION, true)) {
+        qWarning() << "open zip entry failed:" << job.name << _entry->getZipError();
+        return false;
+    }
+    return true;
+}
+
+bool ParallelZipWriter::writeNext(bool wait)
+{
+    if (_failed || isCanceled())
+        return false;
+    if (_jobs.empty())
+        return true;
+
+    QSharedPointer<Job> job = _jobs.front();
+    if (job->directory) {
+        QuaZipFile dir(_zip);
+        dir.open(QIODevice::WriteOnly, QuaZipNewInfo(job->name));
+        dir.close();
+        _jobs.pop_front();
+        return true;
+    }
+
+    QSharedPointer<Chunk> chunk = job->chunks[job->written];
+    {
+        QMutexLocker locker(&_mutex);
+        if (!chunk->done && !wait)
+            return false;
+        while (!chunk->done)
+            _done.wait(&_mutex);
+    }
+
+    if (chunk->failed)
+        return fail(job->filePath);
+
+    if (job->written == 0 && !openEntry(*job, chunk->stored))
+        return fail(QString());
+
+    if (_entry->write(chunk->data) != chunk->data.size())
+        return fail(QString());
+
+    job->crc = (job->written == 0) ? chunk->crc : crc32_combine(job->crc, chunk->crc, static_cast<z_off_t>(chunk->size));
+    job->usize += chunk->size;
+    chunk->data.clear();
+    ++job->written;
+    --_pending;
+
+    if (_progress)
+        _progress(job->filePath, chunk->size);
+
+    if (job->written == job->chunks.size()) {
+        _entry->closeRaw(job->usize, job->crc);
+        if (_entry->getZipError() != UNZ_OK)
+            return fail(QString());
+        _entry.reset();
+        _jobs.pop_front();
+    }
+    return true;
+}
+
+bool ParallelZipWriter::fail(const QString &filePath)
+{
+    qWarning() << "parallel zip failed at:" << (filePath.isEmpty() ? QString("archive") : filePath);
+    _failed = true;
+    _failedFile = filePath;
+    cancel();
+    return false;
+}
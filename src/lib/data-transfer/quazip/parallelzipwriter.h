@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PARALLELZIPWRITER_H_
+#define PARALLELZIPWRITER_H_
+
+#include "exportdefine.h"
+#include "quazip.h"
+
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+
+class QuaZipFile;
+
+// Adds files to an opened zip with the compression spread over a thread pool.
+//
+// Every file is cut in chunks which are read, checksummed and deflated as
+// independent raw deflate streams by the pool, then appended to the archive
+// in the order the files were added. The chunks of one file end with a sync
+// flush, so together they are one valid deflate stream. Already compressed
+// media and archives are stored instead of deflated.
+//
+// The calling thread writes the archive, add() blocks while too many chunks
+// wait to be written, so the memory stays bounded.
+class DLL_EXPORT ParallelZipWriter {
+public:
+    // Called in the calling thread for each written part of a file
+    using Progress = std::function<void(const QString &filePath, qint64 bytes)>;
+
+    // zip must be opened for writing, threads 0 is the ideal thread count
+    explicit ParallelZipWriter(QuaZip *zip, int threads = 0);
+    ~ParallelZipWriter();
+
+    void setProgress(Progress progress);
+
+    // Queue the file under the name inside the archive, false on failure
+    bool addFile(const QString &filePath, const QString &name);
+    // Queue an empty directory entry, the name ends with '/'
+    bool addDirectory(const QString &name);
+    // Write all queued files, false on failure or cancel
+    bool finish();
+    // Stop the work, may be called from any thread
+    void cancel();
+
+    bool isCanceled() const { return _canceled.load(); }
+    // Source file which failed, empty if the archive failed
+    QString failedFile() const { return _failedFile; }
+
+    // Files with these types do not get smaller by deflate
+    static bool isCompressed(const QString &filePath);
+
+private:
+    struct Chunk;
+    struct Job;
+
+    bool compress(const Job &job, Chunk &chunk);
+    bool writeNext(bool wait);
+    bool openEntry(Job &job, bool stored);
+    bool fail(const QString &filePath);
+
+    QuaZip *_zip;
+    Progress _progress;
+    QString _failedFile;
+    std::atomic<bool> _canceled { false };
+    bool _failed { false };
+
+    // queued jobs in the archive order, the front one is written
+    std::deque<QSharedPointer<Job>> _jobs;
+    std::unique_ptr<QuaZipFile> _entry;
+    int _pending { 0 };
+    int _maxPending { 0 };
+
+    QMutex _mutex;
+    QWaitCondition _done;
+    QThreadPool _pool;
+};
+
+#endif /* PARALLELZIPWRITER_H_ */
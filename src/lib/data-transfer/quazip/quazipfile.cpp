@@ -490,6 +490,13 @@ bool QuaZipFile::getFileInfo(QuaZipFileInfo64 *info)
     return p->zipError==UNZ_OK;
 }
 
+void QuaZipFile::closeRaw(qint64 uncompressedSize, quint32 crc)
+{
+  p->uncompressedSize = uncompressedSize;
+  p->crc = crc;
+  close();
+}
+
 void QuaZipFile::close()
 {
   qInfo() << "Closing QuaZipFile";
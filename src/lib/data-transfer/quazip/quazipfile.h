@@ -91,6 +91,8 @@ class DLL_EXPORT QuaZipFile: public QIODevice {
     bool getFileInfo(QuaZipFileInfo64 *info);
     // Close the file
     virtual void close();
+    // Close file opened in raw mode with the size and CRC known only after writing
+    void closeRaw(qint64 uncompressedSize, quint32 crc);
     // Get last ZIP operation error code
     int getZipError() const;
     // Get available bytes for reading